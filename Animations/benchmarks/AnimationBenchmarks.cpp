@@ -0,0 +1,154 @@
+#ifdef _MATH_ANIM_BENCHMARKS
+#include "AnimationBenchmarks.h"
+#include "BenchmarkScenes.h"
+#include "animation/Animation.h"
+#include "animation/AnimationManager.h"
+#include "core/FrameArena.h"
+
+#include <nlohmann/json.hpp>
+
+namespace MathAnim
+{
+	namespace AnimationBenchmarks
+	{
+		// -------------------- Constants --------------------
+		constexpr int NUM_SCENE_OBJECTS = 500;
+		constexpr int NUM_SCENE_ANIMATIONS = 1'000;
+		constexpr int NUM_LARGE_SCENE_OBJECTS = 50'000;
+		constexpr int NUM_LARGE_SCENE_ANIMATIONS = 50'000;
+
+		// -------------------- Internal Functions --------------------
+		static nlohmann::json serializeLargeScene(bool binary);
+
+		// -------------------- Benchmarks --------------------
+		DEFINE_BENCHMARK(resetToFrame500Objects)
+		{
+			AnimationManagerData* am = BenchmarkScenes::createAnimationScene(BenchmarkScenes::DEFAULT_SEED, NUM_SCENE_OBJECTS, NUM_SCENE_ANIMATIONS);
+			int lastFrame = AnimationManager::lastAnimatedFrame(am);
+
+			// Scrub through the timeline the same way every run
+			uint32 frame = 0;
+			while (state.keepRunning())
+			{
+				frame = (frame + 97) % (uint32)lastFrame;
+				AnimationManager::resetToFrame(am, frame);
+
+				state.pauseTiming();
+				FrameArena::reset();
+				state.resumeTiming();
+			}
+
+			AnimationManager::free(am);
+			FrameArena::reset();
+		}
+
+		DEFINE_BENCHMARK(saveSceneJson)
+		{
+			AnimationManagerData* am = BenchmarkScenes::createAnimationScene(BenchmarkScenes::DEFAULT_SEED, NUM_SCENE_OBJECTS, NUM_SCENE_ANIMATIONS);
+
+			while (state.keepRunning())
+			{
+				nlohmann::json sceneJson = {};
+				sceneJson["Version"]["Major"] = SERIALIZER_VERSION_MAJOR;
+				sceneJson["Version"]["Minor"] = SERIALIZER_VERSION_MINOR;
+				AnimationManager::serialize(am, sceneJson["AnimationManager"]);
+				std::string sceneText = sceneJson.dump();
+			}
+
+			AnimationManager::free(am);
+			FrameArena::reset();
+		}
+
+		DEFINE_BENCHMARK(loadSceneJson)
+		{
+			std::string sceneText;
+			{
+				AnimationManagerData* am = BenchmarkScenes::createAnimationScene(BenchmarkScenes::DEFAULT_SEED, NUM_SCENE_OBJECTS, NUM_SCENE_ANIMATIONS);
+				nlohmann::json sceneJson = {};
+				AnimationManager::serialize(am, sceneJson);
+				sceneText = sceneJson.dump();
+				AnimationManager::free(am);
+			}
+
+			while (state.keepRunning())
+			{
+				AnimationManagerData* am = AnimationManager::create();
+				nlohmann::json sceneJson = nlohmann::json::parse(sceneText);
+				AnimationManager::deserialize(am, sceneJson, 0, SERIALIZER_VERSION_MAJOR, SERIALIZER_VERSION_MINOR);
+				AnimationManager::endFrame(am);
+
+				state.pauseTiming();
+				AnimationManager::free(am);
+				state.resumeTiming();
+			}
+		}
+
+		// Both of these go from the bytes on disk to a loaded scene, the binary one is what
+		// Application does with a .scene file after mapping it
+		DEFINE_BENCHMARK(loadScene50kObjectsJson)
+		{
+			std::string sceneText = serializeLargeScene(false).dump();
+
+			while (state.keepRunning())
+			{
+				AnimationManagerData* am = AnimationManager::create();
+				nlohmann::json sceneJson = nlohmann::json::parse(sceneText);
+				AnimationManager::deserialize(am, sceneJson, 0, SERIALIZER_VERSION_MAJOR, SERIALIZER_VERSION_MINOR);
+				AnimationManager::endFrame(am);
+
+				state.pauseTiming();
+				AnimationManager::free(am);
+				state.resumeTiming();
+			}
+		}
+
+		DEFINE_BENCHMARK(loadScene50kObjectsBinary)
+		{
+			std::vector<uint8> sceneBytes = nlohmann::json::to_cbor(serializeLargeScene(true));
+
+			while (state.keepRunning())
+			{
+				AnimationManagerData* am = AnimationManager::create();
+				nlohmann::json sceneJson = nlohmann::json::from_cbor(sceneBytes.data(), sceneBytes.data() + sceneBytes.size());
+				AnimationManager::deserialize(am, sceneJson, 0, SERIALIZER_VERSION_MAJOR, SERIALIZER_VERSION_MINOR);
+				AnimationManager::endFrame(am);
+
+				state.pauseTiming();
+				AnimationManager::free(am);
+				state.resumeTiming();
+			}
+		}
+
+		void setupBenchmarkSuite()
+		{
+			BenchmarkSuite& benchmarkSuite = Benchmarks::addBenchmarkSuite("AnimationManager");
+
+			ADD_BENCHMARK(benchmarkSuite, resetToFrame500Objects);
+			ADD_BENCHMARK(benchmarkSuite, saveSceneJson);
+			ADD_BENCHMARK(benchmarkSuite, loadSceneJson);
+			ADD_BENCHMARK(benchmarkSuite, loadScene50kObjectsJson);
+			ADD_BENCHMARK(benchmarkSuite, loadScene50kObjectsBinary);
+		}
+
+		// -------------------- Internal Functions --------------------
+		static nlohmann::json serializeLargeScene(bool binary)
+		{
+			AnimationManagerData* am = BenchmarkScenes::createAnimationScene(BenchmarkScenes::DEFAULT_SEED, NUM_LARGE_SCENE_OBJECTS, NUM_LARGE_SCENE_ANIMATIONS);
+			nlohmann::json sceneJson = {};
+			if (binary)
+			{
+				AnimationManager::serializeBinary(am, sceneJson);
+			}
+			else
+			{
+				AnimationManager::serialize(am, sceneJson);
+			}
+			AnimationManager::free(am);
+			FrameArena::reset();
+
+			return sceneJson;
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,15 @@
+#ifdef _MATH_ANIM_BENCHMARKS
+#ifndef MATH_ANIM_ANIMATION_BENCHMARKS_H
+#define MATH_ANIM_ANIMATION_BENCHMARKS_H
+#include "core/Benchmarking.h"
+
+namespace MathAnim
+{
+	namespace AnimationBenchmarks
+	{
+		void setupBenchmarkSuite();
+	}
+}
+
+#endif 
+#endif // _MATH_ANIM_BENCHMARKS
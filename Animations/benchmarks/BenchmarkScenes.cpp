@@ -0,0 +1,185 @@
+#ifdef _MATH_ANIM_BENCHMARKS
+#include "BenchmarkScenes.h"
+#include "animation/Animation.h"
+#include "animation/AnimationManager.h"
+#include "core/Application.h"
+
+#include <algorithm>
+
+namespace MathAnim
+{
+	namespace BenchmarkScenes
+	{
+		// -------------------- Constants --------------------
+		static constexpr AnimTypeV1 animationTypes[] = {
+			AnimTypeV1::MoveTo,
+			AnimTypeV1::Create,
+			AnimTypeV1::FadeIn,
+			AnimTypeV1::FadeOut,
+			AnimTypeV1::Shift,
+			AnimTypeV1::RotateTo,
+			AnimTypeV1::AnimateFillColor,
+			AnimTypeV1::AnimateScale,
+		};
+		static constexpr int numAnimationTypes = sizeof(animationTypes) / sizeof(animationTypes[0]);
+
+		// -------------------- Internal Functions --------------------
+		static float randomFloat(std::mt19937& rng, float min, float max);
+		static void appendRandomPoint(std::string& res, std::mt19937& rng, float min, float max);
+
+		AnimationManagerData* createAnimationScene(uint32 seed, int numObjects, int numAnimations)
+		{
+			std::mt19937 rng(seed);
+			glm::vec2 viewportSize = Application::getViewportSize();
+
+			AnimationManagerData* am = AnimationManager::create();
+
+			std::vector<AnimObjId> objectIds;
+			objectIds.reserve(numObjects);
+			for (int i = 0; i < numObjects; i++)
+			{
+				AnimObjectTypeV1 type = i % 2 == 0 ? AnimObjectTypeV1::Square : AnimObjectTypeV1::Circle;
+				AnimObject obj = AnimObject::createDefault(am, type);
+				obj._positionStart = Vec3{ randomFloat(rng, 0.0f, viewportSize.x), randomFloat(rng, 0.0f, viewportSize.y), 0.0f };
+				obj.position = obj._positionStart;
+				obj._strokeWidthStart = randomFloat(rng, 1.0f, 5.0f);
+				objectIds.push_back(obj.id);
+				AnimationManager::addAnimObject(am, obj);
+			}
+
+			std::vector<AnimId> animationIds;
+			animationIds.reserve(numAnimations);
+			for (int i = 0; i < numAnimations; i++)
+			{
+				AnimTypeV1 type = animationTypes[rng() % numAnimationTypes];
+				int32 frameStart = (int32)(rng() % 600);
+				int32 duration = 30 + (int32)(rng() % 90);
+				Animation animation = Animation::createDefault(type, frameStart, duration);
+				animationIds.push_back(animation.id);
+				AnimationManager::addAnimation(am, animation);
+			}
+
+			// Flush the queued objects and animations so they can be linked together
+			AnimationManager::endFrame(am);
+
+			for (AnimId animationId : animationIds)
+			{
+				int numTargets = 1 + (int)(rng() % 4);
+				for (int i = 0; i < numTargets && !objectIds.empty(); i++)
+				{
+					AnimObjId objId = objectIds[rng() % objectIds.size()];
+					AnimationManager::addObjectToAnim(am, objId, animationId);
+				}
+			}
+
+			AnimationManager::calculateAnimationKeyFrames(am);
+			AnimationManager::resetToFrame(am, 0);
+
+			return am;
+		}
+
+		std::string createSvgPath(uint32 seed, int numCommands)
+		{
+			constexpr float maxAbsolute = 500.0f;
+			constexpr float maxRelative = 25.0f;
+			std::mt19937 rng(seed);
+
+			std::string res = "M";
+			appendRandomPoint(res, rng, 0.0f, maxAbsolute);
+			for (int i = 0; i < numCommands; i++)
+			{
+				// Start a new sub-path every so often so the parser sees holes too
+				if (i > 0 && i % 250 == 0)
+				{
+					res += " Z M";
+					appendRandomPoint(res, rng, 0.0f, maxAbsolute);
+					continue;
+				}
+
+				switch (rng() % 7)
+				{
+				case 0:
+					res += " L";
+					appendRandomPoint(res, rng, 0.0f, maxAbsolute);
+					break;
+				case 1:
+					res += " l";
+					appendRandomPoint(res, rng, -maxRelative, maxRelative);
+					break;
+				case 2:
+					res += " C";
+					appendRandomPoint(res, rng, 0.0f, maxAbsolute);
+					appendRandomPoint(res, rng, 0.0f, maxAbsolute);
+					appendRandomPoint(res, rng, 0.0f, maxAbsolute);
+					break;
+				case 3:
+					res += " c";
+					appendRandomPoint(res, rng, -maxRelative, maxRelative);
+					appendRandomPoint(res, rng, -maxRelative, maxRelative);
+					appendRandomPoint(res, rng, -maxRelative, maxRelative);
+					break;
+				case 4:
+					res += " Q";
+					appendRandomPoint(res, rng, 0.0f, maxAbsolute);
+					appendRandomPoint(res, rng, 0.0f, maxAbsolute);
+					break;
+				case 5:
+					res += " h";
+					res += std::to_string((int)randomFloat(rng, -maxRelative, maxRelative));
+					break;
+				case 6:
+					res += " a 20 20 0 0 1";
+					appendRandomPoint(res, rng, -maxRelative, maxRelative);
+					break;
+				}
+			}
+			res += " Z";
+
+			return res;
+		}
+
+		std::string createCppFile(int numLines)
+		{
+			std::string res = "#include <stdio.h>\n\n";
+			int numFunctions = 0;
+			while (std::count(res.begin(), res.end(), '\n') < numLines)
+			{
+				std::string id = std::to_string(numFunctions++);
+				res += "/* Adds up the numbers for case " + id + " */\n";
+				res += "static int sum" + id + "(int count, float scale)\n";
+				res += "{\n";
+				res += "\t// Keep a running total\n";
+				res += "\tint total = 0;\n";
+				res += "\tfor (int i = 0; i < count; i++)\n";
+				res += "\t{\n";
+				res += "\t\ttotal += (int)(i * scale) + 0x" + id + ";\n";
+				res += "\t}\n";
+				res += "\tprintf(\"sum" + id + ": %d\\n\", total);\n";
+				res += "\treturn total;\n";
+				res += "}\n\n";
+			}
+
+			return res;
+		}
+
+		// -------------------- Internal Functions --------------------
+		// std::uniform_real_distribution is implementation defined, mt19937 itself isn't
+		static float randomFloat(std::mt19937& rng, float min, float max)
+		{
+			return min + ((float)rng() / (float)std::mt19937::max()) * (max - min);
+		}
+
+		static void appendRandomPoint(std::string& res, std::mt19937& rng, float min, float max)
+		{
+			// Separate statements so x is always drawn before y
+			float x = randomFloat(rng, min, max);
+			float y = randomFloat(rng, min, max);
+
+			char buffer[64];
+			snprintf(buffer, sizeof(buffer), " %.2f %.2f", x, y);
+			res += buffer;
+		}
+	}
+}
+
+#endif
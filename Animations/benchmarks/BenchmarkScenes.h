@@ -0,0 +1,28 @@
+#ifdef _MATH_ANIM_BENCHMARKS
+#ifndef MATH_ANIM_BENCHMARK_SCENES_H
+#define MATH_ANIM_BENCHMARK_SCENES_H
+#include "core.h"
+
+namespace MathAnim
+{
+	struct AnimationManagerData;
+
+	// Synthetic inputs for the benchmarks. Everything is generated from a fixed seed so
+	// two runs, or two machines, always measure the exact same work.
+	namespace BenchmarkScenes
+	{
+		constexpr uint32 DEFAULT_SEED = 0x5EED'1234;
+
+		// Squares and circles spread over the viewport with numAnimations random
+		// animations attached to them. Free it with AnimationManager::free.
+		AnimationManagerData* createAnimationScene(uint32 seed, int numObjects, int numAnimations);
+
+		// Absolute and relative lines, curves and arcs split over a few sub-paths
+		std::string createSvgPath(uint32 seed, int numCommands);
+
+		std::string createCppFile(int numLines);
+	}
+}
+
+#endif
+#endif // _MATH_ANIM_BENCHMARKS
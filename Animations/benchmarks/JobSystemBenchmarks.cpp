@@ -0,0 +1,61 @@
+#ifdef _MATH_ANIM_BENCHMARKS
+#include "JobSystemBenchmarks.h"
+#include "multithreading/GlobalThreadPool.h"
+
+namespace MathAnim
+{
+	namespace JobSystemBenchmarks
+	{
+		// -------------------- Constants --------------------
+		constexpr size_t NUM_TINY_JOBS = 1'000'000;
+
+		// -------------------- Benchmarks --------------------
+		// Jobs that do next to nothing, so this is all queueing and stealing overhead
+		DEFINE_BENCHMARK(queueAndWait1000000TinyJobs)
+		{
+			GlobalThreadPool pool(std::thread::hardware_concurrency());
+
+			std::atomic<size_t> numJobsRun = 0;
+			while (state.keepRunning())
+			{
+				JobCounter counter;
+				for (size_t i = 0; i < NUM_TINY_JOBS; i++)
+				{
+					pool.queueJob([&numJobsRun]() { numJobsRun.fetch_add(1, std::memory_order_relaxed); }, "TinyJob", Priority::None, &counter);
+				}
+				pool.wait(counter);
+			}
+
+			pool.free();
+		}
+
+		DEFINE_BENCHMARK(parallelFor1000000Indices)
+		{
+			GlobalThreadPool pool(std::thread::hardware_concurrency());
+
+			std::vector<uint32> values(NUM_TINY_JOBS, 0);
+			while (state.keepRunning())
+			{
+				pool.parallelFor(values.size(), 256, [&values](size_t begin, size_t end)
+				{
+					for (size_t i = begin; i < end; i++)
+					{
+						values[i]++;
+					}
+				});
+			}
+
+			pool.free();
+		}
+
+		void setupBenchmarkSuite()
+		{
+			BenchmarkSuite& benchmarkSuite = Benchmarks::addBenchmarkSuite("JobSystem");
+
+			ADD_BENCHMARK(benchmarkSuite, queueAndWait1000000TinyJobs);
+			ADD_BENCHMARK(benchmarkSuite, parallelFor1000000Indices);
+		}
+	}
+}
+
+#endif
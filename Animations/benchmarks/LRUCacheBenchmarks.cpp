@@ -0,0 +1,75 @@
+#ifdef _MATH_ANIM_BENCHMARKS
+#include "LRUCacheBenchmarks.h"
+#include "BenchmarkScenes.h"
+#include "utils/LRUCache.hpp"
+
+namespace MathAnim
+{
+	namespace LRUCacheBenchmarks
+	{
+		// -------------------- Constants --------------------
+		constexpr int NUM_CACHE_ENTRIES = 10'000;
+		constexpr int NUM_CACHE_OPERATIONS = 100'000;
+
+		// -------------------- Benchmarks --------------------
+		DEFINE_BENCHMARK(insert10000)
+		{
+			while (state.keepRunning())
+			{
+				LRUCache<uint64, Vec4> cache;
+				for (int i = 0; i < NUM_CACHE_ENTRIES; i++)
+				{
+					cache.insert((uint64)i, Vec4{ (float)i, 0.0f, 0.0f, 1.0f });
+				}
+
+				state.pauseTiming();
+				cache.clear();
+				state.resumeTiming();
+			}
+		}
+
+		DEFINE_BENCHMARK(getWithEviction100000)
+		{
+			// Same key sequence every run, roughly 80% hits on a cache that stays at a steady size
+			std::mt19937 rng(BenchmarkScenes::DEFAULT_SEED);
+			std::vector<uint64> keys(NUM_CACHE_OPERATIONS);
+			for (int i = 0; i < NUM_CACHE_OPERATIONS; i++)
+			{
+				keys[i] = (uint64)(rng() % (NUM_CACHE_ENTRIES + NUM_CACHE_ENTRIES / 4));
+			}
+
+			LRUCache<uint64, Vec4> cache;
+			for (int i = 0; i < NUM_CACHE_ENTRIES; i++)
+			{
+				cache.insert((uint64)i, Vec4{ (float)i, 0.0f, 0.0f, 1.0f });
+			}
+
+			while (state.keepRunning())
+			{
+				for (int i = 0; i < NUM_CACHE_OPERATIONS; i++)
+				{
+					uint64 key = keys[i];
+					if (!cache.get(key).has_value())
+					{
+						// Miss, make room the way a real cache would by dropping the least recently used
+						uint64 oldestKey = cache.getOldest()->key;
+						cache.evict(oldestKey);
+						cache.insert(key, Vec4{ (float)key, 0.0f, 0.0f, 1.0f });
+					}
+				}
+			}
+
+			cache.clear();
+		}
+
+		void setupBenchmarkSuite()
+		{
+			BenchmarkSuite& benchmarkSuite = Benchmarks::addBenchmarkSuite("LRUCache");
+
+			ADD_BENCHMARK(benchmarkSuite, insert10000);
+			ADD_BENCHMARK(benchmarkSuite, getWithEviction100000);
+		}
+	}
+}
+
+#endif
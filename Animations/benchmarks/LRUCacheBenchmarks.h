@@ -0,0 +1,15 @@
+#ifdef _MATH_ANIM_BENCHMARKS
+#ifndef MATH_ANIM_LRU_CACHE_BENCHMARKS_H
+#define MATH_ANIM_LRU_CACHE_BENCHMARKS_H
+#include "core/Benchmarking.h"
+
+namespace MathAnim
+{
+	namespace LRUCacheBenchmarks
+	{
+		void setupBenchmarkSuite();
+	}
+}
+
+#endif 
+#endif // _MATH_ANIM_BENCHMARKS
@@ -0,0 +1,196 @@
+#ifdef _MATH_ANIM_BENCHMARKS
+#include "RendererBenchmarks.h"
+#include "renderer/Renderer.h"
+#include "renderer/Framebuffer.h"
+#include "renderer/Texture.h"
+#include "renderer/PixelBufferDownloader.h"
+#include "core/FrameArena.h"
+
+namespace MathAnim
+{
+	namespace RendererBenchmarks
+	{
+		// -------------------- Constants --------------------
+		constexpr int NUM_PATH_SEGMENTS = 10'000;
+
+		// -------------------- Internal Functions --------------------
+		static void benchmarkYuvReadback(BenchmarkState& state, uint32 width, uint32 height, bool packed, ByteFormat sampleFormat);
+
+		// -------------------- Benchmarks --------------------
+		DEFINE_BENCHMARK(endPath10000Segments)
+		{
+			// Renderer::init needs OpenGL, main only calls it when it managed to make a context
+			if (glfwGetCurrentContext() == nullptr)
+			{
+				state.skip("No OpenGL context");
+				return;
+			}
+
+			// A closed wave around a circle so every join needs a miter
+			std::vector<Vec2> points;
+			points.reserve(NUM_PATH_SEGMENTS);
+			for (int i = 0; i < NUM_PATH_SEGMENTS; i++)
+			{
+				float theta = (float)i / (float)NUM_PATH_SEGMENTS * glm::two_pi<float>();
+				float radius = 3.0f + 0.25f * glm::sin(theta * 200.0f);
+				points.push_back(Vec2{ radius * glm::cos(theta), radius * glm::sin(theta) });
+			}
+
+			Renderer::pushStrokeWidth(0.05f);
+			while (state.keepRunning())
+			{
+				state.pauseTiming();
+				Path2DContext* path = Renderer::beginPath(points[0]);
+				for (int i = 1; i < NUM_PATH_SEGMENTS; i++)
+				{
+					Renderer::lineTo(path, points[i]);
+				}
+				state.resumeTiming();
+
+				Renderer::endPath(path, true);
+
+				state.pauseTiming();
+				Renderer::free(path);
+				Renderer::clearDrawCalls();
+				FrameArena::reset();
+				state.resumeTiming();
+			}
+			Renderer::popStrokeWidth();
+		}
+
+		// Each sample is one frame converted to YUV and mapped on the CPU, so it includes
+		// waiting for the transfer to finish
+		DEFINE_BENCHMARK(yuvReadbackPlanar1080p)
+		{
+			benchmarkYuvReadback(state, 1920, 1080, false, ByteFormat::R8_UI);
+		}
+
+		DEFINE_BENCHMARK(yuvReadbackPacked1080p)
+		{
+			benchmarkYuvReadback(state, 1920, 1080, true, ByteFormat::R8_UI);
+		}
+
+		DEFINE_BENCHMARK(yuvReadbackPacked10Bit1080p)
+		{
+			benchmarkYuvReadback(state, 1920, 1080, true, ByteFormat::R16_UI);
+		}
+
+		DEFINE_BENCHMARK(yuvReadbackPlanar4K)
+		{
+			benchmarkYuvReadback(state, 3840, 2160, false, ByteFormat::R8_UI);
+		}
+
+		DEFINE_BENCHMARK(yuvReadbackPacked4K)
+		{
+			benchmarkYuvReadback(state, 3840, 2160, true, ByteFormat::R8_UI);
+		}
+
+		DEFINE_BENCHMARK(yuvReadbackPacked10Bit4K)
+		{
+			benchmarkYuvReadback(state, 3840, 2160, true, ByteFormat::R16_UI);
+		}
+
+		void setupBenchmarkSuite()
+		{
+			BenchmarkSuite& benchmarkSuite = Benchmarks::addBenchmarkSuite("Renderer");
+
+			ADD_BENCHMARK(benchmarkSuite, endPath10000Segments);
+			ADD_BENCHMARK(benchmarkSuite, yuvReadbackPlanar1080p);
+			ADD_BENCHMARK(benchmarkSuite, yuvReadbackPacked1080p);
+			ADD_BENCHMARK(benchmarkSuite, yuvReadbackPacked10Bit1080p);
+			ADD_BENCHMARK(benchmarkSuite, yuvReadbackPlanar4K);
+			ADD_BENCHMARK(benchmarkSuite, yuvReadbackPacked4K);
+			ADD_BENCHMARK(benchmarkSuite, yuvReadbackPacked10Bit4K);
+		}
+
+		// -------------------- Internal Functions --------------------
+		static void benchmarkYuvReadback(BenchmarkState& state, uint32 width, uint32 height, bool packed, ByteFormat sampleFormat)
+		{
+			if (glfwGetCurrentContext() == nullptr)
+			{
+				state.skip("No OpenGL context");
+				return;
+			}
+
+			Texture frameTexture = TextureBuilder()
+				.setWidth(width)
+				.setHeight(height)
+				.setFormat(ByteFormat::RGBA8_UI)
+				.setMagFilter(FilterMode::Linear)
+				.setMinFilter(FilterMode::Linear)
+				.generate();
+
+			Texture yTextureSpec = TextureBuilder()
+				.setWidth(width)
+				.setHeight(height)
+				.setFormat(ByteFormat::R8_UI)
+				.setMagFilter(FilterMode::Linear)
+				.setMinFilter(FilterMode::Linear)
+				.build();
+			Texture uvTextureSpec = yTextureSpec;
+			uvTextureSpec.width /= 2;
+			uvTextureSpec.height /= 2;
+			Texture packedTextureSpec = TextureBuilder()
+				.setWidth(width)
+				.setHeight(PixelBufferDownload::packedYuvHeight(width, height))
+				.setFormat(sampleFormat)
+				.setMagFilter(FilterMode::Nearest)
+				.setMinFilter(FilterMode::Nearest)
+				.build();
+
+			Framebuffer yFramebuffer = {};
+			Framebuffer uvFramebuffer = {};
+			Framebuffer packedFramebuffer = {};
+			if (packed)
+			{
+				packedFramebuffer = FramebufferBuilder(packedTextureSpec.width, packedTextureSpec.height)
+					.addColorAttachment(packedTextureSpec)
+					.generate();
+			}
+			else
+			{
+				yFramebuffer = FramebufferBuilder(width, height)
+					.addColorAttachment(yTextureSpec)
+					.generate();
+				uvFramebuffer = FramebufferBuilder(width / 2, height / 2)
+					.addColorAttachment(uvTextureSpec)
+					.addColorAttachment(uvTextureSpec)
+					.generate();
+			}
+
+			// A single buffer makes every frame wait on its own transfer
+			PixelBufferDownload pboDownloader = PixelBufferDownload();
+			pboDownloader.create(width, height, 1, sampleFormat);
+
+			while (state.keepRunning())
+			{
+				if (packed)
+				{
+					Renderer::renderTextureToPackedYuvFramebuffer(frameTexture, packedFramebuffer, width, height);
+					pboDownloader.queueDownloadFrom(packedFramebuffer);
+				}
+				else
+				{
+					Renderer::renderTextureToYuvFramebuffer(frameTexture, yFramebuffer, uvFramebuffer);
+					pboDownloader.queueDownloadFrom(yFramebuffer, uvFramebuffer);
+				}
+
+				pboDownloader.getPixels();
+			}
+
+			pboDownloader.free();
+			if (packed)
+			{
+				packedFramebuffer.destroy();
+			}
+			else
+			{
+				yFramebuffer.destroy();
+				uvFramebuffer.destroy();
+			}
+			frameTexture.destroy();
+		}
+	}
+}
+
+#endif
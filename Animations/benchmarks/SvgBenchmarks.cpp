@@ -0,0 +1,203 @@
+#ifdef _MATH_ANIM_BENCHMARKS
+#include "SvgBenchmarks.h"
+#include "BenchmarkScenes.h"
+#include "svg/Svg.h"
+#include "svg/SvgParser.h"
+#include "core/FrameArena.h"
+
+namespace MathAnim
+{
+	namespace SvgBenchmarks
+	{
+		// -------------------- Constants --------------------
+		constexpr int NUM_PATH_COMMANDS = 2'000;
+		constexpr int NUM_TEXT_CHARACTERS = 5'000;
+		constexpr int NUM_TEXT_GLYPHS = 26;
+		constexpr int NUM_MORPH_GLYPHS = 200;
+		constexpr int NUM_MORPH_FRAMES = 60;
+
+		// -------------------- Private functions --------------------
+		static SvgObject* createGlyph(float size)
+		{
+			SvgObject* glyph = (SvgObject*)g_memory_allocate(sizeof(SvgObject));
+			*glyph = Svg::createDefault();
+
+			// Roughly the shape of an 'o', an outer contour with a hole
+			Svg::beginPath(glyph, Vec2{ 0.0f, 0.0f });
+			Svg::bezier3To(glyph, Vec2{ size, 0.0f }, Vec2{ size, size }, Vec2{ 0.0f, size });
+			Svg::bezier3To(glyph, Vec2{ -size, size }, Vec2{ -size, 0.0f }, Vec2{ 0.0f, 0.0f });
+			Svg::closePath(glyph);
+			Svg::beginPath(glyph, Vec2{ 0.0f, size * 0.25f });
+			Svg::lineTo(glyph, Vec2{ size * 0.25f, size * 0.5f });
+			Svg::lineTo(glyph, Vec2{ 0.0f, size * 0.75f });
+			Svg::lineTo(glyph, Vec2{ -size * 0.25f, size * 0.5f });
+			Svg::closePath(glyph, true, true);
+
+			return glyph;
+		}
+
+		// Single contour made of lines, so morphing to it from createGlyph has to split curves
+		static SvgObject* createBoxGlyph(float size)
+		{
+			SvgObject* glyph = (SvgObject*)g_memory_allocate(sizeof(SvgObject));
+			*glyph = Svg::createDefault();
+
+			Svg::beginPath(glyph, Vec2{ 0.0f, 0.0f });
+			Svg::lineTo(glyph, Vec2{ size, 0.0f });
+			Svg::lineTo(glyph, Vec2{ size, size });
+			Svg::lineTo(glyph, Vec2{ 0.0f, size });
+			Svg::lineTo(glyph, Vec2{ -size, size });
+			Svg::lineTo(glyph, Vec2{ -size, 0.0f });
+			Svg::closePath(glyph);
+
+			return glyph;
+		}
+
+		static void freeSvg(SvgObject* svg)
+		{
+			svg->free();
+			g_memory_free(svg);
+		}
+
+		// -------------------- Benchmarks --------------------
+		DEFINE_BENCHMARK(parseSvgPath2000Commands)
+		{
+			std::string path = BenchmarkScenes::createSvgPath(BenchmarkScenes::DEFAULT_SEED, NUM_PATH_COMMANDS);
+
+			while (state.keepRunning())
+			{
+				// parseSvgPath overwrites the output, so there's nothing to allocate up front
+				SvgObject svg = {};
+				bool parsed = SvgParser::parseSvgPath(path.c_str(), path.length(), &svg);
+
+				state.pauseTiming();
+				if (parsed)
+				{
+					svg.free();
+				}
+				state.resumeTiming();
+			}
+		}
+
+		DEFINE_BENCHMARK(interpolate2000Commands)
+		{
+			std::string srcPath = BenchmarkScenes::createSvgPath(BenchmarkScenes::DEFAULT_SEED, NUM_PATH_COMMANDS);
+			// Different seed and size so interpolate has to split curves to match them up
+			std::string dstPath = BenchmarkScenes::createSvgPath(BenchmarkScenes::DEFAULT_SEED + 1, NUM_PATH_COMMANDS / 2);
+
+			SvgObject src = {};
+			SvgObject dst = {};
+			bool parsedSrc = SvgParser::parseSvgPath(srcPath.c_str(), srcPath.length(), &src);
+			bool parsedDst = SvgParser::parseSvgPath(dstPath.c_str(), dstPath.length(), &dst);
+			if (!parsedSrc || !parsedDst)
+			{
+				state.skip("Failed to parse the generated paths");
+			}
+
+			float t = 0.0f;
+			while (state.keepRunning())
+			{
+				t = t >= 1.0f ? 0.0f : t + 0.05f;
+				Svg::interpolate(&src, &dst, t);
+
+				// The result is a frame temporary
+				state.pauseTiming();
+				FrameArena::reset();
+				state.resumeTiming();
+			}
+
+			if (parsedSrc)
+			{
+				src.free();
+			}
+			if (parsedDst)
+			{
+				dst.free();
+			}
+		}
+
+		// Every character gets a start and a current SvgObject like TextObject::init,
+		// both of which should just reference the shared glyph geometry
+		DEFINE_BENCHMARK(copy5000CharactersFromSharedGlyphs)
+		{
+			std::vector<SvgObject*> glyphs;
+			for (int i = 0; i < NUM_TEXT_GLYPHS; i++)
+			{
+				glyphs.push_back(createGlyph(1.0f + (float)i));
+				glyphs.back()->makeShared();
+			}
+
+			std::vector<SvgObject> characters(NUM_TEXT_CHARACTERS * 2);
+			while (state.keepRunning())
+			{
+				for (int i = 0; i < NUM_TEXT_CHARACTERS; i++)
+				{
+					const SvgObject* glyph = glyphs[i % NUM_TEXT_GLYPHS];
+					SvgObject& start = characters[i * 2];
+					SvgObject& current = characters[i * 2 + 1];
+					start = Svg::createDefault();
+					current = Svg::createDefault();
+					Svg::copy(&start, glyph);
+					Svg::copy(&current, &start);
+				}
+
+				state.pauseTiming();
+				for (SvgObject& character : characters)
+				{
+					character.free();
+				}
+				state.resumeTiming();
+			}
+
+			for (SvgObject* glyph : glyphs)
+			{
+				freeSvg(glyph);
+			}
+		}
+
+		// One sample is one frame of a 200 glyph morph, driven the way replacementTransform
+		// does it with one interpolate per glyph and the arena reset afterwards
+		DEFINE_BENCHMARK(morph200Glyphs)
+		{
+			std::vector<SvgObject*> srcGlyphs;
+			std::vector<SvgObject*> dstGlyphs;
+			for (int i = 0; i < NUM_MORPH_GLYPHS; i++)
+			{
+				srcGlyphs.push_back(createGlyph(1.0f + (float)(i % NUM_TEXT_GLYPHS)));
+				dstGlyphs.push_back(createBoxGlyph(1.0f + (float)(i % NUM_TEXT_GLYPHS)));
+			}
+
+			FrameArena::reset();
+			int frame = 0;
+			while (state.keepRunning())
+			{
+				float t = (float)frame / (float)(NUM_MORPH_FRAMES - 1);
+				frame = (frame + 1) % NUM_MORPH_FRAMES;
+				for (int i = 0; i < NUM_MORPH_GLYPHS; i++)
+				{
+					SvgObject* res = Svg::interpolate(srcGlyphs[i], dstGlyphs[i], t);
+					freeSvg(res);
+				}
+				FrameArena::reset();
+			}
+
+			for (int i = 0; i < NUM_MORPH_GLYPHS; i++)
+			{
+				freeSvg(srcGlyphs[i]);
+				freeSvg(dstGlyphs[i]);
+			}
+		}
+
+		void setupBenchmarkSuite()
+		{
+			BenchmarkSuite& benchmarkSuite = Benchmarks::addBenchmarkSuite("Svg");
+
+			ADD_BENCHMARK(benchmarkSuite, parseSvgPath2000Commands);
+			ADD_BENCHMARK(benchmarkSuite, interpolate2000Commands);
+			ADD_BENCHMARK(benchmarkSuite, copy5000CharactersFromSharedGlyphs);
+			ADD_BENCHMARK(benchmarkSuite, morph200Glyphs);
+		}
+	}
+}
+
+#endif
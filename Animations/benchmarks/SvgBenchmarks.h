@@ -0,0 +1,15 @@
+#ifdef _MATH_ANIM_BENCHMARKS
+#ifndef MATH_ANIM_SVG_BENCHMARKS_H
+#define MATH_ANIM_SVG_BENCHMARKS_H
+#include "core/Benchmarking.h"
+
+namespace MathAnim
+{
+	namespace SvgBenchmarks
+	{
+		void setupBenchmarkSuite();
+	}
+}
+
+#endif 
+#endif // _MATH_ANIM_BENCHMARKS
@@ -0,0 +1,81 @@
+#ifdef _MATH_ANIM_BENCHMARKS
+#include "SyntaxHighlighterBenchmarks.h"
+#include "BenchmarkScenes.h"
+#include "parsers/SyntaxHighlighter.h"
+#include "parsers/SyntaxTheme.h"
+#include "platform/Platform.h"
+
+namespace MathAnim
+{
+	namespace SyntaxHighlighterBenchmarks
+	{
+		// -------------------- Constants --------------------
+		constexpr int NUM_FILE_LINES = 2'000;
+		constexpr const char* CPP_GRAMMAR = "assets/grammars/cpp.tmLanguage.json";
+
+		// -------------------- Internal Functions --------------------
+		static SyntaxTheme createBenchmarkTheme()
+		{
+			SyntaxTheme theme = {};
+			theme.defaultForeground = Vec4{ 1.0f, 1.0f, 1.0f, 1.0f };
+			theme.defaultRule.settings.push_back({ ThemeSettingType::ForegroundColor, theme.defaultForeground });
+			return theme;
+		}
+
+		// -------------------- Benchmarks --------------------
+		DEFINE_BENCHMARK(parse2000Lines)
+		{
+			if (!Platform::fileExists(CPP_GRAMMAR))
+			{
+				state.skip("assets/grammars/cpp.tmLanguage.json not found, build MathAnimations once to copy the grammars");
+				return;
+			}
+
+			SyntaxHighlighter highlighter(CPP_GRAMMAR);
+			SyntaxTheme theme = createBenchmarkTheme();
+			std::string code = BenchmarkScenes::createCppFile(NUM_FILE_LINES);
+
+			while (state.keepRunning())
+			{
+				CodeHighlights highlights = highlighter.parse(code, theme);
+			}
+
+			highlighter.free();
+		}
+
+		DEFINE_BENCHMARK(reparse2000LinesAfterEdit)
+		{
+			if (!Platform::fileExists(CPP_GRAMMAR))
+			{
+				state.skip("assets/grammars/cpp.tmLanguage.json not found, build MathAnimations once to copy the grammars");
+				return;
+			}
+
+			SyntaxHighlighter highlighter(CPP_GRAMMAR);
+			SyntaxTheme theme = createBenchmarkTheme();
+			std::string code = BenchmarkScenes::createCppFile(NUM_FILE_LINES);
+			CodeHighlights highlights = highlighter.parse(code, theme);
+
+			// Typing a character in the middle of the file
+			size_t middle = code.find('\n', code.length() / 2) + 1;
+			std::string edited = code.substr(0, middle) + "x" + code.substr(middle);
+
+			while (state.keepRunning())
+			{
+				CodeHighlights incremental = highlighter.reparse(highlights, edited, theme);
+			}
+
+			highlighter.free();
+		}
+
+		void setupBenchmarkSuite()
+		{
+			BenchmarkSuite& benchmarkSuite = Benchmarks::addBenchmarkSuite("SyntaxHighlighter");
+
+			ADD_BENCHMARK(benchmarkSuite, parse2000Lines);
+			ADD_BENCHMARK(benchmarkSuite, reparse2000LinesAfterEdit);
+		}
+	}
+}
+
+#endif
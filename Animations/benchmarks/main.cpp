@@ -0,0 +1,67 @@
+#ifdef _MATH_ANIM_BENCHMARKS
+#include "core.h"
+#include "core/Benchmarking.h"
+#include "core/Window.h"
+#include "core/FrameArena.h"
+#include "renderer/GladLayer.h"
+#include "renderer/Renderer.h"
+#include "AnimationBenchmarks.h"
+#include "SvgBenchmarks.h"
+#include "RendererBenchmarks.h"
+#include "SyntaxHighlighterBenchmarks.h"
+#include "LRUCacheBenchmarks.h"
+#include "JobSystemBenchmarks.h"
+
+int main(int argc, char** argv)
+{
+	using namespace MathAnim;
+
+	g_logger_init();
+	g_memory_init_padding(true, 5);
+
+	BenchmarkOptions options = Benchmarks::defaultOptions();
+	if (!Benchmarks::parseCommandLine(argc, argv, &options))
+	{
+		return 2;
+	}
+
+	// The renderer benchmarks need a context, everything else runs without one
+	Window* window = nullptr;
+	GlVersion glVersion = GladLayer::init();
+	if (glVersion.major > 0)
+	{
+		window = new Window(640, 480, "Math Animations Benchmarks", WindowFlags::Hidden);
+		if (window->windowPtr)
+		{
+			Renderer::init();
+		}
+	}
+
+	OnigEncoding use_encs[1];
+	use_encs[0] = ONIG_ENCODING_ASCII;
+	onig_initialize(use_encs, sizeof(use_encs) / sizeof(use_encs[0]));
+
+	AnimationBenchmarks::setupBenchmarkSuite();
+	SvgBenchmarks::setupBenchmarkSuite();
+	RendererBenchmarks::setupBenchmarkSuite();
+	SyntaxHighlighterBenchmarks::setupBenchmarkSuite();
+	LRUCacheBenchmarks::setupBenchmarkSuite();
+	JobSystemBenchmarks::setupBenchmarkSuite();
+
+	int numRegressions = Benchmarks::runBenchmarks(options);
+	Benchmarks::free();
+
+	onig_end();
+	if (window && window->windowPtr)
+	{
+		Renderer::free();
+	}
+	FrameArena::free();
+	delete window;
+	GladLayer::deinit();
+
+	g_memory_dumpMemoryLeaks();
+	return numRegressions > 0 ? 1 : 0;
+}
+
+#endif
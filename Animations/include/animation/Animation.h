@@ -372,6 +372,10 @@ namespace MathAnim
 	{
 		char* scriptFilepath;
 		size_t scriptFilepathLength;
+		// Seconds the generator may run before it's stopped, 0 for no limit
+		float timeBudget;
+
+		static constexpr float defaultTimeBudget = 10.0f;
 
 		void serialize(nlohmann::json& j) const;
 		void free();
@@ -520,7 +524,9 @@ namespace MathAnim
 		inline AnimObjId end() const { return NULL_ANIM_OBJECT; }
 
 		void free();
-		void serialize(nlohmann::json& j) const;
+		// Binary scene files pass writeSvgPath = false and store the curves themselves,
+		// see SvgObject::serializeCurves
+		void serialize(nlohmann::json& j, bool writeSvgPath = true) const;
 		static AnimObject deserialize(const nlohmann::json& j, uint32 version);
 		static AnimObject createDefaultFromParent(AnimationManagerData* am, AnimObjectTypeV1 type, AnimObjId parentId, bool addChildAsGenerated = false);
 		static AnimObject createDefaultFromObj(AnimationManagerData* am, AnimObjectTypeV1 type, const AnimObject& obj);
@@ -13,6 +13,15 @@ namespace MathAnim
 	struct Camera;
 
 	struct AnimationManagerData;
+	struct SvgObject;
+
+	// SVG curves held back by AnimationManager::serializeSnapshot. The geometry is
+	// shared with the live object instead of copied.
+	struct SvgCurvesSnapshot
+	{
+		size_t objectIndex;
+		SvgObject* svg;
+	};
 
 	namespace AnimationManager
 	{
@@ -44,6 +53,10 @@ namespace MathAnim
 
 		void render(AnimationManagerData* am, int deltaFrame);
 
+		// Regenerates the children of every LaTeX object that was waiting on this equation. If
+		// the equation replaced a stale svg, the objects that were already showing it get regenerated too.
+		void onLaTexReady(AnimationManagerData* am, const std::string& md5, bool succeeded, bool replacedStaleSvg);
+
 		int lastAnimatedFrame(const AnimationManagerData* am);
 		bool isPastLastFrame(const AnimationManagerData* am);
 
@@ -70,6 +83,17 @@ namespace MathAnim
 		AnimObjId getNextSibling(const AnimationManagerData* am, AnimObjId obj);
 
 		void serialize(const AnimationManagerData* am, nlohmann::json& j);
+		// Same as serialize except SVG objects store their raw curves instead of a path string.
+		// The result has to be written with a binary encoding like CBOR.
+		void serializeBinary(const AnimationManagerData* am, nlohmann::json& j);
+		// Same as serializeBinary except the curves are only referenced, which keeps the
+		// main thread cost of a save independent of how much geometry the scene has.
+		// Pass the result to writeSnapshotCurves on any thread to finish the JSON.
+		void serializeSnapshot(AnimationManagerData* am, nlohmann::json& j, std::vector<SvgCurvesSnapshot>& outCurves);
+		void writeSnapshotCurves(nlohmann::json& j, const std::vector<SvgCurvesSnapshot>& curves);
+		// Drops the references to the live geometry. Always call this, even when the
+		// snapshot never got written.
+		void freeSnapshotCurves(std::vector<SvgCurvesSnapshot>& curves);
 		void deserialize(AnimationManagerData* am, const nlohmann::json& j, int currentFrame, uint32 versionMajor, uint32 versionMinor);
 		void sortAnimations(AnimationManagerData* am);
 
@@ -20,6 +20,8 @@ namespace MathAnim
 		void reInit(AnimationManagerData* am, AnimObject* obj);
 		bool setFilepath(const std::string& newFilepath);
 		bool setFilepath(const char* newFilepath);
+		// Takes ownership of parsedGroup instead of parsing the file again
+		void setFilepath(const std::string& newFilepath, SvgGroup* parsedGroup);
 		void free();
 
 		void serialize(nlohmann::json& j) const;
@@ -39,12 +39,8 @@ namespace MathAnim
 		bool isEquation;
 		bool isParsingLaTex;
 
-		// NOTE: This update function is just used to check if it's
-		// in the middle of parsing latex. If it is, then it checks
-		// if it's ready and then assigns it to the SVG group when it's done
-		// generating the svg
-		void update(AnimationManagerData* am, AnimObjId parentId);
-
+		// NOTE: isParsingLaTex is cleared by AnimationManager::onLaTexReady
+		// once LaTexLayer reports the svg was generated
 		void init(AnimationManagerData* am, AnimObjId parentId);
 		void reInit(AnimationManagerData* am, AnimObject* obj);
 
@@ -68,6 +64,8 @@ namespace MathAnim
 		int32 textLength;
 		HighlighterLanguage language;
 		HighlighterTheme theme;
+		// Highlights from the last init, reused to only re-highlight what changed
+		CodeHighlights* cachedHighlights;
 
 		void init(AnimationManagerData* am, AnimObjId parentId);
 		void reInit(AnimationManagerData* am, AnimObject* obj);
@@ -0,0 +1,45 @@
+#ifndef MATH_ANIM_WAVEFORM_H
+#define MATH_ANIM_WAVEFORM_H
+#include "core.h"
+
+namespace MathAnim
+{
+	struct WavData;
+
+	struct WaveformLevel
+	{
+		int16* minSamples;
+		int16* maxSamples;
+		uint32 numBuckets;
+		uint32 framesPerBucket;
+	};
+
+	// Min/max summary of a WAV file at several resolutions so the timeline can draw
+	// any zoom level without touching the raw PCM data. Level 0 holds one min/max pair
+	// per baseFramesPerBucket sample frames (all channels combined) and every level
+	// after that combines 4 buckets of the level below it.
+	struct Waveform
+	{
+		static constexpr uint32 baseFramesPerBucket = 32;
+		static constexpr uint32 levelReductionFactor = 4;
+
+		WaveformLevel* levels;
+		int numLevels;
+		uint32 numSampleFrames;
+		uint32 sampleRate;
+
+		// Writes the normalized [-1, 1] min and max of the sample frames in
+		// [firstFrame, firstFrame + numFrames). Reads from the coarsest level whose
+		// buckets still fit inside the range, so the cost doesn't depend on numFrames.
+		void getMinMax(uint32 firstFrame, uint32 numFrames, float* outMin, float* outMax) const;
+
+		bool isEmpty() const { return numLevels == 0; }
+
+		void free();
+
+		// Safe to call from any thread. The wav data has to stay alive until this returns.
+		static Waveform build(const WavData& wav);
+	};
+}
+
+#endif
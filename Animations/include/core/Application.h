@@ -35,6 +35,9 @@ namespace MathAnim
 
 		void saveProject();
 		void saveCurrentScene();
+		// Scenes are saved in the binary format, this writes a JSON copy next to it.
+		// A JSON file newer than the binary scene gets imported the next time the scene loads.
+		void exportCurrentSceneToJson();
 		void loadProject(const std::filesystem::path& projectRoot);
 		void loadScene(const std::string& sceneName);
 		void deleteScene(const std::string& sceneName);
@@ -0,0 +1,36 @@
+#ifndef MATH_ANIM_BACKGROUND_SAVER_H
+#define MATH_ANIM_BACKGROUND_SAVER_H
+#include "core.h"
+
+#include <functional>
+
+namespace MathAnim
+{
+	// Writes files on a dedicated thread so saving never stalls the editor.
+	//
+	// Callers take a snapshot of whatever they want to save on the main thread and
+	// hand it to queueSave inside the write function. The write function runs on the
+	// save thread, writes to a temporary file and the temporary file gets renamed
+	// over the real one afterwards, so a crash mid-save never corrupts the old file.
+	namespace BackgroundSaver
+	{
+		typedef std::function<bool(const std::filesystem::path& tmpFilepath)> WriteFn;
+
+		void init();
+
+		// If a save for filepath is still waiting to start, it gets replaced by
+		// this one since only the newest snapshot matters
+		void queueSave(const std::filesystem::path& filepath, WriteFn&& writeFn);
+
+		// Blocks until every queued save has been written. Call this before reading
+		// back a file that could still be getting saved.
+		void waitForPendingSaves();
+
+		bool isSaving();
+
+		// Finishes all queued saves before returning
+		void free();
+	}
+}
+
+#endif
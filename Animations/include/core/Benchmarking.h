@@ -0,0 +1,90 @@
+#ifdef _MATH_ANIM_BENCHMARKS
+#ifndef MATH_ANIM_BENCHMARKING_H
+#define MATH_ANIM_BENCHMARKING_H
+#include "core.h"
+
+#include <chrono>
+
+#define ADD_BENCHMARK(benchmarkSuite, benchmarkName) Benchmarks::addBenchmark(benchmarkSuite, #benchmarkName, benchmarkName)
+
+#define DEFINE_BENCHMARK(fnName) void fnName(BenchmarkState& state)
+
+namespace MathAnim
+{
+	struct BenchmarkSuite;
+
+	// Drives the timing loop of a single benchmark. Everything before the first
+	// keepRunning() call is setup and isn't timed, then each loop iteration becomes
+	// one sample:
+	//
+	//   DEFINE_BENCHMARK(myBenchmark)
+	//   {
+	//       // Setup...
+	//       while (state.keepRunning())
+	//       {
+	//           // Code being measured...
+	//       }
+	//   }
+	struct BenchmarkState
+	{
+		uint32 numWarmupIterations;
+		uint32 numSamples;
+		std::vector<double> sampleMs;
+		const char* skipReason;
+
+		bool keepRunning();
+
+		// Anything between these two calls gets left out of the current sample. Use this
+		// for per-iteration cleanup like freeing outputs or resetting the FrameArena.
+		void pauseTiming();
+		void resumeTiming();
+
+		// Call before the first keepRunning() when the benchmark can't run, for example
+		// when there's no OpenGL context or an asset is missing
+		void skip(const char* reason);
+
+	private:
+		uint32 iteration = 0;
+		double pausedMs = 0.0;
+		std::chrono::high_resolution_clock::time_point sampleStart;
+		std::chrono::high_resolution_clock::time_point pauseStart;
+	};
+
+	typedef void (*BenchmarkFn)(BenchmarkState& state);
+
+	struct BenchmarkOptions
+	{
+		// Where the results get written as JSON, nothing is written if this is empty
+		std::string outputFilepath;
+		// Results from a previous run to compare against, no comparison if this is empty
+		std::string baselineFilepath;
+		// Overwrite the baseline with this run's results instead of comparing against it
+		bool updateBaseline;
+		// A benchmark regresses when its median is this many percent slower than the baseline median
+		float regressionThresholdPercent;
+		// Only run benchmarks whose "Suite/name" contains this string
+		std::string filter;
+		uint32 numWarmupIterations;
+		uint32 numSamples;
+	};
+
+	namespace Benchmarks
+	{
+		BenchmarkSuite& addBenchmarkSuite(const char* benchmarkSuiteName);
+
+		void addBenchmark(BenchmarkSuite& benchmarkSuite, const char* benchmarkName, BenchmarkFn fn);
+
+		BenchmarkOptions defaultOptions();
+		// Fills options from --out, --baseline, --update-baseline, --threshold, --filter,
+		// --warmup and --samples. Returns false on --help or if the arguments didn't make sense.
+		bool parseCommandLine(int argc, char** argv, BenchmarkOptions* options);
+
+		// Returns the number of benchmarks that regressed against the baseline
+		int runBenchmarks(const BenchmarkOptions& options);
+
+		void free();
+	}
+}
+
+#endif // MATH_ANIM_BENCHMARKING_H
+#endif // _MATH_ANIM_BENCHMARKS
@@ -0,0 +1,55 @@
+#ifndef MATH_ANIM_FRAME_ARENA_H
+#define MATH_ANIM_FRAME_ARENA_H
+#include "core.h"
+
+#include <cstddef>
+
+namespace MathAnim
+{
+	// Linear allocator for memory that never outlives the current frame. Allocations
+	// are a pointer bump and there is no per-allocation free, everything is released
+	// at once by reset() which AnimationManager::endFrame calls every frame.
+	//
+	// Main thread only. Never hold on to frame memory across endFrame.
+	namespace FrameArena
+	{
+		void* allocate(size_t numBytes, size_t alignment = alignof(std::max_align_t));
+
+		// Grows in place when ptr was the last allocation, otherwise the data gets copied
+		// into a new allocation and the old one is just dead space until reset()
+		void* reallocate(void* ptr, size_t oldNumBytes, size_t newNumBytes, size_t alignment = alignof(std::max_align_t));
+
+		// Safe to call from any thread, it's always false off the main thread
+		bool owns(const void* ptr);
+
+		// Releases every allocation made this frame. If the frame needed more than one
+		// block they get merged into a single block big enough for the whole frame.
+		void reset();
+
+		size_t getBytesUsed();
+		size_t getHighWaterMark();
+
+		void free();
+	}
+
+	// Lets STL containers that only live for a frame allocate out of the FrameArena
+	template<typename T>
+	struct FrameArenaAllocator
+	{
+		typedef T value_type;
+
+		FrameArenaAllocator() = default;
+		template<typename U>
+		FrameArenaAllocator(const FrameArenaAllocator<U>&) {}
+
+		T* allocate(size_t n) { return (T*)FrameArena::allocate(sizeof(T) * n, alignof(T)); }
+		void deallocate(T*, size_t) {}
+
+		template<typename U>
+		bool operator==(const FrameArenaAllocator<U>&) const { return true; }
+		template<typename U>
+		bool operator!=(const FrameArenaAllocator<U>&) const { return false; }
+	};
+}
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef MATH_ANIM_MEMORY_TRACKER_H
+#define MATH_ANIM_MEMORY_TRACKER_H
+#include "core.h"
+
+namespace MathAnim
+{
+	enum class MemoryTag : uint8
+	{
+		// GPU
+		Textures,
+		Framebuffers,
+		SvgCacheAtlas,
+		GlyphAtlas,
+		GpuBuffers,
+		// CPU
+		SvgCurves,
+		EncoderFrameCache,
+		Profiler,
+		Length
+	};
+
+	constexpr auto _memoryTagNames = fixedSizeArray<const char*, (size_t)MemoryTag::Length>(
+		"Textures",
+		"Framebuffers",
+		"SVG Cache Atlas",
+		"Glyph Atlases",
+		"GPU Buffers",
+		"SVG Curves",
+		"Encoder Frame Cache",
+		"Profiler"
+	);
+
+	constexpr auto _memoryTagIsGpu = fixedSizeArray<bool, (size_t)MemoryTag::Length>(
+		true,
+		true,
+		true,
+		true,
+		true,
+		false,
+		false,
+		false
+	);
+
+	struct MemoryTagStats
+	{
+		size_t currentBytes;
+		size_t peakBytes;
+		// Allocations that haven't been freed yet
+		size_t numLiveAllocations;
+		size_t numTotalAllocations;
+		// 0 means there's no budget
+		size_t budgetBytes;
+	};
+
+	// Running totals of how much memory each subsystem holds on to.
+	//
+	// The counters are updated by whoever owns the memory, CPU subsystems report their own
+	// allocations and GL::bufferData/texImage2D report GPU memory. GPU numbers are estimates
+	// from the size and format of each allocation since drivers don't report real usage.
+	// Every counter is a relaxed atomic so this is safe to call from any thread.
+	namespace MemoryTracker
+	{
+		void recordAllocation(MemoryTag tag, size_t numBytes);
+		void recordFree(MemoryTag tag, size_t numBytes);
+		void recordReallocation(MemoryTag tag, size_t oldNumBytes, size_t newNumBytes);
+
+		// Logs a warning the first time the tag goes over budget, and again only after it
+		// dropped back under
+		void setBudget(MemoryTag tag, size_t budgetBytes);
+
+		MemoryTagStats getStats(MemoryTag tag);
+		void resetPeaks();
+
+		// Tag for GPU resources created on this thread right now, or fallback if there's no
+		// ScopedTag active
+		MemoryTag getCurrentTag(MemoryTag fallback);
+
+		// Attributes GPU resources created inside the scope to a subsystem. The outermost
+		// tag wins, so the SVG cache's tag sticks to the framebuffer it creates even though
+		// the framebuffer code tags its own textures too.
+		struct ScopedTag
+		{
+			ScopedTag(MemoryTag tag);
+			~ScopedTag();
+
+		private:
+			bool isOutermost;
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef MATH_ANIM_PROFILER_H
+#define MATH_ANIM_PROFILER_H
+#include "core.h"
+
+namespace MathAnim
+{
+	struct ProfilerEvent
+	{
+		const char* name;
+		uint64 startNs;
+		uint64 endNs;
+		uint32 depth;
+	};
+
+	struct ProfilerFrame
+	{
+		uint64 startNs;
+		uint64 endNs;
+	};
+
+	struct ProfilerTrack
+	{
+		std::string name;
+		uint32 id;
+		std::vector<ProfilerEvent> events;
+	};
+
+	// Built-in profiler behind the MP_PROFILE_* macros for every build that doesn't use Optick.
+	//
+	// Each thread writes finished events into its own fixed size ring buffer, so recording an
+	// event is two clock reads and a store without any locks. Once a buffer wraps around the
+	// oldest events get overwritten. GPU passes are timed with timestamp queries and show up
+	// on their own "GPU" track a few frames after they ran.
+	namespace Profiler
+	{
+		// Starts recording. Needs the GL context to be current since it also creates the GPU
+		// timer queries, and the thread it's called on becomes the main thread track.
+		void init();
+		// Stops recording and releases every buffer. Call after all other threads were joined.
+		void free();
+
+		uint64 nowNs();
+
+		void beginFrame();
+		void endFrame();
+
+		void setThreadName(const char* name);
+		// Names passed to the profiler are stored as pointers. Anything that isn't a string
+		// literal goes through here first to get a copy that lives until Profiler::free.
+		const char* internName(const char* name);
+
+		uint32 pushDepth();
+		void popDepth();
+		void recordEvent(const char* name, uint64 startNs, uint64 endNs, uint32 depth);
+
+		// Main thread only. These nest, and name has to be a string literal.
+		void beginGpuEvent(const char* name);
+		void endGpuEvent();
+
+		// Nothing gets recorded while paused, which keeps a capture stable while inspecting it
+		void setPaused(bool paused);
+		bool isPaused();
+
+		// Copies of whatever is still in the ring buffers, oldest first. Only events that
+		// overlap [startNs, endNs] are returned.
+		std::vector<ProfilerFrame> getFrames();
+		std::vector<ProfilerTrack> getTracks(uint64 startNs = 0, uint64 endNs = UINT64_MAX);
+
+		// Writes every event still in the ring buffers that ended after startNs in Chrome's
+		// trace event format. Open it with chrome://tracing or https://ui.perfetto.dev.
+		bool exportChromeTrace(const std::filesystem::path& filepath, uint64 startNs = 0);
+
+		struct ScopedEvent
+		{
+			ScopedEvent(const char* inName)
+				: name(inName), depth(pushDepth()), startNs(nowNs()) {}
+
+			~ScopedEvent()
+			{
+				uint64 endNs = nowNs();
+				popDepth();
+				recordEvent(name, startNs, endNs, depth);
+			}
+
+			const char* name;
+			uint32 depth;
+			uint64 startNs;
+		};
+
+		struct ScopedFrame
+		{
+			ScopedFrame() { beginFrame(); }
+			~ScopedFrame() { endFrame(); }
+		};
+	}
+}
+
+#endif
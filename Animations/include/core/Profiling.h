@@ -1,7 +1,7 @@
 #ifndef MATH_ANIMATIONS_PROFILING_H
 #define MATH_ANIMATIONS_PROFILING_H
 
-#ifdef _PROFILER 
+#ifdef _PROFILER
 	#include <optick.h>
 
 	#define MP_PROFILE_FRAME(name) OPTICK_FRAME(name)
@@ -9,10 +9,15 @@
 	#define MP_PROFILE_THREAD(name) OPTICK_THREAD(name)
 	#define MP_PROFILE_DYNAMIC_EVENT(name) OPTICK_EVENT_DYNAMIC(name)
 #else
-	#define MP_PROFILE_FRAME(name)
-	#define MP_PROFILE_EVENT(name)
-	#define MP_PROFILE_THREAD(name)
-	#define MP_PROFILE_DYNAMIC_EVENT(name)
+	#include "core/Profiler.h"
+
+	#define MP_PROFILE_CONCAT_INNER(a, b) a##b
+	#define MP_PROFILE_CONCAT(a, b) MP_PROFILE_CONCAT_INNER(a, b)
+
+	#define MP_PROFILE_FRAME(name) ::MathAnim::Profiler::ScopedFrame MP_PROFILE_CONCAT(mpProfileFrame_, __LINE__)
+	#define MP_PROFILE_EVENT(name) ::MathAnim::Profiler::ScopedEvent MP_PROFILE_CONCAT(mpProfileEvent_, __LINE__)(name)
+	#define MP_PROFILE_THREAD(name) ::MathAnim::Profiler::setThreadName(name)
+	#define MP_PROFILE_DYNAMIC_EVENT(name) ::MathAnim::Profiler::ScopedEvent MP_PROFILE_CONCAT(mpProfileEvent_, __LINE__)(::MathAnim::Profiler::internName(name))
 #endif
 
-#endif
\ No newline at end of file
+#endif
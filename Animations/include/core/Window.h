@@ -15,6 +15,7 @@ namespace MathAnim
 	{
 		None,
 		OpenMaximized = 0x1,
+		Hidden = 0x2,
 	};
     
 	struct Window
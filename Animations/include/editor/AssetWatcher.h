@@ -0,0 +1,34 @@
+#ifndef MATH_ANIM_ASSET_WATCHER_H
+#define MATH_ANIM_ASSET_WATCHER_H
+#include "core.h"
+
+namespace MathAnim
+{
+	struct AnimationManagerData;
+
+	// Watches the whole project directory and reloads only what depends on an asset
+	// when it changes on disk:
+	//
+	//   scripts -> recompiled by LuauLayer
+	//   .svg    -> SvgFileObjects that were built from the file
+	//   images  -> the TextureCache entry, every ImageObject shares the handle
+	//   fonts   -> the cached Font and the TextObjects that use it
+	//
+	// Parsing and decoding happen on the thread pool, objects are re-initialized on
+	// the main thread once the new data is ready.
+	namespace AssetWatcher
+	{
+		void init(const std::filesystem::path& projectRoot);
+
+		void update(AnimationManagerData* am);
+
+		// Records that obj was generated from file. Objects are only checked when the
+		// file changes, so there's no need to remove a dependency when an object is
+		// deleted or pointed at a different file.
+		void addDependency(const std::filesystem::path& file, AnimObjId obj);
+
+		void free();
+	}
+}
+
+#endif
@@ -41,6 +41,26 @@ namespace MathAnim
 		300.0f
 	);
 
+	enum class OutlineResolution : uint8
+	{
+		Full,
+		Half,
+		Quarter,
+		Length
+	};
+
+	constexpr auto _outlineResolutionEnumNames = fixedSizeArray<const char*, (size_t)OutlineResolution::Length>(
+		"Full",
+		"Half",
+		"Quarter"
+	);
+
+	constexpr auto _outlineResolutionValues = fixedSizeArray<float, (size_t)OutlineResolution::Length>(
+		1.0f,
+		0.5f,
+		0.25f
+	);
+
 	struct EditorSettingsData
 	{
 		float cameraRotateSensitivity;
@@ -50,6 +70,7 @@ namespace MathAnim
 		float svgTargetScale;
 		Vec4 activeObjectHighlightColor;
 		float activeObjectOutlineWidth;
+		OutlineResolution activeObjectOutlineResolution;
 	};
 
 	namespace EditorSettings
@@ -1,7 +1,7 @@
 #ifndef MATH_ANIM_PROJECT_SCREEN_H
 #define MATH_ANIM_PROJECT_SCREEN_H
 #include "core.h"
-#include "renderer/Texture.h"
+#include "renderer/TextureCache.h"
 
 namespace MathAnim
 {
@@ -10,7 +10,7 @@ namespace MathAnim
 		std::string projectFilepath;
 		std::string previewImageFilepath;
 		std::string projectName;
-		Texture texture;
+		TextureHandle texture = NULL_TEXTURE_HANDLE;
 	};
 
 	namespace ProjectScreen
@@ -0,0 +1,16 @@
+#ifndef MATH_ANIM_PROFILER_PANEL_H
+#define MATH_ANIM_PROFILER_PANEL_H
+
+namespace MathAnim
+{
+	namespace ProfilerPanel
+	{
+		void init();
+
+		void update();
+
+		void free();
+	}
+}
+
+#endif 
@@ -4,6 +4,8 @@
 
 namespace MathAnim
 {
+	struct Waveform;
+
 	typedef int ImGuiTimelineFlags;
 	enum _ImGuiTimelineFlags
 	{
@@ -90,13 +92,13 @@ namespace MathAnim
 		int32 numAudioChannels;
 		uint32 dataSize;
 		uint8* data;
+		// Min/max pyramid the waveform gets drawn from, nullptr while it's still being built
+		const Waveform* waveform;
 	};
 
 	ImGuiTimelineResult ImGuiTimeline(ImGuiTimeline_Track* tracks, int numTracks, int* currentFrame, int* firstFrame, float* zoom = nullptr, const ImGuiTimeline_AudioData* audioData = nullptr, ImGuiTimelineFlags flags = ImGuiTimelineFlags_None);
 	const char* ImGuiTimeline_DragDropSegmentPayloadId();
 	const char* ImGuiTimeline_DragDropSubSegmentPayloadId();
-
-	void ImGuiTimeline_free();
 }
 
 #endif 
\ No newline at end of file
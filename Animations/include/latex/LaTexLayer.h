@@ -3,13 +3,21 @@
 #include "core.h"
 #include "multithreading/Promise.hpp"
 
+#include <functional>
+
 namespace MathAnim
 {
 	struct SvgObject;
+	struct SvgGroup;
+
+	typedef std::function<void(const std::string& md5, bool succeeded, bool replacedStaleSvg)> LaTexReadyCallback;
 
 	namespace LaTexLayer
 	{
-		void init();
+		// onLaTexReady is called on the main thread during update() every time a
+		// laTexToSvg request finishes, whether it had to be generated or not. replacedStaleSvg
+		// is set when the equation was regenerated over a stale svg that may already be displayed.
+		void init(LaTexReadyCallback onLaTexReady);
 
 		void laTexToSvg(const char* latex, bool isMathTex = false);
 
@@ -21,10 +29,19 @@ namespace MathAnim
 
 		std::string getLaTexMd5(const std::string& latex);
 
+		// Returns a new copy of the parsed SVG generated for md5 or nullptr if it hasn't
+		// been generated yet. The caller owns the group.
+		SvgGroup* loadSvgGroup(const std::string& md5);
+
 		void update();
 
 		void free();
+
+		// Batches are compiled to one multi-page dvi, these are the -o pattern handed to
+		// dvisvgm and the file it writes for each page. pageNumber starts at 1.
+		std::string getBatchPageOutputPattern(const std::string& basename);
+		std::string getBatchPageFilename(const std::string& basename, size_t pageNumber);
 	}
 }
 
-#endif 
\ No newline at end of file
+#endif
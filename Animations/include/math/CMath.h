@@ -331,6 +331,16 @@ namespace MathAnim
 		*/
 		uint32 hashString(const char* str);
 
+		/**
+		 * @brief Returns a 64-bit FNV-1a hash of the bytes. Unlike std::hash this is
+		 *        stable across runs and compilers, so it's safe to write to disk.
+		 * @param data The bytes to hash
+		 * @param length Number of bytes to hash
+		 * @param seed Previous hash to continue hashing from
+		 * @return 64-bit hash
+		*/
+		uint64 hashBytes(const void* data, size_t length, uint64 seed = 0xcbf29ce484222325ULL);
+
 		// ----------- Bezier Helpers -----------
 
 		Vec2 bezier1(const Vec2& p0, const Vec2& p1, float t);
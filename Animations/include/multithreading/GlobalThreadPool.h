@@ -2,35 +2,71 @@
 #define MATH_ANIM_GLOBAL_THREAD_POOL_H
 #include "core.h"
 
+#include <functional>
+#include <deque>
+#include <atomic>
+
 namespace MathAnim
 {
+	// Each priority is its own lane in every worker's queue. Workers always drain
+	// higher priority lanes (including stealing from other workers) before lower ones.
 	enum class Priority : uint8
 	{
 		High = 0,
 		Medium,
 		Low,
-		None
+		None,
+		Length
 	};
 
 	typedef void (*TaskFunction)(void* data, size_t dataSize);
 	typedef void (*ThreadCallback)(void* data, size_t dataSize);
-	struct ThreadTask
+	typedef std::function<void()> JobFunction;
+
+	// Fence for a group of jobs. Pass the same counter to every job in the group,
+	// then either block on it with GlobalThreadPool::wait or attach a continuation
+	// with GlobalThreadPool::continueWith.
+	//
+	// A counter must outlive every job and continuation attached to it.
+	class JobCounter
 	{
-		TaskFunction fn;
-		ThreadCallback callback;
-		uint64 counter;
-		void* data;
-		size_t dataSize;
-		Priority priority;
-		const char* taskName;
+	public:
+		JobCounter() : pending(0), continuations(), continuationMtx(), finishedCv() {}
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+
+		bool isDone() const { return pending.load(std::memory_order_acquire) == 0; }
+
+	private:
+		struct Continuation
+		{
+			JobFunction fn;
+			const char* name;
+			Priority priority;
+			bool runOnMainThread;
+		};
+
+		std::atomic<uint32> pending;
+		std::vector<Continuation> continuations;
+		std::mutex continuationMtx;
+		// Notified under continuationMtx when pending reaches 0, GlobalThreadPool::wait
+		// sleeps on it once there's nothing left to help with
+		std::condition_variable finishedCv;
+
+		friend class GlobalThreadPool;
 	};
 
-	struct CompareThreadTask
+	struct Job
 	{
-		// Returning true means lesser priority
-		bool operator()(const ThreadTask& a, const ThreadTask& b) const;
+		JobFunction fn;
+		JobCounter* counter;
+		const char* name;
 	};
 
+	// Work stealing job system. Every worker owns a deque per priority lane. Workers
+	// push and pop their own jobs from the back and steal from the front of other
+	// workers' deques when they run out of work. Jobs queued from threads outside
+	// the pool are spread round-robin across the workers.
 	class GlobalThreadPool
 	{
 	public:
@@ -39,10 +75,15 @@ namespace MathAnim
 		GlobalThreadPool(bool forceSynchronous);
 #endif
 
+		// Runs every queued job to completion before joining the workers
 		void free();
 
+		// Runs callbacks and continuations that were requested to run on the main thread
 		void processFinishedTasks();
 		void processLoop(uint32 threadIndex);
+
+		// Compatibility shim for the old void* task API. callback is run on
+		// the main thread in processFinishedTasks.
 		void queueTask(
 			TaskFunction function,
 			const char* taskName = "Default",
@@ -53,15 +94,48 @@ namespace MathAnim
 		);
 		void beginWork(bool notifyAll = true);
 
+		void queueJob(JobFunction&& job, const char* jobName = "Job", Priority priority = Priority::None, JobCounter* counter = nullptr);
+
+		// Queues continuation once every job attached to counter has finished. If the
+		// counter is already done the continuation is queued immediately.
+		void continueWith(JobCounter& counter, JobFunction&& continuation, const char* continuationName = "Continuation", Priority priority = Priority::None, bool runOnMainThread = false);
+
+		// Blocks until every job attached to counter has finished. The calling thread
+		// runs queued jobs attached to the same counter while it waits, so this is safe
+		// to call from inside a job. Unrelated jobs are left for the workers, so waiting
+		// on the main thread never runs someone else's job there.
+		void wait(JobCounter& counter);
+
+		// Splits [0, count) into chunks of at most grainSize and runs fn(begin, end) on
+		// each chunk in parallel. Blocks until every chunk has run.
+		void parallelFor(size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)>& fn, Priority priority = Priority::High);
+
+		uint32 getNumThreads() const { return numThreads; }
+
 	private:
-		std::priority_queue<ThreadTask, std::vector<ThreadTask>, CompareThreadTask>* tasks;
-		std::queue<ThreadTask> finishedTasks;
+		struct WorkerQueue
+		{
+			std::deque<Job> lanes[(uint8)Priority::Length];
+			std::mutex mtx;
+		};
+
+		void pushJob(Job&& job, Priority priority);
+		bool popJob(int32 workerIndex, Job* output);
+		bool popJobFor(const JobCounter& counter, Job* output);
+		bool tryRunJob(int32 workerIndex);
+		void runJob(Job& job);
+		void finishJob(JobCounter* counter);
+
+		WorkerQueue* workerQueues;
 		std::thread* workerThreads;
 		std::condition_variable* cv;
-		std::mutex* generalMtx;
-		std::mutex* queueMtx;
+		std::mutex* sleepMtx;
 		std::mutex* finishedQueueMtx;
-		bool doWork;
+		std::queue<JobFunction> finishedTasks;
+		std::atomic<uint32> numQueuedJobs;
+		std::atomic<uint32> numSleepingWorkers;
+		std::atomic<uint32> nextQueue;
+		std::atomic<bool> doWork;
 		uint32 numThreads;
 #ifdef _DEBUG
 		bool forceSynchronous;
@@ -69,4 +143,4 @@ namespace MathAnim
 	};
 }
 
-#endif 
\ No newline at end of file
+#endif
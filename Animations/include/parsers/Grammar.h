@@ -11,6 +11,28 @@ namespace MathAnim
 	struct ParserInfo;
 	struct PatternRepository;
 
+	// Last onig_search result for one regex. Every pattern gets retried from the end of
+	// each new match, so a search that already found a match further ahead can be reused
+	// until the search start passes that match.
+	struct RegexSearchResult
+	{
+		size_t searchStart;
+		size_t searchRange;
+		bool matched;
+		std::vector<int> regionBegin;
+		std::vector<int> regionEnd;
+	};
+
+	// Only valid for a single piece of text, so it gets reset every time the text changes
+	struct RegexSearchCache
+	{
+		std::unordered_map<const regex_t*, RegexSearchResult> results;
+		size_t numSearches;
+		size_t numCacheHits;
+
+		void reset();
+	};
+
 	struct Capture
 	{
 		size_t index;
@@ -31,7 +53,7 @@ namespace MathAnim
 		regex_t* regMatch;
 		std::optional<CaptureList> captures;
 
-		bool match(const std::string& str, size_t start, size_t end, OnigRegion* region, std::vector<GrammarMatch>* outMatches) const;
+		bool match(const std::string& str, size_t start, size_t end, OnigRegion* region, RegexSearchCache* cache, std::vector<GrammarMatch>* outMatches) const;
 
 		void free();
 	};
@@ -46,7 +68,7 @@ namespace MathAnim
 		std::optional<CaptureList> endCaptures;
 		std::optional<std::vector<SyntaxPattern>> patterns;
 
-		bool match(const std::string& str, size_t start, size_t end, const PatternRepository& repo, OnigRegion* region, std::vector<GrammarMatch>* outMatches) const;
+		bool match(const std::string& str, size_t start, size_t end, const PatternRepository& repo, OnigRegion* region, RegexSearchCache* cache, std::vector<GrammarMatch>* outMatches) const;
 
 		void free();
 	};
@@ -75,7 +97,7 @@ namespace MathAnim
 		std::optional<PatternArray> patternArray;
 		std::optional<std::string> patternInclude;
 
-		bool match(const std::string& str, size_t start, size_t end, const PatternRepository& repo, OnigRegion* region, std::vector<GrammarMatch>* outMatches) const;
+		bool match(const std::string& str, size_t start, size_t end, const PatternRepository& repo, OnigRegion* region, RegexSearchCache* cache, std::vector<GrammarMatch>* outMatches) const;
 
 		void free();
 	};
@@ -103,8 +125,12 @@ namespace MathAnim
 		std::vector<SyntaxPattern> patterns;
 		PatternRepository repository;
 		OnigRegion* region;
+		RegexSearchCache* searchCache;
 
+		// Continues from the end of the last match in outMatches. Call resetSearchCache
+		// before matching against a different string.
 		bool getNextMatch(const std::string& code, std::vector<GrammarMatch>* outMatches) const;
+		void resetSearchCache() const;
 
 		static Grammar* importGrammar(const char* filepath);
 		static void free(Grammar* grammar);
@@ -1,11 +1,11 @@
 #ifndef MATH_ANIM_SYNTAX_HIGHLIGHTER_H
 #define MATH_ANIM_SYNTAX_HIGHLIGHTER_H
 #include "core.h"
+#include "parsers/Grammar.h"
 
 namespace MathAnim
 {
 	struct SyntaxTheme;
-	struct Grammar;
 
 	enum class HighlighterLanguage : uint8
 	{
@@ -75,6 +75,14 @@ namespace MathAnim
 	{
 		std::vector<HighlightSegment> segments;
 		std::string codeBlock;
+
+		// Tokenizer state kept around so an edited copy of codeBlock can be re-highlighted
+		// with SyntaxHighlighter::reparse. matchGroupEnds[i] is one past the last match found
+		// by the i'th Grammar::getNextMatch call, and the grammar always resumes searching
+		// from the end of that match.
+		const Grammar* grammar;
+		std::vector<GrammarMatch> matches;
+		std::vector<size_t> matchGroupEnds;
 	};
 
 	class SyntaxHighlighter
@@ -84,6 +92,11 @@ namespace MathAnim
 
 		CodeHighlights parse(const std::string& code, const SyntaxTheme& theme, bool printDebugInfo = false) const;
 
+		// Gives the same result as parse, but only runs the grammar from the line before the
+		// first change in code until the tokenizer ends up back in a state it was in when
+		// previous was highlighted. Everything else gets copied over from previous.
+		CodeHighlights reparse(const CodeHighlights& previous, const std::string& code, const SyntaxTheme& theme) const;
+
 		void free();
 
 	private:
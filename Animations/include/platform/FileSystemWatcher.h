@@ -2,6 +2,8 @@
 #define MATH_ANIM_FILE_SYSTEM_WATCHER
 #include "core.h"
 
+#include <chrono>
+
 namespace MathAnim
 {
 	enum NotifyFilters
@@ -16,6 +18,18 @@ namespace MathAnim
 		Security = 256
 	};
 
+	enum class FileEventType : uint8
+	{
+		Changed,
+		Renamed,
+		Deleted,
+		Created
+	};
+
+	// Watches path (and every directory under it when includeSubdirectories is set) on
+	// a background thread. Events are reported with the full path of the file and only
+	// after the file has been quiet for debounceTime, so the burst of writes an editor
+	// makes while saving turns into a single callback. The callbacks run in poll().
 	class FileSystemWatcher
 	{
 	public:
@@ -39,29 +53,35 @@ namespace MathAnim
 
 		int notifyFilters = 0;
 		bool includeSubdirectories = false;
+		// Only files matching this are reported, either empty or a "*.ext" pattern
 		std::string filter = "";
 		std::filesystem::path path = "";
+		std::chrono::milliseconds debounceTime = std::chrono::milliseconds(100);
 
 	private:
+		struct PendingEvent
+		{
+			FileEventType type;
+			std::chrono::steady_clock::time_point lastEventTime;
+		};
+
 		bool enableRaisingEvents = true;
 		std::thread fileWatcherThread;
-		void* stopEventHandle;
-
-		std::set<std::filesystem::path> changedQueue;
-		std::set<std::filesystem::path> renamedQueue;
-		std::set<std::filesystem::path> deletedQueue;
-		std::set<std::filesystem::path> createdQueue;
-
-		std::set<std::filesystem::path> prevChangedQueue;
-		std::set<std::filesystem::path> prevRenamedQueue;
-		std::set<std::filesystem::path> prevDeletedQueue;
-		std::set<std::filesystem::path> prevCreatedQueue;
+		void* stopEventHandle = nullptr;
+		// Owned by the platform implementation
+		void* platformData = nullptr;
 
+		// Events that are still settling, keyed by the full path of the file
+		std::unordered_map<std::string, PendingEvent> pendingEvents;
 		std::mutex queueMtx;
 
 	private:
 		void startThread();
+		// Called from the watcher thread. Repeated events for the same file are
+		// coalesced and push the file's debounce deadline back.
+		void queueEvent(const std::filesystem::path& file, FileEventType type);
+		bool matchesFilter(const std::filesystem::path& file) const;
 	};
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -24,6 +24,7 @@ namespace MathAnim
 
 		bool getProgramInstallDir(const char* programDisplayName, char* buffer, size_t bufferLength);
 
+		// Blocks until the program exits. Returns true if it exited with a zero exit code.
 		bool executeProgram(const char* programFilepath, const char* cmdLineArgs = nullptr, const char* workingDirectory = nullptr, const char* executionOutputFilename = nullptr);
 
 		bool openFileWithDefaultProgram(const char* filepath);
@@ -36,12 +37,21 @@ namespace MathAnim
 
 		bool deleteFile(const char* filename);
 
+		// Blocks until everything written to filename has reached the disk. Use this
+		// before renaming a freshly written file over an existing one.
+		bool syncFileToDisk(const char* filename);
+
 		std::string tmpFilename(const std::string& directory);
 
 		std::string getSpecialAppDir();
 
 		MemMappedFile* createTmpMemMappedFile(const std::string& directory, size_t fileSize);
 
+		// Maps an existing file into memory as read-only. Returns nullptr if the file
+		// does not exist or could not be mapped. Free the result with freeMemMappedFile
+		// The file can still be appended to while it's mapped, the mapping keeps its original size.
+		MemMappedFile* memMapFile(const char* filepath);
+
 		void freeMemMappedFile(MemMappedFile* file);
 
 		void createDirIfNotExists(const char* dirName);
@@ -3,6 +3,8 @@
 #include "core.h"
 #include "renderer/Texture.h"
 
+#include <shared_mutex>
+
 namespace MathAnim
 {
 	struct SvgObject;
@@ -28,16 +30,39 @@ namespace MathAnim
 		void free();
 	};
 
+	struct KerningPair
+	{
+		// (leftCodepoint << 32) | rightCodepoint
+		uint64 codepoints;
+		float kerning;
+	};
+
 	struct Font
 	{
 		FT_Face fontFace;
 		std::unordered_map<uint32, GlyphOutline> glyphMap;
+		// The lookup tables below can be read from any thread through getGlyphIndex and
+		// getKerning, unlike FT_Face. Fonts::reloadFont builds new tables on the side and
+		// swaps them in while holding lookupMtx exclusively.
+		std::unordered_map<uint32, uint32> glyphIndices;
+		// Only pairs with non-zero kerning, sorted by codepoints
+		std::vector<KerningPair> kerningPairs;
+		std::shared_mutex* lookupMtx;
 		std::string fontFilepath;
+		CharRange defaultCharset;
+		// Bumped by Fonts::reloadFont so glyphs cached from the old file aren't reused
+		uint32 generation;
+		// Seeds SvgDiskCache glyph keys. Covers the file's last write time, so it's
+		// computed once on load instead of stat-ing the font for every glyph.
+		uint64 diskCacheHash;
 		float unitsPerEM;
 		float lineHeight;
 
 		const GlyphOutline& getGlyphInfo(uint32 glyphIndex) const;
+		// Returns 0 for pairs outside the charset the font was loaded with
 		float getKerning(uint32 leftCodepoint, uint32 rightCodepoint) const;
+		// Returns 0 (the missing glyph) for codepoints outside the loaded charset
+		uint32 getGlyphIndex(uint32 codepoint) const;
 		glm::vec2 getSizeOfString(const std::string& string) const;
 		glm::vec2 getSizeOfString(const std::string& string, int fontSizePixels) const;
 	};
@@ -100,6 +125,12 @@ namespace MathAnim
 		// font is fully unloaded
 		void unloadFont(Font* font);
 
+		// Re-reads a loaded font after its file changed on disk. The Font pointer stays
+		// valid, but objects built from the old glyphs need to be re-initialized. Sized
+		// fonts of the same file get their atlases regenerated. Returns nullptr if the
+		// font isn't loaded or the new file can't be read, the old font stays usable.
+		Font* reloadFont(const char* filepath);
+
 		// Decreases a reference count to the font
 		// If the reference count goes below 0, the 
 		// font is fully unloaded
@@ -44,6 +44,7 @@ namespace MathAnim
 		void createVertexArray(GLuint* name);
 		void vertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer);
 		void vertexAttribIPointer(GLuint index, GLint size, GLenum type, GLsizei stride, const void* pointer);
+		void vertexAttribDivisor(GLuint index, GLuint divisor);
 		void enableVertexAttribArray(GLuint index);
 		void deleteVertexArrays(GLsizei n, const GLuint* arrays);
 
@@ -66,6 +67,7 @@ namespace MathAnim
 		void drawArrays(GLenum mode, GLint first, GLsizei count);
 		void drawElements(GLenum mode, GLsizei count, GLenum type, const void* indices);
 		void drawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLint basevertex);
+		void drawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instancecount);
 
 		// Textures
 		void readPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void* pixels);
@@ -79,6 +81,7 @@ namespace MathAnim
 		void texParameteri(GLenum target, GLenum pname, GLint param);
 		void texParameteriv(GLenum target, GLenum pname, const GLint* params);
 		void pixelStorei(GLenum pname, GLint param);
+		void generateMipmap(GLenum target);
 
 		// Shaders
 		GLuint createProgram(void);
@@ -105,6 +108,7 @@ namespace MathAnim
 		void uniform1iv(GLint location, GLsizei count, const GLint* value);
 		void uniform1i(GLint location, GLint v0);
 		void uniform2ui(GLint location, GLuint v0, GLuint v1);
+		void uniform2uiv(GLint location, GLsizei count, const GLuint* value);
 		void uniform1ui(GLint location, GLuint v0);
 		void uniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
 		void uniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
@@ -121,6 +125,15 @@ namespace MathAnim
 		void getIntegerv(GLenum pname, GLint* data);
 		const GLubyte* getStringi(GLenum name, GLuint index);
 
+		// Timer queries, these do nothing when GL 3.3 isn't supported
+		bool supportsTimerQueries();
+		void genQueries(GLsizei n, GLuint* ids);
+		void deleteQueries(GLsizei n, const GLuint* ids);
+		void queryCounter(GLuint id, GLenum target);
+		void getQueryObjectiv(GLuint id, GLenum pname, GLint* params);
+		void getQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params);
+		void getInteger64v(GLenum pname, GLint64* data);
+
 		// Debug callback stuff
 		void debugMessageCallback(GLDEBUGPROC callback, const void* userParam);
 		void pushDebugGroup(GLenum source, GLuint id, GLsizei length, const GLchar* message);
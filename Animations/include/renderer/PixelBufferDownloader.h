@@ -1,11 +1,11 @@
 #ifndef MATH_ANIM_PBO_DOWNLOADER_H
 #define MATH_ANIM_PBO_DOWNLOADER_H
 #include "core.h"
+#include "renderer/Texture.h"
 
 namespace MathAnim
 {
 	struct PixelBufferDownloadData;
-	struct Texture;
 	struct Framebuffer;
 
 	struct Pixels
@@ -25,11 +25,17 @@ namespace MathAnim
 			reset();
 		}
 
-		void create(uint32 width, uint32 height, uint8 numOfBuffers = 3);
+		// Format is R8_UI for 8 bit samples or R16_UI for 10 bit samples stored in 16 bits
+		void create(uint32 width, uint32 height, uint8 numOfBuffers = 3, ByteFormat format = ByteFormat::R8_UI);
 
 		void PixelBufferDownload::queueDownloadFrom(const Framebuffer& yFramebuffer, const Framebuffer& uvFramebuffer);
+		// Reads a frame that Renderer::renderTextureToPackedYuvFramebuffer wrote with one transfer
+		void queueDownloadFrom(const Framebuffer& packedFramebuffer);
 		const Pixels& getPixels();
 
+		// Height of a width wide texture that fits every sample of a width x height I420 frame
+		static uint32 packedYuvHeight(uint32 width, uint32 height);
+
 		void reset()
 		{
 			pixelsAreReady = false;
@@ -45,6 +51,9 @@ namespace MathAnim
 		bool pixelsAreReady;
 		uint32 numItemsInQueue;
 
+	private:
+		void advanceWriteQueue();
+
 	private:
 		PixelBufferDownloadData* data;
 		Pixels currentOutputPixels;
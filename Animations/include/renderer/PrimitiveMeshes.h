@@ -0,0 +1,63 @@
+#ifndef MATH_ANIMATIONS_PRIMITIVE_MESHES_H
+#define MATH_ANIMATIONS_PRIMITIVE_MESHES_H
+#include "core.h"
+
+namespace MathAnim
+{
+	enum class PrimitiveType : uint8
+	{
+		Cube = 0,
+		Cone,
+		Cylinder,
+		Sphere,
+		Torus,
+		Length
+	};
+
+	enum class PrimitiveLod : uint8
+	{
+		Low = 0,
+		Medium,
+		High,
+		Length
+	};
+
+	struct PrimitiveVertex
+	{
+		Vec3 position;
+		// Direction the vertex gets pushed by the instance's tube radius. Only the
+		// torus uses this, it's zero for every other primitive.
+		Vec3 tubeOffset;
+	};
+
+	struct PrimitiveMesh
+	{
+		uint32 vbo;
+		uint32 ebo;
+		uint32 vertCount;
+		uint32 elementCount;
+	};
+
+	// Unit meshes for the 3D primitives. They're generated once at every LOD and
+	// live in static GPU buffers that the instanced 3D draws read from.
+	//
+	// Local space is +X right, +Y up, +Z forward:
+	//   Cube      [-0.5, 0.5] on every axis
+	//   Cone      radius 1 base at z = 0, tip at z = 1
+	//   Cylinder  radius 1 from z = 0 to z = 1
+	//   Sphere    radius 1
+	//   Torus     ring of radius 1 in the XY plane, the tube radius is per instance
+	namespace PrimitiveMeshes
+	{
+		void init();
+
+		const PrimitiveMesh& get(PrimitiveType type, PrimitiveLod lod);
+
+		// CPU side of the mesh, this is what gets uploaded in init()
+		void generate(PrimitiveType type, PrimitiveLod lod, std::vector<PrimitiveVertex>& vertices, std::vector<uint16>& indices);
+
+		void free();
+	}
+}
+
+#endif
@@ -51,6 +51,10 @@ namespace MathAnim
 		void renderFramebuffer(const Framebuffer& framebuffer);
 		void renderTextureToFramebuffer(const Texture& texture, const Framebuffer& framebuffer);
 		void renderTextureToYuvFramebuffer(const Texture& texture, const Framebuffer& yFramebuffer, const Framebuffer& uvFramebuffer);
+		// Writes the frame as planar I420 into the first attachment of packedFramebuffer so it can be
+		// read back with a single transfer. The attachment is R8_UI for 8 bit samples or R16_UI for
+		// 10 bit samples, and has to be PixelBufferDownload::packedYuvHeight(frameWidth, frameHeight) tall.
+		void renderTextureToPackedYuvFramebuffer(const Texture& texture, const Framebuffer& packedFramebuffer, uint32 frameWidth, uint32 frameHeight);
 		void clearDrawCalls();
 
 		// ----------- Styles ----------- 
@@ -30,6 +30,8 @@ namespace MathAnim
 		void uploadUInt(const char* varName, uint32 value) const;
 		void uploadUVec2(const char* varName, const glm::uvec2& vec2) const;
 		void uploadU64AsUVec2(const char* varName, uint64 value) const;
+		// Uploads each uint64 as a uvec2 using the same LOW HIGH split as uploadU64AsUVec2
+		void uploadU64ArrayAsUVec2Array(const char* varName, int length, const uint64* array) const;
 
 		void uploadMat4(const char* varName, const glm::mat4& mat4) const;
 		void uploadMat3(const char* varName, const glm::mat3& mat3) const;
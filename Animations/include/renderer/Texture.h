@@ -32,6 +32,7 @@ namespace MathAnim
 		RG32_UI,
 		R8_UI,
 		R8_F,
+		R16_UI,
 
 		DepthStencil,
 	};
@@ -5,6 +5,8 @@
 
 namespace MathAnim
 {
+	class GlobalThreadPool;
+
 	typedef uint64 TextureHandle;
 	
 	struct TextureLoadOptions
@@ -13,11 +15,19 @@ namespace MathAnim
 		FilterMode minFilter;
 		WrapMode wrapT;
 		WrapMode wrapS;
+		bool generateMipmaps;
+	};
+
+	struct PendingTextureLoad
+	{
+		std::filesystem::path absPath;
+		size_t numBytes;
+		bool isDecoded;
 	};
 
 	namespace TextureCache
 	{
-		void init();
+		void init(GlobalThreadPool* threadPool);
 
 		// NOTE: Textures are ONLY cached according to filepath. The options
 		//       may be different from load to load, but it will only use the
@@ -30,11 +40,41 @@ namespace MathAnim
 				FilterMode::Linear,
 				FilterMode::Linear,
 				WrapMode::None,
-				WrapMode::None
+				WrapMode::None,
+				false
 			});
+
+		// Same caching rules as loadTexture, but the image gets decoded on the thread pool
+		// and uploaded during update(). Only the image header is read here so the returned
+		// texture already has the right width and height, but it samples a 1x1 placeholder
+		// until isReady returns true. Returns a null handle if the image can't be read.
+		TextureHandle loadTextureAsync(
+			const std::string& imageFilepath,
+			const TextureLoadOptions& options = {
+				FilterMode::Linear,
+				FilterMode::Linear,
+				WrapMode::None,
+				WrapMode::None,
+				false
+			});
+		// Re-decodes a cached texture in the background after the file changed on disk.
+		// The handle stays the same and keeps sampling the old pixels until the new ones
+		// are uploaded. Returns false if nothing has the file loaded.
+		bool reloadTexture(const std::filesystem::path& imageFilepath);
 		void unloadTexture(TextureHandle handle);
 
 		const Texture& getTexture(TextureHandle textureHandle);
+		bool isReady(TextureHandle textureHandle);
+
+		// Uploads textures that finished decoding since last frame. Main thread only.
+		void update();
+		// Blocks until every async load in flight is decoded and uploads all of them,
+		// ignoring the per-frame upload budget. Exported frames use this so they never
+		// sample a placeholder or a half-reloaded image. Main thread only.
+		void waitForPendingLoads();
+
+		std::vector<PendingTextureLoad> getPendingLoads();
+		size_t getPendingBytes();
 
 		void free();
 	}
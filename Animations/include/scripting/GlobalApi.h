@@ -1,5 +1,7 @@
 #ifndef MATH_ANIM_GLOBAL_API_H
 #define MATH_ANIM_GLOBAL_API_H
+#include "core.h"
+#include "animation/Animation.h"
 
 struct lua_State;
 
@@ -42,6 +44,10 @@ extern "C"
 	int global_svgQuadToRel(lua_State* L);
 	int global_svgCubicToRel(lua_State* L);
 	int global_svgArcToRel(lua_State* L);
+
+	// Bulk Commands
+	int global_svgPolyline(lua_State* L);
+	int global_svgCubics(lua_State* L);
 	
 	// ------- Exported libraries/shared library support -------
 	int global_require(lua_State* L);
@@ -51,11 +57,24 @@ extern "C"
 namespace MathAnim
 {
 	struct AnimationManagerData;
-	struct AnimObject;
 
 	namespace ScriptApi
 	{
+		// Objects created by a generator script running on a worker thread. Those scripts
+		// never touch the AnimationManagerData, the objects wait here until LuauLayer
+		// adds them to the scene on the main thread.
+		struct GeneratorStaging
+		{
+			// Copy of the object the generator runs on, taken on the main thread
+			AnimObject parent;
+			std::vector<AnimObject> objects;
+			std::unordered_map<AnimObjId, size_t> objectIndices;
+		};
+
 		void registerGlobalFunctions(lua_State* luaState, AnimationManagerData* am);
+		// Registers the same functions, but every object created goes into staging and
+		// the globals are frozen so each script gets its own sandboxed thread
+		void registerGeneratorFunctions(lua_State* luaState, GeneratorStaging* staging);
 
 		void pushAnimObject(lua_State* L, const AnimObject& obj);
 		void pushNewSvgObject(lua_State* L, const AnimObject& obj);
@@ -2,23 +2,44 @@
 #define MATH_ANIM_LUAU_LAYER_H
 #include "core.h"
 
+#include <functional>
+#include <chrono>
+
 namespace MathAnim
 {
 	struct AnimationManagerData;
 
+	typedef std::function<void(const std::string& filename, bool succeeded)> CompileCallback;
+
 	namespace LuauLayer
 	{
-		void init(const std::filesystem::path& scriptDirectory, AnimationManagerData* am);
+		// Compiled bytecode is kept in cacheDirectory, keyed by the script source and
+		// compile options, so unchanged scripts skip luau_compile across sessions
+		void init(const std::filesystem::path& scriptDirectory, const std::filesystem::path& cacheDirectory, AnimationManagerData* am);
 
 		void update();
 
 		bool compile(const std::string& filename);
 		bool compile(const std::string& sourceCode, const std::string& scriptName);
+		// Same as compile(filename), but the file is read and compiled on the thread pool.
+		// onCompiled is called on the main thread once the bytecode is cached (or not).
+		void compileAsync(const std::string& filename, CompileCallback onCompiled = nullptr);
 		const std::string& getCurrentExecutingScriptFilepath();
 
 		bool execute(const std::string& scriptName);
 		bool executeOnAnimObj(const std::string& scriptName, const std::string& functionName, AnimationManagerData* am, AnimObjId obj);
 
+		// Runs functionName from a compiled script on the thread pool, in a sandboxed Luau
+		// state of its own so generators for different objects run side by side. Objects the
+		// script creates are staged and added to am on the main thread once it finishes,
+		// replacing the children obj generated before. A script still running after
+		// timeBudget is stopped, a zero budget lets it run until it's done.
+		void executeOnAnimObjAsync(const std::string& scriptName, const std::string& functionName, AnimationManagerData* am, AnimObjId obj, std::chrono::milliseconds timeBudget);
+		bool isExecuting(AnimObjId obj);
+		// The script stops at its next loop iteration or function call and nothing it
+		// created is added to the scene
+		void cancelExecution(AnimObjId obj);
+
 		bool remove(const std::string& scriptName);
 
 		void free();
@@ -16,7 +16,10 @@ namespace MathAnim
 	public:
 		ScriptAnalyzer(const std::filesystem::path& scriptDirectory);
 
-		bool analyze(const std::string& filename);
+		// Checked modules are kept between calls. A script is only type checked again
+		// when its source or the source of a module it requires changed, skipped is set
+		// to true when the last result could be reused.
+		bool analyze(const std::string& filename, bool* skipped = nullptr);
 		bool analyze(const std::string& sourceCode, const std::string& scriptName);
 
 		void free();
@@ -26,6 +29,11 @@ namespace MathAnim
 		Luau::FileResolver* fileResolver;
 		Luau::ConfigResolver* configResolver;
 		Luau::Frontend* frontend;
+		// Scripts that passed the last time they were checked
+		std::unordered_set<std::string> passedScripts;
+
+	private:
+		void markChangedModulesDirty();
 	};
 }
 
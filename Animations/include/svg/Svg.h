@@ -4,6 +4,8 @@
 
 #include <nlohmann/json_fwd.hpp>
 
+#include <atomic>
+
 namespace MathAnim
 {
 	struct AnimObject;
@@ -62,6 +64,30 @@ namespace MathAnim
 
 		float calculateApproximatePerimeter() const;
 		Curve split(float t0, float t1) const;
+		Vec2 evaluate(float t) const;
+	};
+
+	// Arc length sampled at evenly spaced t values along a list of curves. This maps
+	// a distance along the curves back to a curve and t, so partial strokes advance
+	// at a constant speed no matter how the curves are parameterized.
+	struct ArcLengthLut
+	{
+		static constexpr int samplesPerCurve = 16;
+
+		// lengths[curvei * samplesPerCurve + samplei] is the distance from the start of the
+		// first curve to t = (samplei + 1) / samplesPerCurve on curvei
+		float* lengths;
+		int numCurves;
+		int maxCapacity;
+
+		void addCurve(const Curve& curve);
+		bool isEmpty() const { return numCurves == 0; }
+		float getTotalLength() const;
+		// Returns the index of the curve length lands on and writes the t on that curve to outT
+		int find(float length, float* outT) const;
+		void free();
+
+		static ArcLengthLut create(int numCurvesToReserve = 0);
 	};
 
 	struct Path
@@ -85,6 +111,25 @@ namespace MathAnim
 		FillType fillType;
 		uint8* md5;
 		size_t md5Length;
+		// Non-null when paths and md5 are shared with other SvgObjects. Shared geometry
+		// is immutable, anything that edits the paths calls makeUnique() first.
+		// Atomic since script generators copy and free objects on worker threads.
+		std::atomic<uint32>* sharedRefCount;
+		// Font and codepoint this geometry came from, 0 unless this is an unedited font glyph.
+		// SvgCache uses it to rasterize every occurrence of a glyph once.
+		uint64 glyphId;
+		// Built the first time a partial outline is drawn, dropped whenever the paths change
+		mutable ArcLengthLut arcLengthLut;
+
+		// Marks this geometry as shareable. Svg::copy from a shared object bumps the
+		// reference count instead of deep copying the curves.
+		void makeShared();
+		// Call before editing the paths. Gives this object its own copy of the geometry if
+		// it's currently shared and drops anything cached from the old curves.
+		void makeUnique();
+		bool isShared() const { return sharedRefCount != nullptr; }
+
+		const ArcLengthLut& getArcLengthLut() const;
 
 		void normalize();
 		void calculateApproximatePerimeter();
@@ -93,14 +138,25 @@ namespace MathAnim
 		void finalize();
 		std::string getPathAsString() const;
 		float calculateSvgScale(float targetWidth) const;
-		void render(float svgScale, const Texture& texture, const Vec2& textureOffset) const;
-		void renderAsync(float svgScale, const Texture& texture, const Vec2& textureOffset) const;
+		// diskCacheKey is the SvgDiskCache tile key the rasterized pixels get stored under, 0 skips the disk cache
+		void render(float svgScale, const Texture& texture, const Vec2& textureOffset, uint64 diskCacheKey = 0) const;
+		void renderAsync(float svgScale, const Texture& texture, const Vec2& textureOffset, uint64 diskCacheKey = 0) const;
 		void renderOutline(float t, const AnimObject* parent) const;
 		void free();
 
-		void serialize(nlohmann::json& j) const;
+		// Building the path string is the slow part of saving an SVG, binary scene
+		// files skip it with writePath = false and call serializeCurves instead
+		void serialize(nlohmann::json& j, bool writePath = true) const;
+		// Writes the raw curve data. Only use this for binary scene files, text JSON
+		// can't hold the binary blob.
+		void serializeCurves(nlohmann::json& j) const;
 		static SvgObject* deserialize(const nlohmann::json& j, uint32 version);
 
+		// Raw geometry with the bbox, perimeter and md5 precomputed so it
+		// can be loaded without re-parsing or re-finalizing the paths
+		void serializeGeometry(RawMemory& memory) const;
+		static bool deserializeGeometry(RawMemory& memory, SvgObject* output);
+
 		[[deprecated("This is for upgrading legacy projects developed in beta")]]
 		static SvgObject* legacy_deserialize(RawMemory& memory, uint32 version);
 	};
@@ -119,6 +175,11 @@ namespace MathAnim
 		void normalize();
 		void calculateBBox();
 		void free();
+
+		// Objects, offsets and bbox of an already normalized group. Unique objects
+		// aren't stored, deserialized groups come back with none.
+		void serializeGeometry(RawMemory& memory) const;
+		static bool deserializeGeometry(RawMemory& memory, SvgGroup* output);
 	};
 
 	namespace Svg
@@ -146,10 +207,17 @@ namespace MathAnim
 		void smoothBezier3To(SvgObject* object, const Vec2& control1, const Vec2& dest, bool absolute = true);
 		void arcTo(SvgObject* object, const Vec2& radius, float xAxisRot, bool largeArc, bool sweep, const Vec2& dst, bool absolute = true);
 
+		// Bulk versions of lineTo and bezier3To that grow the path once for every curve
+		// they add. cubicsTo reads control0, control1, dest for each curve from points.
+		void polylineTo(SvgObject* object, const Vec2* points, int numPoints, bool absolute = true);
+		void cubicsTo(SvgObject* object, const Vec2* points, int numCurves, bool absolute = true);
+
 		// Manually add a curve
 		void addCurveManually(SvgObject* object, const Curve& curve);
 
 		void copy(SvgObject* dest, const SvgObject* src);
+		// Deep copies every object, offset and unique object, replacing whatever dest held
+		void copy(SvgGroup* dest, const SvgGroup* src);
 		SvgObject* interpolate(const SvgObject* src, const SvgObject* dst, float t);
 	}
 }
@@ -68,9 +68,12 @@ namespace MathAnim
 
 		std::optional<_SvgCacheEntryInternal> getInternal(uint64 hash);
 		bool existsInternal(uint64 hash);
+		void putInternal(uint64 hash, const AnimObject* parent, SvgObject* svg);
 
 		void generateDefaultFramebuffer(uint32 width, uint32 height);
 
+		static bool isCacheable(const SvgObject* svg);
+		uint64 getKey(const AnimObject* parent, const SvgObject* svg);
 		uint64 hash(const uint8* svgMd5, size_t svgMd5Length, float svgScale, float replacementTransform);
 
 	private:
@@ -0,0 +1,60 @@
+#ifndef MATH_ANIM_SVG_DISK_CACHE_H
+#define MATH_ANIM_SVG_DISK_CACHE_H
+#include "core.h"
+
+namespace MathAnim
+{
+	struct SvgObject;
+	struct GlyphOutline;
+
+	// Content addressed cache of parsed SVG geometry, glyph outlines and rasterized
+	// SvgCache tiles. Everything lives in the project's cache directory and is
+	// memory-mapped at startup so reopening a project doesn't have to re-parse
+	// every path string, rebuild every glyph through FreeType or re-rasterize
+	// every atlas tile.
+	//
+	// New entries are kept in memory and appended to the cache files in flush().
+	// Once a file grows past its size limit the least recently used entries are
+	// dropped by rewriting it on a worker thread. Lookups are only valid on the
+	// main thread.
+	namespace SvgDiskCache
+	{
+		void init(const std::filesystem::path& cacheDirectory);
+
+		// Hash used as the key for parsed SVG geometry
+		uint64 hashSvgPath(const char* pathText, size_t pathTextLength);
+
+		// Hash of a font's filepath and last write time, so editing a font
+		// invalidates its glyphs. Compute it once per loaded font.
+		uint64 hashFont(const std::string& fontFilepath);
+
+		// Hash used as the key for glyph outlines
+		uint64 hashGlyph(uint64 fontHash, uint32 codepoint);
+
+		// Hash used as the key for rasterized tiles
+		uint64 hashTile(const uint8* svgMd5, size_t svgMd5Length, float svgScale);
+
+		// Fills output with a new SvgObject built from the cached geometry.
+		// Returns false on a cache miss and leaves output untouched.
+		bool loadSvg(uint64 svgHash, SvgObject* output);
+		void storeSvg(uint64 svgHash, const SvgObject& svg);
+
+		// Fills output with a new GlyphOutline. Returns false on a cache miss.
+		bool loadGlyph(uint64 glyphHash, GlyphOutline* output);
+		void storeGlyph(uint64 glyphHash, const GlyphOutline& glyph);
+
+		// Returns the RGBA8 pixels of a rasterized tile or nullptr on a cache miss
+		// or if the cached tile has a different size than expected. The pixels are
+		// only valid until the end of the frame, copy them out right away.
+		const uint8* loadTile(uint64 tileHash, int width, int height);
+		void storeTile(uint64 tileHash, int width, int height, const uint8* pixels);
+
+		// Appends any new entries to disk and starts a compaction if a cache file
+		// has grown past its size limit
+		void flush();
+
+		void free();
+	}
+}
+
+#endif
@@ -16,9 +16,19 @@ namespace MathAnim
 
 		void addEntry(const RawMemory& memory, const char* entryName, size_t entryNameLength = 0);
 		RawMemory getEntry(const char* entryName, size_t entryNameLength = 0);
+		// Same as getEntry except the result points into this table's data instead
+		// of being a copy. Don't free the result.
+		RawMemory getEntryView(const char* entryName, size_t entryNameLength = 0);
 
-		void serialize(const char* filepath);
+		bool serialize(const char* filepath);
 		static TableOfContents deserialize(RawMemory& memory);
+		// Reads the table in place without copying anything, this is meant for
+		// memory-mapped files. Don't call free() on the result, the memory
+		// is still owned by the caller.
+		static TableOfContents deserializeView(const uint8* memory, size_t memorySize);
+
+	private:
+		bool findEntry(const char* entryName, size_t entryNameLength, size_t* dataOffset, size_t* dataSize);
 	};
 }
 
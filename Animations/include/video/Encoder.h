@@ -2,6 +2,8 @@
 #define MATH_ANIM_VIDEO_WRITER_H
 #include "core.h"
 
+#include <chrono>
+
 extern "C" {
 	struct AV1Context;
 }
@@ -25,10 +27,38 @@ namespace MathAnim
 
 	typedef int32 Mbps;
 
+	struct VideoEncoderSettings
+	{
+		// SVT-AV1 preset, 0 is the slowest and best quality and 13 is the fastest
+		int preset;
+		// Constant rate factor, 1 is the best quality and 63 the smallest file
+		int crf;
+		// Threads each SVT-AV1 instance is allowed to use
+		int threadsPerEncoder;
+		// Encodes 10 bit samples, every frame pushed has to use 16 bits per sample then
+		bool tenBit;
+
+		// Splits the video into chunks that start with a key frame and encodes them
+		// with independent encoder instances at the same time
+		bool chunked;
+		int numParallelChunks;
+		int chunkLengthSeconds;
+	};
+
+	struct EncodedVideoChunk
+	{
+		size_t firstFrame;
+		size_t numFrames;
+		// Ivf frame headers and frame data, appended to the output file as is
+		std::vector<uint8> ivfData;
+		bool isDone;
+	};
+
 	class VideoEncoder
 	{
 	public:
-		static VideoEncoder* startEncodingFile(const char* outputFilename, int outputWidth, int outputHeight, int outputFramerate, size_t totalNumFramesInVideo, VideoEncoderFlags flags = VideoEncoderFlags::None);
+		static VideoEncoderSettings defaultSettings();
+		static VideoEncoder* startEncodingFile(const char* outputFilename, int outputWidth, int outputHeight, int outputFramerate, size_t totalNumFramesInVideo, const VideoEncoderSettings& settings, VideoEncoderFlags flags = VideoEncoderFlags::None);
 		static void finalizeEncodingFile(VideoEncoder* encoder);
 		static void freeEncoder(VideoEncoder* encoder);
 
@@ -38,14 +68,20 @@ namespace MathAnim
 		void pushYuvFrame(uint8* pixels, size_t pixelsSize);
 
 		void setPercentComplete(float newVal);
+		void addEncodedFrames(size_t numFrames);
 		float getPercentComplete() const { return percentComplete.load(); }
 
 		bool isEncodingVideo() const { return isEncoding.load(); }
 
+		// Frames the encoder finished per second since the export started
+		float getFramesPerSecond() const;
+
 		void destroy();
 
 	private:
 		void encodeThreadLoop();
+		void encodeChunksThreadLoop();
+		void writeChunksThreadLoop();
 		void threadSafeFinalize();
 
 	private:
@@ -75,6 +111,18 @@ namespace MathAnim
 		std::atomic_bool isEncoding;
 		std::atomic<float> percentComplete;
 		std::atomic<size_t> approxRamUsed;
+		std::atomic<size_t> numEncodedFrames;
+		std::chrono::steady_clock::time_point encodeStartTime;
+
+		// Chunked encoding data
+		VideoEncoderSettings settings;
+		std::vector<EncodedVideoChunk> chunks;
+		std::vector<std::thread> chunkThreads;
+		std::atomic<size_t> nextChunkToEncode;
+		std::atomic<size_t> numReadyFrames;
+		std::atomic_bool noMoreFrames;
+		std::mutex chunkMtx;
+		std::condition_variable chunkCv;
 	};
 }
 
@@ -20,11 +20,13 @@
 #include "editor/panels/SceneHierarchyPanel.h"
 
 #include <nlohmann/json.hpp>
+#include <atomic>
 
 namespace MathAnim
 {
 	// ------- Private variables --------
-	static AnimObjId animObjectUidCounter = 0;
+	// Generator scripts create objects from worker threads
+	static std::atomic<AnimObjId> animObjectUidCounter = 0;
 	static AnimObjId animationUidCounter = 0;
 
 	// ----------------------------- Internal Functions -----------------------------
@@ -1055,6 +1057,7 @@ namespace MathAnim
 	void ScriptObject::serialize(nlohmann::json& memory) const
 	{
 		SERIALIZE_NULLABLE_CSTRING(memory, this, scriptFilepath, "Undefined");
+		SERIALIZE_NON_NULL_PROP(memory, this, timeBudget);
 	}
 
 	void ScriptObject::free()
@@ -1077,6 +1080,7 @@ namespace MathAnim
 		{
 			ScriptObject res = {};
 			DESERIALIZE_NULLABLE_CSTRING(&res, scriptFilepath, j);
+			DESERIALIZE_PROP(&res, timeBudget, j, ScriptObject::defaultTimeBudget);
 			return res;
 		}
 		break;
@@ -1102,10 +1106,11 @@ namespace MathAnim
 			res.scriptFilepath = (char*)g_memory_allocate(sizeof(uint8) * (res.scriptFilepathLength + 1));
 			memory.readDangerous((uint8*)res.scriptFilepath, sizeof(uint8) * res.scriptFilepathLength);
 			res.scriptFilepath[res.scriptFilepathLength] = '\0';
+			res.timeBudget = defaultTimeBudget;
 			return res;
 		}
 
-		static const ScriptObject dummy = { nullptr, 0 };
+		static const ScriptObject dummy = { nullptr, 0, defaultTimeBudget };
 		return dummy;
 	}
 
@@ -1114,6 +1119,7 @@ namespace MathAnim
 		ScriptObject res = {};
 		res.scriptFilepath = nullptr;
 		res.scriptFilepathLength = 0;
+		res.timeBudget = defaultTimeBudget;
 
 		return res;
 	}
@@ -1162,7 +1168,7 @@ namespace MathAnim
 			return;
 		}
 
-		TextureHandle handle = TextureCache::loadTexture(imageFilepath, getLoadOptions());
+		TextureHandle handle = TextureCache::loadTextureAsync(imageFilepath, getLoadOptions());
 		const Texture& texture = TextureCache::getTexture(handle);
 
 		size.x = size.x == 0.0f ? (float)texture.width / Application::getOutputSize().x * Application::getViewportSize().x : size.x;
@@ -1232,6 +1238,8 @@ namespace MathAnim
 		case ImageFilterMode::Smooth:
 			loadOptions.magFilter = FilterMode::Linear;
 			loadOptions.minFilter = FilterMode::Linear;
+			// Images are usually drawn smaller than their source, so this avoids shimmering
+			loadOptions.generateMipmaps = true;
 			break;
 		case ImageFilterMode::Pixelated:
 			loadOptions.magFilter = FilterMode::Nearest;
@@ -1281,7 +1289,7 @@ namespace MathAnim
 
 			if (res.imageFilepath > 0)
 			{
-				res.textureHandle = TextureCache::loadTexture(res.imageFilepath, res.getLoadOptions());
+				res.textureHandle = TextureCache::loadTextureAsync(res.imageFilepath, res.getLoadOptions());
 			}
 
 			return res;
@@ -1861,7 +1869,7 @@ namespace MathAnim
 		this->id = NULL_ANIM_OBJECT;
 	}
 
-	void AnimObject::serialize(nlohmann::json& memory) const
+	void AnimObject::serialize(nlohmann::json& memory, bool writeSvgPath) const
 	{
 		SERIALIZE_ENUM(memory, this, objectType, _animationObjectTypeNames);
 		SERIALIZE_VEC(memory, this, _positionStart);
@@ -1894,7 +1902,7 @@ namespace MathAnim
 			break;
 		case AnimObjectTypeV1::SvgObject:
 			g_logger_assert(this->_svgObjectStart != nullptr, "Somehow SVGObject has no object allocated.");
-			SERIALIZE_OBJECT_PTR(memory, this, _svgObjectStart);
+			this->_svgObjectStart->serialize(memory["_svgObjectStart"], writeSvgPath);
 			break;
 		case AnimObjectTypeV1::Square:
 			SERIALIZE_OBJECT(memory, this, as.square);
@@ -1967,7 +1975,7 @@ namespace MathAnim
 		DESERIALIZE_ID(&res, id, j);
 		if (!isNull(res.id))
 		{
-			animObjectUidCounter = glm::max(animObjectUidCounter, res.id + 1);
+			animObjectUidCounter = glm::max(animObjectUidCounter.load(), res.id + 1);
 		}
 
 		DESERIALIZE_ID_ARRAY(&res, generatedChildrenIds, j);
@@ -2123,7 +2131,7 @@ namespace MathAnim
 			res.drawCurveDebugBoxes = drawCurveDebugBoxes != 0;
 
 			memory.read<AnimObjId>(&res.id);
-			animObjectUidCounter = glm::max(animObjectUidCounter, res.id + 1);
+			animObjectUidCounter = glm::max(animObjectUidCounter.load(), res.id + 1);
 			memory.read<AnimObjId>(&res.parentId);
 
 			uint32 numGeneratedChildrenIds;
@@ -10,7 +10,9 @@
 #include "math/CMath.h"
 #include "core/Application.h"
 #include "core/Profiling.h"
+#include "core/FrameArena.h"
 #include "core/Serialization.hpp"
+#include "latex/LaTexLayer.h"
 
 #include <nlohmann/json.hpp>
 
@@ -55,6 +57,7 @@ namespace MathAnim
 		static bool removeSingleAnimObject(AnimationManagerData* am, AnimObjId animObj);
 		static void applyDelta(AnimationManagerData* am, int deltaFrame);
 		static void applyAnimationsFrom(AnimationManagerData* am, int startIndex, int frame, bool calculateKeyframes = false);
+		static void serializeObjects(const AnimationManagerData* am, nlohmann::json& output, bool writeSvgPaths);
 
 		AnimationManagerData* create()
 		{
@@ -140,6 +143,9 @@ namespace MathAnim
 			{
 				activeCamera3D->as.camera.endFrame();
 			}
+
+			// Nothing built this frame is allowed to use frame memory past this point
+			FrameArena::reset();
 		}
 
 		void resetToFrame(AnimationManagerData* am, uint32 absoluteFrame)
@@ -316,11 +322,7 @@ namespace MathAnim
 					}
 
 					// Update any updateable objects
-					if (objectIter->objectType == AnimObjectTypeV1::LaTexObject)
-					{
-						objectIter->as.laTexObject.update(am, objectIter->id);
-					}
-					else if (objectIter->objectType == AnimObjectTypeV1::Camera)
+					if (objectIter->objectType == AnimObjectTypeV1::Camera)
 					{
 						objectIter->as.camera.position = objectIter->globalPosition;
 					}
@@ -328,6 +330,38 @@ namespace MathAnim
 			}
 		}
 
+		void onLaTexReady(AnimationManagerData* am, const std::string& md5, bool succeeded, bool replacedStaleSvg)
+		{
+			g_logger_assert(am != nullptr, "Null AnimationManagerData.");
+
+			// Collect the ids first, reInit adds objects which invalidates any iterators
+			std::vector<AnimObjId> waitingObjects;
+			for (const auto& object : am->objects)
+			{
+				if (object.objectType == AnimObjectTypeV1::LaTexObject &&
+					(object.as.laTexObject.isParsingLaTex || replacedStaleSvg) &&
+					LaTexLayer::getLaTexMd5(object.as.laTexObject.text) == md5)
+				{
+					waitingObjects.push_back(object.id);
+				}
+			}
+
+			for (AnimObjId objId : waitingObjects)
+			{
+				AnimObject* object = getMutableObject(am, objId);
+				if (!object)
+				{
+					continue;
+				}
+
+				object->as.laTexObject.isParsingLaTex = false;
+				if (succeeded)
+				{
+					object->as.laTexObject.reInit(am, object);
+				}
+			}
+		}
+
 		int lastAnimatedFrame(const AnimationManagerData* am)
 		{
 			g_logger_assert(am != nullptr, "Null AnimationManagerData.");
@@ -547,31 +581,74 @@ namespace MathAnim
 
 		void serialize(const AnimationManagerData* am, nlohmann::json& output)
 		{
-			g_logger_assert(am != nullptr, "Null AnimationManagerData.");
+			serializeObjects(am, output, true);
+		}
 
-			// Custom data starts here. Subject to change from version to version
-			writeIdToJson("ActiveCamera", am->activeCamera, output);
-			writeIdToJson("ActiveCamera3D", am->activeCamera3D, output);
-			output["Animations"] = nlohmann::json::array();
+		void serializeBinary(const AnimationManagerData* am, nlohmann::json& output)
+		{
+			serializeObjects(am, output, false);
 
-			// Write out each animation
-			for (int i = 0; i < am->animations.size(); i++)
+			// AnimationObjects is written in the same order as am->objects
+			nlohmann::json& objectsJson = output["AnimationObjects"];
+			for (size_t i = 0; i < am->objects.size(); i++)
 			{
-				nlohmann::json animJson = nlohmann::json();
-				am->animations[i].serialize(animJson);
-				output["Animations"].emplace_back(animJson);
+				const AnimObject& obj = am->objects[i];
+				if (obj.objectType == AnimObjectTypeV1::SvgObject && obj._svgObjectStart != nullptr)
+				{
+					obj._svgObjectStart->serializeCurves(objectsJson[i]["_svgObjectStart"]);
+				}
 			}
+		}
 
-			// Write out each anim object
-			output["AnimationObjects"] = nlohmann::json::array();
-			for (int i = 0; i < am->objects.size(); i++)
+		void serializeSnapshot(AnimationManagerData* am, nlohmann::json& output, std::vector<SvgCurvesSnapshot>& outCurves)
+		{
+			serializeObjects(am, output, false);
+
+			nlohmann::json& objectsJson = output["AnimationObjects"];
+			for (size_t i = 0; i < am->objects.size(); i++)
 			{
-				nlohmann::json animObjectJson = nlohmann::json();
-				am->objects[i].serialize(animObjectJson);
-				output["AnimationObjects"].emplace_back(animObjectJson);
+				AnimObject& obj = am->objects[i];
+				if (obj.objectType != AnimObjectTypeV1::SvgObject || obj._svgObjectStart == nullptr)
+				{
+					continue;
+				}
+
+				if (FrameArena::owns(obj._svgObjectStart->paths))
+				{
+					// Frame temporaries are gone by the time the save thread runs
+					obj._svgObjectStart->serializeCurves(objectsJson[i]["_svgObjectStart"]);
+					continue;
+				}
+
+				// Shared geometry is immutable, anything that edits the live object
+				// gets its own copy first, see SvgObject::makeUnique
+				obj._svgObjectStart->makeShared();
+				SvgObject* svg = (SvgObject*)g_memory_allocate(sizeof(SvgObject));
+				*svg = Svg::createDefault();
+				Svg::copy(svg, obj._svgObjectStart);
+				outCurves.emplace_back(SvgCurvesSnapshot{ i, svg });
+			}
+		}
+
+		void writeSnapshotCurves(nlohmann::json& output, const std::vector<SvgCurvesSnapshot>& curves)
+		{
+			nlohmann::json& objectsJson = output["AnimationObjects"];
+			for (const SvgCurvesSnapshot& snapshot : curves)
+			{
+				snapshot.svg->serializeCurves(objectsJson[snapshot.objectIndex]["_svgObjectStart"]);
 			}
 		}
 
+		void freeSnapshotCurves(std::vector<SvgCurvesSnapshot>& curves)
+		{
+			for (SvgCurvesSnapshot& snapshot : curves)
+			{
+				snapshot.svg->free();
+				g_memory_free(snapshot.svg);
+			}
+			curves.clear();
+		}
+
 		void deserialize(AnimationManagerData* am, const nlohmann::json& j, int currentFrame, uint32 versionMajor, uint32 versionMinor)
 		{
 			g_logger_assert(am != nullptr, "Null AnimationManagerData.");
@@ -1169,5 +1246,32 @@ namespace MathAnim
 				}
 			}
 		}
+
+		static void serializeObjects(const AnimationManagerData* am, nlohmann::json& output, bool writeSvgPaths)
+		{
+			g_logger_assert(am != nullptr, "Null AnimationManagerData.");
+
+			// Custom data starts here. Subject to change from version to version
+			writeIdToJson("ActiveCamera", am->activeCamera, output);
+			writeIdToJson("ActiveCamera3D", am->activeCamera3D, output);
+			output["Animations"] = nlohmann::json::array();
+
+			// Write out each animation
+			for (int i = 0; i < am->animations.size(); i++)
+			{
+				nlohmann::json animJson = nlohmann::json();
+				am->animations[i].serialize(animJson);
+				output["Animations"].emplace_back(animJson);
+			}
+
+			// Write out each anim object
+			output["AnimationObjects"] = nlohmann::json::array();
+			for (int i = 0; i < am->objects.size(); i++)
+			{
+				nlohmann::json animObjectJson = nlohmann::json();
+				am->objects[i].serialize(animObjectJson, writeSvgPaths);
+				output["AnimationObjects"].emplace_back(animObjectJson);
+			}
+		}
 	}
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "svg/SvgParser.h"
 #include "editor/panels/SceneHierarchyPanel.h"
 #include "editor/EditorSettings.h"
+#include "editor/AssetWatcher.h"
 
 #include <nlohmann/json.hpp>
 
@@ -12,6 +13,12 @@ namespace MathAnim
 {
 	void SvgFileObject::init(AnimationManagerData* am, AnimObjId parentId)
 	{
+		if (filepath)
+		{
+			// Regenerate this object whenever the file gets edited
+			AssetWatcher::addDependency(filepath, parentId);
+		}
+
 		if (!svgGroup)
 		{
 			return;
@@ -23,8 +30,10 @@ namespace MathAnim
 		float zOffset = 0.0f;
 		for (int i = 0; i < svgGroup->numObjects; i++)
 		{
-			const SvgObject& obj = svgGroup->objects[i];
+			SvgObject& obj = svgGroup->objects[i];
 			const Vec2& offset = svgGroup->objectOffsets[i];
+			// The children only ever reference the group's geometry
+			obj.makeShared();
 
 			// Add this sub-object as a child
 			AnimObject childObj = AnimObject::createDefaultFromParent(am, AnimObjectTypeV1::SvgObject, parentId, true);
@@ -106,6 +115,19 @@ namespace MathAnim
 		return setFilepath(std::string(newFilepath));
 	}
 
+	void SvgFileObject::setFilepath(const std::string& newFilepath, SvgGroup* parsedGroup)
+	{
+		free();
+
+		filepath = (char*)g_memory_allocate(sizeof(char) * (newFilepath.length() + 1));
+		filepathLength = (uint32)newFilepath.length();
+
+		g_memory_copyMem(filepath, (void*)newFilepath.c_str(), sizeof(char) * newFilepath.length());
+		filepath[filepathLength] = '\0';
+
+		svgGroup = parsedGroup;
+	}
+
 	void SvgFileObject::serialize(nlohmann::json& memory) const
 	{
 		SERIALIZE_NULLABLE_CSTRING(memory, this, filepath, "Undefined");
@@ -9,6 +9,7 @@
 #include "core/Serialization.hpp"
 #include "latex/LaTexLayer.h"
 #include "editor/panels/SceneHierarchyPanel.h"
+#include "editor/AssetWatcher.h"
 #include "parsers/SyntaxTheme.h"
 
 #include <nlohmann/json.hpp>
@@ -25,15 +26,19 @@ namespace MathAnim
 			return;
 		}
 
+		AssetWatcher::addDependency(font->fontFilepath, parentId);
+
 		std::string textStr = std::string(text);
 
 		// Generate children that represent each character of the text object `obj`
 		Vec2 cursorPos = Vec2{ 0, 0 };
+		uint8 prevCodepoint = 0;
 		for (int i = 0; i < textStr.length(); i++)
 		{
 			if (textStr[i] == '\n')
 			{
 				cursorPos = Vec2{ 0.0f, cursorPos.y - font->lineHeight };
+				prevCodepoint = 0;
 				continue;
 			}
 
@@ -44,6 +49,12 @@ namespace MathAnim
 				continue;
 			}
 
+			if (prevCodepoint != 0)
+			{
+				cursorPos.x += font->getKerning(prevCodepoint, codepoint);
+			}
+			prevCodepoint = codepoint;
+
 			float halfGlyphHeight = glyphOutline.glyphHeight / 2.0f;
 			float halfGlyphWidth = glyphOutline.glyphWidth / 2.0f;
 			Vec2 offset = Vec2{
@@ -59,7 +70,7 @@ namespace MathAnim
 				Vec2 finalOffset = offset + cursorPos;
 				childObj._positionStart = Vec3{ finalOffset.x, finalOffset.y, 0.0f };
 
-				// Copy the glyph as the svg object here
+				// The glyph geometry is shared, so this only copies a reference to it
 				childObj._svgObjectStart = (SvgObject*)g_memory_allocate(sizeof(SvgObject));
 				childObj.svgObject = (SvgObject*)g_memory_allocate(sizeof(SvgObject));
 				*(childObj._svgObjectStart) = Svg::createDefault();
@@ -77,7 +88,6 @@ namespace MathAnim
 				SceneHierarchyPanel::addNewAnimObject(childObj);
 			}
 
-			// TODO: I may have to add kerning info here
 			cursorPos += Vec2{ glyphOutline.advanceX, 0.0f };
 		}
 	}
@@ -133,6 +143,13 @@ namespace MathAnim
 			this->text = nullptr;
 			this->textLength = 0;
 		}
+
+		if (this->cachedHighlights)
+		{
+			this->cachedHighlights->~CodeHighlights();
+			g_memory_free(this->cachedHighlights);
+			this->cachedHighlights = nullptr;
+		}
 	}
 
 	TextObject TextObject::deserialize(const nlohmann::json& j, uint32 version)
@@ -216,27 +233,12 @@ namespace MathAnim
 		return res;
 	}
 
-	void LaTexObject::update(AnimationManagerData* am, AnimObjId parentId)
-	{
-		if (isParsingLaTex)
-		{
-			if (LaTexLayer::laTexIsReady(text, isEquation))
-			{
-				AnimObject* parent = AnimationManager::getMutableObject(am, parentId);
-				if (parent)
-				{
-					reInit(am, parent);
-				}
-				isParsingLaTex = false;
-			}
-		}
-	}
-
 	void LaTexObject::init(AnimationManagerData* am, AnimObjId parentId)
 	{
 		// TODO: Memory leak somewhere in here
 
-		std::string filepath = "latex/" + LaTexLayer::getLaTexMd5(text) + ".svg";
+		std::string md5 = LaTexLayer::getLaTexMd5(text);
+		std::string filepath = "latex/" + md5 + ".svg";
 
 		// Add this character as a child
 		AnimObject childObj = AnimObject::createDefaultFromParent(am, AnimObjectTypeV1::SvgFileObject, parentId, true);
@@ -246,7 +248,16 @@ namespace MathAnim
 		// TODO: Ugly what do I do???
 		SceneHierarchyPanel::addNewAnimObject(childObj);
 
-		childObj.as.svgFile.setFilepath(filepath);
+		// The index already has the parsed svg, so the file doesn't need to be parsed again
+		SvgGroup* parsedGroup = LaTexLayer::loadSvgGroup(md5);
+		if (parsedGroup)
+		{
+			childObj.as.svgFile.setFilepath(filepath, parsedGroup);
+		}
+		else
+		{
+			childObj.as.svgFile.setFilepath(filepath);
+		}
 		childObj.as.svgFile.init(am, childObj.id);
 	}
 
@@ -406,8 +417,19 @@ namespace MathAnim
 			return;
 		}
 
-		// First parse the code block and get the code in segmented form with highlight information
-		CodeHighlights highlights = highlighter->parse(text, *syntaxTheme);
+		// First parse the code block and get the code in segmented form with highlight information.
+		// After the first time only the lines that changed since the last init get re-highlighted.
+		if (!cachedHighlights)
+		{
+			cachedHighlights = (CodeHighlights*)g_memory_allocate(sizeof(CodeHighlights));
+			new(cachedHighlights)CodeHighlights();
+			*cachedHighlights = highlighter->parse(text, *syntaxTheme);
+		}
+		else
+		{
+			*cachedHighlights = highlighter->reparse(*cachedHighlights, text, *syntaxTheme);
+		}
+		const CodeHighlights& highlights = *cachedHighlights;
 
 		// Generate children that represent each character of the text object `obj`
 		Vec2 cursorPos = Vec2{ 0, 0 };
@@ -462,7 +484,7 @@ namespace MathAnim
 				Vec2 finalOffset = offset + cursorPos;
 				childObj._positionStart = Vec3{ finalOffset.x, finalOffset.y, 0.0f };
 
-				// Copy the glyph as the svg object here
+				// The glyph geometry is shared, so this only copies a reference to it
 				childObj._svgObjectStart = (SvgObject*)g_memory_allocate(sizeof(SvgObject));
 				childObj.svgObject = (SvgObject*)g_memory_allocate(sizeof(SvgObject));
 				*(childObj._svgObjectStart) = Svg::createDefault();
@@ -532,6 +554,7 @@ namespace MathAnim
 		if (version == 1)
 		{
 			CodeBlock res;
+			res.cachedHighlights = nullptr;
 
 			// theme                -> uint8
 			// language             -> uint8
@@ -592,6 +615,7 @@ namespace MathAnim
 	CodeBlock CodeBlock::createDefault()
 	{
 		CodeBlock res;
+		res.cachedHighlights = nullptr;
 		res.language = HighlighterLanguage::Cpp;
 		res.theme = HighlighterTheme::MonokaiNight;
 		static const char defaultText[] = R"DEFAULT_LANG(#include <stdio.h>
@@ -0,0 +1,232 @@
+#include "audio/Waveform.h"
+#include "audio/WavLoader.h"
+
+#include <emmintrin.h>
+
+namespace MathAnim
+{
+	// ------------- Internal Functions -------------
+	static void buildBaseLevel(const WavData& wav, uint32 numChannels, WaveformLevel& level);
+	static void buildLevelFrom(const WaveformLevel& src, WaveformLevel& dst);
+	static void minMax16(const int16* samples, size_t numSamples, int16* outMin, int16* outMax);
+	static WaveformLevel allocateLevel(uint32 numBuckets, uint32 framesPerBucket);
+
+	void Waveform::getMinMax(uint32 firstFrame, uint32 numFrames, float* outMin, float* outMax) const
+	{
+		*outMin = 0.0f;
+		*outMax = 0.0f;
+		if (numLevels == 0 || numFrames == 0 || firstFrame >= numSampleFrames)
+		{
+			return;
+		}
+
+		int levelIndex = 0;
+		while (levelIndex + 1 < numLevels && levels[levelIndex + 1].framesPerBucket <= numFrames)
+		{
+			levelIndex++;
+		}
+
+		const WaveformLevel& level = levels[levelIndex];
+		uint32 lastFrame = glm::min(firstFrame + numFrames, numSampleFrames);
+		uint32 firstBucket = firstFrame / level.framesPerBucket;
+		uint32 endBucket = glm::min((lastFrame + level.framesPerBucket - 1) / level.framesPerBucket, level.numBuckets);
+
+		int16 minSample = INT16_MAX;
+		int16 maxSample = INT16_MIN;
+		for (uint32 bucket = firstBucket; bucket < endBucket; bucket++)
+		{
+			minSample = glm::min(minSample, level.minSamples[bucket]);
+			maxSample = glm::max(maxSample, level.maxSamples[bucket]);
+		}
+
+		if (firstBucket < endBucket)
+		{
+			*outMin = (float)minSample / (float)INT16_MAX;
+			*outMax = (float)maxSample / (float)INT16_MAX;
+		}
+	}
+
+	void Waveform::free()
+	{
+		for (int i = 0; i < numLevels; i++)
+		{
+			g_memory_free(levels[i].minSamples);
+			g_memory_free(levels[i].maxSamples);
+		}
+
+		if (levels)
+		{
+			g_memory_free(levels);
+		}
+
+		levels = nullptr;
+		numLevels = 0;
+		numSampleFrames = 0;
+		sampleRate = 0;
+	}
+
+	Waveform Waveform::build(const WavData& wav)
+	{
+		Waveform res = {};
+		uint32 bytesPerSample = wav.bitsPerSample / 8;
+		if (!wav.audioData || wav.blockAlignment == 0 || (bytesPerSample != 1 && bytesPerSample != 2))
+		{
+			g_logger_warning("Cannot build waveform for audio with '{}' bits per sample.", wav.bitsPerSample);
+			return res;
+		}
+
+		uint32 numChannels = glm::max(wav.blockAlignment / bytesPerSample, 1u);
+		res.numSampleFrames = wav.dataSize / wav.blockAlignment;
+		res.sampleRate = wav.sampleRate;
+		if (res.numSampleFrames == 0)
+		{
+			return res;
+		}
+
+		// Level 0 plus one level per factor of 4 until everything fits in one bucket
+		uint32 numBaseBuckets = (res.numSampleFrames + baseFramesPerBucket - 1) / baseFramesPerBucket;
+		int numLevels = 1;
+		for (uint32 numBuckets = numBaseBuckets; numBuckets > 1; numBuckets = (numBuckets + levelReductionFactor - 1) / levelReductionFactor)
+		{
+			numLevels++;
+		}
+
+		res.levels = (WaveformLevel*)g_memory_allocate(sizeof(WaveformLevel) * numLevels);
+		res.numLevels = numLevels;
+
+		res.levels[0] = allocateLevel(numBaseBuckets, baseFramesPerBucket);
+		buildBaseLevel(wav, numChannels, res.levels[0]);
+		for (int i = 1; i < numLevels; i++)
+		{
+			const WaveformLevel& src = res.levels[i - 1];
+			res.levels[i] = allocateLevel(
+				(src.numBuckets + levelReductionFactor - 1) / levelReductionFactor,
+				src.framesPerBucket * levelReductionFactor
+			);
+			buildLevelFrom(src, res.levels[i]);
+		}
+
+		return res;
+	}
+
+	// ------------- Internal Functions -------------
+	static void buildBaseLevel(const WavData& wav, uint32 numChannels, WaveformLevel& level)
+	{
+		uint32 numFrames = wav.dataSize / wav.blockAlignment;
+		if (wav.bitsPerSample == 16)
+		{
+			// Channels are interleaved, so every bucket is just one contiguous run of samples
+			const int16* samples = (const int16*)wav.audioData;
+			for (uint32 bucket = 0; bucket < level.numBuckets; bucket++)
+			{
+				uint32 firstFrame = bucket * level.framesPerBucket;
+				uint32 endFrame = glm::min(firstFrame + level.framesPerBucket, numFrames);
+				minMax16(
+					samples + (size_t)firstFrame * numChannels,
+					(size_t)(endFrame - firstFrame) * numChannels,
+					&level.minSamples[bucket],
+					&level.maxSamples[bucket]
+				);
+			}
+			return;
+		}
+
+		// 8-bit PCM is unsigned, re-center it and scale it up to the 16-bit range
+		const uint8* samples = wav.audioData;
+		for (uint32 bucket = 0; bucket < level.numBuckets; bucket++)
+		{
+			size_t first = (size_t)bucket * level.framesPerBucket * numChannels;
+			size_t end = glm::min(first + (size_t)level.framesPerBucket * numChannels, (size_t)numFrames * numChannels);
+			int16 minSample = INT16_MAX;
+			int16 maxSample = INT16_MIN;
+			for (size_t i = first; i < end; i++)
+			{
+				int16 sample = (int16)(((int)samples[i] - 128) * 256);
+				minSample = glm::min(minSample, sample);
+				maxSample = glm::max(maxSample, sample);
+			}
+			level.minSamples[bucket] = minSample;
+			level.maxSamples[bucket] = maxSample;
+		}
+	}
+
+	static void buildLevelFrom(const WaveformLevel& src, WaveformLevel& dst)
+	{
+		// Reduce 4 buckets at a time with SSE2, the leftover buckets at the end go scalar
+		constexpr uint32 factor = Waveform::levelReductionFactor;
+		uint32 numFullBuckets = src.numBuckets / factor;
+		uint32 bucket = 0;
+		for (; bucket + 2 <= numFullBuckets; bucket += 2)
+		{
+			// Two destination buckets are 8 source buckets, pairwise reduce the 8 lanes down to 2
+			__m128i mins = _mm_loadu_si128((const __m128i*)&src.minSamples[bucket * factor]);
+			__m128i maxs = _mm_loadu_si128((const __m128i*)&src.maxSamples[bucket * factor]);
+			mins = _mm_min_epi16(mins, _mm_srli_epi64(mins, 32));
+			maxs = _mm_max_epi16(maxs, _mm_srli_epi64(maxs, 32));
+			mins = _mm_min_epi16(mins, _mm_srli_epi64(mins, 16));
+			maxs = _mm_max_epi16(maxs, _mm_srli_epi64(maxs, 16));
+			dst.minSamples[bucket + 0] = (int16)_mm_extract_epi16(mins, 0);
+			dst.minSamples[bucket + 1] = (int16)_mm_extract_epi16(mins, 4);
+			dst.maxSamples[bucket + 0] = (int16)_mm_extract_epi16(maxs, 0);
+			dst.maxSamples[bucket + 1] = (int16)_mm_extract_epi16(maxs, 4);
+		}
+
+		for (; bucket < dst.numBuckets; bucket++)
+		{
+			uint32 first = bucket * factor;
+			uint32 end = glm::min(first + factor, src.numBuckets);
+			int16 minSample = INT16_MAX;
+			int16 maxSample = INT16_MIN;
+			for (uint32 i = first; i < end; i++)
+			{
+				minSample = glm::min(minSample, src.minSamples[i]);
+				maxSample = glm::max(maxSample, src.maxSamples[i]);
+			}
+			dst.minSamples[bucket] = minSample;
+			dst.maxSamples[bucket] = maxSample;
+		}
+	}
+
+	static void minMax16(const int16* samples, size_t numSamples, int16* outMin, int16* outMax)
+	{
+		__m128i mins = _mm_set1_epi16(INT16_MAX);
+		__m128i maxs = _mm_set1_epi16(INT16_MIN);
+		size_t i = 0;
+		for (; i + 8 <= numSamples; i += 8)
+		{
+			__m128i values = _mm_loadu_si128((const __m128i*)(samples + i));
+			mins = _mm_min_epi16(mins, values);
+			maxs = _mm_max_epi16(maxs, values);
+		}
+
+		// Horizontal reduction of the 8 lanes
+		mins = _mm_min_epi16(mins, _mm_shuffle_epi32(mins, _MM_SHUFFLE(1, 0, 3, 2)));
+		maxs = _mm_max_epi16(maxs, _mm_shuffle_epi32(maxs, _MM_SHUFFLE(1, 0, 3, 2)));
+		mins = _mm_min_epi16(mins, _mm_shuffle_epi32(mins, _MM_SHUFFLE(2, 3, 0, 1)));
+		maxs = _mm_max_epi16(maxs, _mm_shuffle_epi32(maxs, _MM_SHUFFLE(2, 3, 0, 1)));
+		mins = _mm_min_epi16(mins, _mm_srli_epi32(mins, 16));
+		maxs = _mm_max_epi16(maxs, _mm_srli_epi32(maxs, 16));
+
+		int16 minSample = (int16)_mm_extract_epi16(mins, 0);
+		int16 maxSample = (int16)_mm_extract_epi16(maxs, 0);
+		for (; i < numSamples; i++)
+		{
+			minSample = glm::min(minSample, samples[i]);
+			maxSample = glm::max(maxSample, samples[i]);
+		}
+
+		*outMin = minSample;
+		*outMax = maxSample;
+	}
+
+	static WaveformLevel allocateLevel(uint32 numBuckets, uint32 framesPerBucket)
+	{
+		WaveformLevel level;
+		level.numBuckets = numBuckets;
+		level.framesPerBucket = framesPerBucket;
+		level.minSamples = (int16*)g_memory_allocate(sizeof(int16) * numBuckets);
+		level.maxSamples = (int16*)g_memory_allocate(sizeof(int16) * numBuckets);
+		g_logger_assert(level.minSamples != nullptr && level.maxSamples != nullptr, "Ran out of RAM.");
+		return level;
+	}
+}
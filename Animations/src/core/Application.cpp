@@ -3,6 +3,9 @@
 #include "core/Window.h"
 #include "core/Input.h"
 #include "core/Profiling.h"
+#include "core/Profiler.h"
+#include "core/FrameArena.h"
+#include "core/BackgroundSaver.h"
 #include "renderer/Colors.h"
 #include "renderer/GladLayer.h"
 #include "renderer/Renderer.h"
@@ -12,6 +15,7 @@
 #include "renderer/Shader.h"
 #include "renderer/Framebuffer.h"
 #include "renderer/Texture.h"
+#include "renderer/TextureCache.h"
 #include "renderer/Fonts.h"
 #include "renderer/Colors.h"
 #include "renderer/GLApi.h"
@@ -21,6 +25,7 @@
 #include "svg/Svg.h"
 #include "svg/SvgParser.h"
 #include "svg/SvgCache.h"
+#include "svg/SvgDiskCache.h"
 #include "editor/EditorGui.h"
 #include "editor/Gizmos.h"
 #include "editor/EditorCameraController.h"
@@ -43,6 +48,7 @@
 #include <imgui.h>
 #include <oniguruma.h>
 #include <errno.h>
+#include <memory>
 #include <nlohmann/json.hpp>
 
 namespace MathAnim
@@ -77,10 +83,18 @@ namespace MathAnim
 
 		static const char* winTitle = "Math Animations";
 
+		// Bump this whenever the layout of the binary scene container changes. The
+		// scene data inside follows SERIALIZER_VERSION_MAJOR/MINOR like JSON scenes do.
+		static constexpr uint32 binarySceneVersion = 1;
+		static const char* binarySceneExtension = ".scene";
+
 		// ------- Internal Functions -------
 		static nlohmann::json serializeCameras();
 		static void deserializeCameras(const nlohmann::json& cameraData, uint32 version);
 		static std::string sceneToFilename(const std::string& stringName, const char* ext);
+		static nlohmann::json serializeCurrentScene(std::vector<SvgCurvesSnapshot>* outSvgCurves);
+		static bool loadSceneBinary(const std::string& filepath);
+		static void loadSceneFromJson(const nlohmann::json& sceneJson);
 		static void reloadCurrentSceneInternal();
 		static void initializeSceneSystems();
 		static void freeSceneSystems();
@@ -111,6 +125,7 @@ namespace MathAnim
 
 			Fonts::init();
 			Renderer::init();
+			Profiler::init();
 			ImGuiLayer::init(*window, "./assets/layouts/Default.json");
 			Audio::init();
 			GizmoManager::init();
@@ -119,7 +134,10 @@ namespace MathAnim
 			SvgParser::init();
 			Highlighters::init();
 
-			LaTexLayer::init();
+			LaTexLayer::init([](const std::string& md5, bool succeeded, bool replacedStaleSvg)
+			{
+				AnimationManager::onLaTexReady(am, md5, succeeded, replacedStaleSvg);
+			});
 
 			mainFramebuffer = Renderer::prepareFramebuffer(outputWidth, outputHeight);
 			editorFramebuffer = Renderer::prepareFramebuffer(outputWidth, outputHeight);
@@ -129,12 +147,14 @@ namespace MathAnim
 			Platform::createDirIfNotExists(currentProjectTmpDir.string().c_str());
 			currentProjectSceneDir = currentProjectRoot / "scenes";
 			Platform::createDirIfNotExists(currentProjectSceneDir.string().c_str());
+			SvgDiskCache::init(currentProjectRoot / "cache" / "svg");
+			BackgroundSaver::init();
 
 			initializeSceneSystems();
 			loadProject(currentProjectRoot);
 
 			EditorGui::init(am, currentProjectRoot, outputWidth, outputHeight);
-			LuauLayer::init(currentProjectRoot / "scripts", am);
+			LuauLayer::init(currentProjectRoot / "scripts", currentProjectRoot / "cache" / "luau", am);
 
 			svgCache = new SvgCache();
 			svgCache->init();
@@ -194,6 +214,11 @@ namespace MathAnim
 				EditorCameraController::update(deltaTime, editorCamera);
 				LaTexLayer::update();
 				LuauLayer::update();
+				TextureCache::update();
+				if (ExportPanel::isExportingVideo())
+				{
+					TextureCache::waitForPendingLoads();
+				}
 
 				// Update camera matrices
 				// NOTE: The editor camera matrices are updated in EditorCameraController::update
@@ -279,12 +304,14 @@ namespace MathAnim
 				// Do ImGui stuff
 				int debugMsgId = 0;
 				GL::pushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, debugMsgId++, -1, "ImGui_Pass");
+				Profiler::beginGpuEvent("ImGui_Pass");
 				ImGuiLayer::beginFrame();
 				MenuBar::update();
 				ImGui::ShowDemoWindow();
 				SceneManagementPanel::update(sceneData);
 				EditorGui::update(mainFramebuffer, editorFramebuffer, am, deltaTime);
 				ImGuiLayer::endFrame();
+				Profiler::endGpuEvent();
 				GL::popDebugGroup();
 
 				// End frame stuff
@@ -373,6 +400,9 @@ namespace MathAnim
 			delete svgCache;
 
 			saveProject();
+			SvgDiskCache::free();
+			// Blocks until the final save has been written
+			BackgroundSaver::free();
 
 			// Empty tmp directory
 			std::filesystem::remove_all(currentProjectTmpDir);
@@ -391,6 +421,7 @@ namespace MathAnim
 			AnimationManager::free(am);
 			Fonts::unloadAllFonts();
 			Renderer::free();
+			FrameArena::free();
 			GizmoManager::free();
 			Audio::free();
 
@@ -398,6 +429,7 @@ namespace MathAnim
 			Window::cleanup();
 			globalThreadPool->free();
 			delete globalThreadPool;
+			Profiler::free();
 
 			GladLayer::deinit();
 		}
@@ -418,35 +450,82 @@ namespace MathAnim
 			}
 
 			saveCurrentScene();
+			SvgDiskCache::flush();
 		}
 
 		void saveCurrentScene()
 		{
-			// Write data to json files
-			nlohmann::json sceneJson = nlohmann::json();
+			MP_PROFILE_EVENT("Application_SaveCurrentScene");
+
+			// Only the snapshot is taken on the main thread. SVG curves are referenced
+			// instead of copied and get written out along with the CBOR encoding and
+			// disk I/O on the save thread.
+			std::filesystem::path filepath = currentProjectSceneDir / sceneToFilename(sceneData.sceneNames[sceneData.currentScene], binarySceneExtension);
+			// A newer save can replace this one before it runs, so the curves are released
+			// whenever the write function goes away rather than after writing them
+			std::shared_ptr<std::vector<SvgCurvesSnapshot>> svgCurves(
+				new std::vector<SvgCurvesSnapshot>(),
+				[](std::vector<SvgCurvesSnapshot>* curves)
+				{
+					AnimationManager::freeSnapshotCurves(*curves);
+					delete curves;
+				}
+			);
+			nlohmann::json sceneJson = serializeCurrentScene(svgCurves.get());
 
-			// This data should always be present regardless of file version
-			// Container data layout
-			sceneJson["Version"]["Major"] = SERIALIZER_VERSION_MAJOR;
-			sceneJson["Version"]["Minor"] = SERIALIZER_VERSION_MINOR;
-			sceneJson["Version"]["Full"] = std::to_string(SERIALIZER_VERSION_MAJOR) + "." + std::to_string(SERIALIZER_VERSION_MINOR);
+			BackgroundSaver::queueSave(filepath, [sceneJson = std::move(sceneJson), svgCurves](const std::filesystem::path& tmpFilepath) mutable
+			{
+				double startTime = glfwGetTime();
+
+				AnimationManager::writeSnapshotCurves(sceneJson["AnimationManager"], *svgCurves);
+
+				// Binary scene files look like a TableOfContents with
+				// Scene_Header      -> { binarySceneVersion u32, versionMajor u32, versionMinor u32 }
+				// Scene_Data        -> CBOR encoded scene, SVG curves are stored as raw binary
+				std::vector<uint8> sceneBytes = nlohmann::json::to_cbor(sceneJson);
+
+				RawMemory header;
+				header.init(sizeof(uint32) * 3);
+				header.write<uint32>(&binarySceneVersion);
+				header.write<uint32>(&SERIALIZER_VERSION_MAJOR);
+				header.write<uint32>(&SERIALIZER_VERSION_MINOR);
+				header.shrinkToFit();
+
+				RawMemory sceneDataMemory = { sceneBytes.data(), sceneBytes.size(), sceneBytes.size() };
+
+				TableOfContents toc;
+				toc.init();
+				toc.addEntry(header, "Scene_Header");
+				toc.addEntry(sceneDataMemory, "Scene_Data");
+				bool success = toc.serialize(tmpFilepath.string().c_str());
+				toc.free();
+				header.free();
+
+				g_logger_info("Saved scene in {:.2f}ms on the save thread.", (glfwGetTime() - startTime) * 1000.0);
+				return success;
+			});
+		}
 
-			AnimationManager::serialize(am, sceneJson["AnimationManager"]);
-			Timeline::serialize(EditorGui::getTimelineData(), sceneJson["TimelineData"]);
-			sceneJson["EditorCameras"] = serializeCameras();
+		void exportCurrentSceneToJson()
+		{
+			std::filesystem::path jsonFilepath = currentProjectSceneDir / sceneToFilename(sceneData.sceneNames[sceneData.currentScene], ".json");
+			nlohmann::json sceneJson = serializeCurrentScene(nullptr);
 
-			try
+			BackgroundSaver::queueSave(jsonFilepath, [sceneJson = std::move(sceneJson), jsonFilepath](const std::filesystem::path& tmpFilepath)
 			{
-				// TODO: bson should be faster, but it does increase size a bit. Consider switching to
-				// bson files and adding options to export projects as formatted JSON for debugging
-				std::string jsonFilepath = (currentProjectSceneDir / sceneToFilename(sceneData.sceneNames[sceneData.currentScene], ".json")).string();
-				std::ofstream jsonFile(jsonFilepath);
+				std::ofstream jsonFile(tmpFilepath);
 				jsonFile << sceneJson << std::endl;
-			}
-			catch (const std::exception& ex)
-			{
-				g_logger_error("Failed to save current scene with error: '{}'", ex.what());
-			}
+				// Close before checking so a failed flush counts, otherwise the saver
+				// could swap a truncated file in
+				jsonFile.close();
+				if (jsonFile.fail())
+				{
+					return false;
+				}
+
+				g_logger_info("Exported scene to '{}'.", jsonFilepath.string());
+				return true;
+			});
 		}
 
 		void loadProject(const std::filesystem::path& projectRoot)
@@ -532,7 +611,24 @@ namespace MathAnim
 
 		void loadScene(const std::string& sceneName)
 		{
+			// Make sure we don't read a scene that's still being written
+			BackgroundSaver::waitForPendingSaves();
+
 			std::string filepath = (currentProjectSceneDir / sceneToFilename(sceneName, ".json")).string();
+			std::string binaryFilepath = (currentProjectSceneDir / sceneToFilename(sceneName, binarySceneExtension)).string();
+			if (Platform::fileExists(binaryFilepath.c_str()))
+			{
+				// A JSON file that's newer than the binary scene was exported and then
+				// edited by hand, so import it instead
+				std::error_code error;
+				bool jsonIsNewer = Platform::fileExists(filepath.c_str()) &&
+					std::filesystem::last_write_time(filepath, error) > std::filesystem::last_write_time(binaryFilepath, error);
+				if (!jsonIsNewer && loadSceneBinary(binaryFilepath))
+				{
+					return;
+				}
+			}
+
 			if (!Platform::fileExists(filepath.c_str()))
 			{
 				// Check if a legacy project exists and try to load that, if loading fails
@@ -562,35 +658,7 @@ namespace MathAnim
 				std::ifstream inputFile(filepath);
 				nlohmann::json sceneJson;
 				inputFile >> sceneJson;
-
-				// Read version
-				uint32 versionMajor = 0;
-				uint32 versionMinor = 0;
-				if (sceneJson.contains("Version"))
-				{
-					if (sceneJson["Version"].contains("Major") && sceneJson["Version"].contains("Minor"))
-					{
-						versionMajor = sceneJson["Version"]["Major"];
-						versionMinor = sceneJson["Version"]["Minor"];
-					}
-				}
-
-				int loadedProjectCurrentFrame = 0;
-				if (sceneJson.contains("TimelineData") && !sceneJson["TimelineData"].is_null())
-				{
-					TimelineData timeline = Timeline::deserialize(sceneJson["TimelineData"]);
-					EditorGui::setTimelineData(timeline);
-					loadedProjectCurrentFrame = timeline.currentFrame;
-				}
-
-				if (sceneJson.contains("AnimationManager") && !sceneJson["AnimationManager"].is_null())
-				{
-					AnimationManager::deserialize(am, sceneJson["AnimationManager"], loadedProjectCurrentFrame, versionMajor, versionMinor);
-					// Flush any pending objects to be created for real
-					AnimationManager::endFrame(am);
-				}
-
-				deserializeCameras(sceneJson["EditorCameras"], versionMajor);
+				loadSceneFromJson(sceneJson);
 			}
 			catch (const std::exception& ex)
 			{
@@ -672,8 +740,12 @@ namespace MathAnim
 				}
 			}
 
+			BackgroundSaver::waitForPendingSaves();
+
 			std::string filepath = (currentProjectSceneDir / sceneToFilename(sceneName, ".json")).string();
 			remove(filepath.c_str());
+			std::string binaryFilepath = (currentProjectSceneDir / sceneToFilename(sceneName, binarySceneExtension)).string();
+			remove(binaryFilepath.c_str());
 		}
 
 		void changeSceneTo(const std::string& sceneName, bool saveCurrentScene)
@@ -845,6 +917,111 @@ namespace MathAnim
 			return "Scene_" + stringName + ext;
 		}
 
+		static nlohmann::json serializeCurrentScene(std::vector<SvgCurvesSnapshot>* outSvgCurves)
+		{
+			nlohmann::json sceneJson = nlohmann::json();
+
+			// This data should always be present regardless of file version
+			// Container data layout
+			sceneJson["Version"]["Major"] = SERIALIZER_VERSION_MAJOR;
+			sceneJson["Version"]["Minor"] = SERIALIZER_VERSION_MINOR;
+			sceneJson["Version"]["Full"] = std::to_string(SERIALIZER_VERSION_MAJOR) + "." + std::to_string(SERIALIZER_VERSION_MINOR);
+
+			if (outSvgCurves)
+			{
+				AnimationManager::serializeSnapshot(am, sceneJson["AnimationManager"], *outSvgCurves);
+			}
+			else
+			{
+				AnimationManager::serialize(am, sceneJson["AnimationManager"]);
+			}
+			Timeline::serialize(EditorGui::getTimelineData(), sceneJson["TimelineData"]);
+			sceneJson["EditorCameras"] = serializeCameras();
+
+			return sceneJson;
+		}
+
+		static bool loadSceneBinary(const std::string& filepath)
+		{
+			MP_PROFILE_EVENT("Application_LoadSceneBinary");
+			double startTime = glfwGetTime();
+
+			MemMappedFile* file = Platform::memMapFile(filepath.c_str());
+			if (!file)
+			{
+				g_logger_warning("Could not map binary scene '{}'.", filepath);
+				return false;
+			}
+
+			// The CBOR is decoded straight out of the mapping, but it still becomes a full
+			// DOM that goes through the same deserializers as JSON scenes. What this saves
+			// over JSON is text parsing and re-parsing SVG paths, not the DOM itself.
+			TableOfContents toc = TableOfContents::deserializeView(file->data, file->dataSize);
+			RawMemory header = toc.getEntryView("Scene_Header");
+			RawMemory sceneDataMemory = toc.getEntryView("Scene_Data");
+
+			uint32 fileVersion = 0;
+			if (!header.data || !header.read<uint32>(&fileVersion) || fileVersion != binarySceneVersion || !sceneDataMemory.data)
+			{
+				g_logger_warning("Binary scene '{}' has unknown version '{}'. Falling back to JSON.", filepath, fileVersion);
+				Platform::freeMemMappedFile(file);
+				return false;
+			}
+
+			bool success = true;
+			try
+			{
+				nlohmann::json sceneJson = nlohmann::json::from_cbor(sceneDataMemory.data, sceneDataMemory.data + sceneDataMemory.size);
+				loadSceneFromJson(sceneJson);
+			}
+			catch (const std::exception& ex)
+			{
+				g_logger_error("Failed to load binary scene '{}' with error: '{}'", filepath, ex.what());
+				success = false;
+			}
+
+			Platform::freeMemMappedFile(file);
+
+			if (success)
+			{
+				g_logger_info("Loaded scene '{}' in {:.2f}ms.", filepath, (glfwGetTime() - startTime) * 1000.0);
+			}
+
+			return success;
+		}
+
+		static void loadSceneFromJson(const nlohmann::json& sceneJson)
+		{
+			// Read version
+			uint32 versionMajor = 0;
+			uint32 versionMinor = 0;
+			if (sceneJson.contains("Version"))
+			{
+				if (sceneJson["Version"].contains("Major") && sceneJson["Version"].contains("Minor"))
+				{
+					versionMajor = sceneJson["Version"]["Major"];
+					versionMinor = sceneJson["Version"]["Minor"];
+				}
+			}
+
+			int loadedProjectCurrentFrame = 0;
+			if (sceneJson.contains("TimelineData") && !sceneJson["TimelineData"].is_null())
+			{
+				TimelineData timeline = Timeline::deserialize(sceneJson["TimelineData"]);
+				EditorGui::setTimelineData(timeline);
+				loadedProjectCurrentFrame = timeline.currentFrame;
+			}
+
+			if (sceneJson.contains("AnimationManager") && !sceneJson["AnimationManager"].is_null())
+			{
+				AnimationManager::deserialize(am, sceneJson["AnimationManager"], loadedProjectCurrentFrame, versionMajor, versionMinor);
+				// Flush any pending objects to be created for real
+				AnimationManager::endFrame(am);
+			}
+
+			deserializeCameras(sceneJson["EditorCameras"], versionMajor);
+		}
+
 		static void reloadCurrentSceneInternal()
 		{
 			if (saveCurrentSceneOnReload)
@@ -0,0 +1,163 @@
+#include "core/BackgroundSaver.h"
+#include "core/Profiling.h"
+#include "platform/Platform.h"
+
+#include <deque>
+
+namespace MathAnim
+{
+	struct PendingSave
+	{
+		std::filesystem::path filepath;
+		BackgroundSaver::WriteFn writeFn;
+	};
+
+	namespace BackgroundSaver
+	{
+		// ------------- Internal Variables -------------
+		static std::thread saveThread;
+		static std::mutex saveMtx;
+		static std::condition_variable saveCv;
+		static std::condition_variable savesFinishedCv;
+		static std::deque<PendingSave> pendingSaves;
+		static bool saveInProgress = false;
+		static bool doWork = false;
+
+		// ------------- Internal Functions -------------
+		static void saveLoop();
+		static void writeSave(const PendingSave& save);
+
+		void init()
+		{
+			g_logger_assert(!doWork, "BackgroundSaver initialized twice.");
+
+			doWork = true;
+			saveThread = std::thread(saveLoop);
+		}
+
+		void queueSave(const std::filesystem::path& filepath, WriteFn&& writeFn)
+		{
+			{
+				std::lock_guard<std::mutex> lock(saveMtx);
+				g_logger_assert(doWork, "Cannot queue a save before BackgroundSaver::init().");
+
+				// Coalesce with any save to the same file that hasn't started yet
+				auto iter = std::find_if(pendingSaves.begin(), pendingSaves.end(), [&filepath](const PendingSave& save) {
+					return save.filepath == filepath;
+				});
+				if (iter != pendingSaves.end())
+				{
+					iter->writeFn = std::move(writeFn);
+				}
+				else
+				{
+					pendingSaves.emplace_back(PendingSave{ filepath, std::move(writeFn) });
+				}
+			}
+
+			saveCv.notify_one();
+		}
+
+		void waitForPendingSaves()
+		{
+			MP_PROFILE_EVENT("BackgroundSaver_WaitForPendingSaves");
+
+			std::unique_lock<std::mutex> lock(saveMtx);
+			savesFinishedCv.wait(lock, [] { return pendingSaves.empty() && !saveInProgress; });
+		}
+
+		bool isSaving()
+		{
+			std::lock_guard<std::mutex> lock(saveMtx);
+			return !pendingSaves.empty() || saveInProgress;
+		}
+
+		void free()
+		{
+			if (!doWork)
+			{
+				return;
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(saveMtx);
+				doWork = false;
+			}
+			saveCv.notify_one();
+
+			// The save loop drains the queue before exiting
+			saveThread.join();
+		}
+
+		// ------------- Internal Functions -------------
+		static void saveLoop()
+		{
+			while (true)
+			{
+				PendingSave save;
+				{
+					std::unique_lock<std::mutex> lock(saveMtx);
+					saveCv.wait(lock, [] { return !pendingSaves.empty() || !doWork; });
+
+					if (pendingSaves.empty())
+					{
+						// Only reachable once doWork is false and everything has been written
+						break;
+					}
+
+					save = std::move(pendingSaves.front());
+					pendingSaves.pop_front();
+					saveInProgress = true;
+				}
+
+				writeSave(save);
+
+				{
+					std::lock_guard<std::mutex> lock(saveMtx);
+					saveInProgress = false;
+				}
+				savesFinishedCv.notify_all();
+			}
+		}
+
+		static void writeSave(const PendingSave& save)
+		{
+			MP_PROFILE_EVENT("BackgroundSaver_WriteSave");
+
+			std::filesystem::path tmpFilepath = save.filepath;
+			tmpFilepath += ".tmp";
+
+			bool success = false;
+			try
+			{
+				success = save.writeFn(tmpFilepath);
+			}
+			catch (const std::exception& ex)
+			{
+				g_logger_error("Failed to save '{}' with error: '{}'", save.filepath.string(), ex.what());
+			}
+
+			// Make sure the new file is actually on disk before it replaces the old one,
+			// otherwise a crash right after the rename can leave a truncated save behind
+			if (success)
+			{
+				success = Platform::syncFileToDisk(tmpFilepath.string().c_str());
+			}
+
+			if (!success)
+			{
+				g_logger_warning("Save to '{}' failed. Keeping the previous file.", save.filepath.string());
+				std::error_code error;
+				std::filesystem::remove(tmpFilepath, error);
+				return;
+			}
+
+			std::error_code error;
+			std::filesystem::rename(tmpFilepath, save.filepath, error);
+			if (error)
+			{
+				g_logger_error("Failed to replace '{}' after saving. Error: '{}'", save.filepath.string(), error.message());
+			}
+		}
+	}
+}
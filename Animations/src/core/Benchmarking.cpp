@@ -0,0 +1,448 @@
+#ifdef _MATH_ANIM_BENCHMARKS
+#include "core/Benchmarking.h"
+#include "platform/Platform.h"
+
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstdlib>
+
+// See here for more escape code colors https://gist.github.com/fnky/458719343aabd01cfb17a3a4f7296797
+#define ANSI_COLOR_RED     "\u001b[38;5;167m"
+#define ANSI_COLOR_GREEN   "\u001b[38;5;84m"
+#define ANSI_COLOR_YELLOW  "\u001b[38;5;220m"
+#define ANSI_COLOR_RESET   "\u001b[0m"
+
+namespace MathAnim
+{
+	// ----------------- Internal structures -----------------
+	struct BenchmarkPrototype
+	{
+		std::string name;
+		BenchmarkFn fn;
+	};
+
+	struct BenchmarkSuite
+	{
+		const char* name;
+		std::vector<BenchmarkPrototype> benchmarks;
+	};
+
+	struct BenchmarkResult
+	{
+		std::string name;
+		const char* skipReason;
+		uint32 numSamples;
+		double minMs;
+		double medianMs;
+		double meanMs;
+		double maxMs;
+		double stdDevMs;
+	};
+
+	bool BenchmarkState::keepRunning()
+	{
+		auto now = std::chrono::high_resolution_clock::now();
+		if (skipReason)
+		{
+			return false;
+		}
+
+		// The iteration that just finished counts once the warmup is done
+		if (iteration > numWarmupIterations)
+		{
+			double elapsedMs = std::chrono::duration<double, std::milli>(now - sampleStart).count();
+			sampleMs.push_back(elapsedMs - pausedMs);
+		}
+
+		if (iteration >= numWarmupIterations + numSamples)
+		{
+			return false;
+		}
+
+		iteration++;
+		pausedMs = 0.0;
+		sampleStart = std::chrono::high_resolution_clock::now();
+		return true;
+	}
+
+	void BenchmarkState::pauseTiming()
+	{
+		pauseStart = std::chrono::high_resolution_clock::now();
+	}
+
+	void BenchmarkState::resumeTiming()
+	{
+		auto now = std::chrono::high_resolution_clock::now();
+		pausedMs += std::chrono::duration<double, std::milli>(now - pauseStart).count();
+	}
+
+	void BenchmarkState::skip(const char* reason)
+	{
+		skipReason = reason;
+	}
+
+	namespace Benchmarks
+	{
+		// ----------------- Internal variables -----------------
+		static std::vector<BenchmarkSuite> benchmarkSuites = {};
+		static constexpr int resultsFileVersion = 1;
+
+		// ----------------- Internal functions -----------------
+		static BenchmarkResult runBenchmark(const std::string& name, BenchmarkFn fn, const BenchmarkOptions& options);
+		static nlohmann::json serializeResults(const std::vector<BenchmarkResult>& results);
+		static bool writeResults(const std::string& filepath, const std::vector<BenchmarkResult>& results);
+		static int compareAgainstBaseline(const std::vector<BenchmarkResult>& results, const BenchmarkOptions& options);
+		static void printUsage();
+
+		BenchmarkSuite& addBenchmarkSuite(const char* benchmarkSuiteName)
+		{
+			BenchmarkSuite res = {};
+			res.name = benchmarkSuiteName;
+			benchmarkSuites.push_back(res);
+
+			return benchmarkSuites[benchmarkSuites.size() - 1];
+		}
+
+		void addBenchmark(BenchmarkSuite& benchmarkSuite, const char* benchmarkName, BenchmarkFn fn)
+		{
+			BenchmarkPrototype benchmark = {};
+			benchmark.name = std::string(benchmarkSuite.name) + "/" + benchmarkName;
+			benchmark.fn = fn;
+			benchmarkSuite.benchmarks.push_back(benchmark);
+		}
+
+		BenchmarkOptions defaultOptions()
+		{
+			BenchmarkOptions res = {};
+			res.outputFilepath = "benchmarkResults.json";
+			res.baselineFilepath = "";
+			res.updateBaseline = false;
+			res.regressionThresholdPercent = 10.0f;
+			res.filter = "";
+			res.numWarmupIterations = 3;
+			res.numSamples = 25;
+			return res;
+		}
+
+		bool parseCommandLine(int argc, char** argv, BenchmarkOptions* options)
+		{
+			for (int i = 1; i < argc; i++)
+			{
+				std::string arg = argv[i];
+				bool hasValue = i + 1 < argc;
+				if (arg == "--help")
+				{
+					printUsage();
+					return false;
+				}
+
+				if (arg == "--update-baseline")
+				{
+					options->updateBaseline = true;
+					continue;
+				}
+
+				if (!hasValue)
+				{
+					printf("Missing value for argument '%s'.\n", arg.c_str());
+					printUsage();
+					return false;
+				}
+
+				const char* value = argv[++i];
+				if (arg == "--out")
+				{
+					options->outputFilepath = value;
+				}
+				else if (arg == "--baseline")
+				{
+					options->baselineFilepath = value;
+				}
+				else if (arg == "--threshold")
+				{
+					options->regressionThresholdPercent = (float)std::atof(value);
+				}
+				else if (arg == "--filter")
+				{
+					options->filter = value;
+				}
+				else if (arg == "--warmup")
+				{
+					options->numWarmupIterations = (uint32)std::max(std::atoi(value), 0);
+				}
+				else if (arg == "--samples")
+				{
+					options->numSamples = (uint32)std::max(std::atoi(value), 1);
+				}
+				else
+				{
+					printf("Unknown argument '%s'.\n", arg.c_str());
+					printUsage();
+					return false;
+				}
+			}
+
+			if (options->updateBaseline && options->baselineFilepath.empty())
+			{
+				printf("--update-baseline needs a --baseline file to write to.\n");
+				return false;
+			}
+
+			return true;
+		}
+
+		int runBenchmarks(const BenchmarkOptions& options)
+		{
+			std::vector<BenchmarkResult> results = {};
+			for (const auto& benchmarkSuite : benchmarkSuites)
+			{
+				for (const auto& benchmark : benchmarkSuite.benchmarks)
+				{
+					if (!options.filter.empty() && benchmark.name.find(options.filter) == std::string::npos)
+					{
+						continue;
+					}
+
+					BenchmarkResult result = runBenchmark(benchmark.name, benchmark.fn, options);
+					if (result.skipReason)
+					{
+						printf(
+							ANSI_COLOR_YELLOW
+							"  + Skipped "
+							ANSI_COLOR_RESET
+							"'%s': %s\n",
+							result.name.c_str(),
+							result.skipReason
+						);
+						continue;
+					}
+
+					printf("  %-60s median %10.4fms  min %10.4fms  mean %10.4fms  stddev %8.4fms\n",
+						result.name.c_str(),
+						result.medianMs,
+						result.minMs,
+						result.meanMs,
+						result.stdDevMs
+					);
+					results.emplace_back(result);
+				}
+			}
+
+			if (!options.outputFilepath.empty())
+			{
+				writeResults(options.outputFilepath, results);
+			}
+
+			if (options.baselineFilepath.empty())
+			{
+				return 0;
+			}
+
+			if (options.updateBaseline)
+			{
+				if (writeResults(options.baselineFilepath, results))
+				{
+					printf("\n  Updated baseline '%s'\n\n", options.baselineFilepath.c_str());
+				}
+				return 0;
+			}
+
+			return compareAgainstBaseline(results, options);
+		}
+
+		void free()
+		{
+			benchmarkSuites.clear();
+		}
+
+		// ----------------- Internal functions -----------------
+		static BenchmarkResult runBenchmark(const std::string& name, BenchmarkFn fn, const BenchmarkOptions& options)
+		{
+			BenchmarkState state = {};
+			state.numWarmupIterations = options.numWarmupIterations;
+			state.numSamples = options.numSamples;
+			state.skipReason = nullptr;
+			fn(state);
+
+			BenchmarkResult res = {};
+			res.name = name;
+			res.skipReason = state.skipReason;
+			if (state.skipReason == nullptr && state.sampleMs.empty())
+			{
+				res.skipReason = "Benchmark never called keepRunning()";
+			}
+			if (res.skipReason)
+			{
+				return res;
+			}
+
+			std::vector<double> sorted = state.sampleMs;
+			std::sort(sorted.begin(), sorted.end());
+			size_t middle = sorted.size() / 2;
+
+			res.numSamples = (uint32)sorted.size();
+			res.minMs = sorted[0];
+			res.maxMs = sorted[sorted.size() - 1];
+			res.medianMs = sorted.size() % 2 == 0
+				? (sorted[middle - 1] + sorted[middle]) / 2.0
+				: sorted[middle];
+
+			double sum = 0.0;
+			for (double sample : sorted)
+			{
+				sum += sample;
+			}
+			res.meanMs = sum / (double)sorted.size();
+
+			double variance = 0.0;
+			for (double sample : sorted)
+			{
+				variance += (sample - res.meanMs) * (sample - res.meanMs);
+			}
+			res.stdDevMs = glm::sqrt(variance / (double)sorted.size());
+
+			return res;
+		}
+
+		static nlohmann::json serializeResults(const std::vector<BenchmarkResult>& results)
+		{
+			nlohmann::json res = {};
+			res["Version"] = resultsFileVersion;
+			res["Benchmarks"] = nlohmann::json::object();
+			for (const auto& result : results)
+			{
+				nlohmann::json& entry = res["Benchmarks"][result.name];
+				entry["Samples"] = result.numSamples;
+				entry["MinMs"] = result.minMs;
+				entry["MedianMs"] = result.medianMs;
+				entry["MeanMs"] = result.meanMs;
+				entry["MaxMs"] = result.maxMs;
+				entry["StdDevMs"] = result.stdDevMs;
+			}
+
+			return res;
+		}
+
+		static bool writeResults(const std::string& filepath, const std::vector<BenchmarkResult>& results)
+		{
+			try
+			{
+				std::ofstream jsonFile(filepath);
+				jsonFile << serializeResults(results).dump(4) << std::endl;
+				return true;
+			}
+			catch (const std::exception& ex)
+			{
+				g_logger_error("Failed to write benchmark results to '{}' with error: '{}'", filepath, ex.what());
+			}
+
+			return false;
+		}
+
+		static int compareAgainstBaseline(const std::vector<BenchmarkResult>& results, const BenchmarkOptions& options)
+		{
+			if (!Platform::fileExists(options.baselineFilepath.c_str()))
+			{
+				printf("\n  No baseline found at '%s', run with --update-baseline to record one.\n\n", options.baselineFilepath.c_str());
+				return 0;
+			}
+
+			nlohmann::json baseline;
+			try
+			{
+				std::ifstream file(options.baselineFilepath);
+				baseline = nlohmann::json::parse(file);
+			}
+			catch (const nlohmann::json::parse_error& ex)
+			{
+				g_logger_error("Could not load benchmark baseline '{}' as Json.\n\tJson Error: '{}'", options.baselineFilepath, ex.what());
+				return 0;
+			}
+
+			if (!baseline.contains("Version") || baseline["Version"] != resultsFileVersion || !baseline.contains("Benchmarks"))
+			{
+				g_logger_error("Benchmark baseline '{}' was written by an incompatible version.", options.baselineFilepath);
+				return 0;
+			}
+
+			printf("\n  Comparing against baseline '%s' (threshold %.1f%%)...\n\n", options.baselineFilepath.c_str(), options.regressionThresholdPercent);
+
+			int numRegressions = 0;
+			const nlohmann::json& baselineBenchmarks = baseline["Benchmarks"];
+			for (const auto& result : results)
+			{
+				if (!baselineBenchmarks.contains(result.name))
+				{
+					printf("      + New       '%s'\n", result.name.c_str());
+					continue;
+				}
+
+				double baselineMedianMs = baselineBenchmarks[result.name].value("MedianMs", 0.0);
+				if (baselineMedianMs <= 0.0)
+				{
+					continue;
+				}
+
+				double changePercent = (result.medianMs - baselineMedianMs) / baselineMedianMs * 100.0;
+				if (changePercent > options.regressionThresholdPercent)
+				{
+					numRegressions++;
+					printf(
+						ANSI_COLOR_RED
+						"      + Regressed "
+						ANSI_COLOR_RESET
+						"'%s' %+.1f%% (%.4fms -> %.4fms)\n",
+						result.name.c_str(),
+						changePercent,
+						baselineMedianMs,
+						result.medianMs
+					);
+				}
+				else if (changePercent < -options.regressionThresholdPercent)
+				{
+					printf(
+						ANSI_COLOR_GREEN
+						"      + Improved  "
+						ANSI_COLOR_RESET
+						"'%s' %+.1f%% (%.4fms -> %.4fms)\n",
+						result.name.c_str(),
+						changePercent,
+						baselineMedianMs,
+						result.medianMs
+					);
+				}
+				else
+				{
+					printf("      + Unchanged '%s' %+.1f%%\n", result.name.c_str(), changePercent);
+				}
+			}
+
+			printf("\n  Number of Regressions "
+				ANSI_COLOR_YELLOW
+				"%d/%d\n\n"
+				ANSI_COLOR_RESET,
+				numRegressions,
+				(int)results.size()
+			);
+
+			return numRegressions;
+		}
+
+		static void printUsage()
+		{
+			printf(
+				"Usage: MathAnimationsBenchmarks [options]\n"
+				"  --out <file>          Write results as JSON to <file> (default benchmarkResults.json)\n"
+				"  --baseline <file>     Compare the results against a previous run\n"
+				"  --update-baseline     Overwrite the --baseline file with this run instead of comparing\n"
+				"  --threshold <percent> Slowdown in the median that counts as a regression (default 10)\n"
+				"  --filter <text>       Only run benchmarks whose Suite/name contains <text>\n"
+				"  --warmup <n>          Untimed iterations before sampling (default 3)\n"
+				"  --samples <n>         Timed iterations per benchmark (default 25)\n"
+				"  --help                Print this message\n"
+			);
+		}
+	}
+}
+
+#endif
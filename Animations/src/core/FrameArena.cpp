@@ -0,0 +1,177 @@
+#include "core/FrameArena.h"
+
+#include <atomic>
+
+namespace MathAnim
+{
+	struct ArenaBlock
+	{
+		uint8* memory;
+		size_t size;
+		size_t offset;
+	};
+
+	namespace FrameArena
+	{
+		// ------------- Internal Variables -------------
+		static constexpr size_t defaultBlockSize = MB(1);
+		static std::vector<ArenaBlock> blocks = {};
+		static void* lastAllocation = nullptr;
+		static size_t bytesUsed = 0;
+		static size_t highWaterMark = 0;
+		// Read by owns() on any thread, only written by the owner
+		static std::atomic<std::thread::id> ownerThread = std::thread::id();
+
+		// ------------- Internal Functions -------------
+		static ArenaBlock& addBlock(size_t minSize);
+		static size_t alignUp(size_t offset, size_t alignment);
+
+		void* allocate(size_t numBytes, size_t alignment)
+		{
+			if (ownerThread.load() == std::thread::id())
+			{
+				ownerThread = std::this_thread::get_id();
+			}
+			g_logger_assert(ownerThread.load() == std::this_thread::get_id(), "FrameArena can only be used from the main thread.");
+
+			if (numBytes == 0)
+			{
+				numBytes = 1;
+			}
+
+			ArenaBlock* block = blocks.empty() ? nullptr : &blocks.back();
+			size_t offset = block ? alignUp(block->offset, alignment) : 0;
+			if (!block || offset + numBytes > block->size)
+			{
+				block = &addBlock(numBytes + alignment);
+				offset = alignUp(block->offset, alignment);
+			}
+
+			void* result = block->memory + offset;
+			bytesUsed += (offset - block->offset) + numBytes;
+			highWaterMark = glm::max(highWaterMark, bytesUsed);
+			block->offset = offset + numBytes;
+			lastAllocation = result;
+
+			return result;
+		}
+
+		void* reallocate(void* ptr, size_t oldNumBytes, size_t newNumBytes, size_t alignment)
+		{
+			if (!ptr)
+			{
+				return allocate(newNumBytes, alignment);
+			}
+
+			g_logger_assert(owns(ptr), "Tried to reallocate memory that doesn't belong to the FrameArena.");
+
+			// Bump the last allocation in place when there's room
+			if (ptr == lastAllocation)
+			{
+				ArenaBlock& block = blocks.back();
+				size_t start = (uint8*)ptr - block.memory;
+				if (start + newNumBytes <= block.size)
+				{
+					bytesUsed = bytesUsed - (block.offset - start) + newNumBytes;
+					highWaterMark = glm::max(highWaterMark, bytesUsed);
+					block.offset = start + newNumBytes;
+					return ptr;
+				}
+			}
+
+			void* result = allocate(newNumBytes, alignment);
+			g_memory_copyMem(result, ptr, glm::min(oldNumBytes, newNumBytes));
+			return result;
+		}
+
+		bool owns(const void* ptr)
+		{
+			// Other threads can't allocate from the arena so nothing they hold is frame memory.
+			// Bailing out here also keeps them from walking blocks while the owner grows or resets it.
+			if (ownerThread.load() != std::this_thread::get_id())
+			{
+				return false;
+			}
+
+			for (const ArenaBlock& block : blocks)
+			{
+				if ((const uint8*)ptr >= block.memory && (const uint8*)ptr < block.memory + block.size)
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		void reset()
+		{
+			if (blocks.size() > 1)
+			{
+				// The frame overflowed the first block, so make one block that fits
+				// everything to avoid chaining again next frame
+				size_t totalSize = 0;
+				for (const ArenaBlock& block : blocks)
+				{
+					totalSize += block.size;
+					g_memory_free(block.memory);
+				}
+				blocks.clear();
+				addBlock(totalSize);
+			}
+			else if (blocks.size() == 1)
+			{
+#ifdef _DEBUG
+				// Make use-after-reset bugs obvious
+				g_memory_zeroMem(blocks[0].memory, blocks[0].offset);
+#endif
+				blocks[0].offset = 0;
+			}
+
+			lastAllocation = nullptr;
+			bytesUsed = 0;
+		}
+
+		size_t getBytesUsed()
+		{
+			return bytesUsed;
+		}
+
+		size_t getHighWaterMark()
+		{
+			return highWaterMark;
+		}
+
+		void free()
+		{
+			for (const ArenaBlock& block : blocks)
+			{
+				g_memory_free(block.memory);
+			}
+			blocks.clear();
+
+			lastAllocation = nullptr;
+			bytesUsed = 0;
+			highWaterMark = 0;
+			ownerThread = {};
+		}
+
+		// ------------- Internal Functions -------------
+		static ArenaBlock& addBlock(size_t minSize)
+		{
+			ArenaBlock block;
+			block.size = glm::max(minSize, defaultBlockSize);
+			block.memory = (uint8*)g_memory_allocate(block.size);
+			block.offset = 0;
+			g_logger_assert(block.memory != nullptr, "Ran out of RAM.");
+
+			blocks.push_back(block);
+			return blocks.back();
+		}
+
+		static size_t alignUp(size_t offset, size_t alignment)
+		{
+			return (offset + alignment - 1) & ~(alignment - 1);
+		}
+	}
+}
@@ -0,0 +1,158 @@
+#include "core/MemoryTracker.h"
+
+#include <atomic>
+
+namespace MathAnim
+{
+	struct MemoryTagCounters
+	{
+		std::atomic<size_t> currentBytes;
+		std::atomic<size_t> peakBytes;
+		std::atomic<size_t> numLiveAllocations;
+		std::atomic<size_t> numTotalAllocations;
+		std::atomic<bool> isOverBudget;
+	};
+
+	namespace MemoryTracker
+	{
+		// ---- Internal Variables ----
+		static MemoryTagCounters counters[(size_t)MemoryTag::Length] = {};
+		// Constant initialized so allocations from other static initializers already see these
+		static std::atomic<size_t> budgets[(size_t)MemoryTag::Length] = {
+			0,
+			0,
+			(size_t)MB(512),
+			(size_t)MB(64),
+			0,
+			(size_t)MB(256),
+			0,
+			0
+		};
+
+		static thread_local MemoryTag currentTag = MemoryTag::Length;
+
+		// ---- Internal Functions ----
+		static MemoryTagCounters& getCounters(MemoryTag tag);
+		static void checkBudget(MemoryTag tag, MemoryTagCounters& tagCounters, size_t currentBytes);
+
+		void recordAllocation(MemoryTag tag, size_t numBytes)
+		{
+			MemoryTagCounters& tagCounters = getCounters(tag);
+			size_t currentBytes = tagCounters.currentBytes.fetch_add(numBytes, std::memory_order_relaxed) + numBytes;
+			tagCounters.numLiveAllocations.fetch_add(1, std::memory_order_relaxed);
+			tagCounters.numTotalAllocations.fetch_add(1, std::memory_order_relaxed);
+			checkBudget(tag, tagCounters, currentBytes);
+		}
+
+		void recordFree(MemoryTag tag, size_t numBytes)
+		{
+			MemoryTagCounters& tagCounters = getCounters(tag);
+			size_t currentBytes = tagCounters.currentBytes.fetch_sub(numBytes, std::memory_order_relaxed) - numBytes;
+			tagCounters.numLiveAllocations.fetch_sub(1, std::memory_order_relaxed);
+			checkBudget(tag, tagCounters, currentBytes);
+		}
+
+		void recordReallocation(MemoryTag tag, size_t oldNumBytes, size_t newNumBytes)
+		{
+			if (oldNumBytes == 0)
+			{
+				recordAllocation(tag, newNumBytes);
+				return;
+			}
+
+			MemoryTagCounters& tagCounters = getCounters(tag);
+			size_t currentBytes = tagCounters.currentBytes.fetch_add(newNumBytes - oldNumBytes, std::memory_order_relaxed) + (newNumBytes - oldNumBytes);
+			checkBudget(tag, tagCounters, currentBytes);
+		}
+
+		void setBudget(MemoryTag tag, size_t budgetBytes)
+		{
+			MemoryTagCounters& tagCounters = getCounters(tag);
+			budgets[(size_t)tag].store(budgetBytes, std::memory_order_relaxed);
+			tagCounters.isOverBudget.store(false, std::memory_order_relaxed);
+			checkBudget(tag, tagCounters, tagCounters.currentBytes.load(std::memory_order_relaxed));
+		}
+
+		MemoryTagStats getStats(MemoryTag tag)
+		{
+			const MemoryTagCounters& tagCounters = getCounters(tag);
+			MemoryTagStats res;
+			res.currentBytes = tagCounters.currentBytes.load(std::memory_order_relaxed);
+			res.peakBytes = tagCounters.peakBytes.load(std::memory_order_relaxed);
+			res.numLiveAllocations = tagCounters.numLiveAllocations.load(std::memory_order_relaxed);
+			res.numTotalAllocations = tagCounters.numTotalAllocations.load(std::memory_order_relaxed);
+			res.budgetBytes = budgets[(size_t)tag].load(std::memory_order_relaxed);
+			return res;
+		}
+
+		void resetPeaks()
+		{
+			for (size_t i = 0; i < (size_t)MemoryTag::Length; i++)
+			{
+				counters[i].peakBytes.store(counters[i].currentBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			}
+		}
+
+		MemoryTag getCurrentTag(MemoryTag fallback)
+		{
+			return currentTag != MemoryTag::Length
+				? currentTag
+				: fallback;
+		}
+
+		ScopedTag::ScopedTag(MemoryTag tag)
+		{
+			isOutermost = currentTag == MemoryTag::Length;
+			if (isOutermost)
+			{
+				currentTag = tag;
+			}
+		}
+
+		ScopedTag::~ScopedTag()
+		{
+			if (isOutermost)
+			{
+				currentTag = MemoryTag::Length;
+			}
+		}
+
+		// ---- Internal Functions ----
+		static MemoryTagCounters& getCounters(MemoryTag tag)
+		{
+			g_logger_assert(tag < MemoryTag::Length, "Invalid memory tag '{}'.", (size_t)tag);
+			return counters[(size_t)tag];
+		}
+
+		static void checkBudget(MemoryTag tag, MemoryTagCounters& tagCounters, size_t currentBytes)
+		{
+			size_t peakBytes = tagCounters.peakBytes.load(std::memory_order_relaxed);
+			while (currentBytes > peakBytes &&
+				!tagCounters.peakBytes.compare_exchange_weak(peakBytes, currentBytes, std::memory_order_relaxed))
+			{
+			}
+
+			size_t budgetBytes = budgets[(size_t)tag].load(std::memory_order_relaxed);
+			if (budgetBytes == 0)
+			{
+				return;
+			}
+
+			if (currentBytes > budgetBytes)
+			{
+				if (!tagCounters.isOverBudget.exchange(true, std::memory_order_relaxed))
+				{
+					g_logger_warning("'{}' went over its memory budget. Using {:.2f} MB of the {:.2f} MB budget.",
+						_memoryTagNames[(size_t)tag],
+						(float)currentBytes / (float)MB(1),
+						(float)budgetBytes / (float)MB(1)
+					);
+				}
+			}
+			else
+			{
+				tagCounters.isOverBudget.store(false, std::memory_order_relaxed);
+			}
+		}
+	}
+}
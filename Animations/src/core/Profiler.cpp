@@ -0,0 +1,445 @@
+#include "core/Profiler.h"
+#include "core/MemoryTracker.h"
+#include "renderer/GLApi.h"
+
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <deque>
+#include <chrono>
+
+namespace MathAnim
+{
+	// One per thread that ever recorded an event. Only the owning thread writes events and
+	// moves writeIndex forward, readers copy what's there and throw away anything that
+	// could have been overwritten while they were copying.
+	struct ProfilerThreadBuffer
+	{
+		std::string name;
+		uint32 id;
+		ProfilerEvent* events;
+		std::atomic<uint64> writeIndex;
+		uint32 depth;
+		// Owning thread only
+		std::unordered_set<std::string> internedNames;
+	};
+
+	struct PendingGpuEvent
+	{
+		const char* name;
+		GLuint startQuery;
+		GLuint endQuery;
+		uint32 depth;
+	};
+
+	namespace Profiler
+	{
+		// ---- Internal Variables ----
+		static constexpr uint64 eventsPerThread = 1 << 14;
+		static constexpr uint64 maxFrames = 512;
+		static constexpr GLsizei numGpuQueries = 512;
+
+		static std::atomic<bool> recording = false;
+		static std::atomic<bool> paused = false;
+		// Bumped by free() so threads know their cached buffer pointer is gone
+		static std::atomic<uint32> bufferGeneration = 0;
+
+		static std::mutex threadBuffersMtx;
+		static std::vector<ProfilerThreadBuffer*> threadBuffers;
+		static uint32 nextTrackId = 0;
+
+		// Main thread only
+		static ProfilerFrame frames[maxFrames];
+		static uint64 frameWriteIndex = 0;
+		static uint64 currentFrameStartNs = 0;
+
+		// Main thread only
+		static ProfilerThreadBuffer* gpuBuffer = nullptr;
+		static std::vector<GLuint> freeGpuQueries;
+		static std::vector<GLuint> allGpuQueries;
+		static std::vector<PendingGpuEvent> openGpuEvents;
+		static std::deque<PendingGpuEvent> finishedGpuEvents;
+		static int64 gpuToCpuOffsetNs = 0;
+
+		static thread_local std::string threadName = "";
+
+		// ---- Internal Functions ----
+		static ProfilerThreadBuffer* createBuffer(const char* name);
+		static ProfilerThreadBuffer* getThreadBuffer();
+		static void writeEvent(ProfilerThreadBuffer* buffer, const ProfilerEvent& event);
+		static void copyEvents(ProfilerThreadBuffer* buffer, uint64 startNs, uint64 endNs, std::vector<ProfilerEvent>& out);
+		static void collectGpuEvents();
+
+		void init()
+		{
+			recording = true;
+			setThreadName("Main Thread");
+
+			gpuBuffer = createBuffer("GPU");
+			if (GL::supportsTimerQueries())
+			{
+				allGpuQueries.resize(numGpuQueries);
+				GL::genQueries(numGpuQueries, allGpuQueries.data());
+				freeGpuQueries = allGpuQueries;
+			}
+			else
+			{
+				g_logger_info("GPU timer queries aren't supported, the profiler won't time GPU passes.");
+			}
+		}
+
+		void free()
+		{
+			recording = false;
+
+			// The GL context is already gone by the time every thread has been joined, the
+			// queries were released along with it
+			allGpuQueries.clear();
+			freeGpuQueries.clear();
+			openGpuEvents.clear();
+			finishedGpuEvents.clear();
+			gpuBuffer = nullptr;
+
+			std::lock_guard<std::mutex> lock(threadBuffersMtx);
+			for (ProfilerThreadBuffer* buffer : threadBuffers)
+			{
+				MemoryTracker::recordFree(MemoryTag::Profiler, sizeof(ProfilerEvent) * eventsPerThread);
+				g_memory_free(buffer->events);
+				buffer->~ProfilerThreadBuffer();
+				g_memory_free(buffer);
+			}
+			threadBuffers.clear();
+			bufferGeneration++;
+		}
+
+		uint64 nowNs()
+		{
+			static const auto epoch = std::chrono::steady_clock::now();
+			return (uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+		}
+
+		void beginFrame()
+		{
+			if (!recording)
+			{
+				return;
+			}
+
+			collectGpuEvents();
+
+			// Re-sync the GPU clock every frame since the two clocks drift apart
+			if (allGpuQueries.size() > 0)
+			{
+				GLint64 gpuNowNs = 0;
+				GL::getInteger64v(GL_TIMESTAMP, &gpuNowNs);
+				gpuToCpuOffsetNs = (int64)nowNs() - (int64)gpuNowNs;
+			}
+
+			currentFrameStartNs = nowNs();
+		}
+
+		void endFrame()
+		{
+			if (!recording || paused)
+			{
+				return;
+			}
+
+			frames[frameWriteIndex % maxFrames] = { currentFrameStartNs, nowNs() };
+			frameWriteIndex++;
+		}
+
+		void setThreadName(const char* name)
+		{
+			// Threads can be named before the profiler starts, the name gets used once
+			// their buffer is created
+			threadName = name;
+
+			ProfilerThreadBuffer* buffer = getThreadBuffer();
+			if (buffer)
+			{
+				std::lock_guard<std::mutex> lock(threadBuffersMtx);
+				buffer->name = name;
+			}
+		}
+
+		const char* internName(const char* name)
+		{
+			ProfilerThreadBuffer* buffer = getThreadBuffer();
+			if (!buffer)
+			{
+				return name;
+			}
+
+			return buffer->internedNames.insert(name).first->c_str();
+		}
+
+		uint32 pushDepth()
+		{
+			ProfilerThreadBuffer* buffer = getThreadBuffer();
+			return buffer ? buffer->depth++ : 0;
+		}
+
+		void popDepth()
+		{
+			ProfilerThreadBuffer* buffer = getThreadBuffer();
+			if (buffer && buffer->depth > 0)
+			{
+				buffer->depth--;
+			}
+		}
+
+		void recordEvent(const char* name, uint64 startNs, uint64 endNs, uint32 depth)
+		{
+			if (paused)
+			{
+				return;
+			}
+
+			ProfilerThreadBuffer* buffer = getThreadBuffer();
+			if (buffer)
+			{
+				writeEvent(buffer, { name, startNs, endNs, depth });
+			}
+		}
+
+		void beginGpuEvent(const char* name)
+		{
+			PendingGpuEvent event = {};
+			event.name = name;
+			event.depth = (uint32)openGpuEvents.size();
+
+			// Out of queries means the GPU is too far behind, skip this one instead of stalling
+			if (recording && !paused && freeGpuQueries.size() >= 2)
+			{
+				event.startQuery = freeGpuQueries.back();
+				freeGpuQueries.pop_back();
+				event.endQuery = freeGpuQueries.back();
+				freeGpuQueries.pop_back();
+				GL::queryCounter(event.startQuery, GL_TIMESTAMP);
+			}
+
+			openGpuEvents.push_back(event);
+		}
+
+		void endGpuEvent()
+		{
+			if (openGpuEvents.empty())
+			{
+				return;
+			}
+
+			PendingGpuEvent event = openGpuEvents.back();
+			openGpuEvents.pop_back();
+			if (event.endQuery != 0)
+			{
+				GL::queryCounter(event.endQuery, GL_TIMESTAMP);
+				finishedGpuEvents.push_back(event);
+			}
+		}
+
+		void setPaused(bool inPaused)
+		{
+			paused = inPaused;
+		}
+
+		bool isPaused()
+		{
+			return paused;
+		}
+
+		std::vector<ProfilerFrame> getFrames()
+		{
+			std::vector<ProfilerFrame> res;
+			uint64 first = frameWriteIndex > maxFrames ? frameWriteIndex - maxFrames : 0;
+			res.reserve((size_t)(frameWriteIndex - first));
+			for (uint64 i = first; i < frameWriteIndex; i++)
+			{
+				res.push_back(frames[i % maxFrames]);
+			}
+
+			return res;
+		}
+
+		std::vector<ProfilerTrack> getTracks(uint64 startNs, uint64 endNs)
+		{
+			std::vector<ProfilerTrack> res;
+
+			std::lock_guard<std::mutex> lock(threadBuffersMtx);
+			res.reserve(threadBuffers.size());
+			for (ProfilerThreadBuffer* buffer : threadBuffers)
+			{
+				ProfilerTrack track;
+				track.name = buffer->name;
+				track.id = buffer->id;
+				copyEvents(buffer, startNs, endNs, track.events);
+				res.emplace_back(std::move(track));
+			}
+
+			return res;
+		}
+
+		bool exportChromeTrace(const std::filesystem::path& filepath, uint64 startNs)
+		{
+			std::vector<ProfilerTrack> tracks = getTracks(startNs);
+
+			nlohmann::json trace = {};
+			trace["displayTimeUnit"] = "ms";
+			nlohmann::json& traceEvents = trace["traceEvents"];
+			traceEvents = nlohmann::json::array();
+			for (const ProfilerTrack& track : tracks)
+			{
+				nlohmann::json threadName = {};
+				threadName["name"] = "thread_name";
+				threadName["ph"] = "M";
+				threadName["pid"] = 1;
+				threadName["tid"] = track.id;
+				threadName["args"]["name"] = track.name;
+				traceEvents.push_back(threadName);
+
+				for (const ProfilerEvent& event : track.events)
+				{
+					// Trace timestamps are in microseconds
+					nlohmann::json traceEvent = {};
+					traceEvent["name"] = event.name;
+					traceEvent["ph"] = "X";
+					traceEvent["pid"] = 1;
+					traceEvent["tid"] = track.id;
+					traceEvent["ts"] = (double)event.startNs / 1000.0;
+					traceEvent["dur"] = (double)(event.endNs - event.startNs) / 1000.0;
+					traceEvents.push_back(traceEvent);
+				}
+			}
+
+			try
+			{
+				std::ofstream traceFile(filepath);
+				traceFile << trace << std::endl;
+			}
+			catch (const std::exception& ex)
+			{
+				g_logger_error("Failed to write profiler trace to '{}' with error: '{}'", filepath, ex.what());
+				return false;
+			}
+
+			g_logger_info("Wrote profiler trace to '{}'", filepath);
+			return true;
+		}
+
+		// ---- Internal Functions ----
+		static ProfilerThreadBuffer* createBuffer(const char* name)
+		{
+			void* bufferMemory = g_memory_allocate(sizeof(ProfilerThreadBuffer));
+			ProfilerThreadBuffer* res = new(bufferMemory)ProfilerThreadBuffer();
+			res->events = (ProfilerEvent*)g_memory_allocate(sizeof(ProfilerEvent) * eventsPerThread);
+			MemoryTracker::recordAllocation(MemoryTag::Profiler, sizeof(ProfilerEvent) * eventsPerThread);
+			res->writeIndex = 0;
+			res->depth = 0;
+
+			std::lock_guard<std::mutex> lock(threadBuffersMtx);
+			res->name = name;
+			res->id = nextTrackId++;
+			threadBuffers.push_back(res);
+			return res;
+		}
+
+		static ProfilerThreadBuffer* getThreadBuffer()
+		{
+			thread_local ProfilerThreadBuffer* threadBuffer = nullptr;
+			thread_local uint32 threadBufferGeneration = 0;
+
+			if (!recording)
+			{
+				return nullptr;
+			}
+
+			uint32 generation = bufferGeneration.load(std::memory_order_relaxed);
+			if (!threadBuffer || threadBufferGeneration != generation)
+			{
+				std::string name = threadName != ""
+					? threadName
+					: "Thread " + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+				threadBuffer = createBuffer(name.c_str());
+				threadBufferGeneration = generation;
+			}
+
+			return threadBuffer;
+		}
+
+		static void writeEvent(ProfilerThreadBuffer* buffer, const ProfilerEvent& event)
+		{
+			uint64 index = buffer->writeIndex.load(std::memory_order_relaxed);
+			buffer->events[index % eventsPerThread] = event;
+			buffer->writeIndex.store(index + 1, std::memory_order_release);
+		}
+
+		static void copyEvents(ProfilerThreadBuffer* buffer, uint64 startNs, uint64 endNs, std::vector<ProfilerEvent>& out)
+		{
+			uint64 end = buffer->writeIndex.load(std::memory_order_acquire);
+			uint64 begin = end > eventsPerThread ? end - eventsPerThread : 0;
+			size_t firstCopied = out.size();
+			// Where each copied event came from in the ring, the time filter means
+			// this can't be worked out from the position in out
+			std::vector<uint64> copiedIndices;
+			for (uint64 i = begin; i < end; i++)
+			{
+				const ProfilerEvent& event = buffer->events[i % eventsPerThread];
+				if (event.endNs >= startNs && event.startNs <= endNs)
+				{
+					out.push_back(event);
+					copiedIndices.push_back(i);
+				}
+			}
+
+			// The owner kept writing while we copied, anything it lapped is garbage now. The
+			// write at endAfterCopy may still be in progress, so its slot counts as lapped too.
+			uint64 endAfterCopy = buffer->writeIndex.load(std::memory_order_acquire);
+			if (endAfterCopy + 1 <= eventsPerThread)
+			{
+				return;
+			}
+
+			uint64 firstIntactIndex = endAfterCopy + 1 - eventsPerThread;
+			size_t numKept = firstCopied;
+			for (size_t i = 0; i < copiedIndices.size(); i++)
+			{
+				if (copiedIndices[i] >= firstIntactIndex)
+				{
+					out[numKept++] = out[firstCopied + i];
+				}
+			}
+			out.erase(out.begin() + numKept, out.end());
+		}
+
+		static void collectGpuEvents()
+		{
+			// Results come back in the order the passes were submitted, stop at the first
+			// one that isn't ready instead of blocking
+			while (!finishedGpuEvents.empty())
+			{
+				const PendingGpuEvent& event = finishedGpuEvents.front();
+				GLint available = 0;
+				GL::getQueryObjectiv(event.endQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+				if (!available)
+				{
+					break;
+				}
+
+				GLuint64 gpuStartNs = 0;
+				GLuint64 gpuEndNs = 0;
+				GL::getQueryObjectui64v(event.startQuery, GL_QUERY_RESULT, &gpuStartNs);
+				GL::getQueryObjectui64v(event.endQuery, GL_QUERY_RESULT, &gpuEndNs);
+
+				if (!paused && gpuBuffer)
+				{
+					uint64 startNs = (uint64)((int64)gpuStartNs + gpuToCpuOffsetNs);
+					uint64 endNs = (uint64)((int64)gpuEndNs + gpuToCpuOffsetNs);
+					writeEvent(gpuBuffer, { event.name, startNs, endNs, event.depth });
+				}
+
+				freeGpuQueries.push_back(event.startQuery);
+				freeGpuQueries.push_back(event.endQuery);
+				finishedGpuEvents.pop_front();
+			}
+		}
+	}
+}
@@ -6,6 +6,7 @@
 #include "platform/Platform.h"
 #include "renderer/GladLayer.h"
 #include "renderer/GLApi.h"
+#include "renderer/TextureCache.h"
 
 #include <imgui.h>
 
@@ -33,6 +34,8 @@ namespace MathAnim
 			GL::enable(GL_BLEND);
 			GL::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+			TextureCache::init(globalThreadPool);
+
 			std::string specialAppDirectory = Platform::getSpecialAppDir();
 			g_logger_info("Special app directory: '{}'", specialAppDirectory);
 			appRoot = std::filesystem::path(specialAppDirectory) / "MathAnimationEditor";
@@ -63,6 +66,7 @@ namespace MathAnim
 			while (isRunning && !window->shouldClose())
 			{
 				window->pollInput();
+				TextureCache::update();
 
 				GL::viewport(0, 0, window->width, window->height);
 				GL::clearColor(0, 0, 0, 0);
@@ -91,6 +95,7 @@ namespace MathAnim
 		void free()
 		{
 			ProjectScreen::free();
+			TextureCache::free();
 			ImGuiLayer::free();
 			Window::cleanup();
 			globalThreadPool->free();
@@ -21,7 +21,7 @@ namespace MathAnim
 		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
 		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 2);
 		glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-		glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+		glfwWindowHint(GLFW_VISIBLE, (flags & WindowFlags::Hidden) ? GLFW_FALSE : GLFW_TRUE);
 		glfwWindowHint(GLFW_SAMPLES, 4);
 		if (flags & WindowFlags::OpenMaximized)
 		{
@@ -0,0 +1,382 @@
+#include "editor/AssetWatcher.h"
+#include "platform/FileSystemWatcher.h"
+#include "animation/Animation.h"
+#include "animation/AnimationManager.h"
+#include "scripting/LuauLayer.h"
+#include "renderer/TextureCache.h"
+#include "renderer/Fonts.h"
+#include "svg/Svg.h"
+#include "svg/SvgParser.h"
+#include "multithreading/GlobalThreadPool.h"
+#include "core/Application.h"
+
+#include <algorithm>
+
+namespace MathAnim
+{
+	enum class AssetType : uint8
+	{
+		None,
+		Script,
+		Svg,
+		Image,
+		Font
+	};
+
+	namespace AssetWatcher
+	{
+		// -------------- Internal Functions --------------
+		static void onFileChanged(const std::filesystem::path& file);
+		static void onFileRenamed(const std::filesystem::path& file);
+		static void onFileDeleted(const std::filesystem::path& file);
+		static void onFileCreated(const std::filesystem::path& file);
+		static void handleEvent(AnimationManagerData* am, const std::filesystem::path& file, FileEventType type);
+		static void reloadScript(const std::filesystem::path& file, FileEventType type);
+		static void reloadSvgFile(AnimationManagerData* am, const std::string& key);
+		static void reloadFont(AnimationManagerData* am, const std::filesystem::path& file, const std::string& key);
+		static std::vector<AnimObjId> getDependents(AnimationManagerData* am, const std::string& key, AnimObjectTypeV1 objectType);
+		static bool dependsOn(const AnimObject* obj, const std::string& key, AnimObjectTypeV1 objectType);
+		static AssetType getAssetType(const std::filesystem::path& file);
+		static std::string toKey(const std::filesystem::path& file);
+
+		// -------------- Internal Variables --------------
+		static FileSystemWatcher* projectWatcher = nullptr;
+		static std::filesystem::path scriptsRoot;
+		// Filled by the watcher callbacks during poll() and drained right after in update()
+		static std::vector<std::pair<std::filesystem::path, FileEventType>> queuedEvents;
+		// Normalized absolute path -> objects that were generated from that file
+		static std::unordered_map<std::string, std::vector<AnimObjId>> dependencies;
+		static JobCounter reloadCounter;
+		// Bumped in free() so reloads that finish afterwards are thrown away
+		static uint32 reloadGeneration = 0;
+
+		void init(const std::filesystem::path& projectRoot)
+		{
+			scriptsRoot = (projectRoot / "scripts").lexically_normal();
+
+			projectWatcher = (FileSystemWatcher*)g_memory_allocate(sizeof(FileSystemWatcher));
+			new(projectWatcher)FileSystemWatcher();
+			projectWatcher->path = projectRoot;
+			projectWatcher->onChanged = onFileChanged;
+			projectWatcher->onRenamed = onFileRenamed;
+			projectWatcher->onCreated = onFileCreated;
+			projectWatcher->onDeleted = onFileDeleted;
+			projectWatcher->includeSubdirectories = true;
+			projectWatcher->notifyFilters = NotifyFilters::FileName;
+			projectWatcher->notifyFilters |= NotifyFilters::LastWrite;
+			projectWatcher->start();
+		}
+
+		void update(AnimationManagerData* am)
+		{
+			if (!projectWatcher)
+			{
+				return;
+			}
+
+			projectWatcher->poll();
+			for (const auto& [file, type] : queuedEvents)
+			{
+				handleEvent(am, file, type);
+			}
+			queuedEvents.clear();
+		}
+
+		void addDependency(const std::filesystem::path& file, AnimObjId obj)
+		{
+			if (file.empty() || obj == NULL_ANIM_OBJECT)
+			{
+				return;
+			}
+
+			std::vector<AnimObjId>& dependents = dependencies[toKey(file)];
+			if (std::find(dependents.begin(), dependents.end(), obj) == dependents.end())
+			{
+				dependents.push_back(obj);
+			}
+		}
+
+		void free()
+		{
+			if (projectWatcher)
+			{
+				projectWatcher->~FileSystemWatcher();
+				g_memory_free(projectWatcher);
+			}
+			projectWatcher = nullptr;
+
+			// Continuations still queued for the main thread see the new generation and
+			// only clean up after themselves
+			Application::threadPool()->wait(reloadCounter);
+			reloadGeneration++;
+
+			queuedEvents.clear();
+			dependencies.clear();
+		}
+
+		// -------------- Internal Functions --------------
+		static void onFileChanged(const std::filesystem::path& file)
+		{
+			queuedEvents.emplace_back(file, FileEventType::Changed);
+		}
+
+		static void onFileRenamed(const std::filesystem::path& file)
+		{
+			queuedEvents.emplace_back(file, FileEventType::Renamed);
+		}
+
+		static void onFileDeleted(const std::filesystem::path& file)
+		{
+			queuedEvents.emplace_back(file, FileEventType::Deleted);
+		}
+
+		static void onFileCreated(const std::filesystem::path& file)
+		{
+			queuedEvents.emplace_back(file, FileEventType::Created);
+		}
+
+		static void handleEvent(AnimationManagerData* am, const std::filesystem::path& file, FileEventType type)
+		{
+			AssetType assetType = getAssetType(file);
+			if (assetType == AssetType::Script)
+			{
+				reloadScript(file, type);
+				return;
+			}
+
+			// Whatever was loaded from a deleted file stays loaded. It gets picked up
+			// again if the file comes back.
+			if (type == FileEventType::Deleted)
+			{
+				return;
+			}
+
+			switch (assetType)
+			{
+			case AssetType::Svg:
+				reloadSvgFile(am, toKey(file));
+				break;
+			case AssetType::Image:
+				TextureCache::reloadTexture(file);
+				break;
+			case AssetType::Font:
+				reloadFont(am, file, toKey(file));
+				break;
+			case AssetType::Script:
+			case AssetType::None:
+				break;
+			}
+		}
+
+		static void reloadScript(const std::filesystem::path& file, FileEventType type)
+		{
+			std::filesystem::path relativePath = file.lexically_normal().lexically_relative(scriptsRoot);
+			if (relativePath.empty() || *relativePath.begin() == "..")
+			{
+				// LuauLayer only knows about scripts in the scripts directory
+				return;
+			}
+
+			std::string filename = relativePath.string();
+			if (type == FileEventType::Deleted)
+			{
+				LuauLayer::remove(filename);
+				return;
+			}
+
+			LuauLayer::compileAsync(filename, [](const std::string& compiledFilename, bool succeeded)
+			{
+				if (succeeded)
+				{
+					LuauLayer::execute(compiledFilename);
+				}
+			});
+		}
+
+		static void reloadSvgFile(AnimationManagerData* am, const std::string& key)
+		{
+			std::vector<AnimObjId> dependents = getDependents(am, key, AnimObjectTypeV1::SvgFileObject);
+			if (dependents.empty())
+			{
+				return;
+			}
+
+			g_logger_info("Reloading '{}' for {} svg file object(s).", key, dependents.size());
+
+			// Parsed once on a worker. Every object takes ownership of its group, so the
+			// rest of the dependents get copies of it on the main thread.
+			SvgGroup** parsedGroup = (SvgGroup**)g_memory_allocate(sizeof(SvgGroup*));
+			*parsedGroup = nullptr;
+
+			GlobalThreadPool* threadPool = Application::threadPool();
+			threadPool->queueJob(
+				[parsedGroup, key]()
+				{
+					*parsedGroup = SvgParser::parseSvgDoc(key.c_str());
+				},
+				"ParseSvgFile",
+				Priority::Medium,
+				&reloadCounter
+			);
+
+			uint32 generation = reloadGeneration;
+			threadPool->continueWith(
+				reloadCounter,
+				[am, parsedGroup, dependents, key, generation]()
+				{
+					SvgGroup* parsed = *parsedGroup;
+					g_memory_free(parsedGroup);
+					if (!parsed)
+					{
+						return;
+					}
+
+					// The objects could have been deleted or pointed elsewhere while the file was parsing
+					std::vector<AnimObject*> objectsToReload;
+					for (AnimObjId dependent : dependents)
+					{
+						AnimObject* obj = generation == reloadGeneration
+							? AnimationManager::getMutableObject(am, dependent)
+							: nullptr;
+						if (obj && dependsOn(obj, key, AnimObjectTypeV1::SvgFileObject))
+						{
+							objectsToReload.push_back(obj);
+						}
+					}
+
+					if (objectsToReload.empty())
+					{
+						parsed->free();
+						g_memory_free(parsed);
+						return;
+					}
+
+					// Copy before handing anything out since reInit is free to change its group.
+					// The last object just takes the parsed group.
+					std::vector<SvgGroup*> groups;
+					for (size_t i = 0; i + 1 < objectsToReload.size(); i++)
+					{
+						SvgGroup* group = (SvgGroup*)g_memory_allocate(sizeof(SvgGroup));
+						*group = Svg::createDefaultGroup();
+						Svg::copy(group, parsed);
+						groups.push_back(group);
+					}
+					groups.push_back(parsed);
+
+					for (size_t i = 0; i < objectsToReload.size(); i++)
+					{
+						AnimObject* obj = objectsToReload[i];
+						std::string filepath = obj->as.svgFile.filepath;
+						obj->as.svgFile.setFilepath(filepath, groups[i]);
+						obj->as.svgFile.reInit(am, obj);
+					}
+				},
+				"ReloadSvgFileObjects",
+				Priority::Medium,
+				true
+			);
+		}
+
+		static void reloadFont(AnimationManagerData* am, const std::filesystem::path& file, const std::string& key)
+		{
+			// FreeType faces all come from the one FT_Library, which isn't thread safe, so
+			// fonts are reloaded on the main thread. Only fonts that are in use get reloaded.
+			if (!Fonts::reloadFont(file.string().c_str()))
+			{
+				return;
+			}
+
+			for (AnimObjId dependent : getDependents(am, key, AnimObjectTypeV1::TextObject))
+			{
+				AnimObject* obj = AnimationManager::getMutableObject(am, dependent);
+				obj->as.textObject.reInit(am, obj);
+			}
+		}
+
+		static std::vector<AnimObjId> getDependents(AnimationManagerData* am, const std::string& key, AnimObjectTypeV1 objectType)
+		{
+			auto iter = dependencies.find(key);
+			if (iter == dependencies.end())
+			{
+				return {};
+			}
+
+			// Drop anything that was deleted or doesn't use this file anymore
+			std::vector<AnimObjId>& dependents = iter->second;
+			for (auto objIter = dependents.begin(); objIter != dependents.end();)
+			{
+				const AnimObject* obj = AnimationManager::getObject(am, *objIter);
+				if (!obj || !dependsOn(obj, key, objectType))
+				{
+					objIter = dependents.erase(objIter);
+				}
+				else
+				{
+					++objIter;
+				}
+			}
+
+			if (dependents.empty())
+			{
+				dependencies.erase(iter);
+				return {};
+			}
+
+			return dependents;
+		}
+
+		static bool dependsOn(const AnimObject* obj, const std::string& key, AnimObjectTypeV1 objectType)
+		{
+			if (obj->objectType != objectType)
+			{
+				return false;
+			}
+
+			switch (objectType)
+			{
+			case AnimObjectTypeV1::SvgFileObject:
+				return obj->as.svgFile.filepath && toKey(obj->as.svgFile.filepath) == key;
+			case AnimObjectTypeV1::TextObject:
+				return obj->as.textObject.font && toKey(obj->as.textObject.font->fontFilepath) == key;
+			default:
+				break;
+			}
+
+			return false;
+		}
+
+		static AssetType getAssetType(const std::filesystem::path& file)
+		{
+			std::string extension = file.extension().string();
+			std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return (char)std::tolower((unsigned char)c); });
+
+			if (extension == ".luau" || extension == ".lua")
+			{
+				return AssetType::Script;
+			}
+
+			if (extension == ".svg")
+			{
+				return AssetType::Svg;
+			}
+
+			if (extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".bmp" ||
+				extension == ".tga" || extension == ".gif" || extension == ".psd" || extension == ".hdr")
+			{
+				return AssetType::Image;
+			}
+
+			if (extension == ".ttf" || extension == ".otf" || extension == ".ttc")
+			{
+				return AssetType::Font;
+			}
+
+			return AssetType::None;
+		}
+
+		static std::string toKey(const std::filesystem::path& file)
+		{
+			return std::filesystem::absolute(file).lexically_normal().make_preferred().string();
+		}
+	}
+}
@@ -6,12 +6,14 @@
 #include "editor/panels/AssetManagerPanel.h"
 #include "editor/panels/InspectorPanel.h"
 #include "editor/panels/ConsoleLog.h"
+#include "editor/panels/ProfilerPanel.h"
 #include "editor/timeline/Timeline.h"
 #include "editor/imgui/ImGuiLayer.h"
 #include "editor/imgui/ImGuiExtended.h"
 #include "editor/Gizmos.h"
 #include "editor/EditorSettings.h"
 #include "editor/EditorLayout.h"
+#include "editor/AssetWatcher.h"
 #include "animation/AnimationManager.h"
 #include "core/Application.h"
 #include "core/Input.h"
@@ -91,6 +93,7 @@ namespace MathAnim
 			ExportPanel::init(outputWidth, outputHeight);
 			SceneHierarchyPanel::init(am);
 			AssetManagerPanel::init(projectRoot);
+			AssetWatcher::init(projectRoot);
 			EditorLayout::init(projectRoot);
 			timelineLoaded = true;
 
@@ -106,6 +109,7 @@ namespace MathAnim
 			// TODO: Do this in a central file
 			checkHotKeys(am);
 			checkForMousePicking(am, editorFramebuffer);
+			AssetWatcher::update(am);
 
 			ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(0, 0));
 
@@ -151,6 +155,7 @@ namespace MathAnim
 
 			AnimObjectPanel::update();
 			DebugPanel::update();
+			ProfilerPanel::update();
 			ExportPanel::update(am);
 			SceneHierarchyPanel::update(am);
 			AssetManagerPanel::update();
@@ -215,6 +220,7 @@ namespace MathAnim
 		{
 			gizmoPreviewTexture.destroy();
 
+			AssetWatcher::free();
 			AssetManagerPanel::free();
 			SceneHierarchyPanel::free();
 			ExportPanel::free();
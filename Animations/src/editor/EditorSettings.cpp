@@ -21,6 +21,7 @@ namespace MathAnim
 			data->viewMode = ViewMode::Normal;
 			data->activeObjectOutlineWidth = 9.0f;
 			data->activeObjectHighlightColor = "#FF9E28"_hex;
+			data->activeObjectOutlineResolution = OutlineResolution::Half;
 		}
 
 		void imgui(AnimationManagerData* am)
@@ -35,6 +36,19 @@ namespace MathAnim
 				ImGui::ColorEdit4(": Selection Highlight Color", &data->activeObjectHighlightColor.r);
 				ImGui::DragFloat(": Selection Highlight Width", &data->activeObjectOutlineWidth, 0.2f, 1.0f, 50.0f);
 
+				if (ImGui::BeginCombo("Selection Highlight Resolution", _outlineResolutionEnumNames[(int)data->activeObjectOutlineResolution]))
+				{
+					for (int i = 0; i < (int)OutlineResolution::Length; i++)
+					{
+						if (ImGui::Selectable(_outlineResolutionEnumNames[i]))
+						{
+							data->activeObjectOutlineResolution = (OutlineResolution)i;
+							ImGui::CloseCurrentPopup();
+						}
+					}
+					ImGui::EndCombo();
+				}
+
 				if (ImGui::BeginCombo("Preview Fidelity", _previewFidelityEnumNames[(int)data->previewFidelity]))
 				{
 					for (int i = 0; i < (int)PreviewSvgFidelity::Length; i++)
@@ -3,7 +3,7 @@
 #include "core/Serialization.hpp"
 #include "core/Window.h"
 #include "renderer/Colors.h"
-#include "renderer/Texture.h"
+#include "renderer/TextureCache.h"
 #include "platform/Platform.h"
 
 #include <nlohmann/json.hpp>
@@ -94,9 +94,7 @@ namespace MathAnim
 			{
 				if (Platform::fileExists(projects[i].previewImageFilepath.c_str()))
 				{
-					projects[i].texture = TextureBuilder()
-						.setFilepath(projects[i].previewImageFilepath.c_str())
-						.generate(true);
+					projects[i].texture = TextureCache::loadTextureAsync(projects[i].previewImageFilepath);
 				}
 				else
 				{
@@ -182,7 +180,7 @@ namespace MathAnim
 				ImVec2 rectMax = ImGui::GetItemRectMax();
 				drawList->PushClipRect(ImGui::GetCurrentWindow()->ClipRect.Min, ImGui::GetCurrentWindow()->ClipRect.Max);
 				drawList->AddImageRounded(
-					(ImTextureID)(uint64)projects[i].texture.graphicsId,
+					(ImTextureID)(uint64)TextureCache::getTexture(projects[i].texture).graphicsId,
 					rectMin, rectMax, ImVec2(0, 0), ImVec2(1, 1),
 					IM_COL32(255, 255, 255, 255), iconBorderRounding);
 
@@ -276,7 +274,7 @@ namespace MathAnim
 			serializeMetadata();
 			for (int i = 0; i < projects.size(); i++)
 			{
-				projects[i].texture.destroy();
+				TextureCache::unloadTexture(projects[i].texture);
 			}
 
 			ImGuiIO io = ImGui::GetIO();
@@ -2,8 +2,6 @@
 #include "editor/imgui/ImGuiExtended.h"
 #include "utils/FontAwesome.h"
 #include "platform/Platform.h"
-#include "platform/FileSystemWatcher.h"
-#include "scripting/LuauLayer.h"
 
 namespace MathAnim
 {
@@ -22,41 +20,21 @@ namespace MathAnim
 			const char* defaultNewFilename = nullptr,
 			const char* addButtonText = nullptr
 		);
-		static void onScriptChanged(const std::filesystem::path& scriptPath);
-		static void onScriptRenamed(const std::filesystem::path& scriptPath);
-		static void onScriptCreated(const std::filesystem::path& scriptPath);
-		static void onScriptDeleted(const std::filesystem::path& scriptPath);
 		static void newScriptAddedCallback(const char* filename);
 		static void scriptSelectedCallback(const char* filename);
 
 		// -------------- Internal Variables --------------
 		static std::filesystem::path assetsRoot;
 		static std::filesystem::path scriptsRoot;
-		static FileSystemWatcher* scriptWatcher = nullptr;
 
 		void init(const std::filesystem::path& projectRoot)
 		{
 			assetsRoot = projectRoot;
 			scriptsRoot = assetsRoot/"scripts";
-
-			// Initialize the script watcher
-			scriptWatcher = (FileSystemWatcher*)g_memory_allocate(sizeof(FileSystemWatcher));
-			new(scriptWatcher)FileSystemWatcher();
-			scriptWatcher->path = scriptsRoot;
-			scriptWatcher->onChanged = onScriptChanged;
-			scriptWatcher->onRenamed = onScriptRenamed;
-			scriptWatcher->onCreated = onScriptCreated;
-			scriptWatcher->onDeleted = onScriptDeleted;
-			scriptWatcher->includeSubdirectories = true;
-			scriptWatcher->notifyFilters = NotifyFilters::FileName;
-			scriptWatcher->notifyFilters |= NotifyFilters::Attributes;
-			scriptWatcher->start();
 		}
 
 		void update()
 		{
-			scriptWatcher->poll();
-
 			ImGui::Begin("Asset Manager");
 
 			iterateDirectory(
@@ -73,13 +51,6 @@ namespace MathAnim
 
 		void free()
 		{
-			if (scriptWatcher)
-			{
-				scriptWatcher->~FileSystemWatcher();
-				g_memory_free(scriptWatcher);
-			}
-
-			scriptWatcher = nullptr;
 		}
 
 		// -------------- Internal Functions --------------
@@ -199,27 +170,6 @@ namespace MathAnim
 			}
 		}
 
-		static void onScriptChanged(const std::filesystem::path& scriptPath)
-		{
-			LuauLayer::compile(scriptPath.filename().string());
-			LuauLayer::execute(scriptPath.filename().string());
-		}
-
-		static void onScriptDeleted(const std::filesystem::path& scriptPath)
-		{
-			LuauLayer::remove(scriptPath.filename().string());
-		}
-
-		static void onScriptCreated(const std::filesystem::path& scriptPath)
-		{
-			LuauLayer::remove(scriptPath.filename().string());
-		}
-
-		static void onScriptRenamed(const std::filesystem::path& scriptPath)
-		{
-			LuauLayer::remove(scriptPath.filename().string());
-		}
-
 		static void newScriptAddedCallback(const char* filename)
 		{
 			Platform::openFileWithVsCode(filename);
@@ -50,10 +50,17 @@ namespace MathAnim
 		static constexpr size_t maxLogHistorySize = 500;
 
 		static constexpr size_t formatBufferSize = 1024 * 10; // 10KB buffer for a log message seems reasonable /shrug 
-		static char formatBuffer[formatBufferSize];
+		// Scripts can log from worker threads, so every thread formats into its own buffer
+		static thread_local char formatBuffer[formatBufferSize];
+		// Entries logged since the last update(), they're moved into logHistory on the main thread
+		static std::vector<LogEntry> queuedEntries;
+		static std::mutex queuedEntriesMtx;
 		static constexpr ImVec2 logPadding = ImVec2(7.0f, 20.0f);
 		static constexpr float logPaddingBottomY = 12.0f;
 
+		// --------- Internal Functions ---------
+		static void queueEntry(const LogEntry& entry);
+
 		void log(const char* inFilename, int inLine, const char* format, ...)
 		{
 			LogEntry entry = {};
@@ -69,14 +76,7 @@ namespace MathAnim
 
 			entry.message = formatBuffer;
 
-			if (logHistory.size() > 0 && entry == logHistory[logHistory.size() - 1])
-			{
-				logHistory[logHistory.size() - 1].count++;
-			}
-			else
-			{
-				logHistory.push_back(entry);
-			}
+			queueEntry(entry);
 		}
 
 		void info(const char* inFilename, int inLine, const char* format, ...)
@@ -94,14 +94,7 @@ namespace MathAnim
 
 			entry.message = formatBuffer;
 
-			if (logHistory.size() > 0 && entry == logHistory[logHistory.size() - 1])
-			{
-				logHistory[logHistory.size() - 1].count++;
-			}
-			else
-			{
-				logHistory.push_back(entry);
-			}
+			queueEntry(entry);
 		}
 
 		void warning(const char* inFilename, int inLine, const char* format, ...)
@@ -119,14 +112,7 @@ namespace MathAnim
 
 			entry.message = formatBuffer;
 
-			if (logHistory.size() > 0 && entry == logHistory[logHistory.size() - 1])
-			{
-				logHistory[logHistory.size() - 1].count++;
-			}
-			else
-			{
-				logHistory.push_back(entry);
-			}
+			queueEntry(entry);
 		}
 
 		void error(const char* inFilename, int inLine, const char* format, ...)
@@ -144,18 +130,27 @@ namespace MathAnim
 
 			entry.message = formatBuffer;
 
-			if (logHistory.size() > 0 && entry == logHistory[logHistory.size() - 1])
-			{
-				logHistory[logHistory.size() - 1].count++;
-			}
-			else
-			{
-				logHistory.push_back(entry);
-			}
+			queueEntry(entry);
 		}
 
 		void update()
 		{
+			{
+				std::lock_guard<std::mutex> lock(queuedEntriesMtx);
+				for (LogEntry& entry : queuedEntries)
+				{
+					if (logHistory.size() > 0 && entry == logHistory[logHistory.size() - 1])
+					{
+						logHistory[logHistory.size() - 1].count++;
+					}
+					else
+					{
+						logHistory.push_back(entry);
+					}
+				}
+				queuedEntries.clear();
+			}
+
 			while (logHistory.size() > maxLogHistorySize)
 			{
 				logHistory.erase(logHistory.begin());
@@ -323,5 +318,12 @@ namespace MathAnim
 
 			ConsoleLog::error(scriptFilepath.c_str(), debugInfo.currentline, "%s", formatBuffer);
 		}
+
+		// --------- Internal Functions ---------
+		static void queueEntry(const LogEntry& entry)
+		{
+			std::lock_guard<std::mutex> lock(queuedEntriesMtx);
+			queuedEntries.push_back(entry);
+		}
 	}
 }
\ No newline at end of file
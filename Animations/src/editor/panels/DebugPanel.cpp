@@ -1,10 +1,12 @@
 #include "editor/panels/DebugPanel.h"
 #include "core.h"
 #include "core/Application.h"
+#include "core/MemoryTracker.h"
 #include "svg/Svg.h"
 #include "svg/SvgCache.h"
 #include "renderer/Colors.h"
 #include "renderer/Texture.h"
+#include "renderer/TextureCache.h"
 #include "renderer/Renderer.h"
 
 namespace MathAnim
@@ -191,6 +193,109 @@ namespace MathAnim
 				ImGui::TreePop();
 			}
 
+			// Texture loading queue
+			{
+				std::vector<PendingTextureLoad> pendingLoads = TextureCache::getPendingLoads();
+				float pendingMegabytes = (float)TextureCache::getPendingBytes() / (float)MB(1);
+				if (ImGui::TreeNodeEx("###TextureLoadQueue_Tab", ImGuiTreeNodeFlags_FramePadding, "Texture Loads: %d (%2.2fMB)", (int)pendingLoads.size(), pendingMegabytes))
+				{
+					if (ImGui::BeginTable("##TextureLoadQueue", 3, ImGuiTableFlags_Resizable | ImGuiTableFlags_NoSavedSettings | ImGuiTableFlags_Borders))
+					{
+						ImGui::TableSetupColumn("Image");
+						ImGui::TableSetupColumn("Size");
+						ImGui::TableSetupColumn("State");
+						ImGui::TableHeadersRow();
+
+						for (const auto& pendingLoad : pendingLoads)
+						{
+							ImGui::TableNextColumn();
+							ImGui::Text("%s", pendingLoad.absPath.filename().string().c_str());
+							ImGui::TableNextColumn();
+							ImGui::Text("%2.2fMB", (float)pendingLoad.numBytes / (float)MB(1));
+							ImGui::TableNextColumn();
+							ImGui::Text("%s", pendingLoad.isDecoded ? "Uploading" : "Decoding");
+						}
+
+						ImGui::EndTable();
+					}
+
+					ImGui::TreePop();
+				}
+			}
+
+			// Memory breakdown
+			{
+				size_t cpuBytes = 0;
+				size_t gpuBytes = 0;
+				for (size_t i = 0; i < (size_t)MemoryTag::Length; i++)
+				{
+					MemoryTagStats stats = MemoryTracker::getStats((MemoryTag)i);
+					if (_memoryTagIsGpu[i])
+					{
+						gpuBytes += stats.currentBytes;
+					}
+					else
+					{
+						cpuBytes += stats.currentBytes;
+					}
+				}
+
+				float cpuMegabytes = (float)cpuBytes / (float)MB(1);
+				float gpuMegabytes = (float)gpuBytes / (float)MB(1);
+				if (ImGui::TreeNodeEx("###MemoryBreakdown_Tab", ImGuiTreeNodeFlags_FramePadding, "Tracked Memory: %2.2fMB CPU, %2.2fMB GPU (estimated)", cpuMegabytes, gpuMegabytes))
+				{
+					if (ImGui::Button("Reset Peaks"))
+					{
+						MemoryTracker::resetPeaks();
+					}
+
+					if (ImGui::BeginTable("##MemoryBreakdown", 5, ImGuiTableFlags_Resizable | ImGuiTableFlags_NoSavedSettings | ImGuiTableFlags_Borders))
+					{
+						ImGui::TableSetupColumn("Subsystem");
+						ImGui::TableSetupColumn("Current");
+						ImGui::TableSetupColumn("Peak");
+						ImGui::TableSetupColumn("# of Allocations");
+						ImGui::TableSetupColumn("Budget (MB, 0 = None)");
+						ImGui::TableHeadersRow();
+
+						for (size_t i = 0; i < (size_t)MemoryTag::Length; i++)
+						{
+							MemoryTag tag = (MemoryTag)i;
+							MemoryTagStats stats = MemoryTracker::getStats(tag);
+							bool isOverBudget = stats.budgetBytes > 0 && stats.currentBytes > stats.budgetBytes;
+
+							ImGui::TableNextColumn();
+							ImGui::Text("%s (%s)", _memoryTagNames[i], _memoryTagIsGpu[i] ? "GPU" : "CPU");
+							ImGui::TableNextColumn();
+							if (isOverBudget)
+							{
+								ImGui::TextColored(Colors::AccentRed[3], "%2.2fMB", (float)stats.currentBytes / (float)MB(1));
+							}
+							else
+							{
+								ImGui::Text("%2.2fMB", (float)stats.currentBytes / (float)MB(1));
+							}
+							ImGui::TableNextColumn();
+							ImGui::Text("%2.2fMB", (float)stats.peakBytes / (float)MB(1));
+							ImGui::TableNextColumn();
+							ImGui::Text("%zu (%zu total)", stats.numLiveAllocations, stats.numTotalAllocations);
+							ImGui::TableNextColumn();
+							int budgetMegabytes = (int)(stats.budgetBytes / MB(1));
+							std::string budgetId = std::string("##MemoryBudget_") + std::to_string(i);
+							ImGui::SetNextItemWidth(-FLT_MIN);
+							if (ImGui::InputInt(budgetId.c_str(), &budgetMegabytes, 0, 0, ImGuiInputTextFlags_EnterReturnsTrue))
+							{
+								MemoryTracker::setBudget(tag, (size_t)glm::max(budgetMegabytes, 0) * MB(1));
+							}
+						}
+
+						ImGui::EndTable();
+					}
+
+					ImGui::TreePop();
+				}
+			}
+
 			ImGui::End();
 		}
 
@@ -3,11 +3,13 @@
 #include "editor/EditorSettings.h"
 #include "core.h"
 #include "core/Application.h"
+#include "core/Profiler.h"
 #include "video/Encoder.h"
 #include "animation/AnimationManager.h"
 #include "renderer/Renderer.h"
 #include "renderer/Framebuffer.h"
 #include "renderer/Texture.h"
+#include "renderer/TextureCache.h"
 #include "renderer/PixelBufferDownloader.h"
 #include "renderer/GLApi.h"
 
@@ -24,17 +26,24 @@ namespace MathAnim
 		static bool outputVideoFile;
 		static Framebuffer yFramebuffer;
 		static Framebuffer uvFramebuffer;
+		static Framebuffer packedYuvFramebuffer;
 		static PixelBufferDownload pboDownloader;
+		static ByteFormat pboSampleFormat = ByteFormat::R8_UI;
+		static bool usePackedYuv = true;
 		static std::string outputVideoFilename;
 		static uint32 outputWidth;
 		static uint32 outputHeight;
 		static PreviewSvgFidelity fidelityBeforeExport = PreviewSvgFidelity::Low;
+		static bool writeProfilerTrace = false;
+		static VideoEncoderSettings encoderSettings;
+		static uint64 exportStartNs = 0;
 
 		// -------------------- Internal Functions --------------------
 		static void imgui(AnimationManagerData* am);
 		static void processEncoderData(AnimationManagerData* am);
 		static void exportVideoTo(AnimationManagerData* am, const std::string& filename);
 		static void endExport();
+		static void createYuvDownloadTargets(ByteFormat sampleFormat);
 
 		void init(uint32 inOutputWidth, uint32 inOutputHeight)
 		{
@@ -42,9 +51,7 @@ namespace MathAnim
 			outputHeight = inOutputHeight;
 			outputVideoFile = false;
 			encoder = nullptr;
-
-			pboDownloader = PixelBufferDownload();
-			pboDownloader.create(outputWidth, outputHeight);
+			encoderSettings = VideoEncoder::defaultSettings();
 
 			Texture yTextureSpec = TextureBuilder()
 				.setWidth(outputWidth)
@@ -63,6 +70,8 @@ namespace MathAnim
 				.addColorAttachment(uvTextureSpec)
 				.addColorAttachment(uvTextureSpec)
 				.generate();
+
+			createYuvDownloadTargets(ByteFormat::R8_UI);
 		}
 
 		void update(AnimationManagerData* am)
@@ -97,6 +106,7 @@ namespace MathAnim
 		void free()
 		{
 			pboDownloader.free();
+			packedYuvFramebuffer.destroy();
 
 			// Free it just in case, if the encoder isn't active this does nothing
 			VideoEncoder::finalizeEncodingFile(encoder);
@@ -112,6 +122,10 @@ namespace MathAnim
 				? encoder->getPercentComplete()
 				: 0.0f;
 			ImGuiExtended::ProgressBar(": Export Progress", percentExported);
+			if (isExportingVideo())
+			{
+				ImGui::Text("Throughput: %2.1f frames/sec", encoder->getFramesPerSecond());
+			}
 
 			constexpr int filenameBufferSize = MATH_ANIMATIONS_MAX_PATH;
 			static char filenameBuffer[filenameBufferSize];
@@ -168,6 +182,48 @@ namespace MathAnim
 			}
 			ImGui::EndDisabled();
 
+			ImGui::BeginDisabled(isExportingVideo());
+			ImGui::Checkbox(": Write Profiler Trace", &writeProfilerTrace);
+			ImGui::EndDisabled();
+			if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+			{
+				ImGui::SetTooltip("Saves a Chrome trace of the export next to the video as <filename>.trace.json");
+			}
+
+			ImGui::BeginDisabled(isExportingVideo());
+			if (ImGui::TreeNodeEx("Encoder Settings", ImGuiTreeNodeFlags_FramePadding))
+			{
+				int maxThreads = glm::max((int)std::thread::hardware_concurrency(), 1);
+				ImGui::SliderInt(": Preset", &encoderSettings.preset, 0, 13);
+				ImGui::SliderInt(": CRF", &encoderSettings.crf, 1, 63);
+				ImGui::SliderInt(": Threads Per Encoder", &encoderSettings.threadsPerEncoder, 1, maxThreads);
+
+				if (ImGui::Checkbox(": Packed YUV Readback", &usePackedYuv) && !usePackedYuv)
+				{
+					encoderSettings.tenBit = false;
+				}
+				if (ImGui::IsItemHovered())
+				{
+					ImGui::SetTooltip("Converts each frame in one pass and downloads it with a single transfer instead of one per plane");
+				}
+				ImGui::BeginDisabled(!usePackedYuv);
+				ImGui::Checkbox(": 10 Bit Color", &encoderSettings.tenBit);
+				ImGui::EndDisabled();
+				if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+				{
+					ImGui::SetTooltip("Reduces banding in gradients. Needs packed YUV readback.");
+				}
+
+				ImGui::Checkbox(": Chunked Encoding", &encoderSettings.chunked);
+				ImGui::BeginDisabled(!encoderSettings.chunked);
+				ImGui::SliderInt(": Parallel Chunks", &encoderSettings.numParallelChunks, 1, maxThreads);
+				ImGui::SliderInt(": Chunk Length (Seconds)", &encoderSettings.chunkLengthSeconds, 1, 30);
+				ImGui::EndDisabled();
+
+				ImGui::TreePop();
+			}
+			ImGui::EndDisabled();
+
 			ImGui::End();
 		}
 
@@ -177,12 +233,30 @@ namespace MathAnim
 			if (!AnimationManager::isPastLastFrame(am))
 			{
 				GL::pushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, "RGB_To_YUV_Pass");
+				Profiler::beginGpuEvent("RGB_To_YUV_Pass");
 				// Render to yuvFramebuffer
-				Renderer::renderTextureToYuvFramebuffer(mainFramebuffer.getColorAttachment(0), yFramebuffer, uvFramebuffer);
+				if (usePackedYuv)
+				{
+					Renderer::renderTextureToPackedYuvFramebuffer(mainFramebuffer.getColorAttachment(0), packedYuvFramebuffer, outputWidth, outputHeight);
+				}
+				else
+				{
+					Renderer::renderTextureToYuvFramebuffer(mainFramebuffer.getColorAttachment(0), yFramebuffer, uvFramebuffer);
+				}
+				Profiler::endGpuEvent();
 				GL::popDebugGroup();
 
 				// Transfer pixels from this framebuffer to our PBOs for async downloads
-				pboDownloader.queueDownloadFrom(yFramebuffer, uvFramebuffer);
+				Profiler::beginGpuEvent("YUV_Readback");
+				if (usePackedYuv)
+				{
+					pboDownloader.queueDownloadFrom(packedYuvFramebuffer);
+				}
+				else
+				{
+					pboDownloader.queueDownloadFrom(yFramebuffer, uvFramebuffer);
+				}
+				Profiler::endGpuEvent();
 			}
 
 			if (pboDownloader.pixelsAreReady)
@@ -207,13 +281,23 @@ namespace MathAnim
 				return;
 			}
 
+			// The first exported frame shouldn't be the only one missing its images
+			TextureCache::waitForPendingLoads();
+
 			outputVideoFilename = filename;
+			if (!usePackedYuv)
+			{
+				encoderSettings.tenBit = false;
+			}
+			createYuvDownloadTargets(encoderSettings.tenBit ? ByteFormat::R16_UI : ByteFormat::R8_UI);
+
 			encoder = VideoEncoder::startEncodingFile(
 				outputVideoFilename.c_str(),
 				outputWidth,
 				outputHeight,
 				framerate,
 				AnimationManager::lastAnimatedFrame(am),
+				encoderSettings,
 				VideoEncoderFlags::None
 			);
 
@@ -223,6 +307,7 @@ namespace MathAnim
 				AnimationManager::resetToFrame(am, 0);
 				Application::setEditorPlayState(AnimState::PlayForwardFixedFrameTime);
 				outputVideoFile = true;
+				exportStartNs = Profiler::nowNs();
 				fidelityBeforeExport = EditorSettings::getSettings().previewFidelity;
 				EditorSettings::setFidelity(PreviewSvgFidelity::Ultra);
 				AnimationManager::retargetSvgScales(am);
@@ -232,9 +317,40 @@ namespace MathAnim
 		void endExport()
 		{
 			VideoEncoder::finalizeEncodingFile(encoder);
+			if (outputVideoFile && writeProfilerTrace)
+			{
+				Profiler::exportChromeTrace(outputVideoFilename + ".trace.json", exportStartNs);
+			}
 			outputVideoFile = false;
 			EditorSettings::setFidelity(fidelityBeforeExport);
 			Application::setEditorPlayState(AnimState::Pause);
 		}
+
+		static void createYuvDownloadTargets(ByteFormat sampleFormat)
+		{
+			if (pboSampleFormat == sampleFormat && packedYuvFramebuffer.colorAttachments.size() > 0)
+			{
+				return;
+			}
+
+			pboDownloader.free();
+			pboDownloader = PixelBufferDownload();
+			pboDownloader.create(outputWidth, outputHeight, 3, sampleFormat);
+			pboSampleFormat = sampleFormat;
+
+			// Nearest filtering on an integer texture, every texel gets written exactly once
+			uint32 packedHeight = PixelBufferDownload::packedYuvHeight(outputWidth, outputHeight);
+			Texture packedTextureSpec = TextureBuilder()
+				.setWidth(outputWidth)
+				.setHeight(packedHeight)
+				.setFormat(sampleFormat)
+				.setMagFilter(FilterMode::Nearest)
+				.setMinFilter(FilterMode::Nearest)
+				.build();
+			packedYuvFramebuffer.destroy();
+			packedYuvFramebuffer = FramebufferBuilder(outputWidth, packedHeight)
+				.addColorAttachment(packedTextureSpec)
+				.generate();
+		}
 	}
 }
\ No newline at end of file
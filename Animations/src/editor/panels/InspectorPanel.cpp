@@ -1027,54 +1027,26 @@ namespace MathAnim
 				g_memory_copyMem((void*)script.scriptFilepath, buffer, sizeof(char) * (newFilepathLength + 1));
 			}
 
-			if (ImGui::Button("Generate"))
+			ImGui::DragFloat(": Time Budget (s)", &script.timeBudget, slowDragSpeed, 0.0f, 600.0f);
+
+			if (LuauLayer::isExecuting(obj->id))
+			{
+				// Generators run on the thread pool, the old children stay until the new ones are ready
+				ImGui::TextUnformatted("Generating...");
+				ImGui::SameLine();
+				if (ImGui::Button("Cancel"))
+				{
+					LuauLayer::cancelExecution(obj->id);
+				}
+			}
+			else if (ImGui::Button("Generate"))
 			{
 				if (script.scriptFilepathLength > 0 && Platform::fileExists(script.scriptFilepath))
 				{
-					// First remove all generated children, which were generated as a result
-					// of this object (presumably)
-					for (int i = 0; i < obj->generatedChildrenIds.size(); i++)
-					{
-						AnimObject* child = AnimationManager::getMutableObject(am, obj->generatedChildrenIds[i]);
-						if (child)
-						{
-							SceneHierarchyPanel::deleteAnimObject(*child);
-							AnimationManager::removeAnimObject(am, obj->generatedChildrenIds[i]);
-						}
-					}
-					obj->generatedChildrenIds.clear();
-
-					// Next init again which should regenerate the children
 					if (LuauLayer::compile(script.scriptFilepath))
 					{
-						if (!LuauLayer::executeOnAnimObj(script.scriptFilepath, "generate", am, obj->id))
-						{
-							// If execution fails, delete any objects that may have been created prematurely
-							for (int i = 0; i < obj->generatedChildrenIds.size(); i++)
-							{
-								AnimObject* child = AnimationManager::getMutableObject(am, obj->generatedChildrenIds[i]);
-								if (child)
-								{
-									SceneHierarchyPanel::deleteAnimObject(*child);
-									AnimationManager::removeAnimObject(am, obj->generatedChildrenIds[i]);
-								}
-							}
-							obj->generatedChildrenIds.clear();
-						}
-					}
-
-					// Copy the svgObjectStart to all the svgObjects to any generated children
-					// to make sure that they render properly
-					for (auto childId : obj->generatedChildrenIds)
-					{
-						AnimObject* child = AnimationManager::getMutableObject(am, childId);
-						if (child)
-						{
-							if (child->_svgObjectStart)
-							{
-								Svg::copy(child->svgObject, child->_svgObjectStart);
-							}
-						}
+						auto timeBudget = std::chrono::milliseconds((int64)(script.timeBudget * 1000.0f));
+						LuauLayer::executeOnAnimObjAsync(script.scriptFilepath, "generate", am, obj->id, timeBudget);
 					}
 				}
 			}
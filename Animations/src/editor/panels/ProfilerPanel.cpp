@@ -0,0 +1,251 @@
+#include "editor/panels/ProfilerPanel.h"
+#include "editor/imgui/ImGuiExtended.h"
+#include "core.h"
+#include "core/Profiler.h"
+
+#include <nfd.h>
+
+namespace MathAnim
+{
+	namespace ProfilerPanel
+	{
+		// ---- Internal Variables ----
+		static constexpr float frameGraphHeight = 60.0f;
+		static constexpr float frameBarWidth = 3.0f;
+		static constexpr float eventRowHeight = 18.0f;
+		// Frames slower than this get drawn in red
+		static constexpr float slowFrameMs = 1000.0f / 60.0f;
+		static uint64 selectedFrameStartNs = 0;
+
+		// ---- Internal Functions ----
+		static void frameGraph(const std::vector<ProfilerFrame>& frames);
+		static void timeline(const ProfilerFrame& frame);
+		static ImU32 eventColor(const char* name);
+		static void exportTrace();
+
+		void init()
+		{
+		}
+
+		void update()
+		{
+			ImGui::Begin("Profiler");
+
+			bool paused = Profiler::isPaused();
+			if (ImGui::Checkbox("Pause", &paused))
+			{
+				Profiler::setPaused(paused);
+			}
+			ImGui::SameLine();
+			if (ImGui::Button("Export Chrome Trace"))
+			{
+				exportTrace();
+			}
+
+			std::vector<ProfilerFrame> frames = Profiler::getFrames();
+			if (frames.size() == 0)
+			{
+				ImGui::Text("No frames recorded yet.");
+				ImGui::End();
+				return;
+			}
+
+			// Follow the latest frame until the user pauses and picks one
+			const ProfilerFrame* selectedFrame = nullptr;
+			for (const ProfilerFrame& frame : frames)
+			{
+				if (frame.startNs == selectedFrameStartNs)
+				{
+					selectedFrame = &frame;
+				}
+			}
+			if (!paused || !selectedFrame)
+			{
+				selectedFrame = &frames[frames.size() - 1];
+				selectedFrameStartNs = selectedFrame->startNs;
+			}
+
+			// The frame can't be a reference into frames since frameGraph may change the selection
+			ProfilerFrame frameToShow = *selectedFrame;
+			frameGraph(frames);
+			ImGui::Text("Frame: %.3f ms", (float)(frameToShow.endNs - frameToShow.startNs) / 1'000'000.0f);
+			ImGui::Separator();
+			timeline(frameToShow);
+
+			ImGui::End();
+		}
+
+		void free()
+		{
+		}
+
+		// ---- Internal Functions ----
+		static void frameGraph(const std::vector<ProfilerFrame>& frames)
+		{
+			float maxFrameMs = slowFrameMs * 2.0f;
+			for (const ProfilerFrame& frame : frames)
+			{
+				maxFrameMs = glm::max(maxFrameMs, (float)(frame.endNs - frame.startNs) / 1'000'000.0f);
+			}
+
+			ImDrawList* drawList = ImGui::GetWindowDrawList();
+			ImVec2 canvasPos = ImGui::GetCursorScreenPos();
+			ImVec2 canvasSize = ImVec2(ImGui::GetContentRegionAvail().x, frameGraphHeight);
+			drawList->AddRectFilled(canvasPos, canvasPos + canvasSize, ImGui::GetColorU32(ImGuiCol_FrameBg));
+
+			// Newest frame on the right
+			size_t numVisibleFrames = glm::min(frames.size(), (size_t)(canvasSize.x / frameBarWidth));
+			size_t firstVisibleFrame = frames.size() - numVisibleFrames;
+			float graphStartX = canvasPos.x + canvasSize.x - (float)numVisibleFrames * frameBarWidth;
+			for (size_t i = firstVisibleFrame; i < frames.size(); i++)
+			{
+				const ProfilerFrame& frame = frames[i];
+				float frameMs = (float)(frame.endNs - frame.startNs) / 1'000'000.0f;
+				float barHeight = (frameMs / maxFrameMs) * canvasSize.y;
+				float barX = graphStartX + (float)(i - firstVisibleFrame) * frameBarWidth;
+				ImVec2 barMin = ImVec2(barX, canvasPos.y + canvasSize.y - barHeight);
+				ImVec2 barMax = ImVec2(barX + frameBarWidth - 1.0f, canvasPos.y + canvasSize.y);
+
+				ImU32 color = frameMs > slowFrameMs
+					? IM_COL32(220, 80, 80, 255)
+					: IM_COL32(80, 180, 110, 255);
+				if (frame.startNs == selectedFrameStartNs)
+				{
+					color = IM_COL32(240, 240, 240, 255);
+				}
+				drawList->AddRectFilled(barMin, barMax, color);
+			}
+
+			float slowFrameY = canvasPos.y + canvasSize.y - (slowFrameMs / maxFrameMs) * canvasSize.y;
+			drawList->AddLine(
+				ImVec2(canvasPos.x, slowFrameY),
+				ImVec2(canvasPos.x + canvasSize.x, slowFrameY),
+				IM_COL32(255, 255, 255, 80)
+			);
+
+			ImGui::InvisibleButton("##ProfilerFrameGraph", canvasSize);
+			if (ImGui::IsItemHovered())
+			{
+				float mouseX = ImGui::GetIO().MousePos.x;
+				if (mouseX >= graphStartX)
+				{
+					size_t hoveredFrame = firstVisibleFrame + (size_t)((mouseX - graphStartX) / frameBarWidth);
+					hoveredFrame = glm::min(hoveredFrame, frames.size() - 1);
+					const ProfilerFrame& frame = frames[hoveredFrame];
+					ImGui::SetTooltip("%.3f ms", (float)(frame.endNs - frame.startNs) / 1'000'000.0f);
+
+					if (ImGui::IsMouseClicked(ImGuiMouseButton_Left))
+					{
+						// Picking a frame only makes sense while it can't scroll away
+						Profiler::setPaused(true);
+						selectedFrameStartNs = frame.startNs;
+					}
+				}
+			}
+		}
+
+		static void timeline(const ProfilerFrame& frame)
+		{
+			std::vector<ProfilerTrack> tracks = Profiler::getTracks(frame.startNs, frame.endNs);
+			double frameDurationNs = (double)glm::max<uint64>(frame.endNs - frame.startNs, 1);
+
+			ImGui::BeginChild("##ProfilerTimeline", ImVec2(0, 0), false, ImGuiWindowFlags_HorizontalScrollbar);
+			ImDrawList* drawList = ImGui::GetWindowDrawList();
+			float timelineWidth = ImGui::GetContentRegionAvail().x;
+
+			for (const ProfilerTrack& track : tracks)
+			{
+				if (track.events.size() == 0)
+				{
+					continue;
+				}
+
+				uint32 maxDepth = 0;
+				for (const ProfilerEvent& event : track.events)
+				{
+					maxDepth = glm::max(maxDepth, event.depth);
+				}
+
+				ImGui::TextUnformatted(track.name.c_str());
+				ImVec2 trackPos = ImGui::GetCursorScreenPos();
+				ImVec2 trackSize = ImVec2(timelineWidth, (float)(maxDepth + 1) * eventRowHeight);
+				drawList->AddRectFilled(trackPos, trackPos + trackSize, ImGui::GetColorU32(ImGuiCol_FrameBg));
+
+				const ProfilerEvent* hoveredEvent = nullptr;
+				ImVec2 mousePos = ImGui::GetIO().MousePos;
+				for (const ProfilerEvent& event : track.events)
+				{
+					// Events that started in the previous frame or end in the next get clipped to this one
+					double startT = glm::max((double)event.startNs - (double)frame.startNs, 0.0) / frameDurationNs;
+					double endT = glm::min((double)event.endNs - (double)frame.startNs, frameDurationNs) / frameDurationNs;
+					ImVec2 eventMin = ImVec2(
+						trackPos.x + (float)startT * trackSize.x,
+						trackPos.y + (float)event.depth * eventRowHeight
+					);
+					ImVec2 eventMax = ImVec2(
+						glm::max(trackPos.x + (float)endT * trackSize.x, eventMin.x + 1.0f),
+						eventMin.y + eventRowHeight - 1.0f
+					);
+
+					drawList->AddRectFilled(eventMin, eventMax, eventColor(event.name));
+					ImVec2 textSize = ImGui::CalcTextSize(event.name);
+					if (textSize.x + 4.0f < eventMax.x - eventMin.x)
+					{
+						drawList->PushClipRect(eventMin, eventMax, true);
+						drawList->AddText(eventMin + ImVec2(2.0f, 1.0f), IM_COL32(0, 0, 0, 255), event.name);
+						drawList->PopClipRect();
+					}
+
+					if (mousePos.x >= eventMin.x && mousePos.x <= eventMax.x &&
+						mousePos.y >= eventMin.y && mousePos.y <= eventMax.y)
+					{
+						hoveredEvent = &event;
+					}
+				}
+
+				ImGui::Dummy(trackSize);
+				if (hoveredEvent && ImGui::IsWindowHovered())
+				{
+					ImGui::SetTooltip(
+						"%s\n%.3f ms",
+						hoveredEvent->name,
+						(float)(hoveredEvent->endNs - hoveredEvent->startNs) / 1'000'000.0f
+					);
+				}
+			}
+
+			ImGui::EndChild();
+		}
+
+		static ImU32 eventColor(const char* name)
+		{
+			// Hash the name so the same event keeps its color from frame to frame
+			size_t hash = std::hash<std::string_view>{}(name);
+			uint8 r = (uint8)(130 + (hash & 0x7F));
+			uint8 g = (uint8)(130 + ((hash >> 8) & 0x7F));
+			uint8 b = (uint8)(130 + ((hash >> 16) & 0x7F));
+			return IM_COL32(r, g, b, 255);
+		}
+
+		static void exportTrace()
+		{
+			nfdchar_t* outPath = NULL;
+			nfdresult_t result = NFD_SaveDialog("json", NULL, &outPath);
+
+			if (result == NFD_OKAY)
+			{
+				std::filesystem::path filepath = outPath;
+				std::free(outPath);
+				if (!filepath.has_extension())
+				{
+					filepath.replace_extension(".json");
+				}
+				Profiler::exportChromeTrace(filepath);
+			}
+			else if (result != NFD_CANCEL)
+			{
+				g_logger_error("Error opening file to save the profiler trace to:\n\t'{}'", NFD_GetError());
+			}
+		}
+	}
+}
@@ -7,6 +7,8 @@
 #include "animation/AnimationManager.h"
 #include "audio/Audio.h"
 #include "audio/WavLoader.h"
+#include "audio/Waveform.h"
+#include "multithreading/GlobalThreadPool.h"
 
 #include <imgui.h>
 #define IMGUI_DEFINE_MATH_OPERATORS
@@ -24,9 +26,14 @@ namespace MathAnim
 		static AudioSource audioSource;
 		static WavData audioData;
 		static ImGuiTimeline_AudioData imguiAudioData;
+		static Waveform waveform;
+		static JobCounter waveformCounter;
+		// Bumped every time the audio changes so a stale waveform job doesn't get swapped in
+		static uint32 waveformGeneration = 0;
 
 		// ------- Internal Functions --------
 		static void loadAudioSource(const char* filepath);
+		static void freeAudioSource();
 
 		static ImGuiTimeline_Track createDefaultTrack(char* trackName = nullptr);
 		static void freeTrack(ImGuiTimeline_Track& track, AnimationManagerData* am);
@@ -145,8 +152,7 @@ namespace MathAnim
 
 				if (res.flags & ImGuiTimelineResultFlags_DeleteAudioSource)
 				{
-					Audio::free(audioSource);
-					WavLoader::free(audioData);
+					freeAudioSource();
 					timelineData.audioSourceFile = (uint8*)g_memory_realloc(timelineData.audioSourceFile, sizeof(uint8));
 					timelineData.audioSourceFile[0] = '\0';
 					timelineData.audioSourceFileLength = 0;
@@ -286,9 +292,7 @@ namespace MathAnim
 				g_memory_free(tracks);
 			}
 
-			Audio::free(audioSource);
-			WavLoader::free(audioData);
-			ImGuiTimeline_free();
+			freeAudioSource();
 		}
 
 		void serialize(const TimelineData& timelineData, nlohmann::json& j)
@@ -352,8 +356,7 @@ namespace MathAnim
 		// ------- Internal Functions --------
 		static void loadAudioSource(const char* filepath)
 		{
-			Audio::free(audioSource);
-			WavLoader::free(audioData);
+			freeAudioSource();
 			audioData = WavLoader::loadWavFile(filepath);
 			audioSource = Audio::loadWavFile(audioData);
 
@@ -368,6 +371,42 @@ namespace MathAnim
 				imguiAudioData.dataSize = audioData.dataSize;
 				imguiAudioData.numAudioChannels = audioData.audioChannelType == AudioChannelType::Dual ? 2 : 1;
 				imguiAudioData.sampleRate = audioData.sampleRate;
+				imguiAudioData.waveform = nullptr;
+
+				// The timeline draws the waveform from a min/max pyramid, build it in the background
+				// and swap it in on the main thread once it's done
+				GlobalThreadPool* threadPool = Application::threadPool();
+				Waveform* builtWaveform = (Waveform*)g_memory_allocate(sizeof(Waveform));
+				uint32 generation = waveformGeneration;
+				threadPool->queueJob(
+					[builtWaveform]()
+					{
+						*builtWaveform = Waveform::build(audioData);
+					},
+					"BuildAudioWaveform",
+					Priority::Medium,
+					&waveformCounter
+				);
+				threadPool->continueWith(
+					waveformCounter,
+					[builtWaveform, generation]()
+					{
+						if (generation == waveformGeneration)
+						{
+							waveform.free();
+							waveform = *builtWaveform;
+							imguiAudioData.waveform = &waveform;
+						}
+						else
+						{
+							builtWaveform->free();
+						}
+						g_memory_free(builtWaveform);
+					},
+					"SwapAudioWaveform",
+					Priority::Medium,
+					true
+				);
 			}
 			else
 			{
@@ -375,6 +414,18 @@ namespace MathAnim
 			}
 		}
 
+		static void freeAudioSource()
+		{
+			// The waveform job reads straight out of audioData, so it has to finish first
+			Application::threadPool()->wait(waveformCounter);
+			waveformGeneration++;
+
+			waveform.free();
+			imguiAudioData.waveform = nullptr;
+			Audio::free(audioSource);
+			WavLoader::free(audioData);
+		}
+
 		static ImGuiTimeline_Track createDefaultTrack(char* inTrackName)
 		{
 			ImGuiTimeline_Track defaultTrack;
@@ -3,10 +3,19 @@
 #include "platform/Platform.h"
 #include "multithreading/GlobalThreadPool.h"
 #include "core/Profiling.h"
+#include "svg/Svg.h"
+#include "svg/SvgParser.h"
+#include "math/CMath.h"
 
-static const char preamble[] = \
-R"raw(\documentclass[preview]{standalone}
+static const char singlePageHeader[] = "\\documentclass[preview]{standalone}\n";
+static constexpr size_t singlePageHeaderLength = sizeof(singlePageHeader) - 1;
+
+// Every standalone environment becomes its own page in multi mode
+static const char multiPageHeader[] = "\\documentclass[preview,multi]{standalone}\n";
+static constexpr size_t multiPageHeaderLength = sizeof(multiPageHeader) - 1;
 
+static const char preamble[] = \
+R"raw(
 \usepackage[english]{babel}
 \usepackage[utf8]{inputenc}
 \usepackage[T1]{fontenc}
@@ -39,6 +48,12 @@ static constexpr size_t beginAlignLength = sizeof(beginAlign) - 1;
 static const char endAlign[] = "\\end{align*}";
 static constexpr size_t endAlignLength = sizeof(endAlign) - 1;
 
+static const char beginPage[] = "\n\\begin{standalone}";
+static constexpr size_t beginPageLength = sizeof(beginPage) - 1;
+
+static const char endPage[] = "\\end{standalone}\n";
+static constexpr size_t endPageLength = sizeof(endPage) - 1;
+
 static const char postamble[] = "\n\\end{document}";
 static constexpr size_t postambleLength = sizeof(postamble) - 1;
 
@@ -48,10 +63,29 @@ namespace MathAnim
 	{
 		struct LaTexTask
 		{
-			char* laTex;
+			std::string laTex;
+			std::string md5;
 			bool isMathTex;
 		};
 
+		struct FinishedLaTex
+		{
+			LaTexTask task;
+			bool succeeded;
+		};
+
+		// Parsed output of one generated equation. The hashes are the preamble and
+		// toolchain it was generated with, entries that don't match the current ones
+		// are stale and get regenerated the next time they're requested.
+		struct LaTexIndexEntry
+		{
+			std::string laTex;
+			uint64 preambleHash;
+			uint64 toolchainHash;
+			uint64 timestamp;
+			RawMemory geometry;
+		};
+
 		// ----------- Internal variables ----------- 
 		static bool latexIsInstalled;
 		static char latexInstallLocation[MATH_ANIMATIONS_MAX_PATH];
@@ -68,17 +102,55 @@ namespace MathAnim
 		static const char* dvisvgmExeName = "miktex-dvisvgm";
 #endif
 
+		// Every pending equation is packed into one multi-page document so latex and
+		// dvisvgm only start once per batch instead of once per equation
+		static constexpr size_t maxEquationsPerBatch = 32;
+		static constexpr uint32 maxBatchesInFlight = 4;
+		// Enough digits for any batch, see getBatchPageOutputPattern
+		static constexpr size_t batchPageNumberWidth = 3;
+
 		static std::mutex latexQueueMutex;
 		static std::unordered_map<std::string, std::string> latexCachedMd5;
-		static std::queue<LaTexTask*> queuedLatex;
-		static LaTexTask* latexInProgress;
+		static std::deque<LaTexTask> queuedLatex;
+		// Md5s that are queued or being compiled, guarded by latexQueueMutex
+		static std::unordered_set<std::string> pendingLatexMd5s;
+		static std::atomic<uint32> numBatchesInFlight;
+		static std::atomic<bool> isShuttingDown;
+		static uint32 nextBatchId;
+		// Requests that finished on a worker and still need to be reported, guarded by latexQueueMutex
+		static std::vector<FinishedLaTex> finishedLatex;
+		static LaTexReadyCallback onLaTexReadyCallback;
+
+		// Index of every generated equation keyed by md5, only touched on the main thread
+		static const char* laTexIndexFilepath = "latex/index.bin";
+		static constexpr uint32 laTexIndexMagicNumber = 0x1A7E71D0;
+		static constexpr uint32 laTexIndexVersion = 1;
+		static std::unordered_map<std::string, LaTexIndexEntry> laTexIndex;
+		static bool laTexIndexIsDirty;
+		static uint64 currentPreambleHash;
+		// 0 until the version check finishes on a worker, and when LaTeX isn't installed
+		static std::atomic<uint64> currentToolchainHash;
 
 		// ----------- Internal functions ----------- 
-		static bool generateSvgFile(const std::string& filename, const std::string& latex, bool isMathTex);
-		static void generateSvgTask(void* data, size_t dataSize);
-
-		void init()
+		static bool validateLaTex(const std::string& latex, bool isMathTex);
+		static void writeLaTexPage(FILE* fp, const LaTexTask& task);
+		static void deleteIntermediateFiles(const std::string& basename);
+		static bool generateSvgFile(const LaTexTask& task);
+		// Returns whether each task got a freshly generated svg, in the same order as tasks
+		static std::vector<bool> generateSvgBatch(uint32 batchId, std::vector<LaTexTask>& tasks);
+		static uint64 hashPreamble();
+		static uint64 hashToolchain();
+		static bool isStale(const LaTexIndexEntry& entry);
+		static bool addToIndex(const std::string& md5, const std::string& latex);
+		static bool readIndexString(RawMemory& memory, std::string* output);
+		static void writeIndexString(RawMemory& memory, const std::string& str);
+		static void loadIndex();
+		static void saveIndex();
+
+		void init(LaTexReadyCallback onLaTexReady)
 		{
+			onLaTexReadyCallback = onLaTexReady;
+
 			// Check if the user has latex.exe installed
 			latexIsInstalled = Platform::getProgramInstallDir("miktex", latexInstallLocation, MATH_ANIMATIONS_MAX_PATH);
 			if (!latexIsInstalled)
@@ -143,28 +215,64 @@ namespace MathAnim
 			}
 
 			Platform::createDirIfNotExists("latex");
+
+			currentPreambleHash = hashPreamble();
+			currentToolchainHash = 0;
+			loadIndex();
+
+			if (latexIsInstalled && latexProgram[0] != '\0')
+			{
+				// Asking the toolchain for its version spawns processes, so don't hold up startup for it
+				Application::threadPool()->queueJob([]()
+				{
+					if (isShuttingDown)
+					{
+						return;
+					}
+
+					// 0 means unknown, so a toolchain that didn't report any version never invalidates anything
+					uint64 toolchainHash = hashToolchain();
+					if (toolchainHash != 0)
+					{
+						currentToolchainHash = toolchainHash;
+					}
+				}, "Hash LaTeX Toolchain", Priority::Low);
+			}
 		}
 
 		void laTexToSvg(const char* latexRaw, bool isMathTex)
 		{
-			if (!latexIsInstalled)
+			std::string latex = std::string(latexRaw);
+			std::string md5 = getLaTexMd5(latex);
+
+			// SVGs generated before the index existed just need to be parsed once
+			std::string svgFullpath = "latex/" + md5 + ".svg";
+			bool isIndexed = laTexIsReady(latex) || (Platform::fileExists(svgFullpath.c_str()) && addToIndex(md5, latex));
+			// Stale SVGs get used until they're regenerated, and for good if there's no LaTeX to regenerate them with
+			bool needsRegenerating = isIndexed && latexIsInstalled && isStale(laTexIndex.at(md5));
+			bool isReady = isIndexed && !needsRegenerating;
+			if (!isIndexed && !latexIsInstalled)
 			{
 				g_logger_error("Cannot parse LaTeX. No LaTeX program found on the system.");
-				return;
 			}
+			bool canGenerate = !isReady && latexIsInstalled && validateLaTex(latex, isMathTex);
 
-			std::string latex = std::string(latexRaw);
-			if (!laTexIsReady(latex))
+			std::lock_guard<std::mutex> lock(latexQueueMutex);
+			if (!canGenerate)
 			{
-				LaTexTask* taskData = (LaTexTask*)g_memory_allocate(sizeof(LaTexTask));
-				taskData->laTex = (char*)g_memory_allocate(sizeof(char) * latex.length() + 1);
-				g_memory_copyMem(taskData->laTex, (void*)latex.c_str(), sizeof(char) * latex.length());
-				taskData->laTex[latex.length()] = '\0';
-				taskData->isMathTex = isMathTex;
+				// Still reported through the callback on the next update so callers only
+				// have to handle one code path
+				finishedLatex.emplace_back(FinishedLaTex{ LaTexTask{ latex, md5, isMathTex }, isReady });
+				return;
+			}
 
-				std::lock_guard<std::mutex> lock(latexQueueMutex);
-				queuedLatex.push(taskData);
+			if (pendingLatexMd5s.find(md5) != pendingLatexMd5s.end())
+			{
+				return;
 			}
+
+			pendingLatexMd5s.insert(md5);
+			queuedLatex.emplace_back(LaTexTask{ latex, md5, isMathTex });
 		}
 
 		bool laTexIsReady(const char* latexRaw, bool)
@@ -175,17 +283,7 @@ namespace MathAnim
 
 		bool laTexIsReady(const std::string& latex)
 		{
-			if (!latexIsInstalled)
-			{
-				g_logger_error("Cannot parse LaTeX. No LaTeX program found on the system.");
-				return false;
-			}
-
-			// Md5 the latex to get a re-generatable filename
-			std::string filename = Platform::md5FromString(latex);
-			std::string svgFullpath = "latex/" + filename + ".svg";
-
-			return Platform::fileExists(svgFullpath.c_str());
+			return laTexIndex.find(getLaTexMd5(latex)) != laTexIndex.end();
 		}
 
 		std::string getLaTexMd5(const char* latexRaw)
@@ -207,85 +305,152 @@ namespace MathAnim
 			return md5;
 		}
 
+		SvgGroup* loadSvgGroup(const std::string& md5)
+		{
+			auto iter = laTexIndex.find(md5);
+			if (iter == laTexIndex.end())
+			{
+				std::string svgFullpath = "latex/" + md5 + ".svg";
+				if (!Platform::fileExists(svgFullpath.c_str()) || !addToIndex(md5, ""))
+				{
+					return nullptr;
+				}
+				iter = laTexIndex.find(md5);
+			}
+
+			SvgGroup* res = (SvgGroup*)g_memory_allocate(sizeof(SvgGroup));
+			iter->second.geometry.setCursor(0);
+			if (!SvgGroup::deserializeGeometry(iter->second.geometry, res))
+			{
+				g_memory_free(res);
+				iter->second.geometry.free();
+				laTexIndex.erase(iter);
+				laTexIndexIsDirty = true;
+				return nullptr;
+			}
+
+			return res;
+		}
+
 		void update()
 		{
 			MP_PROFILE_EVENT("LaTexLayer_Update");
 
-			std::lock_guard<std::mutex> lock(latexQueueMutex);
-
-			// This loop ensures that only one LaTex file gets processed at a time so
-			// that our application doesn't spawn a bunch of process asynchronously and
-			// make everything super slow
+			std::vector<FinishedLaTex> finished;
+			{
+				std::lock_guard<std::mutex> lock(latexQueueMutex);
+				std::swap(finished, finishedLatex);
+			}
 
-			// First check if the last task that was being processed
-			// has finished and free memory if it has
-			if (queuedLatex.size() > 0)
+			// Parse the new SVGs once here so nobody has to poll the filesystem for them
+			for (const auto& result : finished)
 			{
-				if (queuedLatex.front() != nullptr && queuedLatex.front()  == latexInProgress)
+				bool succeeded = result.succeeded;
+				bool replacedStaleSvg = false;
+				auto indexIter = laTexIndex.find(result.task.md5);
+				if (succeeded && (indexIter == laTexIndex.end() || isStale(indexIter->second)))
 				{
-					// If the current item hasn't finished
-					// processing, then wait until it's done
-					// before processing more queued items
-					if (!laTexIsReady(latexInProgress->laTex))
-					{
-						return;
-					}
+					// Only reached with a freshly generated svg, failed regenerations keep their old stamps
+					replacedStaleSvg = indexIter != laTexIndex.end();
+					succeeded = addToIndex(result.task.md5, result.task.laTex);
+					replacedStaleSvg = replacedStaleSvg && succeeded;
+				}
+				else if (!succeeded && indexIter != laTexIndex.end())
+				{
+					// Regenerating a stale equation failed, the old SVG is better than nothing
+					g_logger_warning("Failed to regenerate LaTeX '{}', using the SVG it was generated with before.", result.task.laTex);
+					succeeded = true;
+				}
 
-					// Free the task and pop it from our queue
-					g_logger_info("Finished processing LaTex: '{}'", latexInProgress->laTex);
-					g_memory_free(queuedLatex.front()->laTex);
-					g_memory_free(queuedLatex.front());
-					queuedLatex.pop();
+				if (succeeded)
+				{
+					g_logger_info("Finished processing LaTex: '{}'", result.task.laTex);
+				}
 
-					latexInProgress = nullptr;
+				if (onLaTexReadyCallback)
+				{
+					onLaTexReadyCallback(result.task.md5, succeeded, replacedStaleSvg);
 				}
+			}
 
-				// If there's any elements that need to be processed
-				// process the next element
-				if (queuedLatex.size() > 0)
+			std::lock_guard<std::mutex> lock(latexQueueMutex);
+
+			// Only a few batches run at a time so that our application doesn't spawn a
+			// bunch of processes asynchronously and make everything super slow
+			while (queuedLatex.size() > 0 && numBatchesInFlight.load() < maxBatchesInFlight)
+			{
+				std::vector<LaTexTask> batch;
+				while (queuedLatex.size() > 0 && batch.size() < maxEquationsPerBatch)
 				{
-					LaTexTask* taskData = queuedLatex.front();
-					// Launch this as a task on a new thread so that it doesn't block the main thread
-					Application::threadPool()->queueTask(
-						generateSvgTask,
-						"Generate LaTeX Svg File",
-						taskData,
-						sizeof(LaTexTask)
-					);
-
-					latexInProgress = taskData;
+					batch.emplace_back(std::move(queuedLatex.front()));
+					queuedLatex.pop_front();
 				}
+
+				uint32 batchId = nextBatchId++;
+				numBatchesInFlight++;
+
+				// Launch this as a job on the thread pool so that it doesn't block the main thread
+				Application::threadPool()->queueJob([batchId, batch = std::move(batch)]() mutable
+				{
+					// Don't check for the svg on disk instead, a stale one is still there when regenerating it fails
+					std::vector<bool> generated = !isShuttingDown
+						? generateSvgBatch(batchId, batch)
+						: std::vector<bool>(batch.size(), false);
+
+					std::lock_guard<std::mutex> lock(latexQueueMutex);
+					for (size_t i = 0; i < batch.size(); i++)
+					{
+						bool succeeded = !isShuttingDown && generated[i];
+						pendingLatexMd5s.erase(batch[i].md5);
+						finishedLatex.emplace_back(FinishedLaTex{ std::move(batch[i]), succeeded });
+					}
+					numBatchesInFlight--;
+				}, "Generate LaTeX Svg Batch", Priority::Low);
 			}
 		}
 
 		void free()
 		{
+			// Batches that haven't started yet are skipped when the thread pool drains
+			isShuttingDown = true;
+
 			std::lock_guard<std::mutex> lock(latexQueueMutex);
-			while (queuedLatex.size() > 0)
+			for (const auto& task : queuedLatex)
 			{
-				g_memory_free(queuedLatex.front()->laTex);
-				g_memory_free(queuedLatex.front());
-				queuedLatex.pop();
+				pendingLatexMd5s.erase(task.md5);
 			}
+			queuedLatex.clear();
+			finishedLatex.clear();
+
+			saveIndex();
+			for (auto& [md5, entry] : laTexIndex)
+			{
+				entry.geometry.free();
+			}
+			laTexIndex.clear();
+			onLaTexReadyCallback = nullptr;
 		}
 
-		// ----------- Internal functions ----------- 
-		static void generateSvgTask(void* data, size_t dataSize)
+		std::string getBatchPageOutputPattern(const std::string& basename)
 		{
-			g_logger_assert(dataSize == sizeof(LaTexTask), "Invalid latex task.");
-			LaTexTask* task = (LaTexTask*)data;
+			// dvisvgm pads %p to the digit count of the last page on its own, an explicit
+			// width keeps the names predictable no matter how many pages a batch has
+			return basename + "-%" + std::to_string(batchPageNumberWidth) + "p.svg";
+		}
 
-			std::string filename = getLaTexMd5(task->laTex);
-			if (!generateSvgFile(filename, task->laTex, task->isMathTex))
+		std::string getBatchPageFilename(const std::string& basename, size_t pageNumber)
+		{
+			std::string number = std::to_string(pageNumber);
+			if (number.length() < batchPageNumberWidth)
 			{
-				std::lock_guard<std::mutex> lock(latexQueueMutex);
-				g_memory_free(queuedLatex.front()->laTex);
-				g_memory_free(queuedLatex.front());
-				queuedLatex.pop();
+				number.insert(0, batchPageNumberWidth - number.length(), '0');
 			}
+
+			return basename + "-" + number + ".svg";
 		}
 
-		static bool generateSvgFile(const std::string& filename, const std::string& latex, bool isMathTex)
+		// ----------- Internal functions ----------- 
+		static bool validateLaTex(const std::string& latex, bool isMathTex)
 		{
 			if (isMathTex)
 			{
@@ -313,6 +478,41 @@ namespace MathAnim
 				}
 			}
 
+			return true;
+		}
+
+		static void writeLaTexPage(FILE* fp, const LaTexTask& task)
+		{
+			if (task.isMathTex)
+			{
+				fwrite(beginAlign, beginAlignLength, 1, fp);
+			}
+			fwrite(task.laTex.c_str(), task.laTex.length(), 1, fp);
+			if (task.isMathTex)
+			{
+				fwrite(endAlign, endAlignLength, 1, fp);
+			}
+		}
+
+		static void deleteIntermediateFiles(const std::string& basename)
+		{
+			static const char* extensions[] = { ".dvi", ".tex", ".dvi.log.txt", ".tex.log.txt", ".aux", ".log" };
+			for (const char* extension : extensions)
+			{
+				std::string filepath = "latex/" + basename + extension;
+				if (Platform::fileExists(filepath.c_str()))
+				{
+					Platform::deleteFile(filepath.c_str());
+				}
+			}
+		}
+
+		static bool generateSvgFile(const LaTexTask& task)
+		{
+			MP_PROFILE_EVENT("LaTexLayer_GenerateSvgFile");
+
+			const std::string& filename = task.md5;
+
 			// First write the latex to a file to be processed
 			std::string latexFilename = filename + ".tex";
 			std::string latexFullpath = "latex/" + latexFilename;
@@ -324,16 +524,9 @@ namespace MathAnim
 					return false;
 				}
 
+				fwrite(singlePageHeader, singlePageHeaderLength, 1, fp);
 				fwrite(preamble, preambleLength, 1, fp);
-				if (isMathTex)
-				{
-					fwrite(beginAlign, beginAlignLength, 1, fp);
-				}
-				fwrite(latex.c_str(), latex.length(), 1, fp);
-				if (isMathTex)
-				{
-					fwrite(endAlign, endAlignLength, 1, fp);
-				}
+				writeLaTexPage(fp, task);
 				fwrite(postamble, postambleLength, 1, fp);
 				fclose(fp);
 			}
@@ -342,33 +535,434 @@ namespace MathAnim
 			std::string workingDirectory = "./latex/";
 			std::string cmdArgs = latexFilename + " -halt-on-error";
 			std::string logFilename = filename + ".tex.log.txt";
-			Platform::executeProgram(latexProgram, cmdArgs.c_str(), workingDirectory.c_str(), logFilename.c_str());
+			bool latexSucceeded = Platform::executeProgram(latexProgram, cmdArgs.c_str(), workingDirectory.c_str(), logFilename.c_str());
 
 			std::string dviFilename = filename + ".dvi";
 			std::string dviFullpath = "latex/" + dviFilename;
-			if (Platform::fileExists(dviFullpath.c_str()))
-			{
-				std::string dviLogFilename = filename + ".dvi.log.txt";
-				std::string cmdArgs2 = dviFilename + " -n";
-				Platform::executeProgram(dvisvgmProgram, cmdArgs2.c_str(), workingDirectory.c_str(), dviLogFilename.c_str());
-
-				// Sleep for 1 second before deleting files to make sure they are not locked
-				std::this_thread::sleep_for(std::chrono::seconds(1));
-				// If everything succeeded, clear out all the unnecessary files
-				Platform::deleteFile(dviFullpath.c_str());
-				Platform::deleteFile(latexFullpath.c_str());
-				Platform::deleteFile(("latex/" + dviLogFilename).c_str());
-				Platform::deleteFile(("latex/" + logFilename).c_str());
-				Platform::deleteFile(("latex/" + filename + ".aux").c_str());
-				Platform::deleteFile(("latex/" + filename + ".log").c_str());
+			if (!latexSucceeded || !Platform::fileExists(dviFullpath.c_str()))
+			{
+				g_logger_error("There was an error processing the latex file: '{}'", latexFullpath);
+				return false;
+			}
+
+			std::string dviLogFilename = filename + ".dvi.log.txt";
+			std::string cmdArgs2 = dviFilename + " -n";
+			if (!Platform::executeProgram(dvisvgmProgram, cmdArgs2.c_str(), workingDirectory.c_str(), dviLogFilename.c_str()))
+			{
+				g_logger_error("There was an error converting the dvi file to svg: '{}'", dviFullpath);
+				return false;
+			}
+
+			// executeProgram only returns once the processes have exited, so none
+			// of these files are locked anymore
+			deleteIntermediateFiles(filename);
+			return true;
+		}
+
+		static std::vector<bool> generateSvgBatch(uint32 batchId, std::vector<LaTexTask>& tasks)
+		{
+			MP_PROFILE_EVENT("LaTexLayer_GenerateSvgBatch");
+
+			std::vector<bool> generated(tasks.size(), false);
+			if (tasks.size() == 1)
+			{
+				generated[0] = generateSvgFile(tasks[0]);
+				return generated;
+			}
+
+			std::string basename = "batch_" + std::to_string(batchId);
+			std::string latexFilename = basename + ".tex";
+			std::string latexFullpath = "latex/" + latexFilename;
+			{
+				FILE* fp = fopen(latexFullpath.c_str(), "wb");
+				if (!fp)
+				{
+					g_logger_error("Failed to create file: '{}'", latexFullpath);
+					return generated;
+				}
+
+				// One page per equation, in the same order as tasks
+				fwrite(multiPageHeader, multiPageHeaderLength, 1, fp);
+				fwrite(preamble, preambleLength, 1, fp);
+				for (const auto& task : tasks)
+				{
+					fwrite(beginPage, beginPageLength, 1, fp);
+					writeLaTexPage(fp, task);
+					fwrite(endPage, endPageLength, 1, fp);
+				}
+				fwrite(postamble, postambleLength, 1, fp);
+				fclose(fp);
+			}
+
+			// Batch ids restart every session, clear out pages a crashed session may have left behind
+			for (size_t i = 0; i < tasks.size() + 1; i++)
+			{
+				std::string stalePageFilepath = "latex/" + getBatchPageFilename(basename, i + 1);
+				if (Platform::fileExists(stalePageFilepath.c_str()))
+				{
+					Platform::deleteFile(stalePageFilepath.c_str());
+				}
+			}
+
+			std::string workingDirectory = "./latex/";
+			std::string cmdArgs = latexFilename + " -halt-on-error";
+			std::string logFilename = basename + ".tex.log.txt";
+			bool succeeded = Platform::executeProgram(latexProgram, cmdArgs.c_str(), workingDirectory.c_str(), logFilename.c_str());
+
+			std::string dviFilename = basename + ".dvi";
+			if (succeeded && Platform::fileExists(("latex/" + dviFilename).c_str()))
+			{
+				// Writes every page to batch_<id>-<pageNumber>.svg
+				std::string dviLogFilename = basename + ".dvi.log.txt";
+				std::string cmdArgs2 = dviFilename + " -n -p 1- -o " + getBatchPageOutputPattern(basename);
+				succeeded = Platform::executeProgram(dvisvgmProgram, cmdArgs2.c_str(), workingDirectory.c_str(), dviLogFilename.c_str());
 			}
 			else
 			{
-				g_logger_error("There was an error processing the latex file.");
+				succeeded = false;
+			}
+
+			// An equation that spans several pages would shift every page after it, so only
+			// trust the page numbers if there's exactly one page per equation
+			std::vector<std::string> pageFilepaths;
+			for (size_t i = 0; i < tasks.size() + 1; i++)
+			{
+				std::string pageFilepath = "latex/" + getBatchPageFilename(basename, i + 1);
+				if (!Platform::fileExists(pageFilepath.c_str()))
+				{
+					break;
+				}
+				pageFilepaths.emplace_back(pageFilepath);
+			}
+			succeeded = succeeded && pageFilepaths.size() == tasks.size();
+
+			if (succeeded)
+			{
+				// Renaming is atomic, so laTexIsReady never sees a half written svg
+				for (size_t i = 0; i < tasks.size(); i++)
+				{
+					std::error_code error;
+					std::filesystem::rename(pageFilepaths[i], "latex/" + tasks[i].md5 + ".svg", error);
+					if (error)
+					{
+						g_logger_error("Failed to move '{}' into the LaTeX cache: '{}'", pageFilepaths[i], error.message());
+					}
+					generated[i] = !error;
+				}
+			}
+			else
+			{
+				for (const auto& pageFilepath : pageFilepaths)
+				{
+					Platform::deleteFile(pageFilepath.c_str());
+				}
+			}
+
+			deleteIntermediateFiles(basename);
+
+			if (!succeeded)
+			{
+				// One bad equation fails the whole batch, compile them one by one so the
+				// good equations still get generated and the error log points at the bad one
+				g_logger_warning("LaTeX batch '{}' failed, compiling its {} equations individually.", basename, tasks.size());
+				for (size_t i = 0; i < tasks.size(); i++)
+				{
+					if (isShuttingDown)
+					{
+						break;
+					}
+
+					generated[i] = generateSvgFile(tasks[i]);
+				}
+			}
+
+			return generated;
+		}
+
+		static uint64 hashPreamble()
+		{
+			// Any change to the template every equation is compiled with invalidates the index
+			uint64 hash = CMath::hashBytes(singlePageHeader, singlePageHeaderLength);
+			hash = CMath::hashBytes(multiPageHeader, multiPageHeaderLength, hash);
+			hash = CMath::hashBytes(preamble, preambleLength, hash);
+			hash = CMath::hashBytes(beginAlign, beginAlignLength, hash);
+			hash = CMath::hashBytes(endAlign, endAlignLength, hash);
+			hash = CMath::hashBytes(beginPage, beginPageLength, hash);
+			hash = CMath::hashBytes(endPage, endPageLength, hash);
+			hash = CMath::hashBytes(postamble, postambleLength, hash);
+			return hash;
+		}
+
+		static uint64 hashToolchain()
+		{
+			MP_PROFILE_EVENT("LaTexLayer_HashToolchain");
+
+			// Hashes what the programs report as their version, that stays the same when an
+			// update touches the executables without changing them or the install moves
+			uint64 hash = CMath::hashBytes(nullptr, 0);
+			int numVersionsHashed = 0;
+			const char* programs[] = { latexProgram, dvisvgmProgram };
+			for (const char* program : programs)
+			{
+				if (program[0] == '\0')
+				{
+					continue;
+				}
+
+				const char* versionFilepath = "latex/toolchainVersion.txt";
+				if (!Platform::executeProgram(program, "--version", nullptr, versionFilepath))
+				{
+					g_logger_warning("Failed to get the version of '{}', cached LaTeX won't be checked against it.", program);
+					continue;
+				}
+
+				std::ifstream versionFile(versionFilepath);
+				std::string version = std::string(std::istreambuf_iterator<char>(versionFile), std::istreambuf_iterator<char>());
+				versionFile.close();
+				Platform::deleteFile(versionFilepath);
+				hash = CMath::hashBytes(version.c_str(), version.length(), hash);
+				numVersionsHashed++;
+			}
+
+			// 0 means unknown. A real hash that happens to be 0 still has to be told apart from that.
+			if (numVersionsHashed == 0)
+			{
+				return 0;
+			}
+			return hash != 0 ? hash : 1;
+		}
+
+		static bool isStale(const LaTexIndexEntry& entry)
+		{
+			if (entry.preambleHash != currentPreambleHash)
+			{
+				return true;
+			}
+
+			// Nothing gets invalidated by a toolchain we don't know the version of
+			uint64 toolchainHash = currentToolchainHash.load();
+			return toolchainHash != 0 && entry.toolchainHash != 0 && entry.toolchainHash != toolchainHash;
+		}
+
+		static bool addToIndex(const std::string& md5, const std::string& latex)
+		{
+			MP_PROFILE_EVENT("LaTexLayer_AddToIndex");
+
+			std::string svgFullpath = "latex/" + md5 + ".svg";
+			SvgGroup* group = SvgParser::parseSvgDoc(svgFullpath.c_str());
+			if (!group)
+			{
+				g_logger_error("Failed to parse generated LaTeX svg '{}'.", svgFullpath);
 				return false;
 			}
 
+			LaTexIndexEntry entry;
+			entry.laTex = latex;
+			entry.preambleHash = currentPreambleHash;
+			entry.toolchainHash = currentToolchainHash;
+			entry.timestamp = (uint64)std::chrono::duration_cast<std::chrono::seconds>(
+				std::chrono::system_clock::now().time_since_epoch()).count();
+			entry.geometry.init(sizeof(SvgGroup));
+			group->serializeGeometry(entry.geometry);
+			entry.geometry.shrinkToFit();
+
+			group->free();
+			g_memory_free(group);
+
+			auto iter = laTexIndex.find(md5);
+			if (iter != laTexIndex.end())
+			{
+				iter->second.geometry.free();
+				laTexIndex.erase(iter);
+			}
+			laTexIndex.emplace(md5, entry);
+			laTexIndexIsDirty = true;
+
 			return true;
 		}
+
+		static bool readIndexString(RawMemory& memory, std::string* output)
+		{
+			uint32 length = 0;
+			if (!memory.read<uint32>(&length) || length > memory.size - memory.offset)
+			{
+				return false;
+			}
+
+			output->resize(length);
+			return length == 0 || memory.readDangerous((uint8*)output->data(), length);
+		}
+
+		static void writeIndexString(RawMemory& memory, const std::string& str)
+		{
+			uint32 length = (uint32)str.length();
+			memory.write<uint32>(&length);
+			if (length > 0)
+			{
+				memory.writeDangerous((const uint8*)str.c_str(), length);
+			}
+		}
+
+		static void loadIndex()
+		{
+			MP_PROFILE_EVENT("LaTexLayer_LoadIndex");
+
+			laTexIndexIsDirty = false;
+
+			FILE* fp = fopen(laTexIndexFilepath, "rb");
+			if (!fp)
+			{
+				return;
+			}
+
+			fseek(fp, 0, SEEK_END);
+			size_t fileSize = (size_t)ftell(fp);
+			fseek(fp, 0, SEEK_SET);
+
+			RawMemory memory;
+			memory.init(glm::max(fileSize, (size_t)1));
+			size_t amountRead = fread(memory.data, 1, fileSize, fp);
+			fclose(fp);
+			memory.size = amountRead;
+
+			// Index looks like
+			// magicNumber          -> uint32
+			// version              -> uint32
+			// numEntries           -> uint32
+			// entries              -> Entry[numEntries]
+			//
+			// Each entry looks like
+			// md5                  -> String
+			// laTex                -> String
+			// preambleHash         -> uint64
+			// toolchainHash        -> uint64
+			// timestamp            -> uint64
+			// geometrySize         -> uint64
+			// geometry             -> uint8[geometrySize]
+			uint32 magicNumber = 0;
+			uint32 version = 0;
+			uint32 numEntries = 0;
+			bool success = memory.read<uint32>(&magicNumber);
+			success = success && memory.read<uint32>(&version);
+			success = success && memory.read<uint32>(&numEntries);
+			if (!success || magicNumber != laTexIndexMagicNumber || version != laTexIndexVersion)
+			{
+				g_logger_warning("LaTeX index '{}' is corrupted or out of date. Every equation will be regenerated.", laTexIndexFilepath);
+				memory.free();
+				laTexIndexIsDirty = true;
+				return;
+			}
+
+			uint32 numStale = 0;
+			for (uint32 i = 0; i < numEntries && success; i++)
+			{
+				std::string md5;
+				LaTexIndexEntry entry;
+				uint64 geometrySize = 0;
+				success = readIndexString(memory, &md5);
+				success = success && readIndexString(memory, &entry.laTex);
+				success = success && memory.read<uint64>(&entry.preambleHash);
+				success = success && memory.read<uint64>(&entry.toolchainHash);
+				success = success && memory.read<uint64>(&entry.timestamp);
+				success = success && memory.read<uint64>(&geometrySize);
+				success = success && geometrySize <= memory.size - memory.offset;
+				if (!success)
+				{
+					break;
+				}
+
+				// Stale entries stay in the index, they get regenerated lazily when they're
+				// requested and LaTeX is around to do it. The toolchain hash isn't known yet.
+				if (entry.preambleHash != currentPreambleHash)
+				{
+					numStale++;
+				}
+
+				entry.geometry.init(glm::max(geometrySize, (uint64)1));
+				memory.readDangerous(entry.geometry.data, geometrySize);
+				entry.geometry.size = geometrySize;
+
+				if (!entry.laTex.empty())
+				{
+					latexCachedMd5[entry.laTex] = md5;
+				}
+				laTexIndex.emplace(md5, entry);
+			}
+
+			if (!success)
+			{
+				g_logger_warning("LaTeX index '{}' is truncated, only loaded '{}' entries.", laTexIndexFilepath, laTexIndex.size());
+			}
+
+			if (numStale > 0)
+			{
+				g_logger_info("The LaTeX preamble changed, '{}' equations will be regenerated when they're used.", numStale);
+			}
+
+			laTexIndexIsDirty = !success;
+			memory.free();
+		}
+
+		static void saveIndex()
+		{
+			if (!laTexIndexIsDirty)
+			{
+				return;
+			}
+
+			MP_PROFILE_EVENT("LaTexLayer_SaveIndex");
+
+			RawMemory memory;
+			memory.init(sizeof(uint32) * 3);
+			uint32 magicNumber = laTexIndexMagicNumber;
+			uint32 version = laTexIndexVersion;
+			uint32 numEntries = (uint32)laTexIndex.size();
+			memory.write<uint32>(&magicNumber);
+			memory.write<uint32>(&version);
+			memory.write<uint32>(&numEntries);
+			for (const auto& [md5, entry] : laTexIndex)
+			{
+				uint64 geometrySize = (uint64)entry.geometry.size;
+				writeIndexString(memory, md5);
+				writeIndexString(memory, entry.laTex);
+				memory.write<uint64>(&entry.preambleHash);
+				memory.write<uint64>(&entry.toolchainHash);
+				memory.write<uint64>(&entry.timestamp);
+				memory.write<uint64>(&geometrySize);
+				if (geometrySize > 0)
+				{
+					memory.writeDangerous(entry.geometry.data, geometrySize);
+				}
+			}
+
+			// Write to a temporary file first so a crash never leaves a half written index
+			std::string tmpFilepath = std::string(laTexIndexFilepath) + ".tmp";
+			FILE* fp = fopen(tmpFilepath.c_str(), "wb");
+			if (!fp)
+			{
+				g_logger_error("Failed to save LaTeX index '{}'.", tmpFilepath);
+				memory.free();
+				return;
+			}
+
+			bool writeSucceeded = fwrite(memory.data, memory.offset, 1, fp) == 1;
+			fclose(fp);
+			memory.free();
+
+			std::error_code error;
+			if (writeSucceeded)
+			{
+				std::filesystem::rename(tmpFilepath, laTexIndexFilepath, error);
+			}
+
+			if (!writeSucceeded || error)
+			{
+				g_logger_error("Failed to save LaTeX index '{}'.", laTexIndexFilepath);
+				std::filesystem::remove(tmpFilepath, error);
+				return;
+			}
+
+			laTexIndexIsDirty = false;
+		}
 	}
 }
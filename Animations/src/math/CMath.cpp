@@ -421,6 +421,21 @@ namespace MathAnim
 			return hash;
 		}
 
+		uint64 hashBytes(const void* data, size_t length, uint64 seed)
+		{
+			constexpr uint64 FNVPrime = 0x00000100000001B3ULL;
+
+			uint64 hash = seed;
+			const uint8* bytes = (const uint8*)data;
+			for (size_t i = 0; i < length; i++)
+			{
+				hash ^= bytes[i];
+				hash *= FNVPrime;
+			}
+
+			return hash;
+		}
+
 		Vec2 bezier1(const Vec2& p0, const Vec2& p1, float t)
 		{
 			return (1.0f - t) * p0 + t * p1;
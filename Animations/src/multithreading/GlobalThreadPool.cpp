@@ -3,30 +3,23 @@
 
 namespace MathAnim
 {
-	bool CompareThreadTask::operator()(const ThreadTask& a, const ThreadTask& b) const
-	{
-		if (a.priority == b.priority)
-		{
-			return a.counter > b.counter;
-		}
-
-		return (uint8)a.priority > (uint8)b.priority;
-	}
+	// Index of the worker running on this thread, -1 for threads outside the pool
+	static thread_local int32 currentWorkerIndex = -1;
+	static thread_local const GlobalThreadPool* currentWorkerPool = nullptr;
 
 	GlobalThreadPool::GlobalThreadPool(uint32 numThreads)
-		: cv(), queueMtx(), generalMtx(), doWork(true), numThreads(numThreads)
+		: finishedTasks(), numQueuedJobs(0), numSleepingWorkers(0), nextQueue(0), doWork(true), numThreads(glm::max(numThreads, 1u))
 	{
-		tasks = new std::priority_queue<ThreadTask, std::vector<ThreadTask>, CompareThreadTask>();
+		workerQueues = new WorkerQueue[this->numThreads];
 		cv = new std::condition_variable();
-		generalMtx = new std::mutex();
-		queueMtx = new std::mutex();
+		sleepMtx = new std::mutex();
 		finishedQueueMtx = new std::mutex();
-		workerThreads = new std::thread[numThreads];
+		workerThreads = new std::thread[this->numThreads];
 #ifdef _DEBUG
 		forceSynchronous = false;
 #endif
 
-		for (uint32 i = 0; i < numThreads; i++)
+		for (uint32 i = 0; i < this->numThreads; i++)
 		{
 			workerThreads[i] = std::thread(&GlobalThreadPool::processLoop, this, i);
 		}
@@ -34,16 +27,14 @@ namespace MathAnim
 
 #ifdef _DEBUG
 	GlobalThreadPool::GlobalThreadPool(bool forceSynchronous)
+		: finishedTasks(), numQueuedJobs(0), numSleepingWorkers(0), nextQueue(0), doWork(false), numThreads(0)
 	{
 		this->forceSynchronous = forceSynchronous;
-		tasks = nullptr;
+		workerQueues = nullptr;
 		cv = nullptr;
-		generalMtx = nullptr;
-		queueMtx = nullptr;
-		finishedQueueMtx = nullptr;
+		sleepMtx = nullptr;
+		finishedQueueMtx = new std::mutex();
 		workerThreads = nullptr;
-		doWork = false;
-		numThreads = 0;
 	}
 #endif
 
@@ -52,16 +43,19 @@ namespace MathAnim
 #ifdef _DEBUG
 		if (forceSynchronous)
 		{
+			processFinishedTasks();
+			delete finishedQueueMtx;
 			return;
 		}
 #endif
 
 		{
-			std::lock_guard lock(*generalMtx);
+			std::lock_guard<std::mutex> lock(*sleepMtx);
 			doWork = false;
 		}
 		cv->notify_all();
 
+		// Workers keep going until every queue is empty
 		for (uint32 i = 0; i < numThreads; i++)
 		{
 			workerThreads[i].join();
@@ -70,71 +64,58 @@ namespace MathAnim
 		processFinishedTasks();
 
 		delete[] workerThreads;
-		delete tasks;
-		delete generalMtx;
-		delete queueMtx;
+		delete[] workerQueues;
+		delete cv;
+		delete sleepMtx;
 		delete finishedQueueMtx;
 	}
 
-	void GlobalThreadPool::processFinishedTasks() 
+	void GlobalThreadPool::processFinishedTasks()
 	{
 		MP_PROFILE_EVENT("GlobalThreadPool_ProcessFinishedTasks");
-		std::lock_guard<std::mutex> lock(*this->finishedQueueMtx);
-		while (!this->finishedTasks.empty())
+
+		// Swap the queue out first so callbacks can queue more work without deadlocking
+		std::queue<JobFunction> tasksToRun;
+		{
+			std::lock_guard<std::mutex> lock(*this->finishedQueueMtx);
+			std::swap(tasksToRun, this->finishedTasks);
+		}
+
+		while (!tasksToRun.empty())
 		{
-			ThreadTask& task = finishedTasks.front();
-			task.callback(task.data, task.dataSize);
-			finishedTasks.pop();
+			tasksToRun.front()();
+			tasksToRun.pop();
 		}
 	}
 
-// Disable this warning since this parameter is used in certain builds
-#pragma warning( push )
-#pragma warning( disable : 4100 )
 	void GlobalThreadPool::processLoop(uint32 threadIndex)
-#pragma warning( pop )
 	{
 		std::string threadName = "GlobalThread_" + std::to_string(threadIndex);
 		MP_PROFILE_THREAD(threadName.c_str());
 
-		bool shouldContinue = true;
-		while (shouldContinue)
+		currentWorkerIndex = (int32)threadIndex;
+		currentWorkerPool = this;
+
+		while (true)
 		{
-			if (tasks->empty())
+			if (tryRunJob((int32)threadIndex))
 			{
-				// Wait until we need to do some work
-				std::unique_lock<std::mutex> lock(*generalMtx);
-				cv->wait(lock, [&] { return (!doWork || !tasks->empty()); });
-				shouldContinue = doWork && !tasks->empty();
+				continue;
 			}
 
-			ThreadTask task{};
+			// Wait until we need to do some work
+			std::unique_lock<std::mutex> lock(*sleepMtx);
+			numSleepingWorkers++;
+			cv->wait(lock, [&] { return !doWork || numQueuedJobs.load() > 0; });
+			numSleepingWorkers--;
+			if (!doWork && numQueuedJobs.load() == 0)
 			{
-				std::lock_guard<std::mutex> queueLock(*queueMtx);
-				if (tasks->size() > 0)
-				{
-					task = tasks->top();
-					tasks->pop();
-				}
-				else
-				{
-					task.fn = nullptr;
-				}
-			}
-
-			if (task.fn)
-			{
-				{
-					MP_PROFILE_DYNAMIC_EVENT(task.taskName);
-					task.fn(task.data, task.dataSize);
-				}
-				if (task.callback)
-				{
-					std::lock_guard<std::mutex> lock(*this->finishedQueueMtx);
-					this->finishedTasks.push(task);
-				}
+				break;
 			}
 		}
+
+		currentWorkerIndex = -1;
+		currentWorkerPool = nullptr;
 	}
 
 	void GlobalThreadPool::queueTask(TaskFunction function, const char* taskName, void* data, size_t dataSize, Priority priority, ThreadCallback callback)
@@ -155,20 +136,19 @@ namespace MathAnim
 		}
 #endif
 
-		static uint64 counter = 0;
-		ThreadTask task;
-		task.fn = function;
-		task.data = data;
-		task.dataSize = dataSize;
-		task.priority = priority;
-		task.callback = callback;
-		task.taskName = taskName;
-		{
-			std::lock_guard<std::mutex> lockGuard(*queueMtx);
-			task.counter = counter++;
-			tasks->push(task);
-			cv->notify_one();
-		}
+		queueJob([this, function, data, dataSize, callback]()
+		{
+			if (function)
+			{
+				function(data, dataSize);
+			}
+
+			if (callback)
+			{
+				std::lock_guard<std::mutex> lock(*this->finishedQueueMtx);
+				this->finishedTasks.push([callback, data, dataSize]() { callback(data, dataSize); });
+			}
+		}, taskName, priority);
 	}
 
 	void GlobalThreadPool::beginWork(bool notifyAll)
@@ -180,6 +160,11 @@ namespace MathAnim
 		}
 #endif
 
+		// Jobs start as soon as they're queued, this just makes sure nobody is left sleeping
+		{
+			std::lock_guard<std::mutex> lock(*sleepMtx);
+		}
+
 		if (notifyAll)
 		{
 			cv->notify_all();
@@ -189,4 +174,278 @@ namespace MathAnim
 			cv->notify_one();
 		}
 	}
+
+	void GlobalThreadPool::queueJob(JobFunction&& job, const char* jobName, Priority priority, JobCounter* counter)
+	{
+		if (counter)
+		{
+			counter->pending.fetch_add(1, std::memory_order_acq_rel);
+		}
+
+#ifdef _DEBUG
+		if (forceSynchronous)
+		{
+			Job syncJob = { std::move(job), counter, jobName };
+			runJob(syncJob);
+			return;
+		}
+#endif
+
+		pushJob(Job{ std::move(job), counter, jobName }, priority);
+	}
+
+	void GlobalThreadPool::continueWith(JobCounter& counter, JobFunction&& continuation, const char* continuationName, Priority priority, bool runOnMainThread)
+	{
+		{
+			std::lock_guard<std::mutex> lock(counter.continuationMtx);
+			if (!counter.isDone())
+			{
+				counter.continuations.emplace_back(JobCounter::Continuation{ std::move(continuation), continuationName, priority, runOnMainThread });
+				return;
+			}
+		}
+
+		// Everything already finished, so the continuation can go right away
+		if (runOnMainThread)
+		{
+			std::lock_guard<std::mutex> lock(*this->finishedQueueMtx);
+			this->finishedTasks.push(std::move(continuation));
+		}
+		else
+		{
+			queueJob(std::move(continuation), continuationName, priority);
+		}
+	}
+
+	void GlobalThreadPool::wait(JobCounter& counter)
+	{
+		MP_PROFILE_EVENT("GlobalThreadPool_Wait");
+
+		constexpr int numYieldsBeforeSleeping = 16;
+		int numEmptyPolls = 0;
+		while (!counter.isDone())
+		{
+			// Help out instead of blocking the thread, but only with jobs we're waiting on.
+			// Anything else could hold the caller up behind unrelated work.
+			Job job;
+#ifdef _DEBUG
+			bool foundJob = !forceSynchronous && popJobFor(counter, &job);
+#else
+			bool foundJob = popJobFor(counter, &job);
+#endif
+			if (foundJob)
+			{
+				runJob(job);
+				numEmptyPolls = 0;
+			}
+			else if (numEmptyPolls < numYieldsBeforeSleeping)
+			{
+				std::this_thread::yield();
+				numEmptyPolls++;
+			}
+			else
+			{
+				// Everything left is already running somewhere else. The timeout is there because
+				// those jobs can queue more work on this counter, which this thread should help with.
+				std::unique_lock<std::mutex> lock(counter.continuationMtx);
+				counter.finishedCv.wait_for(lock, std::chrono::microseconds(500), [&counter]() { return counter.isDone(); });
+			}
+		}
+
+		// The last job decrements the counter while holding this lock, so taking it makes
+		// sure nobody is still touching the counter when the caller destroys it
+		std::lock_guard<std::mutex> lock(counter.continuationMtx);
+	}
+
+	void GlobalThreadPool::parallelFor(size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)>& fn, Priority priority)
+	{
+		MP_PROFILE_EVENT("GlobalThreadPool_ParallelFor");
+
+		if (count == 0)
+		{
+			return;
+		}
+
+		grainSize = glm::max(grainSize, (size_t)1);
+
+		// Queue every chunk except the first, the calling thread runs that one itself
+		JobCounter counter;
+		for (size_t begin = grainSize; begin < count; begin += grainSize)
+		{
+			size_t end = glm::min(begin + grainSize, count);
+			queueJob([&fn, begin, end]() { fn(begin, end); }, "ParallelFor", priority, &counter);
+		}
+
+		fn(0, glm::min(grainSize, count));
+		wait(counter);
+	}
+
+	// ------------------- Internal functions -------------------
+	void GlobalThreadPool::pushJob(Job&& job, Priority priority)
+	{
+		g_logger_assert(priority < Priority::Length, "Invalid job priority '{}'.", (uint8)priority);
+
+		// Workers push onto their own queue, everyone else spreads jobs round-robin
+		uint32 queueIndex = currentWorkerPool == this && currentWorkerIndex >= 0
+			? (uint32)currentWorkerIndex
+			: nextQueue.fetch_add(1, std::memory_order_relaxed) % numThreads;
+
+		// Count the job before it's visible so numQueuedJobs never underflows
+		numQueuedJobs++;
+		{
+			WorkerQueue& queue = workerQueues[queueIndex];
+			std::lock_guard<std::mutex> lock(queue.mtx);
+			queue.lanes[(uint8)priority].emplace_back(std::move(job));
+		}
+
+		// Skip the wakeup entirely while every worker is busy. Sleeping workers re-check
+		// numQueuedJobs after registering themselves, so no wakeup can be missed.
+		if (numSleepingWorkers.load() > 0)
+		{
+			{
+				std::lock_guard<std::mutex> lock(*sleepMtx);
+			}
+			cv->notify_one();
+		}
+	}
+
+	bool GlobalThreadPool::popJob(int32 workerIndex, Job* output)
+	{
+		if (numQueuedJobs.load(std::memory_order_acquire) == 0)
+		{
+			return false;
+		}
+
+		for (uint8 lane = 0; lane < (uint8)Priority::Length; lane++)
+		{
+			// Own queue first, newest job first since it's most likely to still be in cache
+			if (workerIndex >= 0)
+			{
+				WorkerQueue& queue = workerQueues[workerIndex];
+				std::lock_guard<std::mutex> lock(queue.mtx);
+				if (!queue.lanes[lane].empty())
+				{
+					*output = std::move(queue.lanes[lane].back());
+					queue.lanes[lane].pop_back();
+					numQueuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+					return true;
+				}
+			}
+
+			// Then steal the oldest job from everyone else
+			uint32 startIndex = workerIndex >= 0 ? (uint32)workerIndex + 1 : 0;
+			for (uint32 i = 0; i < numThreads; i++)
+			{
+				uint32 victimIndex = (startIndex + i) % numThreads;
+				if ((int32)victimIndex == workerIndex)
+				{
+					continue;
+				}
+
+				WorkerQueue& victim = workerQueues[victimIndex];
+				std::lock_guard<std::mutex> lock(victim.mtx);
+				if (!victim.lanes[lane].empty())
+				{
+					*output = std::move(victim.lanes[lane].front());
+					victim.lanes[lane].pop_front();
+					numQueuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	bool GlobalThreadPool::popJobFor(const JobCounter& counter, Job* output)
+	{
+		if (numQueuedJobs.load(std::memory_order_acquire) == 0)
+		{
+			return false;
+		}
+
+		for (uint8 lane = 0; lane < (uint8)Priority::Length; lane++)
+		{
+			for (uint32 i = 0; i < numThreads; i++)
+			{
+				WorkerQueue& queue = workerQueues[i];
+				std::lock_guard<std::mutex> lock(queue.mtx);
+				std::deque<Job>& jobs = queue.lanes[lane];
+				for (auto iter = jobs.begin(); iter != jobs.end(); iter++)
+				{
+					if (iter->counter == &counter)
+					{
+						*output = std::move(*iter);
+						jobs.erase(iter);
+						numQueuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+						return true;
+					}
+				}
+			}
+		}
+
+		return false;
+	}
+
+	bool GlobalThreadPool::tryRunJob(int32 workerIndex)
+	{
+#ifdef _DEBUG
+		if (forceSynchronous)
+		{
+			return false;
+		}
+#endif
+
+		Job job;
+		if (!popJob(workerIndex, &job))
+		{
+			return false;
+		}
+
+		runJob(job);
+		return true;
+	}
+
+	void GlobalThreadPool::runJob(Job& job)
+	{
+		{
+			MP_PROFILE_DYNAMIC_EVENT(job.name);
+			job.fn();
+		}
+
+		finishJob(job.counter);
+	}
+
+	void GlobalThreadPool::finishJob(JobCounter* counter)
+	{
+		if (!counter)
+		{
+			return;
+		}
+
+		std::vector<JobCounter::Continuation> readyContinuations;
+		{
+			std::lock_guard<std::mutex> lock(counter->continuationMtx);
+			if (counter->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				std::swap(readyContinuations, counter->continuations);
+				// Still under the lock, a woken waiter is free to destroy the counter once it's released
+				counter->finishedCv.notify_all();
+			}
+		}
+
+		// The counter may be destroyed from here on, only touch the local copies
+		for (auto& continuation : readyContinuations)
+		{
+			if (continuation.runOnMainThread)
+			{
+				std::lock_guard<std::mutex> lock(*this->finishedQueueMtx);
+				this->finishedTasks.push(std::move(continuation.fn));
+			}
+			else
+			{
+				queueJob(std::move(continuation.fn), continuation.name, continuation.priority);
+			}
+		}
+	}
 }
@@ -7,13 +7,27 @@ namespace MathAnim
 {
 	using namespace nlohmann;
 
+	// ----------- Internal Variables -----------
+	// Regexes using \G can only match at the search start, so their results depend on where
+	// the search began and can't be reused from an earlier search
+	static std::unordered_set<const regex_t*> regexesWithStartAnchor = {};
+
 	// ----------- Internal Functions -----------
 	static Grammar* importGrammarFromJson(const json& j);
 	static SyntaxPattern parsePattern(const json& json);
 	static std::vector<SyntaxPattern> parsePatternsArray(const json& json);
 	static regex_t* onigFromString(const std::string& str);
-	static std::optional<GrammarMatch> getFirstMatch(const std::string& str, size_t start, size_t end, regex_t* reg, OnigRegion* region);
-	static std::vector<GrammarMatch> checkForMatches(const std::string& str, size_t start, size_t end, regex_t* reg, OnigRegion* region, std::optional<CaptureList> captures);
+	static void freeRegex(regex_t* reg);
+	static const RegexSearchResult* searchRegex(const std::string& str, size_t start, size_t end, regex_t* reg, OnigRegion* region, RegexSearchCache* cache);
+	static std::optional<GrammarMatch> getFirstMatch(const std::string& str, size_t start, size_t end, regex_t* reg, OnigRegion* region, RegexSearchCache* cache);
+	static std::vector<GrammarMatch> checkForMatches(const std::string& str, size_t start, size_t end, regex_t* reg, OnigRegion* region, RegexSearchCache* cache, const std::optional<CaptureList>& captures);
+
+	void RegexSearchCache::reset()
+	{
+		results.clear();
+		numSearches = 0;
+		numCacheHits = 0;
+	}
 
 	CaptureList CaptureList::from(const json& j)
 	{
@@ -54,14 +68,14 @@ namespace MathAnim
 		return res;
 	}
 
-	bool SimpleSyntaxPattern::match(const std::string& str, size_t start, size_t end, OnigRegion* region, std::vector<GrammarMatch>* outMatches) const
+	bool SimpleSyntaxPattern::match(const std::string& str, size_t start, size_t end, OnigRegion* region, RegexSearchCache* cache, std::vector<GrammarMatch>* outMatches) const
 	{
-		std::vector<GrammarMatch> subMatches = checkForMatches(str, start, end, this->regMatch, region, this->captures);
+		std::vector<GrammarMatch> subMatches = checkForMatches(str, start, end, this->regMatch, region, cache, this->captures);
 
 		bool captureWholePattern = false;
 		if (this->scope.has_value())
 		{
-			std::optional<GrammarMatch> match = getFirstMatch(str, start, end, this->regMatch, region);
+			std::optional<GrammarMatch> match = getFirstMatch(str, start, end, this->regMatch, region, cache);
 			if (match.has_value() && match->start < end && match->end <= end)
 			{
 				match->subMatches.insert(match->subMatches.end(), subMatches.begin(), subMatches.end());
@@ -84,16 +98,16 @@ namespace MathAnim
 	{
 		if (regMatch)
 		{
-			onig_free(regMatch);
+			freeRegex(regMatch);
 		}
 
 		regMatch = nullptr;
 	}
 
-	bool ComplexSyntaxPattern::match(const std::string& str, size_t start, size_t endOffset, const PatternRepository& repo, OnigRegion* region, std::vector<GrammarMatch>* outMatches) const
+	bool ComplexSyntaxPattern::match(const std::string& str, size_t start, size_t endOffset, const PatternRepository& repo, OnigRegion* region, RegexSearchCache* cache, std::vector<GrammarMatch>* outMatches) const
 	{
 		// If the begin/end pair doesn't have a match, then this rule isn't a success
-		std::optional<GrammarMatch> beginBlockMatch = getFirstMatch(str, start, endOffset, this->begin, region);
+		std::optional<GrammarMatch> beginBlockMatch = getFirstMatch(str, start, endOffset, this->begin, region, cache);
 		if (!beginBlockMatch.has_value() || beginBlockMatch->start >= endOffset)
 		{
 			return false;
@@ -101,7 +115,7 @@ namespace MathAnim
 
 		size_t endBlockOffset = beginBlockMatch->end - start;
 		// This match can go to the end of the string
-		std::optional<GrammarMatch> endBlockMatch = getFirstMatch(str, start + endBlockOffset, str.length(), this->end, region);
+		std::optional<GrammarMatch> endBlockMatch = getFirstMatch(str, start + endBlockOffset, str.length(), this->end, region, cache);
 		if (!endBlockMatch.has_value())
 		{
 			GrammarMatch eof;
@@ -116,8 +130,8 @@ namespace MathAnim
 
 		// If the begin/end pair *does* have a match, then get all grammar matches for the begin/end blocks and
 		// run the extra patterns against the text between begin/end
-		std::vector<GrammarMatch> beginMatches = checkForMatches(str, beginBlockMatch->start, beginBlockMatch->end, this->begin, region, this->beginCaptures);
-		std::vector<GrammarMatch> endMatches = checkForMatches(str, endBlockMatch->start, endBlockMatch->end, this->end, region, this->endCaptures);
+		std::vector<GrammarMatch> beginMatches = checkForMatches(str, beginBlockMatch->start, beginBlockMatch->end, this->begin, region, cache, this->beginCaptures);
+		std::vector<GrammarMatch> endMatches = checkForMatches(str, endBlockMatch->start, endBlockMatch->end, this->end, region, cache, this->endCaptures);
 
 		GrammarMatch res = {};
 		res.subMatches.insert(res.subMatches.end(), beginMatches.begin(), beginMatches.end());
@@ -126,9 +140,9 @@ namespace MathAnim
 		{
 			size_t inBetweenStart = beginBlockMatch->end;
 			size_t inBetweenEnd = endBlockMatch->start;
-			for (auto pattern : *patterns)
+			for (const auto& pattern : *patterns)
 			{
-				pattern.match(str, inBetweenStart, inBetweenEnd, repo, region, &res.subMatches);
+				pattern.match(str, inBetweenStart, inBetweenEnd, repo, region, cache, &res.subMatches);
 			}
 		}
 
@@ -151,12 +165,12 @@ namespace MathAnim
 	{
 		if (begin)
 		{
-			onig_free(begin);
+			freeRegex(begin);
 		}
 
 		if (end)
 		{
-			onig_free(end);
+			freeRegex(end);
 		}
 
 		begin = nullptr;
@@ -171,7 +185,7 @@ namespace MathAnim
 		}
 	}
 
-	bool SyntaxPattern::match(const std::string& str, size_t start, size_t end, const PatternRepository& repo, OnigRegion* region, std::vector<GrammarMatch>* outMatches) const
+	bool SyntaxPattern::match(const std::string& str, size_t start, size_t end, const PatternRepository& repo, OnigRegion* region, RegexSearchCache* cache, std::vector<GrammarMatch>* outMatches) const
 	{
 		switch (type)
 		{
@@ -179,9 +193,9 @@ namespace MathAnim
 		{
 			if (patternArray.has_value())
 			{
-				for (auto pattern : patternArray->patterns)
+				for (const auto& pattern : patternArray->patterns)
 				{
-					if (pattern.match(str, start, end, repo, region, outMatches))
+					if (pattern.match(str, start, end, repo, region, cache, outMatches))
 					{
 						return true;
 					}
@@ -193,7 +207,7 @@ namespace MathAnim
 		{
 			if (complexPattern.has_value())
 			{
-				return complexPattern->match(str, start, end, repo, region, outMatches);
+				return complexPattern->match(str, start, end, repo, region, cache, outMatches);
 			}
 		}
 		break;
@@ -204,7 +218,7 @@ namespace MathAnim
 				auto iter = repo.patterns.find(patternInclude.value());
 				if (iter != repo.patterns.end())
 				{
-					return iter->second.match(str, start, end, repo, region, outMatches);
+					return iter->second.match(str, start, end, repo, region, cache, outMatches);
 				}
 				g_logger_warning("Unable to resolve pattern reference '{}'.", patternInclude.value());
 			}
@@ -214,7 +228,7 @@ namespace MathAnim
 		{
 			if (simplePattern.has_value())
 			{
-				return simplePattern->match(str, start, end, region, outMatches);
+				return simplePattern->match(str, start, end, region, cache, outMatches);
 			}
 		}
 		case PatternType::Invalid:
@@ -279,10 +293,10 @@ namespace MathAnim
 			}
 
 			std::vector<GrammarMatch> tmpRes = {};
-			for (auto pattern : this->patterns)
+			for (const auto& pattern : this->patterns)
 			{
 				std::vector<GrammarMatch> currentRes = {};
-				if (pattern.match(code, start, lineEnd, this->repository, region, &currentRes))
+				if (pattern.match(code, start, lineEnd, this->repository, region, searchCache, &currentRes))
 				{
 					// The first match wins
 					if (tmpRes.size() == 0 || (
@@ -307,6 +321,14 @@ namespace MathAnim
 		return false;
 	}
 
+	void Grammar::resetSearchCache() const
+	{
+		if (searchCache)
+		{
+			searchCache->reset();
+		}
+	}
+
 	Grammar* Grammar::importGrammar(const char* filepath)
 	{
 		if (!Platform::fileExists(filepath))
@@ -345,6 +367,13 @@ namespace MathAnim
 			}
 			grammar->region = nullptr;
 
+			if (grammar->searchCache)
+			{
+				grammar->searchCache->~RegexSearchCache();
+				g_memory_free(grammar->searchCache);
+			}
+			grammar->searchCache = nullptr;
+
 			grammar->~Grammar();
 			g_memory_free(grammar);
 		}
@@ -357,6 +386,9 @@ namespace MathAnim
 		new(res)Grammar();
 
 		res->region = onig_region_new();
+		res->searchCache = (RegexSearchCache*)g_memory_allocate(sizeof(RegexSearchCache));
+		new(res->searchCache)RegexSearchCache();
+		res->searchCache->reset();
 
 		if (j.contains("name"))
 		{
@@ -564,12 +596,43 @@ namespace MathAnim
 			return nullptr;
 		}
 
+		if (str.find("\\G") != std::string::npos)
+		{
+			regexesWithStartAnchor.insert(reg);
+		}
+
 		return reg;
 	}
 
-	static std::optional<GrammarMatch> getFirstMatch(const std::string& str, size_t startOffset, size_t endOffset, regex_t* reg, OnigRegion* region)
+	static void freeRegex(regex_t* reg)
+	{
+		regexesWithStartAnchor.erase(reg);
+		onig_free(reg);
+	}
+
+	static const RegexSearchResult* searchRegex(const std::string& str, size_t startOffset, size_t endOffset, regex_t* reg, OnigRegion* region, RegexSearchCache* cache)
 	{
-		std::optional<GrammarMatch> res = std::nullopt;
+		cache->numSearches++;
+
+		auto iter = cache->results.find(reg);
+		if (iter != cache->results.end())
+		{
+			const RegexSearchResult& prev = iter->second;
+			bool canReuse = prev.searchRange == endOffset && prev.searchStart <= startOffset;
+			if (canReuse && prev.searchStart != startOffset)
+			{
+				// Nothing matched between the old start and the old match, so searching from
+				// anywhere in that gap ends up at the same match
+				canReuse = regexesWithStartAnchor.find(reg) == regexesWithStartAnchor.end()
+					&& (!prev.matched || (size_t)prev.regionBegin[0] >= startOffset);
+			}
+
+			if (canReuse)
+			{
+				cache->numCacheHits++;
+				return prev.matched ? &prev : nullptr;
+			}
+		}
 
 		const char* cstr = str.c_str();
 		const char* start = cstr + startOffset;
@@ -585,80 +648,76 @@ namespace MathAnim
 			ONIG_OPTION_NONE
 		);
 
-		if (searchRes >= 0)
-		{
-			if (region->num_regs > 0)
-			{
-				// Only accept valid matches
-				if (region->beg[0] >= 0 && region->end[0] > region->beg[0])
-				{
-					GrammarMatch match = {};
-					match.start = (size_t)region->beg[0];
-					match.end = (size_t)region->end[0];
-					match.scope = ScopeRule::from("FIRST_MATCH");
-					res = match;
-				}
-			}
-		}
-		else if (searchRes != ONIG_MISMATCH)
+		if (searchRes < 0 && searchRes != ONIG_MISMATCH)
 		{
 			// Error
 			char s[ONIG_MAX_ERROR_MESSAGE_LEN];
 			onig_error_code_to_str((UChar*)s, searchRes);
 			g_logger_error("Oniguruma Error: '{}'", s);
-			onig_region_free(region, 1 /* 1:free self, 0:free contents only */);
+			// The region belongs to the grammar and gets reused by the next search, only reset it
+			onig_region_clear(region);
+			return nullptr;
 		}
 
-		return res;
+		RegexSearchResult& res = cache->results[reg];
+		res.searchStart = startOffset;
+		res.searchRange = endOffset;
+		res.matched = searchRes >= 0 && region->num_regs > 0;
+		res.regionBegin.clear();
+		res.regionEnd.clear();
+		if (res.matched)
+		{
+			res.regionBegin.insert(res.regionBegin.end(), region->beg, region->beg + region->num_regs);
+			res.regionEnd.insert(res.regionEnd.end(), region->end, region->end + region->num_regs);
+		}
+
+		return res.matched ? &res : nullptr;
 	}
 
-	static std::vector<GrammarMatch> checkForMatches(const std::string& str, size_t startOffset, size_t endOffset, regex_t* reg, OnigRegion* region, std::optional<CaptureList> captures)
+	static std::optional<GrammarMatch> getFirstMatch(const std::string& str, size_t startOffset, size_t endOffset, regex_t* reg, OnigRegion* region, RegexSearchCache* cache)
 	{
-		std::vector<GrammarMatch> res = {};
+		const RegexSearchResult* searchRes = searchRegex(str, startOffset, endOffset, reg, region, cache);
 
-		const char* cstr = str.c_str();
-		const char* start = cstr + startOffset;
-		const char* end = cstr + str.length();
-		const char* range = cstr + endOffset;
-		int searchRes = onig_search(
-			reg,
-			(uint8*)cstr,
-			(uint8*)end,
-			(uint8*)start,
-			(uint8*)range,
-			region,
-			ONIG_OPTION_NONE
-		);
+		// Only accept valid matches
+		if (searchRes && searchRes->regionBegin[0] >= 0 && searchRes->regionEnd[0] > searchRes->regionBegin[0])
+		{
+			GrammarMatch match = {};
+			match.start = (size_t)searchRes->regionBegin[0];
+			match.end = (size_t)searchRes->regionEnd[0];
+			match.scope = ScopeRule::from("FIRST_MATCH");
+			return match;
+		}
+
+		return std::nullopt;
+	}
+
+	static std::vector<GrammarMatch> checkForMatches(const std::string& str, size_t startOffset, size_t endOffset, regex_t* reg, OnigRegion* region, RegexSearchCache* cache, const std::optional<CaptureList>& captures)
+	{
+		std::vector<GrammarMatch> res = {};
+		if (!captures.has_value())
+		{
+			return res;
+		}
 
-		if (searchRes >= 0)
+		const RegexSearchResult* searchRes = searchRegex(str, startOffset, endOffset, reg, region, cache);
+		if (searchRes)
 		{
-			if (captures.has_value())
+			for (const auto& capture : captures->captures)
 			{
-				for (auto capture : captures->captures)
+				if (searchRes->regionBegin.size() > capture.index)
 				{
-					if (region->num_regs > capture.index)
+					// Only accept valid matches
+					if (searchRes->regionBegin[capture.index] >= 0 && searchRes->regionEnd[capture.index] > searchRes->regionBegin[capture.index])
 					{
-						// Only accept valid matches
-						if (region->beg[capture.index] >= 0 && region->end[capture.index] > region->beg[capture.index])
-						{
-							GrammarMatch match = {};
-							match.start = (size_t)region->beg[capture.index];
-							match.end = (size_t)region->end[capture.index];
-							match.scope = capture.scope;
-							res.emplace_back(match);
-						}
+						GrammarMatch match = {};
+						match.start = (size_t)searchRes->regionBegin[capture.index];
+						match.end = (size_t)searchRes->regionEnd[capture.index];
+						match.scope = capture.scope;
+						res.emplace_back(match);
 					}
 				}
 			}
 		}
-		else if (searchRes != ONIG_MISMATCH)
-		{
-			// Error
-			char s[ONIG_MAX_ERROR_MESSAGE_LEN];
-			onig_error_code_to_str((UChar*)s, searchRes);
-			g_logger_error("Oniguruma Error: '{}'", s);
-			onig_region_free(region, 1 /* 1:free self, 0:free contents only */);
-		}
 
 		return res;
 	}
@@ -8,6 +8,9 @@ namespace MathAnim
 {
 	// --------------- Internal Functions ---------------
 	size_t applyTheme(const GrammarMatch& match, size_t highlightCursor, const SyntaxTheme& theme, CodeHighlights& out, const TokenRule* parentRule);
+	static void applyThemeToMatches(const SyntaxTheme& theme, CodeHighlights& out);
+	static void shiftMatch(GrammarMatch& match, int64 shift);
+	static size_t getLineStart(const std::string& str, size_t offset);
 	static HighlightSegment getSegmentFrom(size_t startIndex, size_t endIndex, const TokenRule& setting);
 	static int printMatches(char* bufferPtr, size_t bufferSizeLeft, const GrammarMatch& match, const std::string& code, int level = 1);
 
@@ -23,9 +26,14 @@ namespace MathAnim
 			return {};
 		}
 
-		std::vector<GrammarMatch> matches = {};
-		while (grammar->getNextMatch(code, &matches))
+		CodeHighlights res = {};
+		res.codeBlock = code;
+		res.grammar = grammar;
+
+		grammar->resetSearchCache();
+		while (grammar->getNextMatch(code, &res.matches))
 		{
+			res.matchGroupEnds.push_back(res.matches.size());
 		}
 
 		if (printDebugInfo)
@@ -34,7 +42,7 @@ namespace MathAnim
 			char buffer[bufferSize] = "\0";
 			char* bufferPtr = buffer;
 			size_t bufferSizeLeft = bufferSize;
-			for (auto match : matches)
+			for (auto match : res.matches)
 			{
 				int numBytesWritten = printMatches(bufferPtr, bufferSizeLeft, match, code);
 				if (numBytesWritten > 0 && numBytesWritten < bufferSizeLeft)
@@ -51,22 +59,114 @@ namespace MathAnim
 			g_logger_info("Matches:\n{}", buffer);
 		}
 
+		applyThemeToMatches(theme, res);
+
+		return res;
+	}
+
+	CodeHighlights SyntaxHighlighter::reparse(const CodeHighlights& previous, const std::string& code, const SyntaxTheme& theme) const
+	{
+		if (!this->grammar)
+		{
+			return {};
+		}
+
+		if (previous.grammar != grammar)
+		{
+			return parse(code, theme);
+		}
+
+		const std::string& oldCode = previous.codeBlock;
+		size_t prefixLength = 0;
+		while (prefixLength < oldCode.length() && prefixLength < code.length() && oldCode[prefixLength] == code[prefixLength])
+		{
+			prefixLength++;
+		}
+
+		size_t suffixLength = 0;
+		while (suffixLength < oldCode.length() - prefixLength && suffixLength < code.length() - prefixLength &&
+			oldCode[oldCode.length() - suffixLength - 1] == code[code.length() - suffixLength - 1])
+		{
+			suffixLength++;
+		}
+
+		// Matches can run over the newline at the end of a line, so start one line early to
+		// catch anything on the previous line that could see the edit
+		size_t restartOffset = getLineStart(code, prefixLength);
+		restartOffset = restartOffset > 0 ? getLineStart(code, restartOffset - 1) : 0;
+
+		// Searches are bounded by the line they start on, so once the tokenizer is past the
+		// edited lines and resumes from the same place as before, the rest is unchanged
+		size_t oldEditEnd = oldCode.length() - suffixLength;
+		size_t newEditEnd = code.length() - suffixLength;
+		size_t resyncOffset = code.find('\n', newEditEnd);
+		resyncOffset = resyncOffset == std::string::npos ? code.length() : resyncOffset + 1;
+		int64 shift = (int64)code.length() - (int64)oldCode.length();
+
 		CodeHighlights res = {};
 		res.codeBlock = code;
+		res.grammar = grammar;
 
-		// Attempt to break up the matches into one set of well-defined highlight segments
-		size_t highlightCursor = 0;
-		for (size_t i = 0; i < matches.size(); i++)
+		size_t groupStart = 0;
+		for (size_t groupEnd : previous.matchGroupEnds)
 		{
-			highlightCursor = applyTheme(matches[i], highlightCursor, theme, res, nullptr);
+			if (previous.matches[groupEnd - 1].end > restartOffset)
+			{
+				break;
+			}
+
+			res.matches.insert(res.matches.end(), previous.matches.begin() + groupStart, previous.matches.begin() + groupEnd);
+			res.matchGroupEnds.push_back(groupEnd);
+			groupStart = groupEnd;
+		}
+
+		std::unordered_map<size_t, size_t> oldResumeOffsets = {};
+		for (size_t i = 0; i < previous.matchGroupEnds.size(); i++)
+		{
+			size_t resumeOffset = previous.matches[previous.matchGroupEnds[i] - 1].end;
+			if (resumeOffset >= oldEditEnd)
+			{
+				oldResumeOffsets[resumeOffset] = i;
+			}
 		}
 
-		if (highlightCursor < code.length())
+		grammar->resetSearchCache();
+		while (grammar->getNextMatch(code, &res.matches))
 		{
-			HighlightSegment finalSegment = getSegmentFrom(highlightCursor, code.length(), theme.defaultRule);
-			res.segments.emplace_back(finalSegment);
+			res.matchGroupEnds.push_back(res.matches.size());
+
+			size_t resumeOffset = res.matches.back().end;
+			if (resumeOffset < resyncOffset)
+			{
+				continue;
+			}
+
+			auto iter = oldResumeOffsets.find((size_t)((int64)resumeOffset - shift));
+			if (iter == oldResumeOffsets.end())
+			{
+				continue;
+			}
+
+			// Converged, copy the rest of the old matches over at their new offsets
+			size_t oldGroupIndex = iter->second;
+			size_t oldMatchStart = previous.matchGroupEnds[oldGroupIndex];
+			size_t newMatchStart = res.matches.size();
+			for (size_t i = oldMatchStart; i < previous.matches.size(); i++)
+			{
+				res.matches.push_back(previous.matches[i]);
+				shiftMatch(res.matches.back(), shift);
+			}
+
+			for (size_t i = oldGroupIndex + 1; i < previous.matchGroupEnds.size(); i++)
+			{
+				res.matchGroupEnds.push_back(previous.matchGroupEnds[i] - oldMatchStart + newMatchStart);
+			}
+
+			break;
 		}
 
+		applyThemeToMatches(theme, res);
+
 		return res;
 	}
 
@@ -149,6 +249,45 @@ namespace MathAnim
 	}
 
 	// --------------- Internal Functions ---------------
+	static void applyThemeToMatches(const SyntaxTheme& theme, CodeHighlights& out)
+	{
+		out.segments.clear();
+
+		// Attempt to break up the matches into one set of well-defined highlight segments
+		size_t highlightCursor = 0;
+		for (size_t i = 0; i < out.matches.size(); i++)
+		{
+			highlightCursor = applyTheme(out.matches[i], highlightCursor, theme, out, nullptr);
+		}
+
+		if (highlightCursor < out.codeBlock.length())
+		{
+			HighlightSegment finalSegment = getSegmentFrom(highlightCursor, out.codeBlock.length(), theme.defaultRule);
+			out.segments.emplace_back(finalSegment);
+		}
+	}
+
+	static void shiftMatch(GrammarMatch& match, int64 shift)
+	{
+		match.start = (size_t)((int64)match.start + shift);
+		match.end = (size_t)((int64)match.end + shift);
+		for (auto& subMatch : match.subMatches)
+		{
+			shiftMatch(subMatch, shift);
+		}
+	}
+
+	static size_t getLineStart(const std::string& str, size_t offset)
+	{
+		if (offset == 0)
+		{
+			return 0;
+		}
+
+		size_t newline = str.rfind('\n', offset - 1);
+		return newline == std::string::npos ? 0 : newline + 1;
+	}
+
 	size_t applyTheme(const GrammarMatch& match, size_t highlightCursor, const SyntaxTheme& theme, CodeHighlights& out, const TokenRule* parentRule)
 	{
 		if (highlightCursor > match.start)
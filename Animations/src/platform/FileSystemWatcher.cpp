@@ -0,0 +1,100 @@
+#include "platform/FileSystemWatcher.h"
+
+namespace MathAnim
+{
+	void FileSystemWatcher::poll()
+	{
+		std::vector<std::pair<std::filesystem::path, FileEventType>> readyEvents;
+		{
+			std::lock_guard<std::mutex> queueLock(queueMtx);
+			auto now = std::chrono::steady_clock::now();
+			for (auto iter = pendingEvents.begin(); iter != pendingEvents.end();)
+			{
+				if (now - iter->second.lastEventTime < debounceTime)
+				{
+					++iter;
+					continue;
+				}
+
+				readyEvents.emplace_back(std::filesystem::path(iter->first), iter->second.type);
+				iter = pendingEvents.erase(iter);
+			}
+		}
+
+		// Callbacks run without the lock so they can take as long as they need
+		for (const auto& [file, type] : readyEvents)
+		{
+			switch (type)
+			{
+			case FileEventType::Changed:
+				if (onChanged) onChanged(file);
+				break;
+			case FileEventType::Renamed:
+				if (onRenamed) onRenamed(file);
+				break;
+			case FileEventType::Deleted:
+				if (onDeleted) onDeleted(file);
+				break;
+			case FileEventType::Created:
+				if (onCreated) onCreated(file);
+				break;
+			}
+		}
+	}
+
+	void FileSystemWatcher::queueEvent(const std::filesystem::path& file, FileEventType type)
+	{
+		if (!matchesFilter(file))
+		{
+			return;
+		}
+
+		std::string key = file.lexically_normal().make_preferred().string();
+		auto now = std::chrono::steady_clock::now();
+
+		std::lock_guard<std::mutex> queueLock(queueMtx);
+		auto iter = pendingEvents.find(key);
+		if (iter == pendingEvents.end())
+		{
+			pendingEvents[key] = PendingEvent{ type, now };
+			return;
+		}
+
+		FileEventType previousType = iter->second.type;
+		if (previousType == FileEventType::Created && type == FileEventType::Deleted)
+		{
+			// Temporary file that came and went before anyone needed to know about it
+			pendingEvents.erase(iter);
+			return;
+		}
+
+		if (previousType == FileEventType::Created && type == FileEventType::Changed)
+		{
+			// Still a new file as far as listeners are concerned
+			type = FileEventType::Created;
+		}
+		else if (previousType == FileEventType::Deleted && type != FileEventType::Deleted)
+		{
+			// Editors that save by replacing the file delete it and write it back
+			type = FileEventType::Changed;
+		}
+
+		iter->second.type = type;
+		iter->second.lastEventTime = now;
+	}
+
+	bool FileSystemWatcher::matchesFilter(const std::filesystem::path& file) const
+	{
+		if (filter.empty() || filter == "*" || filter == "*.*")
+		{
+			return true;
+		}
+
+		if (filter.size() > 1 && filter[0] == '*')
+		{
+			return file.extension().string() == filter.substr(1);
+		}
+
+		return file.filename().string() == filter;
+	}
+}
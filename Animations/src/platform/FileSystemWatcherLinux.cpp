@@ -3,23 +3,30 @@
 #include "platform/Platform.h"
 
 #include <unistd.h>
+#include <poll.h>
+#include <sys/eventfd.h>
 #include <sys/inotify.h>
 
-static int inotify_descriptor;
-static int watch_descriptor;
-
 namespace MathAnim
 {
-  FileSystemWatcher::FileSystemWatcher()
+  struct InotifyWatcherData
   {
-  }
+    int inotifyDescriptor;
+    // Written to by stop() to wake the watcher thread up
+    int stopDescriptor;
+    // inotify only reports names relative to the watched directory
+    std::unordered_map<int, std::filesystem::path> watchedDirectories;
+  };
 
-  void FileSystemWatcher::start()
+  // ---- Internal Functions ----
+  static uint32 getWatchMask(int notifyFilters);
+  static void addWatches(InotifyWatcherData* data, const std::filesystem::path& directory, uint32 mask, bool recursive, std::vector<std::filesystem::path>* existingFiles);
+
+  FileSystemWatcher::FileSystemWatcher()
   {
-    fileWatcherThread = std::thread(&FileSystemWatcher::startThread, this);
   }
 
-  void FileSystemWatcher::startThread()
+  void FileSystemWatcher::start()
   {
     if (path.empty())
     {
@@ -29,87 +36,227 @@ namespace MathAnim
 
     Platform::createDirIfNotExists(path.string().c_str());
 
-    inotify_descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
-    if (inotify_descriptor == -1)
+    InotifyWatcherData* data = (InotifyWatcherData*)g_memory_allocate(sizeof(InotifyWatcherData));
+    new(data)InotifyWatcherData();
+    data->inotifyDescriptor = inotify_init1(IN_CLOEXEC);
+    data->stopDescriptor = eventfd(0, EFD_CLOEXEC);
+    if (data->inotifyDescriptor == -1 || data->stopDescriptor == -1)
     {
       g_logger_error("Failed to create FileSystemWatcher for '{}': {}", path, strerror(errno));
+      if (data->inotifyDescriptor != -1) close(data->inotifyDescriptor);
+      if (data->stopDescriptor != -1) close(data->stopDescriptor);
+      data->~InotifyWatcherData();
+      g_memory_free(data);
       return;
     }
 
-    watch_descriptor = inotify_add_watch(inotify_descriptor, path.string().c_str(), IN_MODIFY | IN_DELETE | IN_ATTRIB | IN_MOVED_TO | IN_ACCESS | IN_CREATE);
-    if (watch_descriptor == -1)
-    {
-      close(inotify_descriptor);
-      inotify_descriptor = -1;
-      g_logger_error("Failed to create FileSystemWatcher for '{}': {}", path, strerror(errno));
-      return;
-    }
+    platformData = data;
+    enableRaisingEvents = true;
+    fileWatcherThread = std::thread(&FileSystemWatcher::startThread, this);
   }
 
-  void FileSystemWatcher::stop()
+  void FileSystemWatcher::startThread()
   {
-    if (enableRaisingEvents)
+    InotifyWatcherData* data = (InotifyWatcherData*)platformData;
+    uint32 mask = getWatchMask(notifyFilters);
+
+    // Walking a big project can take a while, which is why this happens here instead of in start()
+    addWatches(data, path, mask, includeSubdirectories, nullptr);
+    if (data->watchedDirectories.empty())
     {
-      enableRaisingEvents = false;
-      inotify_rm_watch(inotify_descriptor, watch_descriptor);
-      close(watch_descriptor);
-      close(inotify_descriptor);
-      fileWatcherThread.join();
+      g_logger_error("Failed to create FileSystemWatcher for '{}': {}", path, strerror(errno));
+      return;
     }
-  }
 
-  void FileSystemWatcher::poll()
-  {
     char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
     struct inotify_event const *event;
-    ssize_t len;
+    struct pollfd descriptors[2] = {
+      { data->inotifyDescriptor, POLLIN, 0 },
+      { data->stopDescriptor, POLLIN, 0 }
+    };
 
-    while (inotify_descriptor != -1 && watch_descriptor != -1)
+    while (enableRaisingEvents)
     {
-      len = read(inotify_descriptor, buf, sizeof(buf));
-      if (len == -1 && errno != EAGAIN)
+      int numReady = ::poll(descriptors, 2, -1);
+      if (numReady == -1)
       {
+        if (errno == EINTR)
+        {
+          continue;
+        }
+
         g_logger_error("Failed to poll from FileSystemWatcher for '{}': {}", path, strerror(errno));
         return;
       }
 
-      if (len <= 0)
+      if (descriptors[1].revents & POLLIN)
+      {
+        return;
+      }
+
+      if (!(descriptors[0].revents & POLLIN))
+      {
+        continue;
+      }
+
+      ssize_t len = read(data->inotifyDescriptor, buf, sizeof(buf));
+      if (len == -1 && errno != EAGAIN && errno != EINTR)
       {
-        // No more events
+        g_logger_error("Failed to read from FileSystemWatcher for '{}': {}", path, strerror(errno));
         return;
       }
 
-      for (char *ptr = buf; ptr < buf + len; ptr += sizeof(struct inotify_event) + event->len)
+      for (char *ptr = buf; len > 0 && ptr < buf + len; ptr += sizeof(struct inotify_event) + event->len)
       {
         event = (struct inotify_event const *)ptr;
 
-        if (event->mask & (IN_ISDIR | IN_IGNORED))
+        if (event->mask & IN_Q_OVERFLOW)
+        {
+          g_logger_warning("FileSystemWatcher for '{}' overflowed, some file events were dropped.", path);
+          continue;
+        }
+
+        if (event->mask & IN_IGNORED)
+        {
+          // The directory was deleted or moved out from under us
+          data->watchedDirectories.erase(event->wd);
+          continue;
+        }
+
+        auto directoryIter = data->watchedDirectories.find(event->wd);
+        if (directoryIter == data->watchedDirectories.end() || event->len == 0)
         {
           continue;
         }
 
-        if (onChanged && event->mask & (IN_MODIFY | IN_ACCESS | IN_ATTRIB))
+        std::filesystem::path file = directoryIter->second / event->name;
+        if (event->mask & IN_ISDIR)
         {
-          onChanged(std::filesystem::path(event->name));
+          if (includeSubdirectories && (event->mask & (IN_CREATE | IN_MOVED_TO)))
+          {
+            // Anything written to the new directory before the watch was added would
+            // be missed otherwise, so report it as created
+            std::vector<std::filesystem::path> existingFiles;
+            addWatches(data, file, mask, true, &existingFiles);
+            for (const std::filesystem::path& existingFile : existingFiles)
+            {
+              queueEvent(existingFile, FileEventType::Created);
+            }
+          }
+          continue;
+        }
+
+        if (event->mask & (IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB))
+        {
+          queueEvent(file, FileEventType::Changed);
         }
 
-        if (onRenamed && event->mask & IN_MOVED_TO)
+        if (event->mask & IN_MOVED_TO)
         {
-          onRenamed(std::filesystem::path(event->name));
+          queueEvent(file, FileEventType::Renamed);
         }
 
-        if (onDeleted && event->mask & IN_DELETE)
+        if (event->mask & (IN_DELETE | IN_MOVED_FROM))
         {
-          onDeleted(std::filesystem::path(event->name));
+          queueEvent(file, FileEventType::Deleted);
         }
 
-        if (onCreated && event->mask & IN_CREATE)
+        if (event->mask & IN_CREATE)
         {
-          onCreated(std::filesystem::path(event->name));
+          queueEvent(file, FileEventType::Created);
         }
       }
     }
   }
+
+  void FileSystemWatcher::stop()
+  {
+    if (enableRaisingEvents)
+    {
+      enableRaisingEvents = false;
+
+      InotifyWatcherData* data = (InotifyWatcherData*)platformData;
+      if (data)
+      {
+        uint64 wakeUp = 1;
+        if (write(data->stopDescriptor, &wakeUp, sizeof(wakeUp)) == -1)
+        {
+          g_logger_error("Failed to stop FileSystemWatcher for '{}': {}", path, strerror(errno));
+        }
+      }
+
+      if (fileWatcherThread.joinable())
+      {
+        fileWatcherThread.join();
+      }
+
+      if (data)
+      {
+        // Closing the descriptor removes every watch along with it
+        close(data->inotifyDescriptor);
+        close(data->stopDescriptor);
+        data->~InotifyWatcherData();
+        g_memory_free(data);
+        platformData = nullptr;
+      }
+    }
+  }
+
+  // ---- Internal Functions ----
+  static uint32 getWatchMask(int notifyFilters)
+  {
+    if (notifyFilters == 0)
+    {
+      notifyFilters = NotifyFilters::FileName | NotifyFilters::LastWrite;
+    }
+
+    // Directories always need to be tracked to keep the recursive watches up to date
+    uint32 mask = IN_CREATE | IN_MOVED_TO;
+    if (notifyFilters & (NotifyFilters::FileName | NotifyFilters::DirectoryName | NotifyFilters::CreationTime))
+    {
+      mask |= IN_DELETE | IN_MOVED_FROM;
+    }
+
+    if (notifyFilters & (NotifyFilters::LastWrite | NotifyFilters::Size))
+    {
+      mask |= IN_MODIFY | IN_CLOSE_WRITE;
+    }
+
+    if (notifyFilters & (NotifyFilters::Attributes | NotifyFilters::Security))
+    {
+      mask |= IN_ATTRIB;
+    }
+
+    // NotifyFilters::LastAccess is deliberately ignored. Reading a file isn't a change.
+    return mask;
+  }
+
+  static void addWatches(InotifyWatcherData* data, const std::filesystem::path& directory, uint32 mask, bool recursive, std::vector<std::filesystem::path>* existingFiles)
+  {
+    int watchDescriptor = inotify_add_watch(data->inotifyDescriptor, directory.string().c_str(), mask | IN_ONLYDIR);
+    if (watchDescriptor == -1)
+    {
+      g_logger_warning("Failed to watch directory '{}': {}", directory, strerror(errno));
+      return;
+    }
+    data->watchedDirectories[watchDescriptor] = directory;
+
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+    {
+      if (entry.is_directory(error))
+      {
+        if (recursive)
+        {
+          addWatches(data, entry.path(), mask, recursive, existingFiles);
+        }
+      }
+      else if (existingFiles)
+      {
+        existingFiles->push_back(entry.path());
+      }
+    }
+  }
 }
 
 #endif
@@ -13,6 +13,10 @@ namespace MathAnim
 
 	void FileSystemWatcher::start()
 	{
+		// Created up front so stop() can always wake the thread, even if it hasn't
+		// reached ReadDirectoryChangesW yet
+		stopEventHandle = CreateEventA(NULL, TRUE, FALSE, NULL);
+		enableRaisingEvents = true;
 		fileWatcherThread = std::thread(&FileSystemWatcher::startThread, this);
 	}
 
@@ -35,49 +39,50 @@ namespace MathAnim
 		}
 
 		// Set up notification flags 
+		int filters = notifyFilters != 0 ? notifyFilters : (NotifyFilters::FileName | NotifyFilters::LastWrite);
 		int flags = 0;
-		if (notifyFilters && NotifyFilters::FileName)
+		if (filters & NotifyFilters::FileName)
 		{
 			flags |= FILE_NOTIFY_CHANGE_FILE_NAME;
 		}
 
-		if (notifyFilters && NotifyFilters::DirectoryName)
+		if (filters & NotifyFilters::DirectoryName)
 		{
 			flags |= FILE_NOTIFY_CHANGE_DIR_NAME;
 		}
 
-		if (notifyFilters && NotifyFilters::Attributes)
+		if (filters & NotifyFilters::Attributes)
 		{
 			flags |= FILE_NOTIFY_CHANGE_ATTRIBUTES;
 		}
 
-		if (notifyFilters && NotifyFilters::Size)
+		if (filters & NotifyFilters::Size)
 		{
 			flags |= FILE_NOTIFY_CHANGE_SIZE;
 		}
 
-		if (notifyFilters && NotifyFilters::LastWrite)
+		if (filters & NotifyFilters::LastWrite)
 		{
 			flags |= FILE_NOTIFY_CHANGE_LAST_WRITE;
 		}
 
-		if (notifyFilters && NotifyFilters::LastAccess)
+		if (filters & NotifyFilters::LastAccess)
 		{
 			flags |= FILE_NOTIFY_CHANGE_LAST_ACCESS;
 		}
 
-		if (notifyFilters && NotifyFilters::CreationTime)
+		if (filters & NotifyFilters::CreationTime)
 		{
 			flags |= FILE_NOTIFY_CHANGE_CREATION;
 		}
 
-		if (notifyFilters && NotifyFilters::Security)
+		if (filters & NotifyFilters::Security)
 		{
 			flags |= FILE_NOTIFY_CHANGE_SECURITY;
 		}
 
 		char filename[MAX_PATH];
-		char buffer[2048];
+		alignas(DWORD) char buffer[2048];
 		DWORD bytesReturned;
 		FILE_NOTIFY_INFORMATION* pNotify;
 		int offset = 0;
@@ -93,8 +98,7 @@ namespace MathAnim
 		bool result = true;
 		HANDLE hEvents[2];
 		hEvents[0] = pollingOverlap.hEvent;
-		hEvents[1] = CreateEventA(NULL, TRUE, FALSE, NULL);
-		stopEventHandle = hEvents[1];
+		hEvents[1] = stopEventHandle;
 
 		while (result && enableRaisingEvents)
 		{
@@ -117,30 +121,37 @@ namespace MathAnim
 				break;
 			}
 
-			std::lock_guard<std::mutex> queueLock(queueMtx);
 			do
 			{
 				pNotify = (FILE_NOTIFY_INFORMATION*)((char*)buffer + offset);
-				strcpy(filename, "");
-				// TODO: This is probably the proper way to do this
-				//int filenamelen = WideCharToMultiByte(CP_ACP, 0, pNotify->FileName, pNotify->FileNameLength / 2, filename, sizeof(filename), NULL, NULL);
-				filename[pNotify->FileNameLength / 2] = '\0';
+				int filenameLength = WideCharToMultiByte(CP_UTF8, 0, pNotify->FileName, pNotify->FileNameLength / sizeof(WCHAR), filename, sizeof(filename) - 1, NULL, NULL);
+				filename[filenameLength] = '\0';
+
+				// Names are relative to the watched directory, listeners get the full path
+				std::filesystem::path file = path / std::filesystem::path(filename);
+				std::error_code error;
+				if (std::filesystem::is_directory(file, error))
+				{
+					offset += pNotify->NextEntryOffset;
+					continue;
+				}
+
 				switch (pNotify->Action)
 				{
 				case FILE_ACTION_ADDED:
-					createdQueue.insert(filename);
+					queueEvent(file, FileEventType::Created);
 					break;
 				case FILE_ACTION_REMOVED:
-					deletedQueue.insert(filename);
+					queueEvent(file, FileEventType::Deleted);
 					break;
 				case FILE_ACTION_MODIFIED:
-					changedQueue.insert(filename);
+					queueEvent(file, FileEventType::Changed);
 					break;
 				case FILE_ACTION_RENAMED_OLD_NAME:
-					// Log::Info("The file was renamed and this is the old name: [%s]", filename);
+					queueEvent(file, FileEventType::Deleted);
 					break;
 				case FILE_ACTION_RENAMED_NEW_NAME:
-					renamedQueue.insert(filename);
+					queueEvent(file, FileEventType::Renamed);
 					break;
 				default:
 					g_logger_error("Default error. Unknown file action '{}' for FileSystemWatcher '{}'", pNotify->Action, path);
@@ -159,69 +170,22 @@ namespace MathAnim
 		if (enableRaisingEvents)
 		{
 			enableRaisingEvents = false;
-			SetEvent(stopEventHandle);
-			fileWatcherThread.join();
-		}
-	}
-
-	void FileSystemWatcher::poll()
-	{
-		// Filesystem watcher is kind of stupid,
-		// so I have to buffer the polling to make sure
-		// it doesn't double-notify 
-		constexpr int pollBufferReset = 10;
-		static int pollBuffer = 0;
-		if (pollBuffer < pollBufferReset)
-		{
-			pollBuffer++;
-		}
-		pollBuffer = 0;
-
-		std::lock_guard<std::mutex> queueLock(queueMtx);
-
-		for (const std::filesystem::path& file : changedQueue)
-		{
-			bool containsFile = prevChangedQueue.find(file) != prevChangedQueue.end();
-			if (onChanged && !containsFile)
+			if (stopEventHandle)
 			{
-				onChanged(file);
+				SetEvent(stopEventHandle);
 			}
-		}
-		prevChangedQueue = changedQueue;
-		changedQueue.clear();
 
-		for (const std::filesystem::path& file : renamedQueue)
-		{
-			bool containsFile = prevRenamedQueue.find(file) != prevRenamedQueue.end();
-			if (onRenamed && !containsFile)
+			if (fileWatcherThread.joinable())
 			{
-				onRenamed(file);
+				fileWatcherThread.join();
 			}
-		}
-		prevRenamedQueue = renamedQueue;
-		renamedQueue.clear();
 
-		for (const std::filesystem::path& file : deletedQueue)
-		{
-			bool containsFile = prevDeletedQueue.find(file) != prevDeletedQueue.end();
-			if (onDeleted && !containsFile)
-			{
-				onDeleted(file);
-			}
-		}
-		prevDeletedQueue = deletedQueue;
-		deletedQueue.clear();
-
-		for (const std::filesystem::path& file : createdQueue)
-		{
-			bool containsFile = prevCreatedQueue.find(file) != prevCreatedQueue.end();
-			if (onCreated && !containsFile)
+			if (stopEventHandle)
 			{
-				onCreated(file);
+				CloseHandle(stopEventHandle);
+				stopEventHandle = nullptr;
 			}
 		}
-		prevCreatedQueue = createdQueue;
-		createdQueue.clear();
 	}
 }
 
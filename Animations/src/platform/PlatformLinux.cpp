@@ -3,10 +3,14 @@
 #include "core.h"
 
 #include <filesystem>
+#include <chrono>
 
 #include <sys/wait.h>
+#include <signal.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <pwd.h>
 
@@ -86,11 +90,18 @@ out:
 
 namespace MathAnim
 {
+  struct MemMapUserData
+  {
+    int fileDescriptor;
+  };
+
   namespace Platform
   {
     static std::vector<std::string> availableFonts = {
         "JetBrains Mono"};
     static bool availableFontsCached = false;
+    // Same as the Windows implementation
+    static constexpr int executeProgramTimeoutMs = 120000;
     static std::string homeDirectory = std::string();
 
     const std::vector<std::string>& getAvailableFonts()
@@ -152,13 +163,126 @@ namespace MathAnim
 
     bool executeProgram(const char* programFilepath, const char* cmdLineArgs, const char* workingDirectory, const char* executionOutputFilename)
     {
-		g_logger_warning("UNIMPLEMENTED: Trying to execute another program");
-		return false;
+      std::string command = std::string("\"") + programFilepath + "\"";
+      if (cmdLineArgs)
+      {
+        command += std::string(" ") + cmdLineArgs;
+      }
+
+      g_logger_log("Running program: '{}'", command);
+      pid_t pid = fork();
+      if (pid < 0)
+      {
+        g_logger_error("Failed to launch process '{}': {}", command, strerror(errno));
+        return false;
+      }
+
+      if (pid == 0)
+      {
+        // Child process, only async-signal-safe calls from here until exec. Its own process
+        // group lets a timeout kill the shell and whatever it started together.
+        setpgid(0, 0);
+        if (workingDirectory && chdir(workingDirectory) != 0)
+        {
+          _exit(127);
+        }
+
+        if (executionOutputFilename)
+        {
+          int fd = open(executionOutputFilename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+          if (fd >= 0)
+          {
+            dup2(fd, STDOUT_FILENO);
+            dup2(fd, STDERR_FILENO);
+            close(fd);
+          }
+        }
+
+        int devNull = open("/dev/null", O_RDONLY);
+        if (devNull >= 0)
+        {
+          dup2(devNull, STDIN_FILENO);
+          close(devNull);
+        }
+
+        execl("/bin/sh", "sh", "-c", command.c_str(), (char*)nullptr);
+        _exit(127);
+      }
+
+      int status = 0;
+      auto waitStart = std::chrono::steady_clock::now();
+      while (true)
+      {
+        pid_t res = waitpid(pid, &status, WNOHANG);
+        if (res == pid)
+        {
+          break;
+        }
+
+        if (res < 0 && errno != EINTR)
+        {
+          g_logger_error("Failed to wait for process '{}': {}", command, strerror(errno));
+          return false;
+        }
+
+        auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - waitStart).count();
+        if (elapsedMs >= executeProgramTimeoutMs)
+        {
+          g_logger_error("Program timed out: '{}'", command);
+          kill(-pid, SIGKILL);
+          // Reap it so it doesn't hold on to the files it was writing
+          while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+          return false;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      }
+
+      return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+
+    // Starts the program without waiting for it, used for editors that stay open
+    static bool launchDetached(const char* programFilepath, const std::string& cmdLineArgs)
+    {
+      std::string command = std::string("\"") + programFilepath + "\" " + cmdLineArgs;
+
+      g_logger_log("Launching program: '{}'", command);
+      pid_t pid = fork();
+      if (pid < 0)
+      {
+        g_logger_error("Failed to launch process '{}': {}", command, strerror(errno));
+        return false;
+      }
+
+      if (pid == 0)
+      {
+        // Fork again so the program gets reparented to init and never becomes our zombie
+        setsid();
+        if (fork() == 0)
+        {
+          int devNull = open("/dev/null", O_RDWR);
+          if (devNull >= 0)
+          {
+            dup2(devNull, STDIN_FILENO);
+            dup2(devNull, STDOUT_FILENO);
+            dup2(devNull, STDERR_FILENO);
+            close(devNull);
+          }
+
+          execl("/bin/sh", "sh", "-c", command.c_str(), (char*)nullptr);
+        }
+        _exit(127);
+      }
+
+      // The intermediate child exits right away
+      int status = 0;
+      while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+      return true;
     }
 
     bool openFileWithDefaultProgram(const char* filepath)
     {
-      return executeProgram("code", filepath);
+      return launchDetached("code", std::string("\"") + filepath + "\"");
     }
 
     bool openFileWithVsCode(const char* filepath, int lineNumber)
@@ -166,7 +290,7 @@ namespace MathAnim
       std::string arg = lineNumber >= 0
                             ? std::string("--goto \"") + filepath + ":" + std::to_string(lineNumber) + "\""
                             : std::string("--goto \"") + filepath + "\"";
-      executeProgram("code", arg.c_str());
+      return launchDetached("code", arg);
     }
 
     bool fileExists(const char* filename)
@@ -186,6 +310,25 @@ namespace MathAnim
       return std::remove(filename) == 0;
     }
 
+    bool syncFileToDisk(const char* filename)
+    {
+      int fd = open(filename, O_RDONLY);
+      if (fd == -1)
+      {
+        g_logger_error("Failed to open '{}' to sync it to disk. Error: '{}'", filename, strerror(errno));
+        return false;
+      }
+
+      bool success = fsync(fd) == 0;
+      if (!success)
+      {
+        g_logger_error("Failed to sync '{}' to disk. Error: '{}'", filename, strerror(errno));
+      }
+      close(fd);
+
+      return success;
+    }
+
     std::string tmpfilename()
     {
       char buffer[] = "fnXXXXXX\0";
@@ -215,6 +358,69 @@ namespace MathAnim
       return homeDirectory + "/.mathanimation";
     }
 
+    MemMappedFile* memMapFile(const char* filepath)
+    {
+      int fd = open(filepath, O_RDONLY);
+      if (fd == -1)
+      {
+        return nullptr;
+      }
+
+      struct stat fileStat;
+      if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+      {
+        // Empty files can't be mapped
+        close(fd);
+        return nullptr;
+      }
+
+      void* baseAddress = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (baseAddress == MAP_FAILED)
+      {
+        g_logger_error("Failed to memmap file '{}'. Errno: '{}'", filepath, errno);
+        close(fd);
+        return nullptr;
+      }
+
+      MemMappedFile* res = (MemMappedFile*)g_memory_allocate(sizeof(MemMappedFile));
+      g_memory_zeroMem(res, sizeof(MemMappedFile));
+      res->userData = (MemMapUserData*)g_memory_allocate(sizeof(MemMapUserData));
+      res->userData->fileDescriptor = fd;
+      res->dataSize = (size_t)fileStat.st_size;
+      // NOTE: See PlatformWin32.cpp, this pointer is const so users don't change it
+      *(uint8**)&res->data = (uint8*)baseAddress;
+      return res;
+    }
+
+    void freeMemMappedFile(MemMappedFile* file)
+    {
+      if (!file)
+      {
+        return;
+      }
+
+      if (file->data)
+      {
+        if (munmap((void*)file->data, file->dataSize) != 0)
+        {
+          g_logger_error("Failed to unmap memmapped file. Errno: '{}'", errno);
+        }
+      }
+
+      if (file->userData)
+      {
+        if (file->userData->fileDescriptor != -1)
+        {
+          close(file->userData->fileDescriptor);
+        }
+
+        g_memory_free(file->userData);
+        file->userData = nullptr;
+      }
+
+      g_memory_free(file);
+    }
+
     void createDirIfNotExists(const char* dirName)
     {
       mkdir_p(dirName, 0755);
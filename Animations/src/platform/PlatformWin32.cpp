@@ -323,12 +323,21 @@ namespace MathAnim
 
 			// Wait until child process exits.
 			g_logger_log("Running program: '{}'", finalArgs);
-			WaitForSingleObject(pi.hProcess, 25000);
-			TerminateProcess(pi.hProcess, 0);
+			if (WaitForSingleObject(pi.hProcess, 120000) == WAIT_TIMEOUT)
+			{
+				g_logger_error("Program timed out: '{}'", finalArgs);
+				TerminateProcess(pi.hProcess, 1);
+				// TerminateProcess is asynchronous, wait until the process is actually gone so it
+				// doesn't hold any locks on the files it was writing
+				WaitForSingleObject(pi.hProcess, INFINITE);
+			}
+
+			DWORD exitCode = 1;
+			GetExitCodeProcess(pi.hProcess, &exitCode);
 			if (fileHandle) CloseHandle(fileHandle);
 			CloseHandle(pi.hProcess);
 			CloseHandle(pi.hThread);
-			return true;
+			return exitCode == 0;
 		}
 
 		bool openFileWithDefaultProgram(const char* filepath)
@@ -367,6 +376,25 @@ namespace MathAnim
 			return true;
 		}
 
+		bool syncFileToDisk(const char* filename)
+		{
+			HANDLE fileHandle = CreateFileA(filename, GENERIC_WRITE, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+			if (fileHandle == INVALID_HANDLE_VALUE)
+			{
+				g_logger_error("Failed to open '{}' to sync it to disk. Error: {}", filename, GetLastError());
+				return false;
+			}
+
+			bool success = FlushFileBuffers(fileHandle);
+			if (!success)
+			{
+				g_logger_error("Failed to sync '{}' to disk. Error: {}", filename, GetLastError());
+			}
+			CloseHandle(fileHandle);
+
+			return success;
+		}
+
 		std::string tmpFilename(const std::string& directory)
 		{
 			char outPath[_MAX_PATH];
@@ -479,6 +507,78 @@ namespace MathAnim
 			return res;
 		}
 
+		MemMappedFile* memMapFile(const char* filepath)
+		{
+			MemMappedFile* res = (MemMappedFile*)g_memory_allocate(sizeof(MemMappedFile));
+			g_memory_zeroMem(res, sizeof(MemMappedFile));
+			res->userData = (MemMapUserData*)g_memory_allocate(sizeof(MemMapUserData));
+			res->userData->fileHandle = INVALID_HANDLE_VALUE;
+			res->userData->fileMappingHandle = INVALID_HANDLE_VALUE;
+
+			res->userData->fileHandle = CreateFileA(
+				filepath,
+				GENERIC_READ,
+				// Allow appending to the file while it's mapped, the mapping keeps its original size
+				FILE_SHARE_READ | FILE_SHARE_WRITE,
+				NULL,
+				OPEN_EXISTING,
+				FILE_ATTRIBUTE_NORMAL,
+				NULL
+			);
+
+			if (res->userData->fileHandle == INVALID_HANDLE_VALUE)
+			{
+				freeMemMappedFile(res);
+				return nullptr;
+			}
+
+			LARGE_INTEGER fileSize;
+			if (!GetFileSizeEx(res->userData->fileHandle, &fileSize) || fileSize.QuadPart == 0)
+			{
+				// Empty files can't be mapped
+				freeMemMappedFile(res);
+				return nullptr;
+			}
+
+			res->userData->fileMappingHandle = CreateFileMappingA(
+				res->userData->fileHandle,
+				NULL,
+				PAGE_READONLY,
+				0,
+				0,
+				NULL
+			);
+			if (res->userData->fileMappingHandle == NULL)
+			{
+				res->userData->fileMappingHandle = INVALID_HANDLE_VALUE;
+				g_logger_error("Failed to memmap file '{}'. Last error: '{}'", filepath, GetLastError());
+				freeMemMappedFile(res);
+				return nullptr;
+			}
+
+			uint8* baseAddress = (uint8*)MapViewOfFile(
+				res->userData->fileMappingHandle,
+				FILE_MAP_READ,
+				0,
+				0,
+				0
+			);
+			if (baseAddress == NULL)
+			{
+				g_logger_error("Failed to create a mapped view of file '{}'. Last Error: '{}'", filepath, GetLastError());
+				freeMemMappedFile(res);
+				return nullptr;
+			}
+
+			res->dataSize = (size_t)fileSize.QuadPart;
+
+#pragma warning( push )
+#pragma warning( disable : 4213 )
+			(uint8*)res->data = baseAddress;
+#pragma warning( pop )
+			return res;
+		}
+
 		void freeMemMappedFile(MemMappedFile* file)
 		{
 			if (!file)
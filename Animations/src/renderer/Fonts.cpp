@@ -1,7 +1,9 @@
 #include "renderer/Fonts.h"
 #include "renderer/Renderer.h"
 #include "core/Application.h"
+#include "core/MemoryTracker.h"
 #include "svg/Svg.h"
+#include "svg/SvgDiskCache.h"
 #include "math/CMath.h"
 
 #include <freetype/ftglyph.h>
@@ -96,6 +98,7 @@ namespace MathAnim
 	struct SharedSizedFont
 	{
 		SizedFont font;
+		CharRange charset;
 		int referenceCount;
 	};
 
@@ -114,22 +117,34 @@ namespace MathAnim
 
 	float Font::getKerning(uint32 leftCodepoint, uint32 rightCodepoint) const
 	{
-		FT_Vector kerning;
+		std::shared_lock<std::shared_mutex> lock(*lookupMtx);
+		uint64 codepoints = ((uint64)leftCodepoint << 32) | (uint64)rightCodepoint;
+		auto iter = std::lower_bound(kerningPairs.begin(), kerningPairs.end(), codepoints, [](const KerningPair& pair, uint64 codepoints)
+		{
+			return pair.codepoints < codepoints;
+		});
 
-		FT_UInt leftGlyph = FT_Get_Char_Index(fontFace, leftCodepoint);
-		FT_UInt rightGlyph = FT_Get_Char_Index(fontFace, rightCodepoint);
-		int error = FT_Get_Kerning(fontFace, leftGlyph, rightGlyph, FT_Kerning_Mode::FT_KERNING_DEFAULT, &kerning);
-		if (error)
+		if (iter != kerningPairs.end() && iter->codepoints == codepoints)
 		{
-			return 0.0f;
+			return iter->kerning;
 		}
 
-		return (float)kerning.x / unitsPerEM;
+		return 0.0f;
+	}
+
+	uint32 Font::getGlyphIndex(uint32 codepoint) const
+	{
+		std::shared_lock<std::shared_mutex> lock(*lookupMtx);
+		auto iter = glyphIndices.find(codepoint);
+		return iter != glyphIndices.end()
+			? iter->second
+			: 0;
 	}
 
 	glm::vec2 Font::getSizeOfString(const std::string& string) const
 	{
 		glm::vec2 cursor = glm::vec2();
+		uint32 prevCodepoint = 0;
 		for (int i = 0; i < string.length(); i++)
 		{
 			const GlyphOutline& outline = getGlyphInfo((uint32)string[i]);
@@ -137,8 +152,18 @@ namespace MathAnim
 
 			if (string[i] == '\n')
 			{
+				// Kerning doesn't apply across lines
 				cursor.y += lineHeight;
+				prevCodepoint = 0;
+				continue;
+			}
+
+			uint32 codepoint = (uint32)(uint8)string[i];
+			if (prevCodepoint != 0)
+			{
+				cursor.x += getKerning(prevCodepoint, codepoint);
 			}
+			prevCodepoint = codepoint;
 		}
 
 		cursor.y += lineHeight;
@@ -191,6 +216,8 @@ namespace MathAnim
 		static std::unordered_map<std::string, SharedSizedFont> loadedSizedFonts;
 
 		static void generateDefaultCharset(Font& font, CharRange defaultCharset);
+		static void generateGlyphAtlas(SizedFont& sizedFont, CharRange defaultCharset);
+		static void generateLookupTables(FT_Face face, CharRange defaultCharset, std::unordered_map<uint32, uint32>& outGlyphIndices, std::vector<KerningPair>& outKerningPairs);
 		static int getOutline(FT_Glyph glyph, FT_OutlineGlyph* Outg);
 		static GlyphOutline createOutlineInternal(FT_OutlineGlyph outlineGlyph, FT_Face face);
 		static std::string getSizedFontKey(const char* filepath, int fontSizePixels);
@@ -218,6 +245,12 @@ namespace MathAnim
 		{
 			g_logger_assert(font->fontFace != nullptr, "Cannot create outline for uninitialized font '{}'.", font->fontFilepath);
 
+			uint64 diskCacheKey = SvgDiskCache::hashGlyph(font->diskCacheHash, character);
+			if (SvgDiskCache::loadGlyph(diskCacheKey, outlineResult))
+			{
+				return 0;
+			}
+
 			FT_Face fontFace = font->fontFace;
 			FT_UInt glyphIndex = FT_Get_Char_Index(fontFace, character);
 			if (glyphIndex == 0)
@@ -248,6 +281,8 @@ namespace MathAnim
 			*outlineResult = createOutlineInternal(outline, fontFace);
 			FT_Done_Glyph(glyph);
 
+			SvgDiskCache::storeGlyph(diskCacheKey, *outlineResult);
+
 			return 0;
 		}
 
@@ -281,85 +316,11 @@ namespace MathAnim
 				}
 			}
 
-			constexpr uint32 textureWidth = 2048;
-			constexpr uint32 textureHeight = 2048;
-			res.texture = TextureBuilder()
-				.setFormat(ByteFormat::R8_UI)
-				.setWidth(textureWidth)
-				.setHeight(textureHeight)
-				.setMagFilter(FilterMode::Linear)
-				.setMinFilter(FilterMode::Linear)
-				.setWrapS(WrapMode::None)
-				.setWrapT(WrapMode::None)
-				.generate();
-
-			// Generate the texture and upload it to the GPU
-			uint8* textureMemory = (uint8*)g_memory_allocate(sizeof(uint8) * textureWidth * textureHeight);
-			g_memory_zeroMem(textureMemory, sizeof(uint8) * textureWidth * textureHeight);
-			uint32 cursorX = 0;
-			uint32 cursorY = 0;
-			uint32 lineHeight = 0;
-			for (uint32 codepoint = defaultCharset.firstCharCode; codepoint <= defaultCharset.lastCharCode; codepoint++)
-			{
-				FT_UInt glyphIndex = FT_Get_Char_Index(res.unsizedFont->fontFace, codepoint);
-				if (glyphIndex == 0)
-				{
-					g_logger_warning("Character code '{}' not found. Missing glyph.", codepoint);
-					continue;
-				}
-
-				// Load the glyph
-				FT_Error error = FT_Load_Glyph(res.unsizedFont->fontFace, glyphIndex, FT_LOAD_RENDER);
-				if (error)
-				{
-					g_logger_error("Freetype could not load glyph for character code '{}'.", codepoint);
-				}
-
-				FT_Bitmap& bitmap = res.unsizedFont->fontFace->glyph->bitmap;
-				if (cursorX + bitmap.width >= textureWidth)
-				{
-					cursorY += lineHeight;
-					lineHeight = 0;
-					cursorX = 0;
-				}
-				lineHeight = glm::max(bitmap.rows, lineHeight);
-
-				if (cursorY + bitmap.rows >= textureHeight)
-				{
-					g_logger_error("Ran out of texture room for font '{}'", filepath);
-					continue;
-				}
-
-				// Copy every row into our bitmap
-				for (uint32 y = 0; y < bitmap.rows; y++)
-				{
-					uint8* dst = textureMemory + cursorX + ((cursorY + y) * textureWidth);
-					uint8* src = bitmap.buffer + (y * bitmap.width);
-					g_memory_copyMem(dst, src, sizeof(uint8) * bitmap.width);
-				}
-
-				// Add normalized glyph position
-				res.glyphTextureCoords[codepoint].lruCacheId = 0;
-				res.glyphTextureCoords[codepoint].uvMin = Vec2{
-					(float)cursorX / (float)textureWidth,
-					(float)cursorY / (float)textureHeight
-				};
-				res.glyphTextureCoords[codepoint].uvMax = Vec2{
-					(float)cursorX / (float)textureWidth + (float)bitmap.width / (float)textureWidth,
-					(float)cursorY / (float)textureHeight + (float)bitmap.rows / (float)textureHeight
-				};
-
-				// Increment our write cursor
-				cursorX += bitmap.width;
-			}
-
-			// Upload texture memory to the GPU
-			res.texture.uploadSubImage(0, 0, textureWidth, textureHeight, textureMemory, sizeof(uint8) * textureWidth * textureHeight);
-
-			g_memory_free(textureMemory);
+			generateGlyphAtlas(res, defaultCharset);
 
 			// All done now cache the result and return it
 			loadedSizedFonts[sizedFontKey].font = res;
+			loadedSizedFonts[sizedFontKey].charset = defaultCharset;
 			loadedSizedFonts[sizedFontKey].referenceCount = 1;
 
 			return &loadedSizedFonts[sizedFontKey].font;
@@ -450,12 +411,18 @@ namespace MathAnim
 			// Generate a texture for the font and initialize the font structure
 			Font font;
 			font.fontFilepath = filepath;
+			font.defaultCharset = defaultCharset;
+			font.generation = 0;
+			font.diskCacheHash = SvgDiskCache::hashFont(font.fontFilepath);
 			font.fontFace = face;
 			font.unitsPerEM = (float)face->units_per_EM;
 			font.lineHeight = (float)face->height / font.unitsPerEM;
 
 			// TODO: Turn the preset characters into a parameter
 			generateDefaultCharset(font, defaultCharset);
+			generateLookupTables(face, defaultCharset, font.glyphIndices, font.kerningPairs);
+			font.lookupMtx = (std::shared_mutex*)g_memory_allocate(sizeof(std::shared_mutex));
+			new(font.lookupMtx)std::shared_mutex();
 
 			loadedFonts[unsizedFontKey].font = font;
 			loadedFonts[unsizedFontKey].referenceCount = 1;
@@ -496,9 +463,84 @@ namespace MathAnim
 
 			FT_Done_Face(font->fontFace);
 			font->fontFace = nullptr;
+			font->lookupMtx->~shared_mutex();
+			g_memory_free(font->lookupMtx);
+			font->lookupMtx = nullptr;
 			loadedFonts.erase(fontIter);
 		}
 
+		Font* reloadFont(const char* filepath)
+		{
+			std::string unsizedFontKey = getUnsizedFontKey(filepath);
+			auto iter = loadedFonts.find(unsizedFontKey);
+			if (iter == loadedFonts.end())
+			{
+				return nullptr;
+			}
+
+			FT_Face face;
+			int error = FT_New_Face(library, filepath, 0, &face);
+			if (error)
+			{
+				g_logger_warning("Font '{}' could not be reloaded, keeping the old version.", filepath);
+				return nullptr;
+			}
+
+			g_logger_info("Reloading font '{}'.", unsizedFontKey);
+
+			Font& font = iter->second.font;
+
+			// Other threads can be reading the old tables, so the new ones are built first
+			// and only swapped in while nobody holds the lock
+			std::unordered_map<uint32, uint32> glyphIndices;
+			std::vector<KerningPair> kerningPairs;
+			generateLookupTables(face, font.defaultCharset, glyphIndices, kerningPairs);
+			{
+				std::unique_lock<std::shared_mutex> lock(*font.lookupMtx);
+				font.glyphIndices.swap(glyphIndices);
+				font.kerningPairs.swap(kerningPairs);
+			}
+
+			// Text objects share these outlines, so the old geometry lives on until
+			// they get re-initialized
+			for (std::pair<const uint32, GlyphOutline>& kv : font.glyphMap)
+			{
+				GlyphOutline& outline = kv.second;
+				outline.free();
+			}
+			font.glyphMap.clear();
+			FT_Done_Face(font.fontFace);
+
+			font.fontFace = face;
+			font.unitsPerEM = (float)face->units_per_EM;
+			font.lineHeight = (float)face->height / font.unitsPerEM;
+			font.generation++;
+			font.diskCacheHash = SvgDiskCache::hashFont(font.fontFilepath);
+			generateDefaultCharset(font, font.defaultCharset);
+
+			for (auto& [sizedFontKey, sharedSizedFont] : loadedSizedFonts)
+			{
+				SizedFont& sizedFont = sharedSizedFont.font;
+				if (sizedFont.unsizedFont != &font)
+				{
+					continue;
+				}
+
+				error = FT_Set_Pixel_Sizes(face, sizedFont.fontSizePixels, sizedFont.fontSizePixels);
+				if (error)
+				{
+					g_logger_error("Freetype failed to set the pixel size for font '{}'.", sizedFontKey);
+					continue;
+				}
+
+				sizedFont.texture.destroy();
+				sizedFont.glyphTextureCoords.clear();
+				generateGlyphAtlas(sizedFont, sharedSizedFont.charset);
+			}
+
+			return &font;
+		}
+
 		void unloadFont(const char* filepath)
 		{
 			std::string unsizedFontKey = getUnsizedFontKey(filepath);
@@ -561,10 +603,158 @@ namespace MathAnim
 					continue;
 				}
 
+				// Every character of every text object references this geometry instead of copying it
+				if (outlineResult.svg)
+				{
+					outlineResult.svg->makeShared();
+					outlineResult.svg->glyphId = CMath::combineHash<uint64>(
+						(uint64)i,
+						CMath::hashBytes(
+							&font.generation,
+							sizeof(font.generation),
+							CMath::hashBytes(font.fontFilepath.data(), font.fontFilepath.size())
+						)
+					);
+				}
 				font.glyphMap[i] = outlineResult;
 			}
 		}
 
+		static void generateGlyphAtlas(SizedFont& sizedFont, CharRange defaultCharset)
+		{
+			constexpr uint32 textureWidth = 2048;
+			constexpr uint32 textureHeight = 2048;
+			MemoryTracker::ScopedTag memoryTag(MemoryTag::GlyphAtlas);
+			sizedFont.texture = TextureBuilder()
+				.setFormat(ByteFormat::R8_UI)
+				.setWidth(textureWidth)
+				.setHeight(textureHeight)
+				.setMagFilter(FilterMode::Linear)
+				.setMinFilter(FilterMode::Linear)
+				.setWrapS(WrapMode::None)
+				.setWrapT(WrapMode::None)
+				.generate();
+
+			// Generate the texture and upload it to the GPU
+			uint8* textureMemory = (uint8*)g_memory_allocate(sizeof(uint8) * textureWidth * textureHeight);
+			g_memory_zeroMem(textureMemory, sizeof(uint8) * textureWidth * textureHeight);
+			uint32 cursorX = 0;
+			uint32 cursorY = 0;
+			uint32 lineHeight = 0;
+			for (uint32 codepoint = defaultCharset.firstCharCode; codepoint <= defaultCharset.lastCharCode; codepoint++)
+			{
+				FT_UInt glyphIndex = FT_Get_Char_Index(sizedFont.unsizedFont->fontFace, codepoint);
+				if (glyphIndex == 0)
+				{
+					g_logger_warning("Character code '{}' not found. Missing glyph.", codepoint);
+					continue;
+				}
+
+				// Load the glyph
+				FT_Error error = FT_Load_Glyph(sizedFont.unsizedFont->fontFace, glyphIndex, FT_LOAD_RENDER);
+				if (error)
+				{
+					g_logger_error("Freetype could not load glyph for character code '{}'.", codepoint);
+				}
+
+				FT_Bitmap& bitmap = sizedFont.unsizedFont->fontFace->glyph->bitmap;
+				if (cursorX + bitmap.width >= textureWidth)
+				{
+					cursorY += lineHeight;
+					lineHeight = 0;
+					cursorX = 0;
+				}
+				lineHeight = glm::max(bitmap.rows, lineHeight);
+
+				if (cursorY + bitmap.rows >= textureHeight)
+				{
+					g_logger_error("Ran out of texture room for font '{}'", sizedFont.unsizedFont->fontFilepath);
+					continue;
+				}
+
+				// Copy every row into our bitmap
+				for (uint32 y = 0; y < bitmap.rows; y++)
+				{
+					uint8* dst = textureMemory + cursorX + ((cursorY + y) * textureWidth);
+					uint8* src = bitmap.buffer + (y * bitmap.width);
+					g_memory_copyMem(dst, src, sizeof(uint8) * bitmap.width);
+				}
+
+				// Add normalized glyph position
+				sizedFont.glyphTextureCoords[codepoint].lruCacheId = 0;
+				sizedFont.glyphTextureCoords[codepoint].uvMin = Vec2{
+					(float)cursorX / (float)textureWidth,
+					(float)cursorY / (float)textureHeight
+				};
+				sizedFont.glyphTextureCoords[codepoint].uvMax = Vec2{
+					(float)cursorX / (float)textureWidth + (float)bitmap.width / (float)textureWidth,
+					(float)cursorY / (float)textureHeight + (float)bitmap.rows / (float)textureHeight
+				};
+
+				// Increment our write cursor
+				cursorX += bitmap.width;
+			}
+
+			// Upload texture memory to the GPU
+			sizedFont.texture.uploadSubImage(0, 0, textureWidth, textureHeight, textureMemory, sizeof(uint8) * textureWidth * textureHeight);
+
+			g_memory_free(textureMemory);
+		}
+
+		static void generateLookupTables(FT_Face face, CharRange defaultCharset, std::unordered_map<uint32, uint32>& outGlyphIndices, std::vector<KerningPair>& outKerningPairs)
+		{
+			for (uint32 codepoint = defaultCharset.firstCharCode; codepoint <= defaultCharset.lastCharCode; codepoint++)
+			{
+				FT_UInt glyphIndex = FT_Get_Char_Index(face, codepoint);
+				if (glyphIndex != 0)
+				{
+					outGlyphIndices[codepoint] = glyphIndex;
+				}
+			}
+
+			if (!FT_HAS_KERNING(face))
+			{
+				return;
+			}
+
+			float unitsPerEM = (float)face->units_per_EM;
+			auto getGlyphIndex = [&outGlyphIndices](uint32 codepoint)
+			{
+				auto iter = outGlyphIndices.find(codepoint);
+				return iter != outGlyphIndices.end() ? iter->second : 0;
+			};
+
+			// Glyph metrics are in unscaled font units divided by units per EM, so the
+			// kerning has to be unscaled as well
+			for (uint32 left = defaultCharset.firstCharCode; left <= defaultCharset.lastCharCode; left++)
+			{
+				uint32 leftGlyph = getGlyphIndex(left);
+				if (leftGlyph == 0)
+				{
+					continue;
+				}
+
+				for (uint32 right = defaultCharset.firstCharCode; right <= defaultCharset.lastCharCode; right++)
+				{
+					uint32 rightGlyph = getGlyphIndex(right);
+					if (rightGlyph == 0)
+					{
+						continue;
+					}
+
+					FT_Vector kerning;
+					FT_Error error = FT_Get_Kerning(face, leftGlyph, rightGlyph, FT_KERNING_UNSCALED, &kerning);
+					if (!error && kerning.x != 0)
+					{
+						outKerningPairs.emplace_back(KerningPair{ ((uint64)left << 32) | (uint64)right, (float)kerning.x / unitsPerEM });
+					}
+				}
+			}
+
+			// Both loops go in ascending order, so the pairs are already sorted for getKerning
+			outKerningPairs.shrink_to_fit();
+		}
+
 		//******************* check error code ********************
 		void Check(FT_Error ErrCode, const char* OKMsg, const char* ErrMsg)
 		{
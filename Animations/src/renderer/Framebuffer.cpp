@@ -4,6 +4,7 @@
 #include "renderer/Texture.h"
 #include "renderer/GLApi.h"
 #include "video/Encoder.h"
+#include "core/MemoryTracker.h"
 
 namespace MathAnim
 {
@@ -266,6 +267,7 @@ namespace MathAnim
 		g_logger_assert(framebuffer.fbo == UINT32_MAX, "Cannot generate framebuffer with Fbo already id == UINT32_MAX.");
 		g_logger_assert(framebuffer.rbo == UINT32_MAX, "Cannot generate framebuffer with Rbo already id == UINT32_MAX.");
 		g_logger_assert(framebuffer.colorAttachments.size() > 0, "Framebuffer must have at least 1 color attachment.");
+		MemoryTracker::ScopedTag memoryTag(MemoryTag::Framebuffers);
 
 		GL::genFramebuffers(1, &framebuffer.fbo);
 		GL::bindFramebuffer(GL_FRAMEBUFFER, framebuffer.fbo);
@@ -1,12 +1,14 @@
 #include "core.h"
 #include "renderer/GLApi.h"
 #include "renderer/Texture.h"
+#include "core/MemoryTracker.h"
 
 namespace MathAnim
 {
 	namespace GL
 	{
 		static bool compatMode = true;
+		static bool gl33Support = true;
 		static bool gl40Support = true;
 		static bool gl43Support = true;
 		static bool gl44Support = true;
@@ -17,6 +19,36 @@ namespace MathAnim
 		// Guaranteed to be at least 16 units
 		static int32 maxTextureImageUnits = 16;
 
+		// Estimated sizes of every live buffer and texture so MemoryTracker can report GPU usage
+		struct GpuAllocation
+		{
+			size_t numBytes;
+			MemoryTag tag;
+			bool hasMipmaps;
+		};
+		static std::unordered_map<GLuint, GpuAllocation> bufferAllocations = {};
+		static std::unordered_map<GLuint, GpuAllocation> textureAllocations = {};
+
+		// Mirrors of what's bound, kept up to date by the wrappers below so the allocation
+		// tracking never has to ask the driver with glGetIntegerv. ImGui's backend binds
+		// things directly but restores everything before returning.
+		static GLuint boundVertexArray = 0;
+		static GLuint boundArrayBuffer = 0;
+		static GLuint boundPixelPackBuffer = 0;
+		static GLuint boundPixelUnpackBuffer = 0;
+		static GLuint boundUniformBuffer = 0;
+		// The element array binding is part of the VAO
+		static std::unordered_map<GLuint, GLuint> vaoElementBuffers = {};
+		static GLint activeTextureSlot = 0;
+		static std::vector<GLuint> boundTextures2D = {};
+
+		static GLuint* getBufferBinding(GLenum target);
+		static GLuint getBoundBuffer(GLenum target);
+		static GLuint getBoundTexture2D();
+		static size_t bytesPerTexel(GLint internalFormat);
+		static void trackGpuAllocation(std::unordered_map<GLuint, GpuAllocation>& allocations, GLuint id, size_t numBytes, MemoryTag fallbackTag);
+		static void untrackGpuAllocations(std::unordered_map<GLuint, GpuAllocation>& allocations, GLsizei n, const GLuint* ids);
+
 		void init(int versionMajor, int versionMinor)
 		{
 			if (versionMajor < minSupportedVersionMajor ||
@@ -45,6 +77,11 @@ namespace MathAnim
 					gl43Support = false;
 				}
 
+				if (versionMajor < 4 && versionMinor < 3)
+				{
+					gl33Support = false;
+				}
+
 				if (versionMajor < 4)
 				{
 					gl40Support = false;
@@ -61,6 +98,7 @@ namespace MathAnim
 			}
 
 			GL::getIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxTextureImageUnits);
+			boundTextures2D = std::vector<GLuint>(maxTextureImageUnits, 0);
 
 			static bool loggedSystemInfo = false;
 			if (!loggedSystemInfo)
@@ -200,6 +238,7 @@ Max Texture Image Units: {}
 		void bindVertexArray(GLuint array)
 		{
 			glBindVertexArray(array);
+			boundVertexArray = array;
 		}
 
 		void createVertexArray(GLuint* name)
@@ -217,6 +256,11 @@ Max Texture Image Units: {}
 			glVertexAttribIPointer(index, size, type, stride, pointer);
 		}
 
+		void vertexAttribDivisor(GLuint index, GLuint divisor)
+		{
+			glVertexAttribDivisor(index, divisor);
+		}
+
 		void enableVertexAttribArray(GLuint index)
 		{
 			glEnableVertexAttribArray(index);
@@ -225,17 +269,30 @@ Max Texture Image Units: {}
 		void deleteVertexArrays(GLsizei n, const GLuint* arrays)
 		{
 			glDeleteVertexArrays(n, arrays);
+			for (GLsizei i = 0; i < n; i++)
+			{
+				vaoElementBuffers.erase(arrays[i]);
+				if (arrays[i] == boundVertexArray)
+				{
+					boundVertexArray = 0;
+				}
+			}
 		}
 
 		// ----------------------- Buffer objects -----------------------
 		void bindBuffer(GLenum target, GLuint buffer)
 		{
 			glBindBuffer(target, buffer);
+			if (GLuint* binding = getBufferBinding(target))
+			{
+				*binding = buffer;
+			}
 		}
 
 		void bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
 		{
 			glBufferData(target, size, data, usage);
+			trackGpuAllocation(bufferAllocations, getBoundBuffer(target), (size_t)size, MemoryTag::GpuBuffers);
 		}
 
 		void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
@@ -250,7 +307,21 @@ Max Texture Image Units: {}
 
 		void deleteBuffers(GLsizei n, const GLuint* buffers)
 		{
+			untrackGpuAllocations(bufferAllocations, n, buffers);
 			glDeleteBuffers(n, buffers);
+
+			// Deleting a bound buffer binds 0 in its place
+			for (GLsizei i = 0; i < n; i++)
+			{
+				for (GLenum target : { GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER, GL_PIXEL_PACK_BUFFER, GL_PIXEL_UNPACK_BUFFER, GL_UNIFORM_BUFFER })
+				{
+					GLuint* binding = getBufferBinding(target);
+					if (binding && *binding == buffers[i])
+					{
+						*binding = 0;
+					}
+				}
+			}
 		}
 
 		void* mapBuffer(GLenum target, GLenum access)
@@ -300,6 +371,11 @@ Max Texture Image Units: {}
 			glDrawElementsBaseVertex(mode, count, type, indices, basevertex);
 		}
 
+		void drawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instancecount)
+		{
+			glDrawElementsInstanced(mode, count, type, indices, instancecount);
+		}
+
 		// ----------------------- Textures -----------------------
 		void readPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void* pixels)
 		{
@@ -314,12 +390,17 @@ Max Texture Image Units: {}
 		void bindTexture(GLenum target, GLuint texture)
 		{
 			glBindTexture(target, texture);
+			if (target == GL_TEXTURE_2D && activeTextureSlot < (GLint)boundTextures2D.size())
+			{
+				boundTextures2D[activeTextureSlot] = texture;
+			}
 		}
 
 		void bindTexSlot(GLenum target, GLuint texture, GLint textureSlot)
 		{
 			g_logger_assert(textureSlot < maxTextureImageUnits, "Invalid texture slot: '{}'. System only supports up to '{}' texture slots.", textureSlot, maxTextureImageUnits);
 			glActiveTexture(GL_TEXTURE0 + textureSlot);
+			activeTextureSlot = textureSlot;
 			GL::bindTexture(target, texture);
 		}
 
@@ -330,12 +411,31 @@ Max Texture Image Units: {}
 
 		void deleteTextures(GLsizei n, const GLuint* textures)
 		{
+			untrackGpuAllocations(textureAllocations, n, textures);
 			glDeleteTextures(n, textures);
+
+			// Deleting a bound texture binds 0 in its place
+			for (GLsizei i = 0; i < n; i++)
+			{
+				for (GLuint& boundTexture : boundTextures2D)
+				{
+					if (boundTexture == textures[i])
+					{
+						boundTexture = 0;
+					}
+				}
+			}
 		}
 
 		void texImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels)
 		{
 			glTexImage2D(target, level, internalformat, width, height, border, format, type, pixels);
+
+			if (target == GL_TEXTURE_2D && level == 0)
+			{
+				size_t numBytes = (size_t)width * (size_t)height * bytesPerTexel(internalformat);
+				trackGpuAllocation(textureAllocations, getBoundTexture2D(), numBytes, MemoryTag::Textures);
+			}
 		}
 
 		void texSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels)
@@ -358,6 +458,24 @@ Max Texture Image Units: {}
 			glPixelStorei(pname, param);
 		}
 
+		void generateMipmap(GLenum target)
+		{
+			glGenerateMipmap(target);
+
+			if (target == GL_TEXTURE_2D)
+			{
+				auto iter = textureAllocations.find(getBoundTexture2D());
+				if (iter != textureAllocations.end() && !iter->second.hasMipmaps)
+				{
+					// The whole mip chain adds about a third on top of the base level
+					size_t numBytes = iter->second.numBytes + iter->second.numBytes / 3;
+					MemoryTracker::recordReallocation(iter->second.tag, iter->second.numBytes, numBytes);
+					iter->second.numBytes = numBytes;
+					iter->second.hasMipmaps = true;
+				}
+			}
+		}
+
 		// ----------------------- Shaders -----------------------
 		GLuint createProgram(void)
 		{
@@ -479,6 +597,11 @@ Max Texture Image Units: {}
 			glUniform2ui(location, v0, v1);
 		}
 
+		void uniform2uiv(GLint location, GLsizei count, const GLuint* value)
+		{
+			glUniform2uiv(location, count, value);
+		}
+
 		void uniform1ui(GLint location, GLuint v0)
 		{
 			glUniform1ui(location, v0);
@@ -545,6 +668,60 @@ Max Texture Image Units: {}
 			return glGetStringi(name, index);
 		}
 
+		// ----------------------- Timer queries -----------------------
+		bool supportsTimerQueries()
+		{
+			return gl33Support;
+		}
+
+		void genQueries(GLsizei n, GLuint* ids)
+		{
+			if (gl33Support)
+			{
+				glGenQueries(n, ids);
+			}
+		}
+
+		void deleteQueries(GLsizei n, const GLuint* ids)
+		{
+			if (gl33Support)
+			{
+				glDeleteQueries(n, ids);
+			}
+		}
+
+		void queryCounter(GLuint id, GLenum target)
+		{
+			if (gl33Support)
+			{
+				glQueryCounter(id, target);
+			}
+		}
+
+		void getQueryObjectiv(GLuint id, GLenum pname, GLint* params)
+		{
+			if (gl33Support)
+			{
+				glGetQueryObjectiv(id, pname, params);
+			}
+		}
+
+		void getQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params)
+		{
+			if (gl33Support)
+			{
+				glGetQueryObjectui64v(id, pname, params);
+			}
+		}
+
+		void getInteger64v(GLenum pname, GLint64* data)
+		{
+			if (gl33Support)
+			{
+				glGetInteger64v(pname, data);
+			}
+		}
+
 		// ----------------------- Debug callback stuff -----------------------
 		void debugMessageCallback(GLDEBUGPROC callback, const void* userParam)
 		{
@@ -578,5 +755,112 @@ Max Texture Image Units: {}
 		{
 			return glGetError();
 		}
+
+		// ----------------------- Internal functions -----------------------
+		static GLuint* getBufferBinding(GLenum target)
+		{
+			switch (target)
+			{
+			case GL_ARRAY_BUFFER:
+				return &boundArrayBuffer;
+			case GL_ELEMENT_ARRAY_BUFFER:
+				return &vaoElementBuffers[boundVertexArray];
+			case GL_PIXEL_PACK_BUFFER:
+				return &boundPixelPackBuffer;
+			case GL_PIXEL_UNPACK_BUFFER:
+				return &boundPixelUnpackBuffer;
+			case GL_UNIFORM_BUFFER:
+				return &boundUniformBuffer;
+			}
+
+			return nullptr;
+		}
+
+		static GLuint getBoundBuffer(GLenum target)
+		{
+			GLuint* binding = getBufferBinding(target);
+			return binding ? *binding : 0;
+		}
+
+		static GLuint getBoundTexture2D()
+		{
+			return activeTextureSlot < (GLint)boundTextures2D.size()
+				? boundTextures2D[activeTextureSlot]
+				: 0;
+		}
+
+		static size_t bytesPerTexel(GLint internalFormat)
+		{
+			switch (internalFormat)
+			{
+			case GL_R8:
+			case GL_R8UI:
+				return 1;
+			case GL_R16UI:
+				return 2;
+			case GL_RGB8:
+			case GL_RGB:
+				return 3;
+			case GL_RGBA8:
+			case GL_RGBA:
+			case GL_R32UI:
+			case GL_DEPTH24_STENCIL8:
+				return 4;
+			case GL_RGBA16F:
+			case GL_RG32F:
+			case GL_RG32UI:
+				return 8;
+			case GL_RGB32F:
+				return 12;
+			case GL_RGBA32F:
+				return 16;
+			}
+
+			return 4;
+		}
+
+		static void trackGpuAllocation(std::unordered_map<GLuint, GpuAllocation>& allocations, GLuint id, size_t numBytes, MemoryTag fallbackTag)
+		{
+			if (id == 0)
+			{
+				return;
+			}
+
+			// Re-specifying storage replaces the old allocation, and it stays with whoever created it
+			auto iter = allocations.find(id);
+			if (iter != allocations.end())
+			{
+				if (iter->second.numBytes == numBytes)
+				{
+					// Orphaning a buffer every frame keeps the same size, nothing to re-account
+					return;
+				}
+
+				MemoryTracker::recordReallocation(iter->second.tag, iter->second.numBytes, numBytes);
+				iter->second.numBytes = numBytes;
+				iter->second.hasMipmaps = false;
+				return;
+			}
+
+			GpuAllocation allocation;
+			allocation.numBytes = numBytes;
+			allocation.tag = MemoryTracker::getCurrentTag(fallbackTag);
+			allocation.hasMipmaps = false;
+			MemoryTracker::recordAllocation(allocation.tag, numBytes);
+			allocations[id] = allocation;
+		}
+
+		static void untrackGpuAllocations(std::unordered_map<GLuint, GpuAllocation>& allocations, GLsizei n, const GLuint* ids)
+		{
+			for (GLsizei i = 0; i < n; i++)
+			{
+				auto iter = allocations.find(ids[i]);
+				if (iter != allocations.end())
+				{
+					MemoryTracker::recordFree(iter->second.tag, iter->second.numBytes);
+					allocations.erase(iter);
+				}
+			}
+		}
 	}
 }
\ No newline at end of file
@@ -8,25 +8,30 @@ namespace MathAnim
 	struct PixelBufferDownloadData
 	{
 		uint32* pboIds;
+		// Size of one frame, the pbos can be a bit bigger to fit a whole packed texture
 		size_t pboSize;
+		size_t pboAllocationSize;
 		uint8 numPbos;
 		ByteFormat formatType;
 	};
 
-	void PixelBufferDownload::create(uint32 width, uint32 height, uint8 numOfBuffers)
+	void PixelBufferDownload::create(uint32 width, uint32 height, uint8 numOfBuffers, ByteFormat format)
 	{
+		g_logger_assert(format == ByteFormat::R8_UI || format == ByteFormat::R16_UI, "PixelBufferDownloader only supports R8_UI and R16_UI.");
 		g_logger_assert(this->data == nullptr, "Tried to create PixelBufferDownloader twice. Data was not null.");
 
 		this->data = (PixelBufferDownloadData*)g_memory_allocate(sizeof(PixelBufferDownloadData));
 
 		this->data->numPbos = numOfBuffers;
 		this->data->pboIds = (uint32*)g_memory_allocate(sizeof(uint32) * this->data->numPbos);
-		this->data->formatType = ByteFormat::R8_UI;
+		this->data->formatType = format;
 		// We'll store 3 color channels in 1 pbo like YYYY...UUUU...VVVV
-		size_t yChannelSize = width * height * sizeof(uint8);
-		size_t uChannelSize = width / 2 * height / 2 * sizeof(uint8);
+		size_t bytesPerSample = TextureUtil::formatSize(format);
+		size_t yChannelSize = width * height * bytesPerSample;
+		size_t uChannelSize = width / 2 * height / 2 * bytesPerSample;
 		size_t vChannelSize = uChannelSize;
 		this->data->pboSize = yChannelSize + uChannelSize + vChannelSize;
+		this->data->pboAllocationSize = (size_t)width * packedYuvHeight(width, height) * bytesPerSample;
 		
 		this->currentOutputPixels.dataSize = this->data->pboSize;
 		this->currentOutputPixels.yColorBuffer = (uint8*)g_memory_allocate(this->data->pboSize);
@@ -37,7 +42,7 @@ namespace MathAnim
 		for (uint8 i = 0; i < this->data->numPbos; i++)
 		{
 			GL::bindBuffer(GL_PIXEL_PACK_BUFFER, this->data->pboIds[i]);
-			GL::bufferData(GL_PIXEL_PACK_BUFFER, this->data->pboSize, NULL, GL_STREAM_READ);
+			GL::bufferData(GL_PIXEL_PACK_BUFFER, this->data->pboAllocationSize, NULL, GL_STREAM_READ);
 		}
 
 		// Unbind pbos since this won't be called often
@@ -50,6 +55,7 @@ namespace MathAnim
 		{
 			return;
 		}
+		g_logger_assert(this->data->formatType == ByteFormat::R8_UI, "Separate Y and UV framebuffers only support 8 bit samples.");
 
 		size_t yChannelSize = yFramebuffer.width * yFramebuffer.height * TextureUtil::formatSize(yFramebuffer.colorAttachments.at(0).format);
 		size_t uChannelSize = uvFramebuffer.width * uvFramebuffer.height * TextureUtil::formatSize(uvFramebuffer.colorAttachments.at(0).format);
@@ -85,6 +91,47 @@ namespace MathAnim
 			GL_UNSIGNED_BYTE,
 			(void*)(yChannelSize + uChannelSize) // Read into pbo[yTextureSpaceAvailable + uTexAvail]
 		);
+
+		advanceWriteQueue();
+	}
+
+	void PixelBufferDownload::queueDownloadFrom(const Framebuffer& packedFramebuffer)
+	{
+		if (!this->data)
+		{
+			return;
+		}
+
+		const Texture& packedTexture = packedFramebuffer.colorAttachments.at(0);
+		g_logger_assert(packedTexture.format == this->data->formatType, "Packed framebuffer format doesn't match the format this downloader was created with.");
+		size_t packedTextureSize = (size_t)packedFramebuffer.width * (size_t)packedFramebuffer.height * TextureUtil::formatSize(packedTexture.format);
+		g_logger_assert(packedTextureSize >= this->data->pboSize && packedTextureSize <= this->data->pboAllocationSize, "Packed texture size doesn't match the PBO size.");
+
+		packedFramebuffer.bind();
+		GL::bindBuffer(GL_PIXEL_PACK_BUFFER, this->data->pboIds[this->writeQueueIndex]);
+		GL::readBuffer(GL_COLOR_ATTACHMENT0);
+		// Rows are tightly packed so the planes end up right after each other
+		GL::pixelStorei(GL_PACK_ALIGNMENT, 1);
+		GL::readPixels(
+			0, 0,
+			packedFramebuffer.width, packedFramebuffer.height,
+			TextureUtil::toGlExternalFormat(packedTexture.format),
+			TextureUtil::toGlDataType(packedTexture.format),
+			0
+		);
+		GL::pixelStorei(GL_PACK_ALIGNMENT, 4);
+
+		advanceWriteQueue();
+	}
+
+	uint32 PixelBufferDownload::packedYuvHeight(uint32 width, uint32 height)
+	{
+		size_t numSamples = (size_t)width * height + (size_t)(width / 2) * (height / 2) * 2;
+		return (uint32)((numSamples + width - 1) / width);
+	}
+
+	void PixelBufferDownload::advanceWriteQueue()
+	{
 		this->totalNumQueuedItems++;
 		this->numItemsInQueue++;
 		if (this->totalNumQueuedItems >= UINT32_MAX)
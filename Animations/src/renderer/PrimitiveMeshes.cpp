@@ -0,0 +1,266 @@
+#include "renderer/PrimitiveMeshes.h"
+#include "renderer/GLApi.h"
+
+namespace MathAnim
+{
+	namespace PrimitiveMeshes
+	{
+		// ------------- Internal Variables -------------
+		static PrimitiveMesh meshes[(size_t)PrimitiveType::Length][(size_t)PrimitiveLod::Length] = {};
+
+		static constexpr int circleSegments[(size_t)PrimitiveLod::Length] = { 8, 16, 32 };
+		static constexpr int sphereSegments[(size_t)PrimitiveLod::Length] = { 8, 16, 32 };
+		static constexpr int torusRingSegments[(size_t)PrimitiveLod::Length] = { 16, 24, 48 };
+		static constexpr int torusTubeSegments[(size_t)PrimitiveLod::Length] = { 8, 12, 24 };
+
+		// ------------- Internal Functions -------------
+		static void generateCube(std::vector<PrimitiveVertex>& vertices, std::vector<uint16>& indices);
+		static void generateCone(int numSegments, std::vector<PrimitiveVertex>& vertices, std::vector<uint16>& indices);
+		static void generateCylinder(int numSegments, std::vector<PrimitiveVertex>& vertices, std::vector<uint16>& indices);
+		static void generateSphere(int numSegments, std::vector<PrimitiveVertex>& vertices, std::vector<uint16>& indices);
+		static void generateTorus(int numRingSegments, int numTubeSegments, std::vector<PrimitiveVertex>& vertices, std::vector<uint16>& indices);
+		static uint16 addVertex(std::vector<PrimitiveVertex>& vertices, const Vec3& position, const Vec3& tubeOffset = Vec3{ 0, 0, 0 });
+		static void addTri(std::vector<uint16>& indices, uint16 i0, uint16 i1, uint16 i2);
+
+		void init()
+		{
+			std::vector<PrimitiveVertex> vertices = {};
+			std::vector<uint16> indices = {};
+			for (size_t type = 0; type < (size_t)PrimitiveType::Length; type++)
+			{
+				for (size_t lod = 0; lod < (size_t)PrimitiveLod::Length; lod++)
+				{
+					vertices.clear();
+					indices.clear();
+					generate((PrimitiveType)type, (PrimitiveLod)lod, vertices, indices);
+
+					PrimitiveMesh& mesh = meshes[type][lod];
+					mesh.vertCount = (uint32)vertices.size();
+					mesh.elementCount = (uint32)indices.size();
+
+					GL::genBuffers(1, &mesh.vbo);
+					GL::bindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+					GL::bufferData(GL_ARRAY_BUFFER, sizeof(PrimitiveVertex) * vertices.size(), vertices.data(), GL_STATIC_DRAW);
+
+					GL::genBuffers(1, &mesh.ebo);
+					GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ebo);
+					GL::bufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint16) * indices.size(), indices.data(), GL_STATIC_DRAW);
+				}
+			}
+
+			GL::bindBuffer(GL_ARRAY_BUFFER, 0);
+			GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+		}
+
+		const PrimitiveMesh& get(PrimitiveType type, PrimitiveLod lod)
+		{
+			g_logger_assert(type < PrimitiveType::Length && lod < PrimitiveLod::Length, "Invalid primitive mesh requested.");
+			return meshes[(size_t)type][(size_t)lod];
+		}
+
+		void generate(PrimitiveType type, PrimitiveLod lod, std::vector<PrimitiveVertex>& vertices, std::vector<uint16>& indices)
+		{
+			switch (type)
+			{
+			case PrimitiveType::Cube:
+				generateCube(vertices, indices);
+				break;
+			case PrimitiveType::Cone:
+				generateCone(circleSegments[(size_t)lod], vertices, indices);
+				break;
+			case PrimitiveType::Cylinder:
+				generateCylinder(circleSegments[(size_t)lod], vertices, indices);
+				break;
+			case PrimitiveType::Sphere:
+				generateSphere(sphereSegments[(size_t)lod], vertices, indices);
+				break;
+			case PrimitiveType::Torus:
+				generateTorus(torusRingSegments[(size_t)lod], torusTubeSegments[(size_t)lod], vertices, indices);
+				break;
+			case PrimitiveType::Length:
+				g_logger_error("Invalid primitive type '{}'.", (int)type);
+				break;
+			}
+		}
+
+		void free()
+		{
+			for (size_t type = 0; type < (size_t)PrimitiveType::Length; type++)
+			{
+				for (size_t lod = 0; lod < (size_t)PrimitiveLod::Length; lod++)
+				{
+					PrimitiveMesh& mesh = meshes[type][lod];
+					if (mesh.vbo != 0)
+					{
+						GL::deleteBuffers(1, &mesh.vbo);
+					}
+
+					if (mesh.ebo != 0)
+					{
+						GL::deleteBuffers(1, &mesh.ebo);
+					}
+
+					mesh = {};
+				}
+			}
+		}
+
+		// ------------- Internal Functions -------------
+		static void generateCube(std::vector<PrimitiveVertex>& vertices, std::vector<uint16>& indices)
+		{
+			uint16 first = (uint16)vertices.size();
+			for (int i = 0; i < 8; i++)
+			{
+				// Bit 0 is x, bit 1 is y, bit 2 is z
+				addVertex(vertices, Vec3{
+					(i & 1) ? 0.5f : -0.5f,
+					(i & 2) ? 0.5f : -0.5f,
+					(i & 4) ? 0.5f : -0.5f
+				});
+			}
+
+			constexpr uint16 faces[6][4] = {
+				{ 0, 2, 3, 1 }, // Back
+				{ 4, 5, 7, 6 }, // Front
+				{ 2, 6, 7, 3 }, // Top
+				{ 0, 1, 5, 4 }, // Bottom
+				{ 0, 4, 6, 2 }, // Left
+				{ 1, 3, 7, 5 }, // Right
+			};
+			for (const auto& face : faces)
+			{
+				addTri(indices, first + face[0], first + face[1], first + face[2]);
+				addTri(indices, first + face[0], first + face[2], first + face[3]);
+			}
+		}
+
+		static void generateCone(int numSegments, std::vector<PrimitiveVertex>& vertices, std::vector<uint16>& indices)
+		{
+			uint16 baseCenter = addVertex(vertices, Vec3{ 0, 0, 0 });
+			uint16 tip = addVertex(vertices, Vec3{ 0, 0, 1 });
+			uint16 firstRing = (uint16)vertices.size();
+			for (int i = 0; i < numSegments; i++)
+			{
+				float theta = glm::two_pi<float>() * (float)i / (float)numSegments;
+				addVertex(vertices, Vec3{ glm::cos(theta), glm::sin(theta), 0.0f });
+			}
+
+			for (int i = 0; i < numSegments; i++)
+			{
+				uint16 thisPoint = firstRing + (uint16)i;
+				uint16 nextPoint = firstRing + (uint16)((i + 1) % numSegments);
+				addTri(indices, baseCenter, nextPoint, thisPoint);
+				addTri(indices, thisPoint, nextPoint, tip);
+			}
+		}
+
+		static void generateCylinder(int numSegments, std::vector<PrimitiveVertex>& vertices, std::vector<uint16>& indices)
+		{
+			uint16 startCenter = addVertex(vertices, Vec3{ 0, 0, 0 });
+			uint16 endCenter = addVertex(vertices, Vec3{ 0, 0, 1 });
+			uint16 firstRing = (uint16)vertices.size();
+			for (int i = 0; i < numSegments; i++)
+			{
+				float theta = glm::two_pi<float>() * (float)i / (float)numSegments;
+				float x = glm::cos(theta);
+				float y = glm::sin(theta);
+				addVertex(vertices, Vec3{ x, y, 0.0f });
+				addVertex(vertices, Vec3{ x, y, 1.0f });
+			}
+
+			for (int i = 0; i < numSegments; i++)
+			{
+				uint16 startThis = firstRing + (uint16)(i * 2);
+				uint16 endThis = startThis + 1;
+				uint16 startNext = firstRing + (uint16)(((i + 1) % numSegments) * 2);
+				uint16 endNext = startNext + 1;
+
+				addTri(indices, startCenter, startNext, startThis);
+				addTri(indices, endCenter, endThis, endNext);
+				addTri(indices, startThis, startNext, endNext);
+				addTri(indices, startThis, endNext, endThis);
+			}
+		}
+
+		static void generateSphere(int numSegments, std::vector<PrimitiveVertex>& vertices, std::vector<uint16>& indices)
+		{
+			// numSegments stacks from pole to pole with numSegments sectors around each stack
+			uint16 first = (uint16)vertices.size();
+			for (int stack = 0; stack <= numSegments; stack++)
+			{
+				float stackAngle = glm::half_pi<float>() - glm::pi<float>() * (float)stack / (float)numSegments;
+				float xy = glm::cos(stackAngle);
+				float z = glm::sin(stackAngle);
+				for (int sector = 0; sector <= numSegments; sector++)
+				{
+					float sectorAngle = glm::two_pi<float>() * (float)sector / (float)numSegments;
+					addVertex(vertices, Vec3{ xy * glm::cos(sectorAngle), xy * glm::sin(sectorAngle), z });
+				}
+			}
+
+			for (int stack = 0; stack < numSegments; stack++)
+			{
+				uint16 k1 = first + (uint16)(stack * (numSegments + 1));
+				uint16 k2 = k1 + (uint16)(numSegments + 1);
+				for (int sector = 0; sector < numSegments; sector++, k1++, k2++)
+				{
+					// The first and last stacks are fans around the poles
+					if (stack != 0)
+					{
+						addTri(indices, k1, k2, k1 + 1);
+					}
+
+					if (stack != numSegments - 1)
+					{
+						addTri(indices, k1 + 1, k2, k2 + 1);
+					}
+				}
+			}
+		}
+
+		static void generateTorus(int numRingSegments, int numTubeSegments, std::vector<PrimitiveVertex>& vertices, std::vector<uint16>& indices)
+		{
+			uint16 first = (uint16)vertices.size();
+			for (int ring = 0; ring < numRingSegments; ring++)
+			{
+				float theta = glm::two_pi<float>() * (float)ring / (float)numRingSegments;
+				Vec3 ringPoint = Vec3{ glm::cos(theta), glm::sin(theta), 0.0f };
+				for (int tube = 0; tube < numTubeSegments; tube++)
+				{
+					float phi = glm::two_pi<float>() * (float)tube / (float)numTubeSegments;
+					Vec3 tubeOffset = ringPoint * glm::cos(phi) + Vec3{ 0, 0, 1 } * glm::sin(phi);
+					addVertex(vertices, ringPoint, tubeOffset);
+				}
+			}
+
+			for (int ring = 0; ring < numRingSegments; ring++)
+			{
+				int nextRing = (ring + 1) % numRingSegments;
+				for (int tube = 0; tube < numTubeSegments; tube++)
+				{
+					int nextTube = (tube + 1) % numTubeSegments;
+					uint16 p0 = first + (uint16)(ring * numTubeSegments + tube);
+					uint16 p1 = first + (uint16)(ring * numTubeSegments + nextTube);
+					uint16 p2 = first + (uint16)(nextRing * numTubeSegments + tube);
+					uint16 p3 = first + (uint16)(nextRing * numTubeSegments + nextTube);
+					addTri(indices, p0, p2, p3);
+					addTri(indices, p0, p3, p1);
+				}
+			}
+		}
+
+		static uint16 addVertex(std::vector<PrimitiveVertex>& vertices, const Vec3& position, const Vec3& tubeOffset)
+		{
+			g_logger_assert(vertices.size() < UINT16_MAX, "Primitive mesh has too many vertices for 16-bit indices.");
+			vertices.push_back({ position, tubeOffset });
+			return (uint16)(vertices.size() - 1);
+		}
+
+		static void addTri(std::vector<uint16>& indices, uint16 i0, uint16 i1, uint16 i2)
+		{
+			indices.push_back(i0);
+			indices.push_back(i1);
+			indices.push_back(i2);
+		}
+	}
+}
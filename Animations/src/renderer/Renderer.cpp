@@ -9,10 +9,13 @@
 #include "renderer/Colors.h"
 #include "renderer/Fonts.h"
 #include "renderer/GLApi.h"
+#include "renderer/PrimitiveMeshes.h"
 #include "animation/Animation.h"
 #include "animation/AnimationManager.h"
 #include "core/Application.h"
 #include "core/Profiling.h"
+#include "core/Profiler.h"
+#include "core/FrameArena.h"
 #include "editor/timeline/Timeline.h"
 #include "editor/EditorGui.h"
 #include "editor/EditorSettings.h"
@@ -47,6 +50,15 @@ namespace MathAnim
 		bool isTransparent;
 	};
 
+	struct DrawCmdInstanced3D
+	{
+		const Camera* camera;
+		PrimitiveType type;
+		PrimitiveLod lod;
+		bool isTransparent;
+		uint32 instanceCount;
+	};
+
 	struct DrawCmdSimple3D
 	{
 		const Camera* camera;
@@ -106,12 +118,12 @@ namespace MathAnim
 		Vec2 backP1, backP2;
 	};
 
+	// Paths are built and drawn within a single frame so everything lives in the FrameArena
 	struct Path2DContext
 	{
-		std::vector<Curve> rawCurves;
-		std::vector<Path_Vertex2DLine> data;
+		std::vector<Curve, FrameArenaAllocator<Curve>> rawCurves;
+		std::vector<Path_Vertex2DLine, FrameArenaAllocator<Path_Vertex2DLine>> data;
 		glm::mat4 transform;
-		float approximateLength;
 	};
 
 	struct Vertex3DLine
@@ -180,6 +192,14 @@ namespace MathAnim
 		uint64 objId;
 	};
 
+	struct PrimitiveInstance3D
+	{
+		glm::mat4 transform;
+		Vec4 color;
+		uint64 objId;
+		float tubeRadius;
+	};
+
 	struct DrawList3D
 	{
 		std::vector<Vertex3D> vertices;
@@ -187,10 +207,20 @@ namespace MathAnim
 		std::vector<DrawCmd3D> drawCommands;
 		std::vector<uint32> textureIdStack;
 
+		// Primitive meshes don't go through the vertex list. Every instance gets tagged
+		// with the command for its camera/primitive/LOD/pass and render() groups them so
+		// each command is a single instanced draw.
+		std::vector<PrimitiveInstance3D> instances;
+		std::vector<uint16> instanceCommandIndices;
+		std::vector<DrawCmdInstanced3D> instancedDrawCommands;
+
 		uint32 vao;
 		uint32 ebo;
 		uint32 vbo;
 
+		uint32 instancedVao;
+		uint32 instanceVbo;
+
 		void init();
 
 		void changeBatchIfNeeded(uint32 textureId, bool isTransparent);
@@ -198,9 +228,11 @@ namespace MathAnim
 		void addTexturedQuad3D(uint32 textureId, const Vec3& bottomLeft, const Vec3& topLeft, const Vec3& topRight, const Vec3& bottomRight, const Vec2& uvMin, const Vec2& uvMax, const Vec4& color, const Vec3& faceNormal, AnimObjId objId);
 		void addColoredTri(const Vec3& p0, const Vec3& p1, const Vec3& p2, const Vec4& color, AnimObjId objId);
 		void addMultiColoredTri(const Vec3& p0, const Vec4& c0, const Vec3& p1, const Vec4& c1, const Vec3& p2, const Vec4& c2, AnimObjId objId);
+		void addPrimitive(PrimitiveType type, PrimitiveLod lod, const glm::mat4& transform, const Vec4& color, float tubeRadius, AnimObjId objId);
 
 		void setupGraphicsBuffers();
-		void render(const Shader& opaqueShader, const Shader& transparentShader, const Shader& compositeShader, const Framebuffer& framebuffer) const;
+		void render(const Shader& opaqueShader, const Shader& transparentShader, const Shader& instancedOpaqueShader, const Shader& instancedTransparentShader, const Shader& compositeShader, const Framebuffer& framebuffer) const;
+		void renderInstanced(const Shader& shader, bool isTransparentPass, const uint32* commandOffsets) const;
 		void reset();
 		void free();
 	};
@@ -231,6 +263,7 @@ namespace MathAnim
 		static Shader activeObjectMaskShader;
 		static Shader rgbToYuvShaderYChannel;
 		static Shader rgbToYuvShaderUvChannel;
+		static Shader rgbToPackedYuvShader;
 
 		static Shader shader3DLine;
 		static Shader shader3DScreenAlignedBillboard;
@@ -238,10 +271,18 @@ namespace MathAnim
 		static Shader shader3DOpaque;
 		static Shader shader3DTransparent;
 		static Shader shader3DComposite;
+		static Shader shader3DInstancedOpaque;
+		static Shader shader3DInstancedTransparent;
 
 		static Shader jumpFloodShader;
 		static Shader outlineShader;
 
+		// The jump flood for selection outlines runs in this reduced resolution
+		// framebuffer. It's (re)generated lazily whenever the editor framebuffer
+		// or outline resolution setting changes.
+		static Framebuffer outlineFramebuffer = {};
+		static constexpr int maxOutlinedObjectsPerPass = 128;
+
 		static constexpr int MAX_STACK_SIZE = 64;
 
 		static glm::vec4 colorStack[MAX_STACK_SIZE];
@@ -285,12 +326,16 @@ namespace MathAnim
 		// ---------------------- Internal Functions ----------------------
 		static void setupDefaultWhiteTexture();
 		static void setupScreenVao();
+		static Framebuffer prepareOutlineFramebuffer(int outputWidth, int outputHeight);
 		static void generateMiter3D(const Vec3& previousPoint, const Vec3& currentPoint, const Vec3& nextPoint, float strokeWidth, Vec2* outNormal, float* outStrokeWidth);
 		static void lineToInternal(Path2DContext* path, const Vec2& point, bool addToRawCurve);
 		static void lineToInternal(Path2DContext* path, const Path_Vertex2DLine& vert, bool addToRawCurve);
 		static const Camera* getCurrentCamera2D();
 		static const Camera* getCurrentCamera3D();
 		static uint32 packColor(const Vec4& color);
+		static glm::mat4 primitiveTransform(const Vec3& origin, const Vec3& xAxis, const Vec3& yAxis, const Vec3& zAxis);
+		static PrimitiveLod selectPrimitiveLod(const Vec3& center, float boundingRadius);
+		static void drawDonutArc(const Vec3& center, float innerRadius, float outerRadius, const Vec3& forward, const Vec3& up, float thetaStart, float thetaEnd, AnimObjId objId);
 
 		void init()
 		{
@@ -308,11 +353,14 @@ namespace MathAnim
 			activeObjectMaskShader.compile("assets/shaders/activeObjectMask.glsl");
 			rgbToYuvShaderYChannel.compile("assets/shaders/rgbToYuvYChannel.glsl");
 			rgbToYuvShaderUvChannel.compile("assets/shaders/rgbToYuvUvChannel.glsl");
+			rgbToPackedYuvShader.compile("assets/shaders/rgbToPackedI420.glsl");
 			shader3DLine.compile("assets/shaders/shader3DLine.glsl");
 			shader3DScreenAlignedBillboard.compile("assets/shaders/screenAlignedBillboard.glsl");
 			shader3DOpaque.compile("assets/shaders/shader3DOpaque.glsl");
 			shader3DTransparent.compile("assets/shaders/shader3DTransparent.glsl");
 			shader3DComposite.compile("assets/shaders/shader3DComposite.glsl");
+			shader3DInstancedOpaque.compile("assets/shaders/shader3DInstancedOpaque.glsl");
+			shader3DInstancedTransparent.compile("assets/shaders/shader3DInstancedTransparent.glsl");
 			jumpFloodShader.compile("assets/shaders/jumpFlood.glsl");
 			outlineShader.compile("assets/shaders/outlineShader.glsl");
 #else
@@ -323,15 +371,20 @@ namespace MathAnim
 			activeObjectMaskShader.compile("assets/shaders/activeObjectMask.glsl");
 			rgbToYuvShaderYChannel.compile("assets/shaders/rgbToYuvYChannel.glsl");
 			rgbToYuvShaderUvChannel.compile("assets/shaders/rgbToYuvUvChannel.glsl");
+			rgbToPackedYuvShader.compile("assets/shaders/rgbToPackedI420.glsl");
 			shader3DLine.compile("assets/shaders/shader3DLine.glsl");
 			shader3DScreenAlignedBillboard.compile("assets/shaders/screenAlignedBillboard.glsl");
 			shader3DOpaque.compile("assets/shaders/shader3DOpaque.glsl");
 			shader3DTransparent.compile("assets/shaders/shader3DTransparent.glsl");
 			shader3DComposite.compile("assets/shaders/shader3DComposite.glsl");
+			shader3DInstancedOpaque.compile("assets/shaders/shader3DInstancedOpaque.glsl");
+			shader3DInstancedTransparent.compile("assets/shaders/shader3DInstancedTransparent.glsl");
 			jumpFloodShader.compile("assets/shaders/jumpFlood.glsl");
 			outlineShader.compile("assets/shaders/outlineShader.glsl");
 #endif
 
+			PrimitiveMeshes::init();
+
 			drawList2D.init();
 			drawList3DLine.init();
 			drawList3D.init();
@@ -339,7 +392,7 @@ namespace MathAnim
 			setupScreenVao();
 			setupDefaultWhiteTexture();
 
-			TextureCache::init();
+			TextureCache::init(Application::threadPool());
 		}
 
 		void free()
@@ -350,11 +403,14 @@ namespace MathAnim
 			activeObjectMaskShader.destroy();
 			rgbToYuvShaderYChannel.destroy();
 			rgbToYuvShaderUvChannel.destroy();
+			rgbToPackedYuvShader.destroy();
 			shader3DLine.destroy();
 			shader3DScreenAlignedBillboard.destroy();
 			shader3DOpaque.destroy();
 			shader3DTransparent.destroy();
 			shader3DComposite.destroy();
+			shader3DInstancedOpaque.destroy();
+			shader3DInstancedTransparent.destroy();
 			jumpFloodShader.destroy();
 			outlineShader.destroy();
 
@@ -362,6 +418,12 @@ namespace MathAnim
 			drawList3DLine.free();
 			drawList3D.free();
 			drawList3DBillboard.free();
+			PrimitiveMeshes::free();
+
+			if (outlineFramebuffer.colorAttachments.size() > 0)
+			{
+				outlineFramebuffer.destroy();
+			}
 
 			TextureCache::free();
 		}
@@ -420,35 +482,11 @@ namespace MathAnim
 				.setHeight(outputHeight)
 				.build();
 
-			Texture activeObjectsOutlineMask = TextureBuilder()
-				.setFormat(ByteFormat::RGBA16_F)
-				.setMinFilter(FilterMode::Nearest)
-				.setMagFilter(FilterMode::Nearest)
-				// TODO: Should we have a smaller framebuffer for outlines?
-				// We could potentially make it 2x or 3x smaller and then just
-				// render to that instead of having it attached to the main framebuffer
-				.setWidth(outputWidth)
-				.setHeight(outputHeight)
-				.build();
-
-			Texture activeObjectsOutlineMask2 = TextureBuilder()
-				.setFormat(ByteFormat::RGBA16_F)
-				.setMinFilter(FilterMode::Nearest)
-				.setMagFilter(FilterMode::Nearest)
-				// TODO: Should we have a smaller framebuffer for outlines?
-				// We could potentially make it 2x or 3x smaller and then just
-				// render to that instead of having it attached to the main framebuffer
-				.setWidth(outputWidth)
-				.setHeight(outputHeight)
-				.build();
-
 			Framebuffer res = FramebufferBuilder(outputWidth, outputHeight)
 				.addColorAttachment(compositeTexture)
 				.addColorAttachment(accumulationTexture)
 				.addColorAttachment(revelageTexture)
 				.addColorAttachment(objIdTexture)
-				.addColorAttachment(activeObjectsOutlineMask)
-				.addColorAttachment(activeObjectsOutlineMask2)
 				.includeDepthStencil()
 				.generate();
 
@@ -465,20 +503,23 @@ namespace MathAnim
 		void clearFramebuffer(Framebuffer& framebuffer, const Vec4& clearColor)
 		{
 			GL::pushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, debugMsgId++, -1, "Clear_Framebuffer");
+			Profiler::beginGpuEvent("Clear_Framebuffer");
 			framebuffer.clearColorAttachmentRgba(0, clearColor);
 			framebuffer.clearColorAttachmentUint64(3, NULL_ANIM_OBJECT);
 			framebuffer.clearDepthStencil();
+			Profiler::endGpuEvent();
 			GL::popDebugGroup();
 		}
 
 		void renderToFramebuffer(Framebuffer& framebuffer, const char* debugName)
 		{
-			constexpr size_t numExpectedColorAttachments = 6;
+			constexpr size_t numExpectedColorAttachments = 4;
 			g_logger_assert(framebuffer.colorAttachments.size() == numExpectedColorAttachments, "Invalid framebuffer. Should have {} color attachments.", numExpectedColorAttachments);
 			g_logger_assert(framebuffer.includeDepthStencil, "Invalid framebuffer. Should include depth and stencil buffers.");
 
 			debugMsgId = 0;
 			GL::pushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, debugMsgId++, -1, debugName);
+			Profiler::beginGpuEvent(debugName);
 
 			// Reset the draw buffers to draw to FB_attachment_0
 			GLenum compositeDrawBuffers[] = { GL_COLOR_ATTACHMENT0, GL_NONE, GL_NONE, GL_COLOR_ATTACHMENT3 };
@@ -492,6 +533,8 @@ namespace MathAnim
 			drawList3D.render(
 				shader3DOpaque,
 				shader3DTransparent,
+				shader3DInstancedOpaque,
+				shader3DInstancedTransparent,
 				shader3DComposite,
 				framebuffer
 			);
@@ -509,6 +552,7 @@ namespace MathAnim
 			// These should be blended appropriately
 			// drawList2D.render(shader2D);
 
+			Profiler::endGpuEvent();
 			GL::popDebugGroup();
 		}
 
@@ -539,35 +583,66 @@ namespace MathAnim
 			// Source[1]: https://blog.demofox.org/2016/02/29/fast-voronoi-diagrams-and-distance-dield-textures-on-the-gpu-with-the-jump-flooding-algorithm/
 
 			GL::pushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, debugMsgId++, -1, "Main_Framebuffer_Pass_StencilOutline");
+			Profiler::beginGpuEvent("Main_Framebuffer_Pass_StencilOutline");
+
+			const EditorSettingsData& editorSettings = EditorSettings::getSettings();
+			const float resolutionScale = _outlineResolutionValues[(int)editorSettings.activeObjectOutlineResolution];
+			const int downsampleFactor = (int)glm::ceil(1.0f / resolutionScale);
+			const int outlineWidth = glm::max((int)glm::ceil((float)framebuffer.width / (float)downsampleFactor), 1);
+			const int outlineHeight = glm::max((int)glm::ceil((float)framebuffer.height / (float)downsampleFactor), 1);
+			if (outlineFramebuffer.width != outlineWidth || outlineFramebuffer.height != outlineHeight)
+			{
+				if (outlineFramebuffer.colorAttachments.size() > 0)
+				{
+					outlineFramebuffer.destroy();
+				}
+				outlineFramebuffer = prepareOutlineFramebuffer(outlineWidth, outlineHeight);
+			}
 
 			GL::disable(GL_DEPTH_TEST);
 			GL::disable(GL_BLEND);
-			GL::viewport(0, 0, framebuffer.width, framebuffer.height);
 
 			// All the draw calls following will use this VAO
 			GL::bindVertexArray(screenVao);
 
-			// Reset the draw draw buffers
-			const GLenum compositeDrawBuffers[] = { GL_NONE, GL_NONE, GL_NONE, GL_NONE, GL_COLOR_ATTACHMENT4, GL_COLOR_ATTACHMENT5 };
-			GL::drawBuffers(6, compositeDrawBuffers);
-
-			// Clear the draw buffer to 0s
-			framebuffer.bind();
+			// Clear the jump masks to -1s
+			outlineFramebuffer.bind();
+			GL::viewport(0, 0, outlineFramebuffer.width, outlineFramebuffer.height);
+			const GLenum seedDrawBuffers[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+			GL::drawBuffers(2, seedDrawBuffers);
 			float maskClearColor[4] = { -1.0f, -1.0f, -1.0f, -1.0f };
-			GL::clearBufferfv(GL_COLOR, 4, maskClearColor);
-			GL::clearBufferfv(GL_COLOR, 5, maskClearColor);
+			GL::clearBufferfv(GL_COLOR, 0, maskClearColor);
+			GL::clearBufferfv(GL_COLOR, 1, maskClearColor);
 
-			// Do a screen pass for the active object and each one of its children
+			// Seed the jump mask with every active object at once. The shader does a binary
+			// search over the sorted ids, so one pass handles up to maxOutlinedObjectsPerPass
+			// objects and each pixel costs O(log(n)) regardless of how many objects are selected.
 			activeObjectMaskShader.bind();
 
 			const Texture& objectIdTexture = framebuffer.getColorAttachment(3);
 			constexpr int objectIdTexSlot = 0;
 			objectIdTexture.bind(objectIdTexSlot);
 			activeObjectMaskShader.uploadInt("uObjectIdTexture", objectIdTexSlot);
+			activeObjectMaskShader.uploadInt("uDownsampleFactor", downsampleFactor);
 
-			for (auto activeObjId : activeObjects)
+			std::vector<AnimObjId> sortedActiveObjects = activeObjects;
+			std::sort(sortedActiveObjects.begin(), sortedActiveObjects.end(), [](AnimObjId a, AnimObjId b)
+				{
+					// Sort by (HIGH, LOW) to match the comparison done in the shader
+					uint32 aHigh = (uint32)(a >> 32);
+					uint32 bHigh = (uint32)(b >> 32);
+					if (aHigh != bHigh)
+					{
+						return aHigh < bHigh;
+					}
+					return (uint32)a < (uint32)b;
+				});
+
+			for (size_t offset = 0; offset < sortedActiveObjects.size(); offset += maxOutlinedObjectsPerPass)
 			{
-				activeObjectMaskShader.uploadU64AsUVec2("uActiveObjectId", activeObjId);
+				int numIds = (int)glm::min(sortedActiveObjects.size() - offset, (size_t)maxOutlinedObjectsPerPass);
+				activeObjectMaskShader.uploadInt("uNumActiveObjectIds", numIds);
+				activeObjectMaskShader.uploadU64ArrayAsUVec2Array("uActiveObjectIds", numIds, sortedActiveObjects.data() + offset);
 
 				GL::drawArrays(GL_TRIANGLES, 0, 6);
 			}
@@ -578,43 +653,51 @@ namespace MathAnim
 			constexpr int jumpMaskTexSlot = 0;
 			jumpFloodShader.uploadInt("uJumpMask", jumpMaskTexSlot);
 
-			const GLenum pingBuffer[] = { GL_COLOR_ATTACHMENT4, GL_NONE, GL_NONE, GL_NONE, GL_NONE };
-			const GLenum pongBuffer[] = { GL_COLOR_ATTACHMENT5, GL_NONE, GL_NONE, GL_NONE, GL_NONE };
+			const GLenum pingBuffer[] = { GL_COLOR_ATTACHMENT0, GL_NONE };
+			const GLenum pongBuffer[] = { GL_NONE, GL_COLOR_ATTACHMENT1 };
 
-			int numPasses = (int)glm::log2((float)glm::max(framebuffer.width, framebuffer.height));
+			// We only need to flood as far as the outline reaches, not across the entire
+			// framebuffer. See Source[0], this is where most of the savings come from.
+			float outlineWidthInMaskPixels = glm::max(editorSettings.activeObjectOutlineWidth / (float)downsampleFactor, 1.0f);
+			int numPasses = glm::min(
+				(int)glm::ceil(glm::log2(outlineWidthInMaskPixels)) + 1,
+				(int)glm::log2((float)glm::max(outlineFramebuffer.width, outlineFramebuffer.height))
+			);
+			numPasses = glm::max(numPasses, 1);
 			const GLenum* currentDrawBuffer = pongBuffer;
 			for (int pass = 0; pass < numPasses; pass++)
 			{
-				GL::drawBuffers(5, currentDrawBuffer);
-				int readBufferId = currentDrawBuffer == pingBuffer ? 5 : 4;
-				const Texture& currentReadBuffer = framebuffer.getColorAttachment(readBufferId);
+				GL::drawBuffers(2, currentDrawBuffer);
+				int readBufferId = currentDrawBuffer == pingBuffer ? 1 : 0;
+				const Texture& currentReadBuffer = outlineFramebuffer.getColorAttachment(readBufferId);
 
 				currentReadBuffer.bind(jumpMaskTexSlot);
 				// Switch where we draw to and read from every frame
 				currentDrawBuffer = currentDrawBuffer == pingBuffer ? pongBuffer : pingBuffer;
 
 				float sampleOffset = glm::exp2((float)numPasses - (float)pass - 1.0f);
-				glm::vec2 normalizedSampleOffset = glm::vec2(1.0f / framebuffer.width, 1.0f / framebuffer.height);
-				if (pass != numPasses - 1)
-				{
-					normalizedSampleOffset *= sampleOffset;
-				}
+				glm::vec2 normalizedSampleOffset = glm::vec2(1.0f / outlineFramebuffer.width, 1.0f / outlineFramebuffer.height);
+				normalizedSampleOffset *= sampleOffset;
 				jumpFloodShader.uploadVec2("uSampleOffset", normalizedSampleOffset);
 
 				GL::drawArrays(GL_TRIANGLES, 0, 6);
 			}
 
-			// Reset drawBuffers
-			const GLenum regularDrawBuffers[] = { GL_COLOR_ATTACHMENT0, GL_NONE, GL_NONE, GL_NONE, GL_NONE };
-			GL::drawBuffers(5, regularDrawBuffers);
+			// Reset drawBuffers and go back to the full resolution framebuffer
+			framebuffer.bind();
+			GL::viewport(0, 0, framebuffer.width, framebuffer.height);
+			const GLenum regularDrawBuffers[] = { GL_COLOR_ATTACHMENT0, GL_NONE, GL_NONE, GL_NONE };
+			GL::drawBuffers(4, regularDrawBuffers);
 			GL::enable(GL_BLEND);
 
-			// Finally use the generated texture to draw the outline. PROFIT!
+			// Finally use the generated texture to draw the outline. This pass runs at full
+			// resolution and upsamples the jump mask, since it stores normalized seed
+			// coordinates the distance is still calculated in full resolution pixels. PROFIT!
 			{
 				outlineShader.bind();
 
-				int readBufferId = currentDrawBuffer == pingBuffer ? 5 : 4;
-				const Texture& currentReadBuffer = framebuffer.getColorAttachment(readBufferId);
+				int readBufferId = currentDrawBuffer == pingBuffer ? 1 : 0;
+				const Texture& currentReadBuffer = outlineFramebuffer.getColorAttachment(readBufferId);
 
 				constexpr int readJumpMaskTexSlot = 0;
 				currentReadBuffer.bind(readJumpMaskTexSlot);
@@ -623,15 +706,14 @@ namespace MathAnim
 				framebuffer.getColorAttachment(3).bind(1);
 				outlineShader.uploadInt("uObjectIdTexture", 1);
 
-				const EditorSettingsData& editorSettings = EditorSettings::getSettings();
 				outlineShader.uploadFloat("uOutlineWidth", editorSettings.activeObjectOutlineWidth);
 				outlineShader.uploadVec4("uOutlineColor", editorSettings.activeObjectHighlightColor);
 				outlineShader.uploadVec2("uFramebufferSize", glm::vec2((float)framebuffer.width, (float)framebuffer.height));
-				outlineShader.uploadU64AsUVec2("uActiveObjectId", activeObjects[0]);
 
 				GL::drawArrays(GL_TRIANGLES, 0, 6);
 			}
 
+			Profiler::endGpuEvent();
 			GL::popDebugGroup();
 		}
 
@@ -700,18 +782,45 @@ namespace MathAnim
 			GL::drawArrays(GL_TRIANGLES, 0, 6);
 		}
 
+		void renderTextureToPackedYuvFramebuffer(const Texture& texture, const Framebuffer& packedFramebuffer, uint32 frameWidth, uint32 frameHeight)
+		{
+			// A single pass writes all 3 planes, every fragment works out which plane its texel belongs to
+			packedFramebuffer.bind();
+
+			rgbToPackedYuvShader.bind();
+			GLenum drawBuffers[] = { GL_COLOR_ATTACHMENT0, GL_NONE, GL_NONE, GL_NONE };
+			GL::drawBuffers(4, drawBuffers);
+
+			GL::viewport(0, 0, packedFramebuffer.width, packedFramebuffer.height);
+
+			constexpr int texSlot = 0;
+			texture.bind(texSlot);
+			rgbToPackedYuvShader.uploadInt("uTexture", texSlot);
+			rgbToPackedYuvShader.uploadUVec2("uFrameSize", glm::uvec2(frameWidth, frameHeight));
+			// 10 bit samples are the 8 bit ones shifted up by 2 bits
+			bool isTenBit = packedFramebuffer.colorAttachments.at(0).format == ByteFormat::R16_UI;
+			rgbToPackedYuvShader.uploadFloat("uSampleScale", isTenBit ? 4.0f : 1.0f);
+
+			GL::bindVertexArray(screenVao);
+			GL::drawArrays(GL_TRIANGLES, 0, 6);
+		}
+
 		void clearDrawCalls()
 		{
 			MP_PROFILE_EVENT("Renderer_ClearDrawCalls");
 
 			// Track metrics
 			list2DNumDrawCalls += (int)drawList2D.drawCommands.size();
-			list3DNumDrawCalls += (int)drawList3D.drawCommands.size();
+			list3DNumDrawCalls += (int)(drawList3D.drawCommands.size() + drawList3D.instancedDrawCommands.size());
 			list3DLineNumDrawCalls += (int)drawList3DLine.drawCommands.size();
 			list3DBillboardNumDrawCalls += (int)drawList3DBillboard.drawCommands.size();
 
 			list2DNumTris += (int)drawList2D.indices.size() / 3;
 			list3DNumTris += (int)drawList3D.indices.size() / 3;
+			for (const DrawCmdInstanced3D& cmd : drawList3D.instancedDrawCommands)
+			{
+				list3DNumTris += (int)(PrimitiveMeshes::get(cmd.type, cmd.lod).elementCount / 3 * cmd.instanceCount);
+			}
 			list3DLineNumTris += (int)drawList3DLine.vertices.size() / 3;
 			list3DBillboardNumTris += (int)drawList3DBillboard.vertices.size() / 3;
 
@@ -992,7 +1101,7 @@ namespace MathAnim
 				float kerning = 0.0f;
 				if (i < string.length() - 1)
 				{
-					//kerning = font->getKerning((uint32)string[i], (uint32)string[i + 1]);
+					kerning = font->getKerning((uint32)(uint8)string[i], (uint32)(uint8)string[i + 1]);
 				}
 				cursorPos.x += (glyphOutline.advanceX + kerning) * font->fontSizePixels;
 			}
@@ -1019,7 +1128,7 @@ namespace MathAnim
 		// ----------- 2D Line stuff ----------- 
 		Path2DContext* beginPath(const Vec2& start, const glm::mat4& transform)
 		{
-			Path2DContext* context = (Path2DContext*)g_memory_allocate(sizeof(Path2DContext));
+			Path2DContext* context = (Path2DContext*)FrameArena::allocate(sizeof(Path2DContext), alignof(Path2DContext));
 			new(context)Path2DContext();
 
 			float strokeWidth = strokeWidthStackPtr > 0
@@ -1039,8 +1148,8 @@ namespace MathAnim
 
 		void free(Path2DContext* path)
 		{
+			// The memory itself goes back with FrameArena::reset
 			path->~Path2DContext();
-			g_memory_free(path);
 		}
 
 		static Vec3 transformVertVec3(const Vec2& vert, const glm::mat4& transform)
@@ -1221,152 +1330,79 @@ namespace MathAnim
 			startT = glm::clamp(startT, 0.0f, 1.0f);
 			endT = glm::clamp(endT, startT, 1.0f);
 
-			// Start the fade in after 80% of the svg object is drawn
-			const float lengthToDraw = (endT - startT) * (float)path->approximateLength;
-			float currentT = 0.0f;
-
-			if (lengthToDraw > 0 && path->rawCurves.size() > 0)
+			if (endT <= startT || path->rawCurves.size() == 0)
 			{
-				float lengthDrawn = 0.0f;
-
-				Path2DContext* context = nullptr;
+				return;
+			}
 
-				for (int curvei = 0; curvei < path->rawCurves.size(); curvei++)
-				{
-					float lengthLeft = lengthToDraw - lengthDrawn;
-					if (lengthLeft < 0.0f)
-					{
-						break;
-					}
+			// Map the start and end distances to a curve and t on that curve so the outline
+			// grows at a constant speed
+			ArcLengthLut arcLengthLut = ArcLengthLut::create((int)path->rawCurves.size());
+			for (const Curve& curve : path->rawCurves)
+			{
+				arcLengthLut.addCurve(curve);
+			}
 
-					Curve curve = path->rawCurves[curvei];
-					float approxLength = curve.calculateApproximatePerimeter();
-					float approxLengthTVal = approxLength / (float)path->approximateLength;
+			float startCurveT, endCurveT;
+			int startCurve = arcLengthLut.find(startT * arcLengthLut.getTotalLength(), &startCurveT);
+			int endCurve = arcLengthLut.find(endT * arcLengthLut.getTotalLength(), &endCurveT);
+			arcLengthLut.free();
 
-					if (context == nullptr)
-					{
-						Renderer::pushColor(path->data[curvei].color);
-						if (currentT >= startT)
-						{
-							context = Renderer::beginPath(path->rawCurves[curvei].p0);
-						}
-						else if (currentT + approxLengthTVal >= startT)
-						{
-							float tSplit0 = 1.0f - ((currentT + approxLengthTVal - startT) / approxLengthTVal);
-							curve = curve.split(tSplit0, 1.0f);
-							currentT = startT;
-							approxLength = curve.calculateApproximatePerimeter();
-							approxLengthTVal = approxLength / (float)path->approximateLength;
-
-							context = Renderer::beginPath(curve.p0);
-						}
-						Renderer::popColor();
-					}
+			Path2DContext* context = nullptr;
+			for (int curvei = startCurve; curvei <= endCurve; curvei++)
+			{
+				float t0 = curvei == startCurve ? startCurveT : 0.0f;
+				float t1 = curvei == endCurve ? endCurveT : 1.0f;
+				Curve curve = t0 > 0.0f || t1 < 1.0f
+					? path->rawCurves[curvei].split(t0, t1)
+					: path->rawCurves[curvei];
 
-					const Vec2& p0 = curve.p0;
-					Renderer::pushColor(path->data[curvei + 1].color);
+				if (context == nullptr)
+				{
+					Renderer::pushColor(path->data[curvei].color);
+					context = Renderer::beginPath(curve.p0);
+					Renderer::popColor();
+				}
 
-					switch (curve.type)
-					{
-					case CurveType::Bezier3:
-					{
-						if (currentT < startT)
-						{
-							break;
-						}
-
-						if (lengthLeft < approxLength)
-						{
-							// Interpolate the curve
-							float percentOfCurveToDraw = lengthLeft / approxLength;
-							curve = curve.split(0.0f, percentOfCurveToDraw);
-						}
-
-						lengthDrawn += approxLength;
-						Renderer::cubicTo(
-							context,
-							curve.as.bezier3.p1,
-							curve.as.bezier3.p2,
-							curve.as.bezier3.p3
-						);
-					}
+				Renderer::pushColor(path->data[curvei + 1].color);
+				switch (curve.type)
+				{
+				case CurveType::Bezier3:
+					Renderer::cubicTo(
+						context,
+						curve.as.bezier3.p1,
+						curve.as.bezier3.p2,
+						curve.as.bezier3.p3
+					);
 					break;
-					case CurveType::Bezier2:
-					{
-						if (currentT < startT)
-						{
-							break;
-						}
-
-						const Vec2& p1 = curve.as.bezier2.p1;
-						const Vec2& p2 = curve.as.bezier2.p1;
-						const Vec2& p3 = curve.as.bezier2.p2;
-
-						// Degree elevated quadratic bezier curve
-						Vec2 pr0 = p0;
-						Vec2 pr1 = (1.0f / 3.0f) * p0 + (2.0f / 3.0f) * p1;
-						Vec2 pr2 = (2.0f / 3.0f) * p1 + (1.0f / 3.0f) * p2;
-						Vec2 pr3 = p3;
-
-						if (lengthLeft < approxLength)
-						{
-							// Interpolate the curve
-							float percentOfCurveToDraw = lengthLeft / approxLength;
-							curve = curve.split(0.0f, percentOfCurveToDraw);
-
-							pr1 = curve.as.bezier3.p1;
-							pr2 = curve.as.bezier3.p2;
-							pr3 = curve.as.bezier3.p3;
-						}
-
-						lengthDrawn += approxLength;
-						Renderer::cubicTo(
-							context,
-							pr1,
-							pr2,
-							pr3
-						);
-					}
+				case CurveType::Bezier2:
+					Renderer::quadTo(
+						context,
+						curve.as.bezier2.p1,
+						curve.as.bezier2.p2
+					);
 					break;
-					case CurveType::Line:
-					{
-						if (currentT < startT)
-						{
-							break;
-						}
-
-						if (lengthLeft < approxLength)
-						{
-							float percentOfCurveToDraw = lengthLeft / approxLength;
-							curve = curve.split(0.0f, percentOfCurveToDraw);
-						}
-
-						const Vec2& p1 = curve.as.line.p1;
-						lengthDrawn += approxLength;
-						Renderer::lineTo(
-							context,
-							p1
-						);
-					}
+				case CurveType::Line:
+					Renderer::lineTo(
+						context,
+						curve.as.line.p1
+					);
+					break;
+				case CurveType::None:
 					break;
-					case CurveType::None:
-						break;
-					}
-
-					Renderer::popColor();
-					currentT += approxLengthTVal;
 				}
+				Renderer::popColor();
+			}
 
-				if (endT < 1.0f)
-				{
-					Renderer::endPath(context, false, objId);
-					Renderer::free(context);
-				}
-				else
-				{
-					Renderer::endPath(context, closePath, objId);
-					Renderer::free(context);
-				}
+			if (endT < 1.0f)
+			{
+				Renderer::endPath(context, false, objId);
+				Renderer::free(context);
+			}
+			else
+			{
+				Renderer::endPath(context, closePath, objId);
+				Renderer::free(context);
 			}
 		}
 
@@ -1401,7 +1437,6 @@ namespace MathAnim
 				rawCurve.as.bezier2.p1 = p1;
 				rawCurve.as.bezier2.p2 = p2;
 
-				path->approximateLength += rawCurve.calculateApproximatePerimeter();
 				path->rawCurves.emplace_back(rawCurve);
 			}
 
@@ -1439,7 +1474,6 @@ namespace MathAnim
 				rawCurve.as.bezier3.p2 = p2;
 				rawCurve.as.bezier3.p3 = p3;
 
-				path->approximateLength += rawCurve.calculateApproximatePerimeter();
 				path->rawCurves.emplace_back(rawCurve);
 			}
 
@@ -1550,68 +1584,16 @@ namespace MathAnim
 		void drawCube3D(const Vec3& center, const Vec3& size, const Vec3& forward, const Vec3& up, AnimObjId objId)
 		{
 			Vec3 right = CMath::cross(forward, up);
-			Vec3 halfSize = size / 2.0f;
-
-			Vec3 p0 = center - (halfSize * forward) - (halfSize * up) - (halfSize * right); // Back-Bottom-Left
-			Vec3 p1 = p0 + up * size; // Back-Top-Left
-			Vec3 p2 = p1 + right * size; // Back-Top-Right
-			Vec3 p3 = p2 - up * size; // Back-Bottom-Right
-
-			Vec3 p4 = p0 + forward * size; // Front-Bottom-Left
-			Vec3 p5 = p1 + forward * size; // Front-Top-Left
-			Vec3 p6 = p2 + forward * size; // Front-Top-Right
-			Vec3 p7 = p3 + forward * size; // Front-Bottom-Right
-
-			// Back face
-			drawFilledTri3D(p0, p1, p2, objId);
-			drawFilledTri3D(p0, p2, p3, objId);
-
-			// Front face
-			drawFilledTri3D(p4, p5, p6, objId);
-			drawFilledTri3D(p4, p6, p7, objId);
-
-			// Top Face
-			drawFilledTri3D(p1, p2, p6, objId);
-			drawFilledTri3D(p1, p6, p5, objId);
-
-			// Bottom Face
-			drawFilledTri3D(p0, p3, p7, objId);
-			drawFilledTri3D(p0, p7, p4, objId);
-
-			// Left face
-			drawFilledTri3D(p0, p1, p5, objId);
-			drawFilledTri3D(p0, p5, p4, objId);
-
-			// Right Face
-			drawFilledTri3D(p2, p3, p7, objId);
-			drawFilledTri3D(p2, p7, p6, objId);
+			glm::mat4 transform = primitiveTransform(center, right * size.x, up * size.y, forward * size.z);
+			float boundingRadius = CMath::length(size) / 2.0f;
+			drawList3D.addPrimitive(PrimitiveType::Cube, selectPrimitiveLod(center, boundingRadius), transform, getColor(), 0.0f, objId);
 		}
 
 		void drawCone3D(const Vec3& baseCenter, const Vec3& forward, const Vec3& up, float radius, float length, AnimObjId objId)
 		{
-			Vec3 tip = baseCenter + (forward * length);
-
 			const Vec3 rightDir = CMath::cross(forward, up);
-
-			constexpr int numPointsOnCircle = 16;
-			constexpr float increments = 360.0f / (float)numPointsOnCircle;
-			for (int i = 0; i < numPointsOnCircle; i++)
-			{
-				float radians = glm::radians((float)i * increments);
-				float nextRadians = glm::radians((float)((i + 1) % numPointsOnCircle) * increments);
-
-				float xVal = glm::sin(radians) * radius;
-				float yVal = glm::cos(radians) * radius;
-
-				float nextXVal = glm::sin(nextRadians) * radius;
-				float nextYVal = glm::cos(nextRadians) * radius;
-
-				Vec3 thisPoint = baseCenter + (rightDir * xVal) + (up * yVal);
-				Vec3 nextPoint = baseCenter + (rightDir * nextXVal) + (up * nextYVal);
-
-				drawFilledTri3D(baseCenter, thisPoint, nextPoint, objId);
-				drawFilledTri3D(thisPoint, tip, nextPoint, objId);
-			}
+			glm::mat4 transform = primitiveTransform(baseCenter, rightDir * radius, up * radius, forward * length);
+			drawList3D.addPrimitive(PrimitiveType::Cone, selectPrimitiveLod(baseCenter, glm::max(radius, length)), transform, getColor(), 0.0f, objId);
 		}
 
 		static Vec3 calculateOffset(float radius, float degrees, const Vec3& rightDir, const Vec3& up)
@@ -1626,36 +1608,14 @@ namespace MathAnim
 
 		void drawCylinder(const Vec3& startCenter, const Vec3& endCenter, const Vec3& up, float radius, AnimObjId objId)
 		{
-			const Vec3 forward = CMath::normalize(endCenter - startCenter);
+			const Vec3 toEnd = endCenter - startCenter;
+			const float length = CMath::length(toEnd);
+			const Vec3 forward = toEnd / length;
 			const Vec3 rightDir = CMath::cross(forward, up);
 
-			constexpr int numPointsOnCircle = 16;
-			constexpr float increments = 360.0f / (float)numPointsOnCircle;
-			for (int i = 0; i < numPointsOnCircle; i++)
-			{
-				const float radians = glm::radians((float)i * increments);
-				const float nextRadians = glm::radians((float)((i + 1) % numPointsOnCircle) * increments);
-
-				const float xVal = glm::sin(radians) * radius;
-				const float yVal = glm::cos(radians) * radius;
-
-				const float nextXVal = glm::sin(nextRadians) * radius;
-				const float nextYVal = glm::cos(nextRadians) * radius;
-
-				const Vec3 thisOffset = (rightDir * xVal) + (up * yVal);
-				const Vec3 nextOffset = (rightDir * nextXVal) + (up * nextYVal);
-
-				const Vec3 startThisPoint = startCenter + thisOffset;
-				const Vec3 startNextPoint = startCenter + nextOffset;
-
-				const Vec3 endThisPoint = endCenter + thisOffset;
-				const Vec3 endNextPoint = endCenter + nextOffset;
-
-				drawFilledTri3D(startCenter, startThisPoint, startNextPoint, objId);
-				drawFilledTri3D(endCenter, endThisPoint, endNextPoint, objId);
-				drawFilledTri3D(startThisPoint, endThisPoint, endNextPoint, objId);
-				drawFilledTri3D(startThisPoint, endNextPoint, startNextPoint, objId);
-			}
+			// LOD is picked from the radius since long thin guidelines still only need a few sides
+			glm::mat4 transform = primitiveTransform(startCenter, rightDir * radius, up * radius, toEnd);
+			drawList3D.addPrimitive(PrimitiveType::Cylinder, selectPrimitiveLod(startCenter + toEnd / 2.0f, radius * 4.0f), transform, getColor(), 0.0f, objId);
 		}
 
 		void drawDonut(
@@ -1668,60 +1628,18 @@ namespace MathAnim
 			float thetaEnd,
 			AnimObjId objId)
 		{
-			const Vec3 rightDir = CMath::cross(up, forward);
-
-			constexpr int numPointsOnCircle = 24;
-			float increments = (thetaEnd - thetaStart) / (float)numPointsOnCircle;
-			for (int donutEdgei = 0; donutEdgei < numPointsOnCircle; donutEdgei++)
+			// The unit torus is a full ring, partial arcs still get triangulated on the CPU
+			if (thetaEnd - thetaStart < 360.0f)
 			{
-				// TODO: This is probably wrong, only works for 0-360 degree donut
-				const float thisTheta = (float)donutEdgei * increments;
-				const float nextTheta = (float)(donutEdgei + 1) * increments;
-
-				const Vec3 thisInnerOffset = calculateOffset(innerRadius, thisTheta, rightDir, up);
-				const Vec3 thisOuterOffset = calculateOffset(outerRadius, thisTheta, rightDir, up);
-				Vec3 startCenter = thisInnerOffset + ((thisOuterOffset - thisInnerOffset) / 2.0f);
-
-				const Vec3 nextInnerOffset = calculateOffset(innerRadius, nextTheta, rightDir, up);
-				const Vec3 nextOuterOffset = calculateOffset(outerRadius, nextTheta, rightDir, up);
-				Vec3 endCenter = nextInnerOffset + ((nextOuterOffset - nextInnerOffset) / 2.0f);
-
-				Vec3 startToEndDir = CMath::normalize(endCenter - startCenter);
-
-				Vec3 thisCurvatureCirclePoints[numPointsOnCircle] = {};
-				Vec3 nextCurvatureCirclePoints[numPointsOnCircle] = {};
-
-				Vec3 curvatureThisRightDir = CMath::normalize(thisOuterOffset - thisInnerOffset);
-				Vec3 curvatureThisUpDir = CMath::cross(startToEndDir, curvatureThisRightDir);
-
-				Vec3 curvatureNextRightDir = CMath::normalize(nextOuterOffset - nextInnerOffset);
-				Vec3 curvatureNextUpDir = CMath::cross(startToEndDir, curvatureNextRightDir);
-
-				constexpr float incrementsDonutEdge = 360.0f / (float)numPointsOnCircle;
-				float curvatureRadius = (outerRadius - innerRadius) / 2.0f;
-				for (int donutCurvaturei = 0; donutCurvaturei < numPointsOnCircle; donutCurvaturei++)
-				{
-					const float curvatureTheta = (float)donutCurvaturei * incrementsDonutEdge;
-					Vec3 offset = calculateOffset(curvatureRadius, curvatureTheta, curvatureThisRightDir, curvatureThisUpDir);
-					thisCurvatureCirclePoints[donutCurvaturei] = center + startCenter + offset;
-
-					Vec3 nextOffset = calculateOffset(curvatureRadius, curvatureTheta, curvatureNextRightDir, curvatureNextUpDir);
-					nextCurvatureCirclePoints[donutCurvaturei] = center + endCenter + nextOffset;
-				}
-
-				// Connect the two curvature circles with triangles
-				for (int donutCurvaturei = 0; donutCurvaturei < numPointsOnCircle; donutCurvaturei++)
-				{
-					Vec3 thisCurvatureP0 = thisCurvatureCirclePoints[donutCurvaturei];
-					Vec3 thisCurvatureP1 = thisCurvatureCirclePoints[(donutCurvaturei + 1) % numPointsOnCircle];
-
-					Vec3 nextCurvatureP0 = nextCurvatureCirclePoints[donutCurvaturei];
-					Vec3 nextCurvatureP1 = nextCurvatureCirclePoints[(donutCurvaturei + 1) % numPointsOnCircle];
-
-					drawFilledTri3D(thisCurvatureP0, nextCurvatureP0, nextCurvatureP1, objId);
-					drawFilledTri3D(thisCurvatureP0, nextCurvatureP1, thisCurvatureP1, objId);
-				}
+				drawDonutArc(center, innerRadius, outerRadius, forward, up, thetaStart, thetaEnd, objId);
+				return;
 			}
+
+			const Vec3 rightDir = CMath::cross(up, forward);
+			const float ringRadius = (innerRadius + outerRadius) / 2.0f;
+			const float tubeRadius = (outerRadius - innerRadius) / 2.0f;
+			glm::mat4 transform = primitiveTransform(center, rightDir * ringRadius, up * ringRadius, forward * ringRadius);
+			drawList3D.addPrimitive(PrimitiveType::Torus, selectPrimitiveLod(center, outerRadius), transform, getColor(), tubeRadius / ringRadius, objId);
 		}
 
 		void drawSphere(
@@ -1729,98 +1647,8 @@ namespace MathAnim
 			float radius,
 			AnimObjId objId)
 		{
-			std::vector<Vec3> vertices{};
-
-			float x, y, z, xy;                              // vertex position
-			// float nx, ny, nz, lengthInv = 1.0f / radius;    // vertex normal
-			// float s, t;                                     // vertex texCoord
-
-			// SectorCount is number of quads in slice
-			constexpr float sectorCount = 20;
-			// StackCount is a slice
-			constexpr float stackCount = 20;
-			constexpr float sectorStep = 2.f * glm::pi<float>() / sectorCount;
-			constexpr float stackStep = glm::pi<float>() / stackCount;
-			float sectorAngle, stackAngle;
-
-			for (int i = 0; i <= stackCount; ++i)
-			{
-				stackAngle = glm::pi<float>() / 2 - i * stackStep;        // starting from pi/2 to -pi/2
-				xy = radius * cosf(stackAngle);             // r * cos(u)
-				z = radius * sinf(stackAngle);              // r * sin(u)
-
-				// add (sectorCount+1) vertices per stack
-				// first and last vertices have same position and normal, but different tex coords
-				for (int j = 0; j <= sectorCount; ++j)
-				{
-					sectorAngle = j * sectorStep;           // starting from 0 to 2pi
-
-					// vertex position (x, y, z)
-					x = xy * cosf(sectorAngle);             // r * cos(u) * cos(v)
-					y = xy * sinf(sectorAngle);             // r * cos(u) * sin(v)
-					vertices.push_back(center + Vec3{ x, y, z });
-
-					// normalized vertex normal (nx, ny, nz)
-					// nx = x * lengthInv;
-					// ny = y * lengthInv;
-					// nz = z * lengthInv;
-					// normals.push_back(nx);
-					// normals.push_back(ny);
-					// normals.push_back(nz);
-
-					// vertex tex coord (s, t) range between [0, 1]
-					// s = (float)j / sectorCount;
-					// t = (float)i / stackCount;
-					// texCoords.push_back(s);
-					// texCoords.push_back(t);
-				}
-			}
-
-			// generate CCW index list of sphere triangles
-			// k1--k1+1
-			// |  / |
-			// | /  |
-			// k2--k2+1
-			// std::vector<int> indices;
-			// std::vector<int> lineIndices;
-			int k1, k2;
-			for (int i = 0; i < stackCount; ++i)
-			{
-				k1 = (int)((float)i * (sectorCount + 1.f));     // beginning of current stack
-				k2 = (int)((float)k1 + sectorCount + 1.f);      // beginning of next stack
-
-				for (int j = 0; j < sectorCount; ++j, ++k1, ++k2)
-				{
-					// 2 triangles per sector excluding first and last stacks
-					// k1 => k2 => k1+1
-					if (i != 0)
-					{
-						// indices.push_back(k1);
-						// indices.push_back(k2);
-						// indices.push_back(k1 + 1);
-						drawFilledTri3D(vertices[k1], vertices[k2], vertices[k1 + 1], objId);
-					}
-
-					// k1+1 => k2 => k2+1
-					if (i != (stackCount - 1))
-					{
-						// indices.push_back(k1 + 1);
-						// indices.push_back(k2);
-						// indices.push_back(k2 + 1);
-						drawFilledTri3D(vertices[k1 + 1], vertices[k2], vertices[k2 + 1], objId);
-					}
-
-					// store indices for lines
-					// vertical lines for all stacks, k1 => k2
-					//lineIndices.push_back(k1);
-					//lineIndices.push_back(k2);
-					//if (i != 0)  // horizontal lines except 1st stack, k1 => k+1
-					//{
-					//	lineIndices.push_back(k1);
-					//	lineIndices.push_back(k1 + 1);
-					//}
-				}
-			}
+			glm::mat4 transform = primitiveTransform(center, Vector3::Right * radius, Vector3::Up * radius, Vector3::Forward * radius);
+			drawList3D.addPrimitive(PrimitiveType::Sphere, selectPrimitiveLod(center, radius), transform, getColor(), 0.0f, objId);
 		}
 
 		// ----------- Miscellaneous ----------- 
@@ -1900,6 +1728,111 @@ namespace MathAnim
 		}
 
 		// ---------------------- Begin Internal Functions ----------------------
+		static glm::mat4 primitiveTransform(const Vec3& origin, const Vec3& xAxis, const Vec3& yAxis, const Vec3& zAxis)
+		{
+			return glm::mat4(
+				glm::vec4(xAxis.x, xAxis.y, xAxis.z, 0.0f),
+				glm::vec4(yAxis.x, yAxis.y, yAxis.z, 0.0f),
+				glm::vec4(zAxis.x, zAxis.y, zAxis.z, 0.0f),
+				glm::vec4(origin.x, origin.y, origin.z, 1.0f)
+			);
+		}
+
+		static PrimitiveLod selectPrimitiveLod(const Vec3& center, float boundingRadius)
+		{
+			// Pick the LOD from roughly how much of the screen height the primitive covers
+			const Camera* camera = getCurrentCamera3D();
+			float viewHeight;
+			if (camera->mode == CameraMode::Orthographic)
+			{
+				Vec4 leftRightBottomTop = camera->getLeftRightBottomTop();
+				viewHeight = leftRightBottomTop.values[3] - leftRightBottomTop.values[2];
+			}
+			else
+			{
+				float distance = glm::max(CMath::length(center - camera->position), camera->nearFarRange.min);
+				viewHeight = 2.0f * distance * glm::tan(glm::radians(camera->fov / 2.0f));
+			}
+
+			float screenCoverage = (2.0f * boundingRadius) / glm::max(viewHeight, 0.0001f);
+			if (screenCoverage < 0.02f)
+			{
+				return PrimitiveLod::Low;
+			}
+			else if (screenCoverage < 0.15f)
+			{
+				return PrimitiveLod::Medium;
+			}
+
+			return PrimitiveLod::High;
+		}
+
+		static void drawDonutArc(
+			const Vec3& center,
+			float innerRadius,
+			float outerRadius,
+			const Vec3& forward,
+			const Vec3& up,
+			float thetaStart,
+			float thetaEnd,
+			AnimObjId objId)
+		{
+			const Vec3 rightDir = CMath::cross(up, forward);
+
+			constexpr int numPointsOnCircle = 24;
+			float increments = (thetaEnd - thetaStart) / (float)numPointsOnCircle;
+			for (int donutEdgei = 0; donutEdgei < numPointsOnCircle; donutEdgei++)
+			{
+				// Offset by thetaStart so partial arcs start where they're asked to instead of at 0
+				const float thisTheta = thetaStart + (float)donutEdgei * increments;
+				const float nextTheta = thetaStart + (float)(donutEdgei + 1) * increments;
+
+				const Vec3 thisInnerOffset = calculateOffset(innerRadius, thisTheta, rightDir, up);
+				const Vec3 thisOuterOffset = calculateOffset(outerRadius, thisTheta, rightDir, up);
+				Vec3 startCenter = thisInnerOffset + ((thisOuterOffset - thisInnerOffset) / 2.0f);
+
+				const Vec3 nextInnerOffset = calculateOffset(innerRadius, nextTheta, rightDir, up);
+				const Vec3 nextOuterOffset = calculateOffset(outerRadius, nextTheta, rightDir, up);
+				Vec3 endCenter = nextInnerOffset + ((nextOuterOffset - nextInnerOffset) / 2.0f);
+
+				Vec3 startToEndDir = CMath::normalize(endCenter - startCenter);
+
+				Vec3 thisCurvatureCirclePoints[numPointsOnCircle] = {};
+				Vec3 nextCurvatureCirclePoints[numPointsOnCircle] = {};
+
+				Vec3 curvatureThisRightDir = CMath::normalize(thisOuterOffset - thisInnerOffset);
+				Vec3 curvatureThisUpDir = CMath::cross(startToEndDir, curvatureThisRightDir);
+
+				Vec3 curvatureNextRightDir = CMath::normalize(nextOuterOffset - nextInnerOffset);
+				Vec3 curvatureNextUpDir = CMath::cross(startToEndDir, curvatureNextRightDir);
+
+				constexpr float incrementsDonutEdge = 360.0f / (float)numPointsOnCircle;
+				float curvatureRadius = (outerRadius - innerRadius) / 2.0f;
+				for (int donutCurvaturei = 0; donutCurvaturei < numPointsOnCircle; donutCurvaturei++)
+				{
+					const float curvatureTheta = (float)donutCurvaturei * incrementsDonutEdge;
+					Vec3 offset = calculateOffset(curvatureRadius, curvatureTheta, curvatureThisRightDir, curvatureThisUpDir);
+					thisCurvatureCirclePoints[donutCurvaturei] = center + startCenter + offset;
+
+					Vec3 nextOffset = calculateOffset(curvatureRadius, curvatureTheta, curvatureNextRightDir, curvatureNextUpDir);
+					nextCurvatureCirclePoints[donutCurvaturei] = center + endCenter + nextOffset;
+				}
+
+				// Connect the two curvature circles with triangles
+				for (int donutCurvaturei = 0; donutCurvaturei < numPointsOnCircle; donutCurvaturei++)
+				{
+					Vec3 thisCurvatureP0 = thisCurvatureCirclePoints[donutCurvaturei];
+					Vec3 thisCurvatureP1 = thisCurvatureCirclePoints[(donutCurvaturei + 1) % numPointsOnCircle];
+
+					Vec3 nextCurvatureP0 = nextCurvatureCirclePoints[donutCurvaturei];
+					Vec3 nextCurvatureP1 = nextCurvatureCirclePoints[(donutCurvaturei + 1) % numPointsOnCircle];
+
+					drawFilledTri3D(thisCurvatureP0, nextCurvatureP0, nextCurvatureP1, objId);
+					drawFilledTri3D(thisCurvatureP0, nextCurvatureP1, thisCurvatureP1, objId);
+				}
+			}
+		}
+
 		static void setupDefaultWhiteTexture()
 		{
 			defaultWhiteTexture = TextureBuilder()
@@ -1935,6 +1868,31 @@ namespace MathAnim
 			GL::enableVertexAttribArray(1);
 		}
 
+		static Framebuffer prepareOutlineFramebuffer(int outputWidth, int outputHeight)
+		{
+			// Ping-pong jump flood masks
+			Texture jumpMask = TextureBuilder()
+				.setFormat(ByteFormat::RGBA16_F)
+				.setMinFilter(FilterMode::Nearest)
+				.setMagFilter(FilterMode::Nearest)
+				.setWidth(outputWidth)
+				.setHeight(outputHeight)
+				.build();
+
+			Texture jumpMask2 = TextureBuilder()
+				.setFormat(ByteFormat::RGBA16_F)
+				.setMinFilter(FilterMode::Nearest)
+				.setMagFilter(FilterMode::Nearest)
+				.setWidth(outputWidth)
+				.setHeight(outputHeight)
+				.build();
+
+			return FramebufferBuilder(outputWidth, outputHeight)
+				.addColorAttachment(jumpMask)
+				.addColorAttachment(jumpMask2)
+				.generate();
+		}
+
 		static void lineToInternal(Path2DContext* path, const Vec2& point, bool addRawCurve)
 		{
 			g_logger_assert(path != nullptr, "Null path.");
@@ -1963,8 +1921,7 @@ namespace MathAnim
 					rawCurve.p0 = path->data[path->data.size() - 1].position;
 					rawCurve.as.line.p1 = vert.position;
 
-					path->approximateLength += rawCurve.calculateApproximatePerimeter();
-					path->rawCurves.emplace_back(rawCurve);
+						path->rawCurves.emplace_back(rawCurve);
 				}
 
 				path->data.emplace_back(vert);
@@ -1990,8 +1947,7 @@ namespace MathAnim
 					rawCurve.p0 = path->data[path->data.size() - 1].position;
 					rawCurve.as.line.p1 = vert.position;
 
-					path->approximateLength += rawCurve.calculateApproximatePerimeter();
-					path->rawCurves.emplace_back(rawCurve);
+						path->rawCurves.emplace_back(rawCurve);
 				}
 
 				path->data.emplace_back(vert);
@@ -2221,6 +2177,7 @@ namespace MathAnim
 		}
 
 		GL::pushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, Renderer::debugMsgId++, -1, "2D_General_Pass");
+		Profiler::beginGpuEvent("2D_General_Pass");
 		GL::enable(GL_BLEND);
 		GL::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
@@ -2272,6 +2229,7 @@ namespace MathAnim
 			);
 		}
 
+		Profiler::endGpuEvent();
 		GL::popDebugGroup();
 	}
 
@@ -2428,6 +2386,7 @@ namespace MathAnim
 		}
 
 		GL::pushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, Renderer::debugMsgId++, -1, "3D_Line_Pass");
+		Profiler::beginGpuEvent("3D_Line_Pass");
 
 		GL::disable(GL_DEPTH_TEST);
 		GL::disable(GL_CULL_FACE);
@@ -2452,6 +2411,7 @@ namespace MathAnim
 			GL::drawArrays(GL_TRIANGLES, 0, (GLsizei)vertices.size());
 		}
 
+		Profiler::endGpuEvent();
 		GL::popDebugGroup();
 	}
 
@@ -2659,6 +2619,7 @@ namespace MathAnim
 		}
 
 		GL::pushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, Renderer::debugMsgId++, -1, "3D_Billboard_Pass");
+		Profiler::beginGpuEvent("3D_Billboard_Pass");
 
 		GL::enable(GL_DEPTH_TEST);
 		GL::disable(GL_CULL_FACE);
@@ -2697,6 +2658,7 @@ namespace MathAnim
 
 		GL::disable(GL_DEPTH_TEST);
 
+		Profiler::endGpuEvent();
 		GL::popDebugGroup();
 	}
 
@@ -2729,11 +2691,16 @@ namespace MathAnim
 		vao = UINT32_MAX;
 		ebo = UINT32_MAX;
 		vbo = UINT32_MAX;
+		instancedVao = UINT32_MAX;
+		instanceVbo = UINT32_MAX;
 
 		vertices = {};
 		indices = {};
 		drawCommands = {};
 		textureIdStack = {};
+		instances = {};
+		instanceCommandIndices = {};
+		instancedDrawCommands = {};
 		setupGraphicsBuffers();
 	}
 
@@ -2916,6 +2883,43 @@ namespace MathAnim
 		cmd.vertCount += 3;
 	}
 
+	void DrawList3D::addPrimitive(PrimitiveType type, PrimitiveLod lod, const glm::mat4& transform, const Vec4& color, float tubeRadius, AnimObjId objId)
+	{
+		const Camera* currentCamera = Renderer::getCurrentCamera3D();
+		bool isTransparent = color.a < 1.0f;
+
+		// There's only ever a handful of commands per frame so a linear search is fine
+		size_t cmdIndex = 0;
+		for (; cmdIndex < instancedDrawCommands.size(); cmdIndex++)
+		{
+			const DrawCmdInstanced3D& cmd = instancedDrawCommands[cmdIndex];
+			if (cmd.camera == currentCamera && cmd.type == type && cmd.lod == lod && cmd.isTransparent == isTransparent)
+			{
+				break;
+			}
+		}
+
+		if (cmdIndex == instancedDrawCommands.size())
+		{
+			DrawCmdInstanced3D newCommand;
+			newCommand.camera = currentCamera;
+			newCommand.type = type;
+			newCommand.lod = lod;
+			newCommand.isTransparent = isTransparent;
+			newCommand.instanceCount = 0;
+			instancedDrawCommands.emplace_back(newCommand);
+		}
+
+		PrimitiveInstance3D instance;
+		instance.transform = transform;
+		instance.color = color;
+		instance.objId = objId;
+		instance.tubeRadius = tubeRadius;
+		instances.push_back(instance);
+		instanceCommandIndices.push_back((uint16)cmdIndex);
+		instancedDrawCommands[cmdIndex].instanceCount++;
+	}
+
 	void DrawList3D::setupGraphicsBuffers()
 	{
 		// Create the batched vao
@@ -2947,23 +2951,67 @@ namespace MathAnim
 
 		GL::vertexAttribIPointer(4, 2, GL_UNSIGNED_INT, sizeof(Vertex3D), (void*)(offsetof(Vertex3D, objId)));
 		GL::enableVertexAttribArray(4);
+
+		// The instanced vao gets its attribute pointers set per draw in renderInstanced since
+		// the mesh buffers and the offset into the instance buffer change every draw
+		GL::createVertexArray(&instancedVao);
+		GL::bindVertexArray(instancedVao);
+
+		GL::genBuffers(1, &instanceVbo);
+		GL::bindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+		GL::bufferData(GL_ARRAY_BUFFER, sizeof(PrimitiveInstance3D), NULL, GL_DYNAMIC_DRAW);
+
+		for (GLuint attrib = 0; attrib <= 8; attrib++)
+		{
+			GL::enableVertexAttribArray(attrib);
+			// 0 and 1 are per vertex, 2 to 8 are per instance
+			GL::vertexAttribDivisor(attrib, attrib >= 2 ? 1 : 0);
+		}
 	}
 
 	void DrawList3D::render(
 		const Shader& opaqueShader,
 		const Shader& transparentShader,
+		const Shader& instancedOpaqueShader,
+		const Shader& instancedTransparentShader,
 		const Shader& compositeShader,
 		const Framebuffer& framebuffer
 	) const
 	{
-		if (vertices.size() == 0)
+		if (vertices.size() == 0 && instances.size() == 0)
 		{
 			return;
 		}
 
 		GL::pushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, Renderer::debugMsgId++, -1, "3D_OIT_Pass");
+		Profiler::beginGpuEvent("3D_OIT_Pass");
 		framebuffer.bind();
 
+		// Group the primitive instances by command and upload them all at once,
+		// every instanced draw then just points into its own range
+		uint32* commandOffsets = nullptr;
+		if (instances.size() > 0)
+		{
+			commandOffsets = (uint32*)FrameArena::allocate(sizeof(uint32) * instancedDrawCommands.size(), alignof(uint32));
+			uint32* commandCursors = (uint32*)FrameArena::allocate(sizeof(uint32) * instancedDrawCommands.size(), alignof(uint32));
+			uint32 offset = 0;
+			for (size_t i = 0; i < instancedDrawCommands.size(); i++)
+			{
+				commandOffsets[i] = offset;
+				commandCursors[i] = offset;
+				offset += instancedDrawCommands[i].instanceCount;
+			}
+
+			PrimitiveInstance3D* sortedInstances = (PrimitiveInstance3D*)FrameArena::allocate(sizeof(PrimitiveInstance3D) * instances.size(), alignof(PrimitiveInstance3D));
+			for (size_t i = 0; i < instances.size(); i++)
+			{
+				sortedInstances[commandCursors[instanceCommandIndices[i]]++] = instances[i];
+			}
+
+			GL::bindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+			GL::bufferData(GL_ARRAY_BUFFER, sizeof(PrimitiveInstance3D) * instances.size(), sortedInstances, GL_DYNAMIC_DRAW);
+		}
+
 		Vec4 sunColor = "#ffffffff"_hex;
 
 		// Set up the opaque draw buffers
@@ -3028,6 +3076,8 @@ namespace MathAnim
 			);
 		}
 
+		renderInstanced(instancedOpaqueShader, false, commandOffsets);
+
 		// Set up the transparent draw buffers
 		drawBuffers[0] = GL_NONE;
 		drawBuffers[1] = GL_COLOR_ATTACHMENT1;
@@ -3108,6 +3158,8 @@ namespace MathAnim
 			);
 		}
 
+		renderInstanced(instancedTransparentShader, true, commandOffsets);
+
 		// Set up the composite draw buffers
 		drawBuffers[0] = GL_COLOR_ATTACHMENT0;
 		drawBuffers[1] = GL_NONE;
@@ -3141,14 +3193,66 @@ namespace MathAnim
 		GL::depthMask(GL_TRUE);
 		GL::disable(GL_DEPTH_TEST);
 
+		Profiler::endGpuEvent();
 		GL::popDebugGroup();
 	}
 
+	void DrawList3D::renderInstanced(const Shader& shader, bool isTransparentPass, const uint32* commandOffsets) const
+	{
+		bool shaderIsBound = false;
+		for (size_t i = 0; i < instancedDrawCommands.size(); i++)
+		{
+			const DrawCmdInstanced3D& cmd = instancedDrawCommands[i];
+			if (cmd.isTransparent != isTransparentPass)
+			{
+				continue;
+			}
+
+			if (!shaderIsBound)
+			{
+				shader.bind();
+				GL::bindVertexArray(instancedVao);
+				shaderIsBound = true;
+			}
+
+			shader.uploadMat4("uProjection", cmd.camera->projectionMatrix);
+			shader.uploadMat4("uView", cmd.camera->viewMatrix);
+
+			const PrimitiveMesh& mesh = PrimitiveMeshes::get(cmd.type, cmd.lod);
+			GL::bindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+			GL::vertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(PrimitiveVertex), (void*)(offsetof(PrimitiveVertex, position)));
+			GL::vertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(PrimitiveVertex), (void*)(offsetof(PrimitiveVertex, tubeOffset)));
+			GL::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ebo);
+
+			// GL 3.3 has no base instance, so offset the instance attributes instead
+			size_t instanceByteOffset = sizeof(PrimitiveInstance3D) * commandOffsets[i];
+			GL::bindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+			for (GLuint column = 0; column < 4; column++)
+			{
+				GL::vertexAttribPointer(2 + column, 4, GL_FLOAT, GL_FALSE, sizeof(PrimitiveInstance3D), (void*)(instanceByteOffset + offsetof(PrimitiveInstance3D, transform) + sizeof(glm::vec4) * column));
+			}
+			GL::vertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(PrimitiveInstance3D), (void*)(instanceByteOffset + offsetof(PrimitiveInstance3D, color)));
+			GL::vertexAttribPointer(7, 1, GL_FLOAT, GL_FALSE, sizeof(PrimitiveInstance3D), (void*)(instanceByteOffset + offsetof(PrimitiveInstance3D, tubeRadius)));
+			GL::vertexAttribIPointer(8, 2, GL_UNSIGNED_INT, sizeof(PrimitiveInstance3D), (void*)(instanceByteOffset + offsetof(PrimitiveInstance3D, objId)));
+
+			GL::drawElementsInstanced(
+				GL_TRIANGLES,
+				mesh.elementCount,
+				GL_UNSIGNED_SHORT,
+				nullptr,
+				cmd.instanceCount
+			);
+		}
+	}
+
 	void DrawList3D::reset()
 	{
 		vertices.clear();
 		indices.clear();
 		drawCommands.clear();
+		instances.clear();
+		instanceCommandIndices.clear();
+		instancedDrawCommands.clear();
 		g_logger_assert(textureIdStack.size() == 0, "Mismatched texture ID stack. Are you missing a drawList2D.popTexture()?");
 	}
 
@@ -3169,14 +3273,29 @@ namespace MathAnim
 			GL::deleteVertexArrays(1, &vao);
 		}
 
+		if (instanceVbo != UINT32_MAX)
+		{
+			GL::deleteBuffers(1, &instanceVbo);
+		}
+
+		if (instancedVao != UINT32_MAX)
+		{
+			GL::deleteVertexArrays(1, &instancedVao);
+		}
+
 		vbo = UINT32_MAX;
 		ebo = UINT32_MAX;
 		vao = UINT32_MAX;
+		instanceVbo = UINT32_MAX;
+		instancedVao = UINT32_MAX;
 
 		vertices.clear();
 		indices.clear();
 		drawCommands.clear();
 		textureIdStack.clear();
+		instances.clear();
+		instanceCommandIndices.clear();
+		instancedDrawCommands.clear();
 	}
 	// ---------------------- End DrawList3D Functions ----------------------
 }
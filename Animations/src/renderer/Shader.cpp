@@ -271,6 +271,18 @@ namespace MathAnim
 		}
 	}
 
+	void Shader::uploadU64ArrayAsUVec2Array(const char* varName, int length, const uint64* array) const
+	{
+		int varLocation = GetVariableLocation(*this, varName);
+		if (varLocation != -1)
+		{
+			// On little-endian machines a uint64 is already laid out as
+			// the (LOW, HIGH) pair that uploadU64AsUVec2 produces
+			static_assert(sizeof(uint64) == sizeof(GLuint) * 2, "Invalid uint64 size.");
+			GL::uniform2uiv(varLocation, length, (const GLuint*)array);
+		}
+	}
+
 	void Shader::uploadMat4(const char* varName, const glm::mat4& mat4) const
 	{
 		int varLocation = GetVariableLocation(*this, varName);
@@ -224,6 +224,8 @@ namespace MathAnim
 				return GL_R8UI;
 			case ByteFormat::R8_F:
 				return GL_R8;
+			case ByteFormat::R16_UI:
+				return GL_R16UI;
 			case ByteFormat::DepthStencil:
 				return GL_DEPTH24_STENCIL8;
 			case ByteFormat::None:
@@ -257,6 +259,8 @@ namespace MathAnim
 				return GL_RED_INTEGER;
 			case ByteFormat::R8_F:
 				return GL_RED;
+			case ByteFormat::R16_UI:
+				return GL_RED_INTEGER;
 			case ByteFormat::DepthStencil:
 				return GL_DEPTH_STENCIL;
 			case ByteFormat::None:
@@ -290,6 +294,8 @@ namespace MathAnim
 				return GL_UNSIGNED_BYTE;
 			case ByteFormat::R8_F:
 				return GL_FLOAT;
+			case ByteFormat::R16_UI:
+				return GL_UNSIGNED_SHORT;
 			case ByteFormat::DepthStencil:
 				return GL_UNSIGNED_INT_24_8;
 			case ByteFormat::None:
@@ -327,6 +333,8 @@ namespace MathAnim
 				return false;
 			case ByteFormat::R8_F:
 				return false;
+			case ByteFormat::R16_UI:
+				return true;
 			}
 
 			return false;
@@ -361,6 +369,8 @@ namespace MathAnim
 				return false;
 			case ByteFormat::R8_F:
 				return false;
+			case ByteFormat::R16_UI:
+				return false;
 			}
 
 			return false;
@@ -394,6 +404,8 @@ namespace MathAnim
 				return false;
 			case ByteFormat::R8_F:
 				return false;
+			case ByteFormat::R16_UI:
+				return false;
 			}
 
 			return false;
@@ -446,6 +458,8 @@ namespace MathAnim
 				return sizeof(uint8);
 			case ByteFormat::R8_F:
 				return sizeof(uint8);
+			case ByteFormat::R16_UI:
+				return sizeof(uint16);
 			case ByteFormat::None:
 			case ByteFormat::DepthStencil:
 				return 0;
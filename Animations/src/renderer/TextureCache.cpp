@@ -1,4 +1,11 @@
 #include "renderer/TextureCache.h"
+#include "renderer/GLApi.h"
+#include "multithreading/GlobalThreadPool.h"
+#include "core/Profiling.h"
+
+#include <stb/stb_image.h>
+
+#include <deque>
 
 namespace MathAnim
 {
@@ -7,22 +14,63 @@ namespace MathAnim
 		Texture texture;
 		uint32 refCount;
 		std::filesystem::path absPath;
+		TextureLoadOptions options;
+		// Non-zero while an async load for this texture is in flight
+		uint64 loadId;
+	};
+
+	struct DecodedTexture
+	{
+		TextureHandle handle;
+		uint64 loadId;
+		uint8* pixels;
+		int width;
+		int height;
+		int channels;
 	};
 
 	namespace TextureCache
 	{
+		// Uploads never stall on a buffer the driver may still be reading from since the
+		// ring is always a couple of frames ahead of the GPU
+		static constexpr int numUploadBuffers = 3;
+		// Once this is hit the rest of the decoded textures wait for the next frame, at
+		// least one texture always gets uploaded so huge images can't starve the queue
+		static constexpr size_t maxUploadBytesPerFrame = MB(32);
+
 		static std::unordered_map<std::filesystem::path, TextureHandle> cachedTexturePaths = {};
 		static std::unordered_map<TextureHandle, CachedTexture> cachedTextures = {};
 
 		static std::unordered_map<TextureHandle, std::filesystem::path> deadTextures = {};
 
+		static GlobalThreadPool* threadPool = nullptr;
+		static uint32 uploadBuffers[numUploadBuffers] = {};
+		static int uploadBufferIndex = 0;
+		static uint64 nextLoadId = 1;
+		static std::unordered_map<uint64, PendingTextureLoad> pendingLoads = {};
+		static std::deque<DecodedTexture> readyForUpload = {};
+
+		static std::mutex decodedTexturesMutex;
+		static std::vector<DecodedTexture> decodedTextures = {};
+		static std::atomic<bool> isShuttingDown;
+		// Every decode job in flight, so exports can block until they're all done
+		static JobCounter decodeCounter;
+
 		// -------------------- Internal Functions --------------------
 		static inline std::filesystem::path stringToAbsPath(const std::string& path) { return std::filesystem::absolute(path).make_preferred(); }
+		static void uploadDecodedTextures(size_t maxBytes);
+		static void queueDecode(TextureHandle handle, uint64 loadId, const std::filesystem::path& absolutePath, int desiredChannels);
+		static void uploadDecodedTexture(const DecodedTexture& decoded);
 
-		void init()
+		void init(GlobalThreadPool* inThreadPool)
 		{
 			cachedTexturePaths = {};
 			cachedTextures = {};
+
+			threadPool = inThreadPool;
+			isShuttingDown = false;
+			GL::genBuffers(numUploadBuffers, uploadBuffers);
+			uploadBufferIndex = 0;
 		}
 
 		TextureHandle loadTexture(const std::string& imageFilepath, const TextureLoadOptions& options)
@@ -58,11 +106,111 @@ namespace MathAnim
 			// Cache the texture data
 			newEntry.absPath = absolutePath;
 			newEntry.refCount = 1;
+			newEntry.options = options;
+			newEntry.loadId = 0;
+			cachedTextures[handle] = newEntry;
+
+			return handle;
+		}
+
+		TextureHandle loadTextureAsync(const std::string& imageFilepath, const TextureLoadOptions& options)
+		{
+			std::filesystem::path absolutePath = stringToAbsPath(imageFilepath);
+			auto textureHandleIter = cachedTexturePaths.find(absolutePath);
+			if (textureHandleIter != cachedTexturePaths.end())
+			{
+				auto textureIter = cachedTextures.find(textureHandleIter->second);
+				g_logger_assert(textureIter != cachedTextures.end(), "Somehow a TextureHandle was cached but the corresponding Texture data was not cached. This should never be hit.");
+				textureIter->second.refCount++;
+				return textureHandleIter->second;
+			}
+
+			// Reading the header is cheap and gives callers the real size right away
+			int width, height, channels;
+			if (!stbi_info(absolutePath.string().c_str(), &width, &height, &channels))
+			{
+				g_logger_error("Failed to load image '{}'.\n-> STB Failure Reason: '{}'", absolutePath, stbi_failure_reason());
+				return NULL_TEXTURE_HANDLE;
+			}
+
+			g_logger_info("Caching texture '{}' asynchronously", absolutePath);
+
+			// Anything that isn't RGB gets expanded to RGBA by the decoder
+			int desiredChannels = channels == 3 ? 3 : 4;
+			ByteFormat format = desiredChannels == 3 ? ByteFormat::RGB8_UI : ByteFormat::RGBA8_UI;
+
+			CachedTexture newEntry;
+			newEntry.texture = TextureBuilder()
+				.setFormat(format)
+				.setMagFilter(options.magFilter)
+				.setMinFilter(options.minFilter)
+				.setWrapS(options.wrapS)
+				.setWrapT(options.wrapT)
+				.setWidth(1)
+				.setHeight(1)
+				.generate();
+
+			uint8 placeholderPixel[4] = { 128, 128, 128, 255 };
+			newEntry.texture.uploadSubImage(0, 0, 1, 1, placeholderPixel, sizeof(placeholderPixel));
+			newEntry.texture.width = width;
+			newEntry.texture.height = height;
+			newEntry.texture.path = absolutePath;
+
+			TextureHandle handle = (TextureHandle)newEntry.texture.graphicsId;
+			uint64 loadId = nextLoadId++;
+
+			cachedTexturePaths[absolutePath] = handle;
+
+			newEntry.absPath = absolutePath;
+			newEntry.refCount = 1;
+			newEntry.options = options;
+			newEntry.loadId = loadId;
 			cachedTextures[handle] = newEntry;
 
+			size_t numBytes = (size_t)width * (size_t)height * (size_t)desiredChannels;
+			pendingLoads[loadId] = PendingTextureLoad{ absolutePath, numBytes, false };
+
+			queueDecode(handle, loadId, absolutePath, desiredChannels);
+
 			return handle;
 		}
 
+		bool reloadTexture(const std::filesystem::path& imageFilepath)
+		{
+			std::filesystem::path absolutePath = stringToAbsPath(imageFilepath.string());
+			auto textureHandleIter = cachedTexturePaths.find(absolutePath);
+			if (textureHandleIter == cachedTexturePaths.end())
+			{
+				return false;
+			}
+
+			int width, height, channels;
+			if (!stbi_info(absolutePath.string().c_str(), &width, &height, &channels))
+			{
+				// Probably caught the file halfway through being written, keep the old pixels
+				g_logger_warning("Failed to reload image '{}'.\n-> STB Failure Reason: '{}'", absolutePath, stbi_failure_reason());
+				return false;
+			}
+
+			g_logger_info("Reloading texture '{}'", absolutePath);
+
+			TextureHandle handle = textureHandleIter->second;
+			CachedTexture& entry = cachedTextures[handle];
+
+			// A new load id makes update() drop any decode that was still in flight for
+			// the old contents. The texture keeps its old pixels until the upload.
+			pendingLoads.erase(entry.loadId);
+			uint64 loadId = nextLoadId++;
+			entry.loadId = loadId;
+
+			int desiredChannels = channels == 3 ? 3 : 4;
+			size_t numBytes = (size_t)width * (size_t)height * (size_t)desiredChannels;
+			pendingLoads[loadId] = PendingTextureLoad{ absolutePath, numBytes, false };
+			queueDecode(handle, loadId, absolutePath, desiredChannels);
+
+			return true;
+		}
+
 		void unloadTexture(TextureHandle handle)
 		{
 			if (isNull(handle))
@@ -97,6 +245,10 @@ namespace MathAnim
 					// Store the dead texture filepath for recall when debugging
 					deadTextures[handle] = textureIter->second.absPath;
 
+					// The decode job still finishes, but update() drops its pixels since
+					// the load id won't match anything anymore
+					pendingLoads.erase(textureIter->second.loadId);
+
 					// Delete the actual GPU texture and the handle -> texture mapping
 					textureIter->second.texture.destroy();
 					cachedTextures.erase(textureIter);
@@ -132,8 +284,73 @@ namespace MathAnim
 			return dummy;
 		}
 
+		bool isReady(TextureHandle textureHandle)
+		{
+			auto textureHandleIter = cachedTextures.find(textureHandle);
+			return textureHandleIter != cachedTextures.end() && textureHandleIter->second.loadId == 0;
+		}
+
+		void update()
+		{
+			uploadDecodedTextures(maxUploadBytesPerFrame);
+		}
+
+		void waitForPendingLoads()
+		{
+			if (pendingLoads.size() == 0 || !threadPool)
+			{
+				return;
+			}
+
+			MP_PROFILE_EVENT("TextureCache_WaitForPendingLoads");
+			threadPool->wait(decodeCounter);
+			uploadDecodedTextures(SIZE_MAX);
+		}
+
+		std::vector<PendingTextureLoad> getPendingLoads()
+		{
+			std::vector<PendingTextureLoad> res;
+			res.reserve(pendingLoads.size());
+			for (const auto& [loadId, pendingLoad] : pendingLoads)
+			{
+				res.push_back(pendingLoad);
+			}
+			return res;
+		}
+
+		size_t getPendingBytes()
+		{
+			size_t res = 0;
+			for (const auto& [loadId, pendingLoad] : pendingLoads)
+			{
+				res += pendingLoad.numBytes;
+			}
+			return res;
+		}
+
 		void free()
 		{
+			{
+				// Decode jobs that are still running free their own pixels from here on
+				std::lock_guard<std::mutex> lock(decodedTexturesMutex);
+				isShuttingDown = true;
+				for (const auto& decoded : decodedTextures)
+				{
+					stbi_image_free(decoded.pixels);
+				}
+				decodedTextures.clear();
+			}
+			for (const auto& decoded : readyForUpload)
+			{
+				stbi_image_free(decoded.pixels);
+			}
+			readyForUpload.clear();
+			pendingLoads.clear();
+
+			GL::deleteBuffers(numUploadBuffers, uploadBuffers);
+			g_memory_zeroMem(uploadBuffers, sizeof(uploadBuffers));
+			threadPool = nullptr;
+
 			cachedTexturePaths.clear();
 			cachedTexturePaths = {};
 			deadTextures.clear();
@@ -149,5 +366,118 @@ namespace MathAnim
 		}
 
 		// -------------------- Internal Functions --------------------
+		static void uploadDecodedTextures(size_t maxBytes)
+		{
+			{
+				std::lock_guard<std::mutex> lock(decodedTexturesMutex);
+				for (const auto& decoded : decodedTextures)
+				{
+					auto pendingIter = pendingLoads.find(decoded.loadId);
+					if (pendingIter != pendingLoads.end())
+					{
+						pendingIter->second.isDecoded = true;
+					}
+					readyForUpload.emplace_back(decoded);
+				}
+				decodedTextures.clear();
+			}
+
+			size_t bytesUploaded = 0;
+			while (readyForUpload.size() > 0 && (bytesUploaded == 0 || bytesUploaded < maxBytes))
+			{
+				DecodedTexture decoded = readyForUpload.front();
+				readyForUpload.pop_front();
+
+				// GL reuses texture ids, so the load id is what tells us this texture
+				// is still the one that queued the decode
+				auto textureIter = cachedTextures.find(decoded.handle);
+				if (textureIter != cachedTextures.end() && textureIter->second.loadId == decoded.loadId)
+				{
+					if (decoded.pixels)
+					{
+						uploadDecodedTexture(decoded);
+						bytesUploaded += (size_t)decoded.width * (size_t)decoded.height * (size_t)decoded.channels;
+					}
+					textureIter->second.loadId = 0;
+				}
+
+				pendingLoads.erase(decoded.loadId);
+				stbi_image_free(decoded.pixels);
+			}
+		}
+
+		static void queueDecode(TextureHandle handle, uint64 loadId, const std::filesystem::path& absolutePath, int desiredChannels)
+		{
+			threadPool->queueJob([handle, loadId, absolutePath, desiredChannels]()
+			{
+				DecodedTexture decoded = {};
+				decoded.handle = handle;
+				decoded.loadId = loadId;
+				if (!isShuttingDown)
+				{
+					stbi_set_flip_vertically_on_load_thread(true);
+					decoded.pixels = stbi_load(absolutePath.string().c_str(), &decoded.width, &decoded.height, &decoded.channels, desiredChannels);
+					decoded.channels = desiredChannels;
+					if (!decoded.pixels)
+					{
+						g_logger_error("STB failed to load image: '{}'\n-> STB Failure Reason: '{}'", absolutePath, stbi_failure_reason());
+					}
+				}
+
+				std::lock_guard<std::mutex> lock(decodedTexturesMutex);
+				if (isShuttingDown)
+				{
+					stbi_image_free(decoded.pixels);
+					return;
+				}
+				decodedTextures.emplace_back(decoded);
+			}, "Decode Texture", Priority::Medium, &decodeCounter);
+		}
+
+		static void uploadDecodedTexture(const DecodedTexture& decoded)
+		{
+			CachedTexture& entry = cachedTextures[decoded.handle];
+			Texture& texture = entry.texture;
+			texture.width = decoded.width;
+			texture.height = decoded.height;
+			texture.format = decoded.channels == 3 ? ByteFormat::RGB8_UI : ByteFormat::RGBA8_UI;
+
+			size_t numBytes = (size_t)decoded.width * (size_t)decoded.height * (size_t)decoded.channels;
+			uint32 pbo = uploadBuffers[uploadBufferIndex];
+			uploadBufferIndex = (uploadBufferIndex + 1) % numUploadBuffers;
+
+			// Orphan the old storage so mapping never waits on a previous upload
+			GL::bindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+			GL::bufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)numBytes, nullptr, GL_STREAM_DRAW);
+			void* mappedMemory = GL::mapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+			const void* pixelSource = nullptr;
+			if (mappedMemory)
+			{
+				g_memory_copyMem(mappedMemory, decoded.pixels, numBytes);
+				GL::unmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+			}
+			else
+			{
+				// Fall back to a regular client memory upload
+				GL::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+				pixelSource = decoded.pixels;
+			}
+
+			uint32 internalFormat = TextureUtil::toGlSizedInternalFormat(texture.format);
+			uint32 externalFormat = TextureUtil::toGlExternalFormat(texture.format);
+			GL::bindTexture(GL_TEXTURE_2D, texture.graphicsId);
+			GL::pixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			GL::texImage2D(GL_TEXTURE_2D, 0, internalFormat, texture.width, texture.height, 0, externalFormat, GL_UNSIGNED_BYTE, pixelSource);
+			GL::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+			if (entry.options.generateMipmaps)
+			{
+				GL::generateMipmap(GL_TEXTURE_2D);
+				GLint minFilter = entry.options.minFilter == FilterMode::Nearest
+					? GL_NEAREST_MIPMAP_NEAREST
+					: GL_LINEAR_MIPMAP_LINEAR;
+				GL::texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
+			}
+		}
 	}
 }
\ No newline at end of file
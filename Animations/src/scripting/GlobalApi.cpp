@@ -55,6 +55,10 @@ extern "C"
 
 	// --------------- Internal Variables ---------------
 	static std::unordered_map<lua_CFunction, std::string> cFunctionDebugNames;
+	// Generator scripts push functions from worker threads
+	static std::mutex cFunctionDebugNamesMtx;
+	// Reused by the bulk svg commands so they don't allocate on every call
+	static thread_local std::vector<Vec2> bulkPoints;
 
 	// --------------- Internal Functions ---------------
 	static uint64 toU64(lua_State* L, int index);
@@ -67,7 +71,10 @@ extern "C"
 	static void pushVec2(lua_State* L, const Vec2& value);
 	static void pushCFunction(lua_State* L, lua_CFunction fn, const char* debugName);
 	static AnimationManagerData* getAnimationManagerData(lua_State* L);
+	static ScriptApi::GeneratorStaging* getGeneratorStaging(lua_State* L);
+	static AnimObject* getScriptObject(lua_State* L, AnimObjId id);
 	static SvgObject* checkIfSvgIsNull(lua_State* L, int index);
+	static bool toPointList(lua_State* L, int index, std::vector<Vec2>& points);
 
 	// Print helpers
 	static void luaPrintTable(lua_State* L, char* buffer, size_t bufferSize, int index, int tabDepth = 1, int maxTabDepth = 5);
@@ -120,6 +127,36 @@ extern "C"
 		AnimObjId id = toU64(L, -1);
 		lua_pop(L, 1);
 
+		ScriptApi::GeneratorStaging* staging = getGeneratorStaging(L);
+		if (staging)
+		{
+			// The parent is either the object the generator runs on or one the generator created
+			AnimObject* stagedParent = getScriptObject(L, id);
+			if (!stagedParent && id != staging->parent.id)
+			{
+				throwError(L, "createAnimObject(parent) expects the object passed to the generator or an object it created.");
+			}
+
+			AnimObject newObject = AnimObject::createDefault(am, AnimObjectTypeV1::SvgObject);
+			newObject.takeAttributesFrom(stagedParent ? *stagedParent : staging->parent);
+			newObject.parentId = id;
+			newObject.isGenerated = true;
+			if (stagedParent)
+			{
+				stagedParent->generatedChildrenIds.push_back(newObject.id);
+			}
+
+			newObject._svgObjectStart = (SvgObject*)g_memory_allocate(sizeof(SvgObject));
+			newObject.svgObject = (SvgObject*)g_memory_allocate(sizeof(SvgObject));
+			(*newObject._svgObjectStart) = Svg::createDefault();
+			(*newObject.svgObject) = Svg::createDefault();
+			ScriptApi::pushAnimObject(L, newObject);
+
+			staging->objectIndices[newObject.id] = staging->objects.size();
+			staging->objects.push_back(newObject);
+			return 1;
+		}
+
 		AnimObject newObject = AnimObject::createDefaultFromParent(am, AnimObjectTypeV1::SvgObject, id, true);
 		newObject._svgObjectStart = (SvgObject*)g_memory_allocate(sizeof(SvgObject));
 		newObject.svgObject = (SvgObject*)g_memory_allocate(sizeof(SvgObject));
@@ -141,8 +178,6 @@ extern "C"
 		int nargs = lua_gettop(L);
 		argumentCheckWithSelf(L, 1, setName(nameString), nargs);
 
-		AnimationManagerData* am = getAnimationManagerData(L);
-
 		if (!lua_istable(L, 1))
 		{
 			throwError(L, "Error: AnimObject.setName expects first argument to be of type AnimObject.");
@@ -158,7 +193,7 @@ extern "C"
 		lua_pop(L, 1);
 		const char* name = lua_tostring(L, 2);
 
-		AnimObject* obj = AnimationManager::getMutableObject(am, id);
+		AnimObject* obj = getScriptObject(L, id);
 		if (obj)
 		{
 			obj->setName(name);
@@ -173,8 +208,6 @@ extern "C"
 		int nargs = lua_gettop(L);
 		argumentCheckWithSelf(L, 1, setPosition({ x = xPos, y = yPos, z = zPos }), nargs);
 
-		AnimationManagerData* am = getAnimationManagerData(L);
-
 		// AnimObj is first parameter
 		lua_getfield(L, 1, "id");
 		uint64 id = toU64(L, -1);
@@ -183,7 +216,7 @@ extern "C"
 		// Position is arg 2
 		Vec3 position = toVec3(L, 2);
 
-		AnimObject* obj = AnimationManager::getMutableObject(am, id);
+		AnimObject* obj = getScriptObject(L, id);
 		if (obj)
 		{
 			obj->_positionStart = position;
@@ -198,8 +231,6 @@ extern "C"
 		int nargs = lua_gettop(L);
 		argumentCheckWithSelf(L, 3, setPosition(x, y, z), nargs);
 
-		AnimationManagerData* am = getAnimationManagerData(L);
-
 		// AnimObj is first arg
 		lua_getfield(L, 1, "id");
 		uint64 id = toU64(L, -1);
@@ -223,7 +254,7 @@ extern "C"
 			throwError(L, "Expected number as third argument in setPosition(x, y, z). Got something else instead.");
 		}
 
-		AnimObject* obj = AnimationManager::getMutableObject(am, id);
+		AnimObject* obj = getScriptObject(L, id);
 		if (obj)
 		{
 			obj->_positionStart = Vec3{ x, y, z };
@@ -239,8 +270,6 @@ extern "C"
 		int nargs = lua_gettop(L);
 		argumentCheckWithSelf(L, 1, setColor: (self: AnimObject, color : Vec4), nargs);
 
-		AnimationManagerData* am = getAnimationManagerData(L);
-
 		// AnimObj is first parameter
 		lua_getfield(L, 1, "id");
 		uint64 id = toU64(L, -1);
@@ -249,7 +278,7 @@ extern "C"
 		// Position is arg 2
 		Vec4 color = toVec4(L, 2);
 
-		AnimObject* obj = AnimationManager::getMutableObject(am, id);
+		AnimObject* obj = getScriptObject(L, id);
 		if (obj)
 		{
 			obj->_fillColorStart = glm::u8vec4(
@@ -271,8 +300,6 @@ extern "C"
 		int nargs = lua_gettop(L);
 		argumentCheckWithSelf(L, 1, beginPath: (startPosition: Vec2), nargs);
 
-		AnimationManagerData* am = getAnimationManagerData(L);
-
 		// SvgObject is first arg
 		lua_getfield(L, 1, "ptr");
 		if (!lua_islightuserdata(L, -1))
@@ -285,7 +312,7 @@ extern "C"
 			// Get the animObjId and assign it's startSvgObject to this pointer now
 			lua_getfield(L, 1, "objId");
 			AnimObjId objId = toU64(L, -1);
-			AnimObject* obj = AnimationManager::getMutableObject(am, objId);
+			AnimObject* obj = getScriptObject(L, objId);
 			if (obj)
 			{
 				obj->_svgObjectStart = (SvgObject*)g_memory_allocate(sizeof(SvgObject));
@@ -741,6 +768,67 @@ extern "C"
 		return 0;
 	}
 
+	// Bulk Commands
+	int global_svgPolyline(lua_State* L)
+	{
+		// polyline: (points: buffer | {number}) -> ()
+		int nargs = lua_gettop(L);
+		argumentCheckWithSelf(L, 1, polyline: (points: buffer | {number}), nargs);
+
+		// SvgObject is first arg
+		lua_getfield(L, 1, "ptr");
+		SvgObject* svgPtr = checkIfSvgIsNull(L, -1);
+		if (!svgPtr)
+		{
+			return -1;
+		}
+
+		// points is arg 2
+		if (!toPointList(L, 2, bulkPoints))
+		{
+			throwError(L, "SvgObject.polyline(points: buffer | {number}) expects a buffer of f32 x, y pairs or an array of numbers {x0, y0, x1, y1, ...}.");
+		}
+
+		if (svgPtr->numPaths == 0)
+		{
+			throwError(L, "SvgObject.polyline(points: buffer | {number}) needs a path. Did you forget to call beginPath()?");
+		}
+
+		Svg::polylineTo(svgPtr, bulkPoints.data(), (int)bulkPoints.size());
+
+		return 0;
+	}
+
+	int global_svgCubics(lua_State* L)
+	{
+		// cubics: (points: buffer | {number}) -> ()
+		int nargs = lua_gettop(L);
+		argumentCheckWithSelf(L, 1, cubics: (points: buffer | {number}), nargs);
+
+		// SvgObject is first arg
+		lua_getfield(L, 1, "ptr");
+		SvgObject* svgPtr = checkIfSvgIsNull(L, -1);
+		if (!svgPtr)
+		{
+			return -1;
+		}
+
+		// points is arg 2, three points for every curve
+		if (!toPointList(L, 2, bulkPoints) || bulkPoints.size() % 3 != 0)
+		{
+			throwError(L, "SvgObject.cubics(points: buffer | {number}) expects three points (p0, p1, p2) for every curve, as f32 x, y pairs in a buffer or an array of numbers.");
+		}
+
+		if (svgPtr->numPaths == 0)
+		{
+			throwError(L, "SvgObject.cubics(points: buffer | {number}) needs a path. Did you forget to call beginPath()?");
+		}
+
+		Svg::cubicsTo(svgPtr, bulkPoints.data(), (int)(bulkPoints.size() / 3));
+
+		return 0;
+	}
+
 	int global_require(lua_State* L)
 	{
 		int nargs = lua_gettop(L);
@@ -974,6 +1062,8 @@ extern "C"
 	static void pushCFunction(lua_State* L, lua_CFunction fn, const char* debugName)
 	{
 		lua_pushcfunction(L, fn, debugName);
+
+		std::lock_guard<std::mutex> lock(cFunctionDebugNamesMtx);
 		cFunctionDebugNames[fn] = debugName;
 	}
 
@@ -984,6 +1074,29 @@ extern "C"
 		return am;
 	}
 
+	static ScriptApi::GeneratorStaging* getGeneratorStaging(lua_State* L)
+	{
+		lua_getglobal(L, "GeneratorStaging");
+		ScriptApi::GeneratorStaging* staging = (ScriptApi::GeneratorStaging*)lua_tolightuserdata(L, -1);
+		lua_pop(L, 1);
+		return staging;
+	}
+
+	// Generators only get to modify the objects they created themselves
+	static AnimObject* getScriptObject(lua_State* L, AnimObjId id)
+	{
+		ScriptApi::GeneratorStaging* staging = getGeneratorStaging(L);
+		if (staging)
+		{
+			auto iter = staging->objectIndices.find(id);
+			return iter != staging->objectIndices.end()
+				? &staging->objects[iter->second]
+				: nullptr;
+		}
+
+		return AnimationManager::getMutableObject(getAnimationManagerData(L), id);
+	}
+
 	static SvgObject* checkIfSvgIsNull(lua_State* L, int index)
 	{
 		if (!lua_islightuserdata(L, index))
@@ -1002,6 +1115,61 @@ extern "C"
 		return svgPtr;
 	}
 
+	static bool toPointList(lua_State* L, int index, std::vector<Vec2>& points)
+	{
+		points.clear();
+
+		if (lua_isbuffer(L, index))
+		{
+			// Packed f32 x, y pairs, what buffer.writef32 writes
+			size_t numBytes = 0;
+			const void* data = lua_tobuffer(L, index, &numBytes);
+			if (numBytes % (sizeof(float) * 2) != 0)
+			{
+				return false;
+			}
+
+			points.resize(numBytes / (sizeof(float) * 2));
+			for (size_t i = 0; i < points.size(); i++)
+			{
+				float xy[2];
+				g_memory_copyMem(xy, (uint8*)data + i * sizeof(xy), sizeof(xy));
+				points[i] = Vec2{ xy[0], xy[1] };
+			}
+
+			return true;
+		}
+
+		if (!lua_istable(L, index))
+		{
+			return false;
+		}
+
+		// Flat array of numbers {x0, y0, x1, y1, ...}
+		int numNumbers = lua_objlen(L, index);
+		if (numNumbers % 2 != 0)
+		{
+			return false;
+		}
+
+		points.resize(numNumbers / 2);
+		for (int i = 0; i < numNumbers / 2; i++)
+		{
+			lua_rawgeti(L, index, i * 2 + 1);
+			lua_rawgeti(L, index, i * 2 + 2);
+			if (!lua_isnumber(L, -2) || !lua_isnumber(L, -1))
+			{
+				lua_pop(L, 2);
+				return false;
+			}
+
+			points[i] = Vec2{ (float)lua_tonumber(L, -2), (float)lua_tonumber(L, -1) };
+			lua_pop(L, 2);
+		}
+
+		return true;
+	}
+
 	// Print helpers
 	static void luaPrintTable(lua_State* L, char* buffer, size_t bufferSize, int index, int tabDepth, int maxTabDepth)
 	{
@@ -1169,6 +1337,7 @@ static std::string getAsString(lua_State* L, int index)
 	{
 		lua_CFunction func = lua_tocfunction(L, index);
 		std::string fnName = "Unregistered C Function";
+		std::lock_guard<std::mutex> lock(cFunctionDebugNamesMtx);
 		auto iter = cFunctionDebugNames.find(func);
 		if (iter != cFunctionDebugNames.end())
 		{
@@ -1250,6 +1419,18 @@ namespace MathAnim
 			// luaL_sandbox(L);
 		}
 
+		void registerGeneratorFunctions(lua_State* L, GeneratorStaging* staging)
+		{
+			registerGlobalFunctions(L, nullptr);
+
+			lua_pushlightuserdata(L, (void*)staging);
+			lua_setglobal(L, "GeneratorStaging");
+
+			// Scripts run in a thread made with luaL_sandboxthread, so the functions they
+			// define go in the thread's own globals table instead of the frozen one
+			luaL_sandbox(L);
+		}
+
 		void pushAnimObject(lua_State* L, const AnimObject& obj)
 		{
 			lua_createtable(L, 0, 5);
@@ -1275,7 +1456,7 @@ namespace MathAnim
 
 		void pushNewSvgObject(lua_State* L, const AnimObject& obj)
 		{
-			lua_createtable(L, 0, 18);
+			lua_createtable(L, 0, 20);
 
 			lua_pushlightuserdata(L, obj._svgObjectStart);
 			lua_setfield(L, -2, "ptr");
@@ -1335,6 +1516,13 @@ namespace MathAnim
 
 			pushCFunction(L, global_svgArcToRel, "arcToRel: (radius: Vec2, xAxisRot: number, largeArcFlag: boolean, sweepFlag: boolean, p0: Vec2) -> ()");
 			lua_setfield(L, -2, "arcToRel");
+
+			// Bulk svg commands
+			pushCFunction(L, global_svgPolyline, "polyline: (points: buffer | {number}) -> ()");
+			lua_setfield(L, -2, "polyline");
+
+			pushCFunction(L, global_svgCubics, "cubics: (points: buffer | {number}) -> ()");
+			lua_setfield(L, -2, "cubics");
 		}
 	}
 }
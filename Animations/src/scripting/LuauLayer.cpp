@@ -6,6 +6,11 @@
 #include "animation/Animation.h"
 #include "animation/AnimationManager.h"
 #include "editor/panels/ConsoleLog.h"
+#include "editor/panels/SceneHierarchyPanel.h"
+#include "svg/Svg.h"
+#include "multithreading/GlobalThreadPool.h"
+#include "core/Application.h"
+#include "math/CMath.h"
 
 #pragma warning( push )
 #pragma warning( disable : 4100 )
@@ -16,6 +21,8 @@
 #include <luacode.h>
 #pragma warning ( pop )
 
+#include <algorithm>
+
 namespace MathAnim
 {
 	struct Bytecode
@@ -23,6 +30,42 @@ namespace MathAnim
 		std::string scriptFilepath;
 		char* bytes;
 		size_t size;
+		// Registry reference to the loaded chunk, so running the script again doesn't
+		// have to luau_load it again
+		int chunkRef;
+		// Functions the chunk defined that were called through executeOnAnimObj. Every
+		// script defines its functions in the same globals table, so these are grabbed
+		// right after the chunk runs before another script can overwrite them.
+		std::unordered_map<std::string, int> functionRefs;
+	};
+
+	struct CompiledScript
+	{
+		char* bytecode;
+		size_t bytecodeSize;
+		// Hash of the source and compile options, names the file in the disk cache
+		uint64 cacheKey;
+		bool fromDiskCache;
+		float milliseconds;
+	};
+
+	struct GeneratorJob
+	{
+		// Own copy of the bytecode, the cached one can be replaced while the job runs
+		Bytecode bytecode;
+		std::string functionName;
+		AnimationManagerData* am;
+		AnimObjId objId;
+		ScriptApi::GeneratorStaging staging;
+		std::chrono::milliseconds timeBudget;
+		std::chrono::steady_clock::time_point deadline;
+		std::atomic<bool> cancelled;
+		bool timedOut;
+		bool succeeded;
+		std::string errorMessage;
+		float milliseconds;
+		uint32 generation;
+		JobCounter counter;
 	};
 
 	struct ParsedError
@@ -37,17 +80,46 @@ namespace MathAnim
 		// ---------- Internal Functions ----------
 		static void* luaAllocWrapper(void* ud, void* ptr, size_t osize, size_t nsize);
 		static ParsedError parseError(const char* luaRuntimeErrorMessage);
+		static CompiledScript readAndCompile(const std::string& scriptPath, bool useDiskCache = true);
+		static bool storeBytecode(const std::string& filename, const std::string& scriptPath, CompiledScript& compiled);
+		static void releaseRefs(Bytecode& bytecode);
+		static void removeBytecode(const std::string& filename);
+		static bool callFunction(int numArgs);
+		static std::filesystem::path getDiskCachePath(uint64 cacheKey);
+		static float millisecondsSince(std::chrono::steady_clock::time_point start);
+		static void runGenerator(GeneratorJob* job);
+		static void commitGenerator(GeneratorJob* job);
+		static void freeGenerator(GeneratorJob* job);
+		static void generatorInterrupt(lua_State* L, int gc);
 
 		// ---------- Internal Variables ----------
 		ScriptAnalyzer* analyzer = nullptr;
 		lua_State* luaState = nullptr;
 		std::unordered_map<std::string, Bytecode> cachedBytecode;
 		std::filesystem::path scriptDirectory = "";
-		const Bytecode* currentExecutingScript = nullptr;
-
-		void init(const std::filesystem::path& inScriptDirectory, AnimationManagerData* am)
+		// Written once in init() and only read afterwards, so compile jobs can use it
+		static std::filesystem::path bytecodeCacheDirectory = "";
+		// Part of every disk cache key, bump it whenever the cached bytes change meaning
+		static constexpr uint64 bytecodeCacheVersion = 1;
+		static constexpr int compileOptimizationLevel = 1;
+		static constexpr int compileDebugLevel = 1;
+		// Generators run on worker threads, each one reports its own script
+		thread_local const Bytecode* currentExecutingScript = nullptr;
+		static JobCounter compileCounter;
+		// Bumped in free() so compiles that finish afterwards throw their bytecode away
+		static uint32 compileGeneration = 0;
+		// At most one generator per object, starting another one cancels the old one
+		static std::unordered_map<AnimObjId, GeneratorJob*> runningGenerators;
+		// Every job that hasn't been freed yet, including cancelled ones that are still winding down
+		static std::vector<GeneratorJob*> liveGenerators;
+		// Bumped in free() so generators that finish afterwards throw their objects away
+		static uint32 generatorGeneration = 0;
+
+		void init(const std::filesystem::path& inScriptDirectory, const std::filesystem::path& cacheDirectory, AnimationManagerData* am)
 		{
 			Platform::createDirIfNotExists(inScriptDirectory.string().c_str());
+			Platform::createDirIfNotExists(cacheDirectory.string().c_str());
+			bytecodeCacheDirectory = cacheDirectory;
 
 			luaState = lua_newstate(luaAllocWrapper, NULL);
 			ScriptApi::registerGlobalFunctions(luaState, am);
@@ -64,71 +136,97 @@ namespace MathAnim
 
 		bool compile(const std::string& filename)
 		{
-			if (!analyzer->analyze(filename))
+			auto start = std::chrono::steady_clock::now();
+			bool analysisSkipped = false;
+			if (!analyzer->analyze(filename, &analysisSkipped))
 			{
 				// If the bytecode exists, free the bytes since the most recent code is broken
-				auto iter = cachedBytecode.find(filename);
-				if (iter != cachedBytecode.end())
-				{
-					::free(iter->second.bytes);
-					cachedBytecode.erase(iter);
-				}
+				removeBytecode(filename);
 				return false;
 			}
+			float analysisMs = millisecondsSince(start);
 
 			std::string scriptPath = (scriptDirectory / filename).make_preferred().lexically_normal().string();
-			FILE* fp = fopen(scriptPath.c_str(), "rb");
-			if (!fp)
+			CompiledScript compiled = readAndCompile(scriptPath);
+			if (!compiled.bytecode)
 			{
 				g_logger_warning("Could not open file '{}', error opening file.", filename);
 				return false;
 			}
 
-			fseek(fp, 0, SEEK_END);
-			size_t fileSize = ftell(fp);
-			fseek(fp, 0, SEEK_SET);
-
-			RawMemory memory;
-			memory.init(fileSize + 1);
-			fread(memory.data, fileSize, 1, fp);
-			memory.data[fileSize] = '\0';
-			fclose(fp);
-
-			lua_CompileOptions compileOptions = {};
-			compileOptions.optimizationLevel = 1;
-			compileOptions.debugLevel = 1;
-			size_t bytecodeSize = 0;
-			char* bytecode = luau_compile((const char*)memory.data, memory.size, &compileOptions, &bytecodeSize);
-			int result = luau_load(luaState, filename.c_str(), bytecode, bytecodeSize, 0);
-
-			memory.free();
-
-			// Pop the bytecode off the stack
-			lua_pop(luaState, 1);
+			bool succeeded = storeBytecode(filename, scriptPath, compiled);
+			ConsoleLog::info(scriptPath.c_str(), 0, "Compiled in %.2fms (analysis %s %.2fms, bytecode %s %.2fms)",
+				millisecondsSince(start),
+				analysisSkipped ? "unchanged" : "checked", analysisMs,
+				compiled.fromDiskCache ? "from disk cache" : "compiled", compiled.milliseconds);
+			return succeeded;
+		}
 
-			if (result != 0)
-			{
-				::free(bytecode);
-				return false;
-			}
+		void compileAsync(const std::string& filename, CompileCallback onCompiled)
+		{
+			std::string scriptPath = (scriptDirectory / filename).make_preferred().lexically_normal().string();
+			CompiledScript* result = (CompiledScript*)g_memory_allocate(sizeof(CompiledScript));
+			*result = {};
 
-			{
-				// If the bytecode exists, free the bytes since it's about to be
-				// replaced
-				auto iter = cachedBytecode.find(filename);
-				if (iter != cachedBytecode.end())
+			GlobalThreadPool* threadPool = Application::threadPool();
+			threadPool->queueJob(
+				[result, scriptPath]()
 				{
-					::free(iter->second.bytes);
-				}
-			}
+					*result = readAndCompile(scriptPath);
+				},
+				"CompileLuauScript",
+				Priority::Medium,
+				&compileCounter
+			);
+
+			// The analyzer and the lua state aren't thread safe, so type checking and
+			// loading the bytecode still happen on the main thread
+			uint32 generation = compileGeneration;
+			threadPool->continueWith(
+				compileCounter,
+				[result, filename, scriptPath, generation, onCompiled]()
+				{
+					if (generation != compileGeneration)
+					{
+						::free(result->bytecode);
+						g_memory_free(result);
+						return;
+					}
 
-			Bytecode res;
-			res.bytes = bytecode;
-			res.size = bytecodeSize;
-			res.scriptFilepath = scriptPath;
-			cachedBytecode[filename] = res;
+					auto start = std::chrono::steady_clock::now();
+					bool analysisSkipped = false;
+					bool succeeded = false;
+					if (!result->bytecode)
+					{
+						g_logger_warning("Could not open file '{}', error opening file.", filename);
+					}
+					else if (!analyzer->analyze(filename, &analysisSkipped))
+					{
+						::free(result->bytecode);
 
-			return true;
+						// The most recent code is broken so the old bytecode is stale now
+						removeBytecode(filename);
+					}
+					else
+					{
+						float analysisMs = millisecondsSince(start);
+						succeeded = storeBytecode(filename, scriptPath, *result);
+						ConsoleLog::info(scriptPath.c_str(), 0, "Compiled in %.2fms on the main thread (analysis %s %.2fms, bytecode %s %.2fms in the background)",
+							millisecondsSince(start),
+							analysisSkipped ? "unchanged" : "checked", analysisMs,
+							result->fromDiskCache ? "from disk cache" : "compiled", result->milliseconds);
+					}
+					g_memory_free(result);
+
+					if (onCompiled)
+					{
+						onCompiled(filename, succeeded);
+					}
+				},
+				"LoadLuauScript",
+				Priority::Medium,
+				true
+			);
 		}
 
 		bool compile(const std::string& sourceCode, const std::string& scriptName)
@@ -139,36 +237,12 @@ namespace MathAnim
 			}
 
 			lua_CompileOptions compileOptions = {};
-			compileOptions.optimizationLevel = 1;
-			compileOptions.debugLevel = 1;
-			size_t bytecodeSize = 0;
-			char* bytecode = luau_compile(sourceCode.c_str(), sourceCode.length(), &compileOptions, &bytecodeSize);
-			int result = luau_load(luaState, scriptName.c_str(), bytecode, bytecodeSize, 0);
-
-			// Pop the bytecode off the stack
-			lua_pop(luaState, 1);
-
-			if (result != 0)
-			{
-				::free(bytecode);
-				return false;
-			}
+			compileOptions.optimizationLevel = compileOptimizationLevel;
+			compileOptions.debugLevel = compileDebugLevel;
+			CompiledScript compiled = {};
+			compiled.bytecode = luau_compile(sourceCode.c_str(), sourceCode.length(), &compileOptions, &compiled.bytecodeSize);
 
-			// If the bytecode exists, free the bytes since it's about to be
-			// replaced
-			auto iter = cachedBytecode.find(scriptName);
-			if (iter != cachedBytecode.end())
-			{
-				::free(iter->second.bytes);
-			}
-
-			Bytecode res;
-			res.bytes = bytecode;
-			res.size = bytecodeSize;
-			res.scriptFilepath = scriptName;
-			cachedBytecode[scriptName] = res;
-
-			return true;
+			return storeBytecode(scriptName, scriptName, compiled);
 		}
 
 		const std::string& getCurrentExecutingScriptFilepath()
@@ -193,26 +267,10 @@ namespace MathAnim
 
 			const Bytecode& bytecode = iter->second;
 			currentExecutingScript = &bytecode;
-			int result = luau_load(luaState, filename.c_str(), bytecode.bytes, bytecode.size, 0);
-
-			if (result == 0)
-			{
-				result = lua_pcall(luaState, 0, LUA_MULTRET, 0);
-				if (result)
-				{
-					ParsedError error = parseError(lua_tostring(luaState, -1));
-					ConsoleLog::error(error.filepath.c_str(), error.lineNumber, "%s", error.message.c_str());
-					lua_pop(luaState, 1);
-					return false;
-				}
-
-				currentExecutingScript = nullptr;
-				return true;
-			}
-
-			lua_pop(luaState, 1);
+			lua_getref(luaState, bytecode.chunkRef);
+			bool succeeded = callFunction(0);
 			currentExecutingScript = nullptr;
-			return false;
+			return succeeded;
 		}
 
 		bool executeOnAnimObj(const std::string& filename, const std::string& functionName, AnimationManagerData* am, AnimObjId id)
@@ -231,51 +289,138 @@ namespace MathAnim
 				return false;
 			}
 
-			const Bytecode& bytecode = iter->second;
+			auto start = std::chrono::steady_clock::now();
+			Bytecode& bytecode = iter->second;
 			currentExecutingScript = &bytecode;
-			int result = luau_load(luaState, filename.c_str(), bytecode.bytes, bytecode.size, 0);
 
-			if (result == 0)
+			auto functionIter = bytecode.functionRefs.find(functionName);
+			if (functionIter == bytecode.functionRefs.end())
 			{
 				// Run the script to get all the function definitions loaded
-				result = lua_pcall(luaState, 0, LUA_MULTRET, 0);
-				if (result)
+				lua_getref(luaState, bytecode.chunkRef);
+				if (!callFunction(0))
 				{
-					ParsedError error = parseError(lua_tostring(luaState, -1));
-					ConsoleLog::error(error.filepath.c_str(), error.lineNumber, "%s", error.message.c_str());
-					lua_pop(luaState, 1);
+					currentExecutingScript = nullptr;
 					return false;
 				}
 
-				// Get the function and push it on top of the stack
 				lua_getfield(luaState, LUA_GLOBALSINDEX, functionName.c_str());
-				// Push anim object to top of the stack
-				ScriptApi::pushAnimObject(luaState, *obj);
-				result = lua_pcall(luaState, 1, 0, 0);
-				if (result)
+				if (!lua_isfunction(luaState, -1))
 				{
-					ParsedError error = parseError(lua_tostring(luaState, -1));
-					ConsoleLog::error(error.filepath.c_str(), error.lineNumber, "%s", error.message.c_str());
+					ConsoleLog::error(bytecode.scriptFilepath.c_str(), 0, "Script does not define a function named '%s'.", functionName.c_str());
 					lua_pop(luaState, 1);
+					currentExecutingScript = nullptr;
 					return false;
 				}
 
-				for (auto breadthFirstIter = obj->beginBreadthFirst(am); breadthFirstIter != obj->end(); ++breadthFirstIter)
-				{
-					AnimObject* childObj = AnimationManager::getMutableObject(am, *breadthFirstIter);
-					if (childObj)
-					{
-						childObj->retargetSvgScale();
-					}
-				}
+				int functionRef = lua_ref(luaState, -1);
+				lua_pop(luaState, 1);
+				functionIter = bytecode.functionRefs.emplace(functionName, functionRef).first;
+			}
 
+			// Get the function and push it on top of the stack
+			lua_getref(luaState, functionIter->second);
+			// Push anim object to top of the stack
+			ScriptApi::pushAnimObject(luaState, *obj);
+			if (!callFunction(1))
+			{
 				currentExecutingScript = nullptr;
-				return true;
+				return false;
 			}
 
-			lua_pop(luaState, 1);
+			for (auto breadthFirstIter = obj->beginBreadthFirst(am); breadthFirstIter != obj->end(); ++breadthFirstIter)
+			{
+				AnimObject* childObj = AnimationManager::getMutableObject(am, *breadthFirstIter);
+				if (childObj)
+				{
+					childObj->retargetSvgScale();
+				}
+			}
+
+			ConsoleLog::info(bytecode.scriptFilepath.c_str(), 0, "Ran '%s' in %.2fms", functionName.c_str(), millisecondsSince(start));
 			currentExecutingScript = nullptr;
-			return false;
+			return true;
+		}
+
+		void executeOnAnimObjAsync(const std::string& filename, const std::string& functionName, AnimationManagerData* am, AnimObjId id, std::chrono::milliseconds timeBudget)
+		{
+			const AnimObject* obj = AnimationManager::getObject(am, id);
+			if (!obj)
+			{
+				g_logger_error("Cannot run script on null anim object. Object '{}' does not exist.", id);
+				return;
+			}
+
+			auto iter = cachedBytecode.find(filename);
+			if (iter == cachedBytecode.end())
+			{
+				g_logger_warning("Tried to execute script '{}' which was never compiled successfully.", filename);
+				return;
+			}
+
+			cancelExecution(id);
+
+			GeneratorJob* job = (GeneratorJob*)g_memory_allocate(sizeof(GeneratorJob));
+			new(job)GeneratorJob();
+			job->bytecode.scriptFilepath = iter->second.scriptFilepath;
+			job->bytecode.size = iter->second.size;
+			job->bytecode.bytes = (char*)::malloc(job->bytecode.size);
+			g_memory_copyMem(job->bytecode.bytes, iter->second.bytes, job->bytecode.size);
+			job->bytecode.chunkRef = LUA_NOREF;
+			job->functionName = functionName;
+			job->am = am;
+			job->objId = id;
+			// The worker never reads the scene, so it gets a copy of the object without its
+			// geometry. Scripts can only draw into objects they create.
+			job->staging.parent = *obj;
+			job->staging.parent._svgObjectStart = nullptr;
+			job->staging.parent.svgObject = nullptr;
+			job->timeBudget = timeBudget;
+			job->cancelled = false;
+			job->timedOut = false;
+			job->succeeded = false;
+			job->milliseconds = 0.0f;
+			job->generation = generatorGeneration;
+			runningGenerators[id] = job;
+			liveGenerators.push_back(job);
+
+			GlobalThreadPool* threadPool = Application::threadPool();
+			threadPool->queueJob(
+				[job]()
+				{
+					runGenerator(job);
+				},
+				"RunLuauGenerator",
+				Priority::Low,
+				&job->counter
+			);
+
+			threadPool->continueWith(
+				job->counter,
+				[job]()
+				{
+					commitGenerator(job);
+				},
+				"CommitLuauGenerator",
+				Priority::Low,
+				true
+			);
+		}
+
+		bool isExecuting(AnimObjId id)
+		{
+			return runningGenerators.find(id) != runningGenerators.end();
+		}
+
+		void cancelExecution(AnimObjId id)
+		{
+			auto iter = runningGenerators.find(id);
+			if (iter != runningGenerators.end())
+			{
+				// The job cleans up in its continuation, it only has to stop running
+				iter->second->cancelled = true;
+				runningGenerators.erase(iter);
+			}
 		}
 
 		bool remove(const std::string& filename)
@@ -287,12 +432,26 @@ namespace MathAnim
 				return false;
 			}
 
-			cachedBytecode.erase(iter);
+			removeBytecode(filename);
 			return true;
 		}
 
 		void free()
 		{
+			Application::threadPool()->wait(compileCounter);
+			compileGeneration++;
+
+			// Continuations still queued for the main thread see the new generation and
+			// only clean up after themselves
+			for (GeneratorJob* job : liveGenerators)
+			{
+				job->cancelled = true;
+				Application::threadPool()->wait(job->counter);
+			}
+			runningGenerators.clear();
+			liveGenerators.clear();
+			generatorGeneration++;
+
 			if (analyzer)
 			{
 				analyzer->free();
@@ -306,7 +465,8 @@ namespace MathAnim
 				lua_close(luaState);
 			}
 
-			for (auto pair : cachedBytecode)
+			// The refs went away with the lua state
+			for (auto& pair : cachedBytecode)
 			{
 				::free(pair.second.bytes);
 			}
@@ -329,6 +489,357 @@ namespace MathAnim
 				return ::realloc(ptr, nsize);
 		}
 
+		static CompiledScript readAndCompile(const std::string& scriptPath, bool useDiskCache)
+		{
+			auto start = std::chrono::steady_clock::now();
+			CompiledScript res = {};
+
+			FILE* fp = fopen(scriptPath.c_str(), "rb");
+			if (!fp)
+			{
+				return res;
+			}
+
+			fseek(fp, 0, SEEK_END);
+			size_t fileSize = ftell(fp);
+			fseek(fp, 0, SEEK_SET);
+
+			std::string source(fileSize, '\0');
+			fread(source.data(), fileSize, 1, fp);
+			fclose(fp);
+
+			uint64 options[] = { bytecodeCacheVersion, (uint64)compileOptimizationLevel, (uint64)compileDebugLevel };
+			res.cacheKey = CMath::hashBytes(options, sizeof(options), CMath::hashBytes(source.data(), source.size()));
+			std::filesystem::path cachePath = getDiskCachePath(res.cacheKey);
+			if (useDiskCache)
+			{
+				FILE* cacheFp = fopen(cachePath.string().c_str(), "rb");
+				if (cacheFp)
+				{
+					fseek(cacheFp, 0, SEEK_END);
+					res.bytecodeSize = ftell(cacheFp);
+					fseek(cacheFp, 0, SEEK_SET);
+
+					// Bytecode is always released with ::free since that's what luau_compile allocates with
+					res.bytecode = (char*)::malloc(res.bytecodeSize);
+					size_t amtRead = res.bytecodeSize > 0 ? fread(res.bytecode, res.bytecodeSize, 1, cacheFp) : 0;
+					fclose(cacheFp);
+
+					if (amtRead == 1)
+					{
+						res.fromDiskCache = true;
+						res.milliseconds = millisecondsSince(start);
+						return res;
+					}
+
+					::free(res.bytecode);
+					res.bytecode = nullptr;
+					res.bytecodeSize = 0;
+				}
+			}
+
+			// luau_compile doesn't touch any lua state, so this is safe to run on any thread
+			lua_CompileOptions compileOptions = {};
+			compileOptions.optimizationLevel = compileOptimizationLevel;
+			compileOptions.debugLevel = compileDebugLevel;
+			res.bytecode = luau_compile(source.c_str(), source.length(), &compileOptions, &res.bytecodeSize);
+
+			// A leading zero byte means the bytecode holds a compile error instead, which
+			// isn't worth caching
+			if (res.bytecode && res.bytecodeSize > 0 && res.bytecode[0] != 0)
+			{
+				// Write to a temporary file first so a half written file never gets loaded.
+				// Two threads compiling the same source just write the same bytes twice.
+				std::filesystem::path tmpPath = cachePath;
+				tmpPath += ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+				FILE* cacheFp = fopen(tmpPath.string().c_str(), "wb");
+				if (cacheFp)
+				{
+					size_t amtWritten = fwrite(res.bytecode, res.bytecodeSize, 1, cacheFp);
+					fclose(cacheFp);
+
+					std::error_code error;
+					if (amtWritten == 1)
+					{
+						std::filesystem::rename(tmpPath, cachePath, error);
+					}
+					if (amtWritten != 1 || error)
+					{
+						std::filesystem::remove(tmpPath, error);
+					}
+				}
+			}
+
+			res.milliseconds = millisecondsSince(start);
+			return res;
+		}
+
+		static bool storeBytecode(const std::string& filename, const std::string& scriptPath, CompiledScript& compiled)
+		{
+			int result = luau_load(luaState, filename.c_str(), compiled.bytecode, compiled.bytecodeSize, 0);
+			if (result != 0 && compiled.fromDiskCache)
+			{
+				// Most likely written by a different version of Luau, throw it away and
+				// compile the source again
+				lua_pop(luaState, 1);
+				::free(compiled.bytecode);
+				std::error_code error;
+				std::filesystem::remove(getDiskCachePath(compiled.cacheKey), error);
+
+				compiled = readAndCompile(scriptPath, false);
+				if (!compiled.bytecode)
+				{
+					return false;
+				}
+				result = luau_load(luaState, filename.c_str(), compiled.bytecode, compiled.bytecodeSize, 0);
+			}
+
+			if (result != 0)
+			{
+				// Pop the error message off the stack
+				lua_pop(luaState, 1);
+				::free(compiled.bytecode);
+				return false;
+			}
+
+			// Keep the loaded chunk around, it's what execute() runs
+			int chunkRef = lua_ref(luaState, -1);
+			lua_pop(luaState, 1);
+
+			{
+				// If the bytecode exists, free the bytes since it's about to be
+				// replaced
+				auto iter = cachedBytecode.find(filename);
+				if (iter != cachedBytecode.end())
+				{
+					releaseRefs(iter->second);
+					::free(iter->second.bytes);
+				}
+			}
+
+			Bytecode res;
+			res.bytes = compiled.bytecode;
+			res.size = compiled.bytecodeSize;
+			res.scriptFilepath = scriptPath;
+			res.chunkRef = chunkRef;
+			cachedBytecode[filename] = res;
+
+			return true;
+		}
+
+		static void releaseRefs(Bytecode& bytecode)
+		{
+			lua_unref(luaState, bytecode.chunkRef);
+			for (auto& [functionName, functionRef] : bytecode.functionRefs)
+			{
+				lua_unref(luaState, functionRef);
+			}
+			bytecode.functionRefs.clear();
+		}
+
+		static void removeBytecode(const std::string& filename)
+		{
+			auto iter = cachedBytecode.find(filename);
+			if (iter != cachedBytecode.end())
+			{
+				releaseRefs(iter->second);
+				::free(iter->second.bytes);
+				cachedBytecode.erase(iter);
+			}
+		}
+
+		// Calls the function sitting below numArgs arguments on the stack and reports any errors
+		static bool callFunction(int numArgs)
+		{
+			int result = lua_pcall(luaState, numArgs, 0, 0);
+			if (result)
+			{
+				ParsedError error = parseError(lua_tostring(luaState, -1));
+				ConsoleLog::error(error.filepath.c_str(), error.lineNumber, "%s", error.message.c_str());
+				lua_pop(luaState, 1);
+				return false;
+			}
+
+			return true;
+		}
+
+		static void runGenerator(GeneratorJob* job)
+		{
+			auto start = std::chrono::steady_clock::now();
+			job->deadline = start + job->timeBudget;
+			currentExecutingScript = &job->bytecode;
+
+			lua_State* L = lua_newstate(luaAllocWrapper, NULL);
+			ScriptApi::registerGeneratorFunctions(L, &job->staging);
+			lua_callbacks(L)->userdata = job;
+			lua_callbacks(L)->interrupt = generatorInterrupt;
+
+			// The thread gets a fresh globals table that falls back to the frozen one
+			lua_State* thread = lua_newthread(L);
+			luaL_sandboxthread(thread);
+
+			if (luau_load(thread, job->bytecode.scriptFilepath.c_str(), job->bytecode.bytes, job->bytecode.size, 0) == 0
+				&& lua_pcall(thread, 0, 0, 0) == 0)
+			{
+				lua_getfield(thread, LUA_GLOBALSINDEX, job->functionName.c_str());
+				if (!lua_isfunction(thread, -1))
+				{
+					job->errorMessage = "Script does not define a function named '" + job->functionName + "'.";
+				}
+				else
+				{
+					ScriptApi::pushAnimObject(thread, job->staging.parent);
+					job->succeeded = lua_pcall(thread, 1, 0, 0) == 0;
+				}
+			}
+
+			if (!job->succeeded && job->errorMessage.empty() && lua_isstring(thread, -1))
+			{
+				job->errorMessage = lua_tostring(thread, -1);
+			}
+
+			lua_close(L);
+			currentExecutingScript = nullptr;
+			job->milliseconds = millisecondsSince(start);
+		}
+
+		static void commitGenerator(GeneratorJob* job)
+		{
+			auto iter = runningGenerators.find(job->objId);
+			if (iter != runningGenerators.end() && iter->second == job)
+			{
+				runningGenerators.erase(iter);
+			}
+
+			if (job->generation != generatorGeneration || job->cancelled)
+			{
+				freeGenerator(job);
+				return;
+			}
+
+			const std::string& scriptFilepath = job->bytecode.scriptFilepath;
+			if (job->timedOut)
+			{
+				ConsoleLog::error(scriptFilepath.c_str(), 0, "'%s' was stopped after running for longer than its %.2fs time budget.",
+					job->functionName.c_str(), (float)job->timeBudget.count() / 1000.0f);
+				freeGenerator(job);
+				return;
+			}
+
+			if (!job->succeeded)
+			{
+				ParsedError error = parseError(job->errorMessage.c_str());
+				if (error.filepath.empty())
+				{
+					ConsoleLog::error(scriptFilepath.c_str(), 0, "%s", job->errorMessage.c_str());
+				}
+				else
+				{
+					ConsoleLog::error(error.filepath.c_str(), error.lineNumber, "%s", error.message.c_str());
+				}
+				freeGenerator(job);
+				return;
+			}
+
+			AnimationManagerData* am = job->am;
+			AnimObject* parent = AnimationManager::getMutableObject(am, job->objId);
+			if (!parent)
+			{
+				// Deleted while the script was running
+				freeGenerator(job);
+				return;
+			}
+
+			// The children from the last run stay in the scene until the new ones are ready
+			for (AnimObjId childId : parent->generatedChildrenIds)
+			{
+				AnimObject* child = AnimationManager::getMutableObject(am, childId);
+				if (child)
+				{
+					SceneHierarchyPanel::deleteAnimObject(*child);
+					AnimationManager::removeAnimObject(am, childId);
+				}
+			}
+			parent->generatedChildrenIds.clear();
+
+			for (AnimObject& obj : job->staging.objects)
+			{
+				if (obj.parentId == job->objId)
+				{
+					parent->generatedChildrenIds.push_back(obj.id);
+				}
+
+				// Copy the svgObjectStart to the svgObject to make sure the object renders properly
+				if (obj._svgObjectStart)
+				{
+					Svg::copy(obj.svgObject, obj._svgObjectStart);
+				}
+				obj.retargetSvgScale();
+
+				AnimationManager::addAnimObject(am, obj);
+				SceneHierarchyPanel::addNewAnimObject(obj);
+			}
+
+			ConsoleLog::info(scriptFilepath.c_str(), 0, "Ran '%s' in %.2fms on a worker thread, generated %d objects",
+				job->functionName.c_str(), job->milliseconds, (int)job->staging.objects.size());
+
+			// The scene owns the objects now
+			job->staging.objects.clear();
+			freeGenerator(job);
+		}
+
+		static void freeGenerator(GeneratorJob* job)
+		{
+			for (AnimObject& obj : job->staging.objects)
+			{
+				obj.free();
+			}
+
+			auto iter = std::find(liveGenerators.begin(), liveGenerators.end(), job);
+			if (iter != liveGenerators.end())
+			{
+				liveGenerators.erase(iter);
+			}
+
+			::free(job->bytecode.bytes);
+			job->~GeneratorJob();
+			g_memory_free(job);
+		}
+
+		// Called by Luau at loop back edges and function calls, which is where a running
+		// generator gets stopped
+		static void generatorInterrupt(lua_State* L, int gc)
+		{
+			if (gc >= 0)
+			{
+				return;
+			}
+
+			GeneratorJob* job = (GeneratorJob*)lua_callbacks(L)->userdata;
+			if (job->cancelled)
+			{
+				luaL_error(L, "Generator was cancelled.");
+			}
+
+			if (job->timeBudget.count() > 0 && std::chrono::steady_clock::now() > job->deadline)
+			{
+				job->timedOut = true;
+				luaL_error(L, "Generator ran out of time.");
+			}
+		}
+
+		static std::filesystem::path getDiskCachePath(uint64 cacheKey)
+		{
+			char filename[32];
+			snprintf(filename, sizeof(filename), "%016llx.luauc", (unsigned long long)cacheKey);
+			return bytecodeCacheDirectory / filename;
+		}
+
+		static float millisecondsSince(std::chrono::steady_clock::time_point start)
+		{
+			return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+		}
+
 		// Disgusting quick parsing to get the dumb error message in
 		// a nicer struct
 		static ParsedError parseError(const char* message)
@@ -72,7 +72,12 @@ export type SvgObject = {
     lineToRel: (svgObject: SvgObject, p0: Vec2) -> (),
     quadToRel: (svgObject: SvgObject, p0: Vec2, p1: Vec2) -> (),
     cubicToRel: (svgObject: SvgObject, p0: Vec2, p1: Vec2, p2: Vec2) -> (),
-    arcToRel: (svgObject: SvgObject, radius: Vec2, xAxisRot: number, largeArcFlag: boolean, sweepFlag: boolean, p0: Vec2) -> ()
+    arcToRel: (svgObject: SvgObject, radius: Vec2, xAxisRot: number, largeArcFlag: boolean, sweepFlag: boolean, p0: Vec2) -> (),
+
+    -- Bulk svg commands, points are f32 x, y pairs in a buffer or a flat array {x0, y0, x1, y1, ...}
+    polyline: (svgObject: SvgObject, points: buffer | {number}) -> (),
+    -- Three points (p0, p1, p2) for every cubic
+    cubics: (svgObject: SvgObject, points: buffer | {number}) -> ()
 }
 
 export type AnimObject = {
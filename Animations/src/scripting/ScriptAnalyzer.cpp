@@ -2,6 +2,7 @@
 #include "scripting/MathAnimGlobals.h"
 #include "platform/Platform.h"
 #include "editor/panels/ConsoleLog.h"
+#include "math/CMath.h"
 
 #pragma warning( push )
 #pragma warning( disable : 4100 )
@@ -15,11 +16,22 @@
 #pragma warning( pop )
 
 // ------------------------------- Internal Types -------------------------------
+struct ModuleSourceStamp
+{
+	std::filesystem::file_time_type lastWriteTime;
+	uintmax_t fileSize;
+	uint64 sourceHash;
+};
+
 struct ScriptFileResolver : public Luau::FileResolver
 {
 	std::string anonymousSource;
 	std::string anonymousName;
 	const std::filesystem::path scriptDirectory;
+	// Every module source the frontend read, used to tell which modules changed on
+	// disk since they were last checked. The source is only hashed again when the
+	// write time or size differ, so unchanged modules cost one stat per check.
+	std::unordered_map<Luau::ModuleName, ModuleSourceStamp> sourceStamps;
 
 	ScriptFileResolver(const std::filesystem::path& scriptDirectory);
 
@@ -49,6 +61,8 @@ enum class ReportFormat
 };
 
 // ------------------------------- Internal Functions -------------------------------
+static bool readScriptFile(const std::string& scriptPath, std::string* output);
+static bool statScriptFile(const std::string& scriptPath, ModuleSourceStamp* output);
 static void reportError(const Luau::Frontend* frontend, const char* filepath, ReportFormat format, const Luau::TypeError& error);
 static void report(ReportFormat format, const char* filepath, const Luau::Location& loc, const char* type, const char* message);
 
@@ -118,8 +132,13 @@ namespace MathAnim
 		Luau::freeze(frontend->typeChecker.globalTypes);
 	}
 
-	bool ScriptAnalyzer::analyze(const std::string& filename)
+	bool ScriptAnalyzer::analyze(const std::string& filename, bool* skipped)
 	{
+		if (skipped)
+		{
+			*skipped = false;
+		}
+
 		if (!fileResolver || !configResolver || !frontend)
 		{
 			static bool displayWarning = true;
@@ -131,10 +150,19 @@ namespace MathAnim
 			return false;
 		}
 
-		Luau::CheckResult cr;
+		markChangedModulesDirty();
+		if (!frontend->isDirty(filename) && passedScripts.find(filename) != passedScripts.end())
+		{
+			if (skipped)
+			{
+				*skipped = true;
+			}
+			return true;
+		}
 
-		if (frontend->isDirty(filename))
-			cr = frontend->check(filename);
+		// Scripts that failed last time are checked again so their errors get reported again
+		frontend->markDirty(filename);
+		Luau::CheckResult cr = frontend->check(filename);
 
 		if (!frontend->getSourceModule(filename))
 		{
@@ -147,7 +175,14 @@ namespace MathAnim
 			reportError(frontend, scriptFilepath.c_str(), ReportFormat::Default, error);
 		}
 
-		frontend->clear();
+		if (cr.errors.size() == 0)
+		{
+			passedScripts.insert(filename);
+		}
+		else
+		{
+			passedScripts.erase(filename);
+		}
 		return cr.errors.size() == 0;
 	}
 
@@ -167,10 +202,10 @@ namespace MathAnim
 		ScriptFileResolver* scriptFileResolver = dynamic_cast<ScriptFileResolver*>(fileResolver);
 		scriptFileResolver->setAnonymousFile(sourceCode, scriptName);
 
-		Luau::CheckResult cr;
-
-		if (frontend->isDirty(scriptName))
-			cr = frontend->check(scriptName);
+		// Anonymous sources can't be hashed from disk, so they're always checked
+		markChangedModulesDirty();
+		frontend->markDirty(scriptName);
+		Luau::CheckResult cr = frontend->check(scriptName);
 
 		if (!frontend->getSourceModule(scriptName))
 		{
@@ -182,7 +217,7 @@ namespace MathAnim
 			reportError(frontend, scriptName.c_str(), ReportFormat::Default, error);
 		}
 
-		frontend->clear();
+		passedScripts.erase(scriptName);
 		return cr.errors.size() == 0;
 	}
 
@@ -209,6 +244,40 @@ namespace MathAnim
 		fileResolver = nullptr;
 		configResolver = nullptr;
 		frontend = nullptr;
+		passedScripts.clear();
+	}
+
+	void ScriptAnalyzer::markChangedModulesDirty()
+	{
+		// markDirty also dirties every module that requires the changed one, which is
+		// what makes a script get checked again when only a required module changed
+		ScriptFileResolver* scriptFileResolver = dynamic_cast<ScriptFileResolver*>(fileResolver);
+		std::string source;
+		for (auto& [moduleName, stamp] : scriptFileResolver->sourceStamps)
+		{
+			std::string scriptPath = (m_scriptDirectory / moduleName).string();
+			ModuleSourceStamp current;
+			if (!statScriptFile(scriptPath, &current))
+			{
+				frontend->markDirty(moduleName);
+				continue;
+			}
+
+			if (current.lastWriteTime == stamp.lastWriteTime && current.fileSize == stamp.fileSize)
+			{
+				continue;
+			}
+
+			// Saving without changes still bumps the write time, only recheck if the source differs
+			if (!readScriptFile(scriptPath, &source) || CMath::hashBytes(source.data(), source.size()) != stamp.sourceHash)
+			{
+				frontend->markDirty(moduleName);
+				continue;
+			}
+
+			stamp.lastWriteTime = current.lastWriteTime;
+			stamp.fileSize = current.fileSize;
+		}
 	}
 }
 
@@ -248,33 +317,17 @@ std::optional<Luau::SourceCode> ScriptFileResolver::readSource(const Luau::Modul
 	Luau::SourceCode res;
 	res.type = res.Module;
 
-	FILE* fp = fopen(scriptPath.c_str(), "rb");
-	if (!fp)
+	// Stat before reading, a write that lands in between then shows up as a changed stamp next time
+	ModuleSourceStamp stamp;
+	if (!statScriptFile(scriptPath, &stamp) || !readScriptFile(scriptPath, &res.source))
 	{
 		g_logger_warning("Could not open file '{}', error opening file.", scriptPath);
+		sourceStamps.erase(name);
 		return std::nullopt;
 	}
 
-	fseek(fp, 0, SEEK_END);
-	size_t fileSize = ftell(fp);
-	fseek(fp, 0, SEEK_SET);
-
-	RawMemory memory;
-	memory.init(fileSize + 1);
-	size_t amtRead = fread(memory.data, fileSize, 1, fp);
-	fclose(fp);
-
-	if (amtRead != 1)
-	{
-		g_logger_error("Error reading file '{}'.", scriptPath);
-		memory.free();
-		return std::nullopt;
-	}
-
-	memory.data[fileSize] = '\0';
-	res.source = (char*)memory.data;
-	memory.free();
-
+	stamp.sourceHash = MathAnim::CMath::hashBytes(res.source.data(), res.source.size());
+	sourceStamps[name] = stamp;
 	return res;
 }
 
@@ -308,6 +361,44 @@ const Luau::Config& ScriptConfigResolver::getConfig(const Luau::ModuleName&) con
 }
 
 // ------------------------------- Internal Functions -------------------------------
+static bool readScriptFile(const std::string& scriptPath, std::string* output)
+{
+	FILE* fp = fopen(scriptPath.c_str(), "rb");
+	if (!fp)
+	{
+		return false;
+	}
+
+	fseek(fp, 0, SEEK_END);
+	size_t fileSize = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	output->resize(fileSize);
+	size_t amtRead = fileSize > 0 ? fread(output->data(), fileSize, 1, fp) : 1;
+	fclose(fp);
+
+	if (amtRead != 1)
+	{
+		g_logger_error("Error reading file '{}'.", scriptPath);
+		return false;
+	}
+
+	return true;
+}
+
+static bool statScriptFile(const std::string& scriptPath, ModuleSourceStamp* output)
+{
+	std::error_code error;
+	output->lastWriteTime = std::filesystem::last_write_time(scriptPath, error);
+	if (error)
+	{
+		return false;
+	}
+
+	output->fileSize = std::filesystem::file_size(scriptPath, error);
+	return !error;
+}
+
 static void reportError(const Luau::Frontend* frontend, const char* filepath, ReportFormat format, const Luau::TypeError& error)
 {
 	if (const Luau::SyntaxError* syntaxError = Luau::get_if<Luau::SyntaxError>(&error.data))
@@ -1,6 +1,7 @@
 #include "svg/Svg.h"
 #include "svg/SvgParser.h"
 #include "svg/SvgCache.h"
+#include "svg/SvgDiskCache.h"
 #include "animation/Animation.h"
 #include "renderer/Renderer.h"
 #include "renderer/Framebuffer.h"
@@ -9,6 +10,8 @@
 #include "core/Application.h"
 #include "core/Profiling.h"
 #include "core/Serialization.hpp"
+#include "core/FrameArena.h"
+#include "core/MemoryTracker.h"
 #include "multithreading/GlobalThreadPool.h"
 #include "math/CMath.h"
 #include "platform/Platform.h" 
@@ -29,6 +32,10 @@ namespace MathAnim
 
 		// ----------------- Internal functions -----------------
 		static void checkResize(Path& path);
+		static void reserveCurves(Path& path, int numCurves);
+		static void copyProperties(SvgObject* dest, const SvgObject* src);
+		static SvgObject* createFrameTemporary();
+		static void* reallocGeometry(void* ptr, size_t oldNumBytes, size_t newNumBytes, size_t alignment);
 
 		SvgObject createDefault()
 		{
@@ -45,6 +52,9 @@ namespace MathAnim
 			res.fillType = FillType::NonZeroFillType;
 			res.md5 = nullptr;
 			res.md5Length = 0;
+			res.sharedRefCount = nullptr;
+			res.glyphId = 0;
+			res.arcLengthLut = ArcLengthLut::create();
 			return res;
 		}
 
@@ -114,17 +124,27 @@ namespace MathAnim
 
 		void beginPath(SvgObject* object, const Vec2& firstPoint, bool isAbsolute)
 		{
+			object->makeUnique();
 			if (!isAbsolute)
 			{
 				g_logger_assert(object->numPaths > 0, "Cannot have non-absolute beginPath without prior paths.");
 			}
 
 			object->numPaths++;
-			object->paths = (Path*)g_memory_realloc(object->paths, sizeof(Path) * object->numPaths);
+			object->paths = (Path*)reallocGeometry(object->paths, sizeof(Path) * (object->numPaths - 1), sizeof(Path) * object->numPaths, alignof(Path));
 			g_logger_assert(object->paths != nullptr, "Ran out of RAM.");
 
+			// Curves go wherever the paths live so frame temporaries stay entirely in the FrameArena
 			object->paths[object->numPaths - 1].maxCapacity = initialMaxCapacity;
-			object->paths[object->numPaths - 1].curves = (Curve*)g_memory_allocate(sizeof(Curve) * initialMaxCapacity);
+			if (FrameArena::owns(object->paths))
+			{
+				object->paths[object->numPaths - 1].curves = (Curve*)FrameArena::allocate(sizeof(Curve) * initialMaxCapacity, alignof(Curve));
+			}
+			else
+			{
+				object->paths[object->numPaths - 1].curves = (Curve*)g_memory_allocate(sizeof(Curve) * initialMaxCapacity);
+				MemoryTracker::recordAllocation(MemoryTag::SvgCurves, sizeof(Curve) * initialMaxCapacity);
+			}
 			object->paths[object->numPaths - 1].numCurves = 0;
 			object->paths[object->numPaths - 1].isHole = false;
 
@@ -141,6 +161,7 @@ namespace MathAnim
 
 		void closePath(SvgObject* object, bool lineToEndpoint, bool isHole)
 		{
+			object->makeUnique();
 			g_logger_assert(object->numPaths > 0, "object->numContours == 0. Cannot close contour when no contour exists.");
 			g_logger_assert(object->paths[object->numPaths - 1].numCurves > 0, "contour->numCurves == 0. Cannot close contour with 0 vertices. There must be at least one vertex to close a contour.");
 
@@ -157,6 +178,7 @@ namespace MathAnim
 
 		void moveTo(SvgObject* object, const Vec2& point, bool absolute)
 		{
+			object->makeUnique();
 			// If no object has started, begin the object here
 			if (object->numPaths == 0)
 			{
@@ -186,6 +208,7 @@ namespace MathAnim
 
 		void lineTo(SvgObject* object, const Vec2& point, bool absolute)
 		{
+			object->makeUnique();
 			g_logger_assert(object->numPaths > 0, "object->numPaths == 0. Cannot create a lineTo when no path exists.");
 			Path& path = object->paths[object->numPaths - 1];
 			path.numCurves++;
@@ -216,6 +239,7 @@ namespace MathAnim
 
 		void bezier2To(SvgObject* object, const Vec2& control, const Vec2& dest, bool absolute)
 		{
+			object->makeUnique();
 			g_logger_assert(object->numPaths > 0, "object->numPaths == 0. Cannot create a bezier2To when no path exists.");
 			Path& path = object->paths[object->numPaths - 1];
 			path.numCurves++;
@@ -234,6 +258,7 @@ namespace MathAnim
 
 		void bezier3To(SvgObject* object, const Vec2& control0, const Vec2& control1, const Vec2& dest, bool absolute)
 		{
+			object->makeUnique();
 			g_logger_assert(object->numPaths > 0, "object->numPaths == 0. Cannot create a bezier3To when no path exists.");
 			Path& path = object->paths[object->numPaths - 1];
 			path.numCurves++;
@@ -251,8 +276,64 @@ namespace MathAnim
 			path.curves[path.numCurves - 1].type = CurveType::Bezier3;
 		}
 
+		void polylineTo(SvgObject* object, const Vec2* points, int numPoints, bool absolute)
+		{
+			if (numPoints <= 0)
+			{
+				return;
+			}
+
+			object->makeUnique();
+			g_logger_assert(object->numPaths > 0, "object->numPaths == 0. Cannot create a polylineTo when no path exists.");
+			Path& path = object->paths[object->numPaths - 1];
+			reserveCurves(path, path.numCurves + numPoints);
+
+			Vec2 cursor = object->_cursor;
+			Curve* curve = path.curves + path.numCurves;
+			for (int i = 0; i < numPoints; i++, curve++)
+			{
+				curve->type = CurveType::Line;
+				curve->p0 = cursor;
+				curve->as.line.p1 = absolute ? points[i] : points[i] + cursor;
+				cursor = curve->as.line.p1;
+			}
+
+			path.numCurves += numPoints;
+			object->_cursor = cursor;
+		}
+
+		void cubicsTo(SvgObject* object, const Vec2* points, int numCurves, bool absolute)
+		{
+			if (numCurves <= 0)
+			{
+				return;
+			}
+
+			object->makeUnique();
+			g_logger_assert(object->numPaths > 0, "object->numPaths == 0. Cannot create a cubicsTo when no path exists.");
+			Path& path = object->paths[object->numPaths - 1];
+			reserveCurves(path, path.numCurves + numCurves);
+
+			Vec2 cursor = object->_cursor;
+			Curve* curve = path.curves + path.numCurves;
+			for (int i = 0; i < numCurves; i++, curve++, points += 3)
+			{
+				curve->type = CurveType::Bezier3;
+				curve->p0 = cursor;
+				// Relative control points are relative to the start of their own curve, same as bezier3To
+				curve->as.bezier3.p1 = absolute ? points[0] : points[0] + cursor;
+				curve->as.bezier3.p2 = absolute ? points[1] : points[1] + cursor;
+				curve->as.bezier3.p3 = absolute ? points[2] : points[2] + cursor;
+				cursor = curve->as.bezier3.p3;
+			}
+
+			path.numCurves += numCurves;
+			object->_cursor = cursor;
+		}
+
 		void smoothBezier2To(SvgObject* object, const Vec2& dest, bool absolute)
 		{
+			object->makeUnique();
 			g_logger_assert(object->numPaths > 0, "object->numPaths == 0. Cannot create a bezier3To when no path exists.");
 			Path& path = object->paths[object->numPaths - 1];
 			path.numCurves++;
@@ -281,6 +362,7 @@ namespace MathAnim
 
 		void smoothBezier3To(SvgObject* object, const Vec2& control1, const Vec2& dest, bool absolute)
 		{
+			object->makeUnique();
 			g_logger_assert(object->numPaths > 0, "object->numPaths == 0. Cannot create a bezier3To when no path exists.");
 			Path& path = object->paths[object->numPaths - 1];
 			path.numCurves++;
@@ -506,6 +588,7 @@ namespace MathAnim
 
 		void addCurveManually(SvgObject* object, const Curve& curve)
 		{
+			object->makeUnique();
 			g_logger_assert(object->numPaths > 0, "object->numPaths == 0. Cannot create a lineTo when no path exists.");
 			Path& path = object->paths[object->numPaths - 1];
 			path.numCurves++;
@@ -531,12 +614,46 @@ namespace MathAnim
 
 		void copy(SvgObject* dest, const SvgObject* src)
 		{
+			dest->arcLengthLut.free();
+
+			if (dest->isShared() && dest->sharedRefCount == src->sharedRefCount)
+			{
+				// Already pointing at the same geometry
+				copyProperties(dest, src);
+				return;
+			}
+
+			if (src->isShared())
+			{
+				// Immutable geometry can just be referenced
+				dest->free();
+				dest->paths = src->paths;
+				dest->numPaths = src->numPaths;
+				dest->md5 = src->md5;
+				dest->md5Length = src->md5Length;
+				dest->sharedRefCount = src->sharedRefCount;
+				dest->sharedRefCount->fetch_add(1, std::memory_order_relaxed);
+				copyProperties(dest, src);
+				return;
+			}
+
+			if (dest->isShared())
+			{
+				// Let go of the old shared geometry instead of writing into it
+				dest->free();
+				dest->paths = (Path*)g_memory_allocate(sizeof(Path));
+			}
+
 			if (dest->numPaths != src->numPaths)
 			{
 				// Free any extra paths the destination has
 				// If the destination has less, this loop doesn't run
 				for (int contouri = src->numPaths; contouri < dest->numPaths; contouri++)
 				{
+					if (dest->paths[contouri].curves)
+					{
+						MemoryTracker::recordFree(MemoryTag::SvgCurves, sizeof(Curve) * dest->paths[contouri].maxCapacity);
+					}
 					g_memory_free(dest->paths[contouri].curves);
 					dest->paths[contouri].curves = nullptr;
 					dest->paths[contouri].numCurves = 0;
@@ -551,6 +668,7 @@ namespace MathAnim
 				for (int contouri = dest->numPaths; contouri < src->numPaths; contouri++)
 				{
 					dest->paths[contouri].curves = (Curve*)g_memory_allocate(sizeof(Curve) * initialMaxCapacity);
+					MemoryTracker::recordAllocation(MemoryTag::SvgCurves, sizeof(Curve) * initialMaxCapacity);
 					dest->paths[contouri].maxCapacity = initialMaxCapacity;
 					dest->paths[contouri].numCurves = 0;
 				}
@@ -585,10 +703,7 @@ namespace MathAnim
 				g_logger_assert(dstPath.numCurves == src->paths[pathi].numCurves, "How did this happen?");
 			}
 
-			dest->fillType = src->fillType;
-			dest->fillColor = src->fillColor;
-			dest->approximatePerimeter = src->approximatePerimeter;
-			dest->bbox = src->bbox;
+			copyProperties(dest, src);
 
 			dest->md5Length = src->md5Length;
 			if (dest->md5Length > 0)
@@ -602,6 +717,41 @@ namespace MathAnim
 			}
 		}
 
+		void copy(SvgGroup* dest, const SvgGroup* src)
+		{
+			dest->free();
+			*dest = createDefaultGroup();
+
+			dest->numObjects = src->numObjects;
+			dest->objects = (SvgObject*)g_memory_realloc(dest->objects, sizeof(SvgObject) * glm::max(src->numObjects, 1));
+			g_logger_assert(dest->objects != nullptr, "Ran out of RAM.");
+			dest->objectOffsets = (Vec2*)g_memory_realloc(dest->objectOffsets, sizeof(Vec2) * glm::max(src->numObjects, 1));
+			g_logger_assert(dest->objectOffsets != nullptr, "Ran out of RAM.");
+			for (int i = 0; i < src->numObjects; i++)
+			{
+				dest->objects[i] = createDefault();
+				copy(dest->objects + i, src->objects + i);
+				dest->objectOffsets[i] = src->objectOffsets[i];
+			}
+
+			dest->numUniqueObjects = src->numUniqueObjects;
+			dest->uniqueObjects = (SvgObject*)g_memory_realloc(dest->uniqueObjects, sizeof(SvgObject) * glm::max(src->numUniqueObjects, 1));
+			g_logger_assert(dest->uniqueObjects != nullptr, "Ran out of RAM.");
+			dest->uniqueObjectNames = (char**)g_memory_realloc(dest->uniqueObjectNames, sizeof(char*) * glm::max(src->numUniqueObjects, 1));
+			g_logger_assert(dest->uniqueObjectNames != nullptr, "Ran out of RAM.");
+			for (int i = 0; i < src->numUniqueObjects; i++)
+			{
+				dest->uniqueObjects[i] = createDefault();
+				copy(dest->uniqueObjects + i, src->uniqueObjects + i);
+
+				size_t nameLength = std::strlen(src->uniqueObjectNames[i]);
+				dest->uniqueObjectNames[i] = (char*)g_memory_allocate(sizeof(char) * (nameLength + 1));
+				g_memory_copyMem(dest->uniqueObjectNames[i], src->uniqueObjectNames[i], sizeof(char) * (nameLength + 1));
+			}
+
+			dest->bbox = src->bbox;
+		}
+
 		SvgObject* interpolate(const SvgObject* src, const SvgObject* dst, float t)
 		{
 			// Count the total number of curves in all paths
@@ -616,10 +766,10 @@ namespace MathAnim
 				dstNumCurves += dst->paths[pathi].numCurves;
 			}
 
-			SvgObject* modifiedSrcObject = (SvgObject*)g_memory_allocate(sizeof(SvgObject));
-			SvgObject* modifiedDstObject = (SvgObject*)g_memory_allocate(sizeof(SvgObject));
-			*modifiedSrcObject = Svg::createDefault();
-			*modifiedDstObject = Svg::createDefault();
+			// The split copies only exist until the result is built, so they come out of the
+			// FrameArena instead of hitting the heap for every path and curve array
+			SvgObject* modifiedSrcObject = createFrameTemporary();
+			SvgObject* modifiedDstObject = createFrameTemporary();
 
 			const SvgObject* splitObj = srcNumCurves < dstNumCurves
 				? src
@@ -1108,11 +1258,7 @@ namespace MathAnim
 
 			res->finalize();
 
-			// Free temporary memory
-			modifiedSrcObject->free();
-			modifiedDstObject->free();
-			g_memory_free(modifiedSrcObject);
-			g_memory_free(modifiedDstObject);
+			// Temporary memory is released with the rest of the FrameArena at the end of the frame
 			modifiedSrcObject = nullptr;
 			modifiedDstObject = nullptr;
 
@@ -1125,10 +1271,58 @@ namespace MathAnim
 			if (path.numCurves > path.maxCapacity)
 			{
 				path.maxCapacity *= 2;
-				path.curves = (Curve*)g_memory_realloc(path.curves, sizeof(Curve) * path.maxCapacity);
+				path.curves = (Curve*)reallocGeometry(path.curves, sizeof(Curve) * (path.maxCapacity / 2), sizeof(Curve) * path.maxCapacity, alignof(Curve));
 				g_logger_assert(path.curves != nullptr, "Ran out of RAM.");
+				if (!FrameArena::owns(path.curves))
+				{
+					MemoryTracker::recordReallocation(MemoryTag::SvgCurves, sizeof(Curve) * (path.maxCapacity / 2), sizeof(Curve) * path.maxCapacity);
+				}
 			}
 		}
+
+		static void reserveCurves(Path& path, int numCurves)
+		{
+			if (numCurves > path.maxCapacity)
+			{
+				int oldMaxCapacity = path.maxCapacity;
+				path.maxCapacity = glm::max(path.maxCapacity * 2, numCurves);
+				path.curves = (Curve*)reallocGeometry(path.curves, sizeof(Curve) * oldMaxCapacity, sizeof(Curve) * path.maxCapacity, alignof(Curve));
+				g_logger_assert(path.curves != nullptr, "Ran out of RAM.");
+				if (!FrameArena::owns(path.curves))
+				{
+					MemoryTracker::recordReallocation(MemoryTag::SvgCurves, sizeof(Curve) * oldMaxCapacity, sizeof(Curve) * path.maxCapacity);
+				}
+			}
+		}
+
+		static void copyProperties(SvgObject* dest, const SvgObject* src)
+		{
+			dest->fillType = src->fillType;
+			dest->fillColor = src->fillColor;
+			dest->approximatePerimeter = src->approximatePerimeter;
+			dest->bbox = src->bbox;
+			dest->glyphId = src->glyphId;
+		}
+
+		static SvgObject* createFrameTemporary()
+		{
+			SvgObject* res = (SvgObject*)FrameArena::allocate(sizeof(SvgObject), alignof(SvgObject));
+			*res = {};
+			res->paths = (Path*)FrameArena::allocate(sizeof(Path), alignof(Path));
+			res->fillColor = Vec4{ 1, 1, 1, 1 };
+			res->fillType = FillType::NonZeroFillType;
+			return res;
+		}
+
+		static void* reallocGeometry(void* ptr, size_t oldNumBytes, size_t newNumBytes, size_t alignment)
+		{
+			if (FrameArena::owns(ptr))
+			{
+				return FrameArena::reallocate(ptr, oldNumBytes, newNumBytes, alignment);
+			}
+
+			return g_memory_realloc(ptr, newNumBytes);
+		}
 	}
 
 	struct RenderAsyncData
@@ -1139,6 +1333,7 @@ namespace MathAnim
 		const SvgObject* obj;
 		plutovg_surface_t* surface;
 		plutovg_t* pluto;
+		uint64 diskCacheKey;
 	};
 
 	// ----------------- SvgObject functions -----------------
@@ -1152,6 +1347,8 @@ namespace MathAnim
 
 	void SvgObject::normalize()
 	{
+		makeUnique();
+
 		// First find the min max of the entire curve
 		Vec2 min = { FLT_MAX, FLT_MAX };
 		Vec2 max = { FLT_MIN, FLT_MIN };
@@ -1344,14 +1541,13 @@ namespace MathAnim
 			res.type = CurveType::Bezier3;
 
 			const Vec2& p1 = as.bezier2.p1;
-			const Vec2& p2 = as.bezier2.p1;
-			const Vec2& p3 = as.bezier2.p2;
+			const Vec2& p2 = as.bezier2.p2;
 
 			// Degree elevated quadratic bezier curve
 			Vec2 pr0 = p0;
 			Vec2 pr1 = (1.0f / 3.0f) * p0 + (2.0f / 3.0f) * p1;
 			Vec2 pr2 = (2.0f / 3.0f) * p1 + (1.0f / 3.0f) * p2;
-			Vec2 pr3 = p3;
+			Vec2 pr3 = p2;
 
 			// Interpolate the curve
 			// Taken from https://stackoverflow.com/questions/878862/drawing-part-of-a-b%C3%A9zier-curve-by-reusing-a-basic-b%C3%A9zier-curve-function
@@ -1397,6 +1593,119 @@ namespace MathAnim
 		return res;
 	}
 
+	Vec2 Curve::evaluate(float t) const
+	{
+		switch (type)
+		{
+		case CurveType::Bezier3:
+			return CMath::bezier3(p0, as.bezier3.p1, as.bezier3.p2, as.bezier3.p3, t);
+		case CurveType::Bezier2:
+			return CMath::bezier2(p0, as.bezier2.p1, as.bezier2.p2, t);
+		case CurveType::Line:
+			return CMath::bezier1(p0, as.line.p1, t);
+		case CurveType::None:
+			break;
+		}
+
+		return p0;
+	}
+
+	// ----------------- ArcLengthLut functions -----------------
+	void ArcLengthLut::addCurve(const Curve& curve)
+	{
+		if (numCurves >= maxCapacity)
+		{
+			maxCapacity = glm::max(maxCapacity * 2, 8);
+			lengths = (float*)g_memory_realloc(lengths, sizeof(float) * samplesPerCurve * maxCapacity);
+			g_logger_assert(lengths != nullptr, "Ran out of RAM.");
+		}
+
+		float length = getTotalLength();
+		float* curveLengths = lengths + numCurves * samplesPerCurve;
+		if (curve.type == CurveType::Line)
+		{
+			// Lines are already parameterized by length
+			float lineLength = CMath::length(curve.as.line.p1 - curve.p0);
+			for (int samplei = 0; samplei < samplesPerCurve; samplei++)
+			{
+				curveLengths[samplei] = length + lineLength * (float)(samplei + 1) / (float)samplesPerCurve;
+			}
+		}
+		else
+		{
+			Vec2 lastPoint = curve.p0;
+			for (int samplei = 0; samplei < samplesPerCurve; samplei++)
+			{
+				Vec2 point = curve.evaluate((float)(samplei + 1) / (float)samplesPerCurve);
+				length += CMath::length(point - lastPoint);
+				curveLengths[samplei] = length;
+				lastPoint = point;
+			}
+		}
+
+		numCurves++;
+	}
+
+	float ArcLengthLut::getTotalLength() const
+	{
+		return numCurves > 0
+			? lengths[numCurves * samplesPerCurve - 1]
+			: 0.0f;
+	}
+
+	int ArcLengthLut::find(float length, float* outT) const
+	{
+		if (numCurves == 0)
+		{
+			*outT = 0.0f;
+			return 0;
+		}
+
+		const float* end = lengths + numCurves * samplesPerCurve;
+		const float* sample = std::lower_bound(lengths, end, length);
+		if (sample == end)
+		{
+			*outT = 1.0f;
+			return numCurves - 1;
+		}
+
+		int index = (int)(sample - lengths);
+		int curvei = index / samplesPerCurve;
+		int samplei = index % samplesPerCurve;
+
+		// Linearly interpolate t between the two samples surrounding length
+		float prevLength = index > 0 ? lengths[index - 1] : 0.0f;
+		float sampleLength = *sample - prevLength;
+		float fraction = sampleLength > 0.0f
+			? glm::clamp((length - prevLength) / sampleLength, 0.0f, 1.0f)
+			: 1.0f;
+		*outT = ((float)samplei + fraction) / (float)samplesPerCurve;
+		return curvei;
+	}
+
+	void ArcLengthLut::free()
+	{
+		if (lengths)
+		{
+			g_memory_free(lengths);
+		}
+
+		lengths = nullptr;
+		numCurves = 0;
+		maxCapacity = 0;
+	}
+
+	ArcLengthLut ArcLengthLut::create(int numCurvesToReserve)
+	{
+		ArcLengthLut res;
+		res.numCurves = 0;
+		res.maxCapacity = glm::max(numCurvesToReserve, 0);
+		res.lengths = res.maxCapacity > 0
+			? (float*)g_memory_allocate(sizeof(float) * samplesPerCurve * res.maxCapacity)
+			: nullptr;
+		return res;
+	}
+
 	float Path::calculateApproximatePerimeter() const
 	{
 		float approxPerimeter = 0.0f;
@@ -1467,11 +1776,13 @@ namespace MathAnim
 
 	void SvgObject::calculateMd5()
 	{
+		makeUnique();
+
 		std::string pathAsStr = getPathAsString();
 		std::string md5Str = Platform::md5FromString(pathAsStr);
 
 		md5Length = md5Str.length();
-		md5 = (uint8*)g_memory_allocate(sizeof(uint8) * (md5Length + 1));
+		md5 = (uint8*)g_memory_realloc(md5, sizeof(uint8) * (md5Length + 1));
 		g_memory_copyMem(md5, (void*)md5Str.c_str(), sizeof(uint8) * md5Length);
 		md5[md5Length] = '\0';
 	}
@@ -1572,7 +1883,7 @@ namespace MathAnim
 		return 0.0f;
 	}
 
-	void SvgObject::render(float svgScale, const Texture& texture, const Vec2& textureOffset) const
+	void SvgObject::render(float svgScale, const Texture& texture, const Vec2& textureOffset, uint64 diskCacheKey) const
 	{
 		MP_PROFILE_EVENT("Svg_RenderWithPluto");
 		Vec2 bboxSize = (bbox.max - bbox.min) * svgScale;
@@ -1597,20 +1908,28 @@ namespace MathAnim
 				surfaceWidth * surfaceHeight * sizeof(uint8) * 4,
 				true
 			);
+
+			if (diskCacheKey != 0)
+			{
+				SvgDiskCache::storeTile(diskCacheKey, surfaceWidth, surfaceHeight, pixels);
+			}
 		}
 
 		plutovg_surface_destroy(surface);
 		plutovg_destroy(pluto);
 	}
 
-	void SvgObject::renderAsync(float svgScale, const Texture& texture, const Vec2& textureOffset) const
+	void SvgObject::renderAsync(float svgScale, const Texture& texture, const Vec2& textureOffset, uint64 diskCacheKey) const
 	{
 		RenderAsyncData* data = (RenderAsyncData*)g_memory_allocate(sizeof(RenderAsyncData));
 		*data = RenderAsyncData{
 			svgScale,
 			&texture,
 			textureOffset,
-			this
+			this,
+			nullptr,
+			nullptr,
+			diskCacheKey
 		};
 		Application::threadPool()->queueTask(
 			rasterizeAsyncCallback,
@@ -1627,19 +1946,134 @@ namespace MathAnim
 		renderOutline2D(t, parent, this);
 	}
 
-	void SvgObject::free()
+	void SvgObject::makeShared()
+	{
+		if (!sharedRefCount)
+		{
+			sharedRefCount = (std::atomic<uint32>*)g_memory_allocate(sizeof(std::atomic<uint32>));
+			new(sharedRefCount)std::atomic<uint32>(1);
+		}
+	}
+
+	void SvgObject::makeUnique()
 	{
+		arcLengthLut.free();
+		glyphId = 0;
+
+		if (!sharedRefCount)
+		{
+			return;
+		}
+
+		// Nobody can add a reference without holding one, so if ours is the
+		// only one left it stays that way
+		if (sharedRefCount->load(std::memory_order_acquire) == 1)
+		{
+			// Last reference, the geometry is already ours
+			g_memory_free(sharedRefCount);
+			sharedRefCount = nullptr;
+			return;
+		}
+
+		Path* uniquePaths = (Path*)g_memory_allocate(sizeof(Path) * glm::max(numPaths, 1));
 		for (int pathi = 0; pathi < numPaths; pathi++)
+		{
+			const Path& sharedPath = paths[pathi];
+			uniquePaths[pathi] = sharedPath;
+			uniquePaths[pathi].maxCapacity = glm::max(sharedPath.numCurves, 1);
+			uniquePaths[pathi].curves = (Curve*)g_memory_allocate(sizeof(Curve) * uniquePaths[pathi].maxCapacity);
+			MemoryTracker::recordAllocation(MemoryTag::SvgCurves, sizeof(Curve) * uniquePaths[pathi].maxCapacity);
+			g_memory_copyMem(uniquePaths[pathi].curves, sharedPath.curves, sizeof(Curve) * sharedPath.numCurves);
+		}
+
+		uint8* uniqueMd5 = nullptr;
+		if (md5)
+		{
+			uniqueMd5 = (uint8*)g_memory_allocate(sizeof(uint8) * (md5Length + 1));
+			g_memory_copyMem(uniqueMd5, md5, sizeof(uint8) * (md5Length + 1));
+		}
+
+		if (sharedRefCount->fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			// Every other reference was released while we were copying, so nobody
+			// else is left to free the old geometry
+			SvgObject orphan = Svg::createDefault();
+			g_memory_free(orphan.paths);
+			orphan.paths = paths;
+			orphan.numPaths = numPaths;
+			orphan.md5 = md5;
+			orphan.md5Length = md5Length;
+			orphan.free();
+
+			g_memory_free(sharedRefCount);
+		}
+
+		sharedRefCount = nullptr;
+		paths = uniquePaths;
+		md5 = uniqueMd5;
+	}
+
+	const ArcLengthLut& SvgObject::getArcLengthLut() const
+	{
+		if (arcLengthLut.isEmpty())
+		{
+			int numCurves = 0;
+			for (int pathi = 0; pathi < numPaths; pathi++)
+			{
+				numCurves += paths[pathi].numCurves;
+			}
+
+			arcLengthLut.free();
+			arcLengthLut = ArcLengthLut::create(numCurves);
+			for (int pathi = 0; pathi < numPaths; pathi++)
+			{
+				for (int curvei = 0; curvei < paths[pathi].numCurves; curvei++)
+				{
+					arcLengthLut.addCurve(paths[pathi].curves[curvei]);
+				}
+			}
+		}
+
+		return arcLengthLut;
+	}
+
+	void SvgObject::free()
+	{
+		arcLengthLut.free();
+		glyphId = 0;
+
+		if (sharedRefCount)
+		{
+			if (sharedRefCount->fetch_sub(1, std::memory_order_acq_rel) > 1)
+			{
+				// Someone else still uses the geometry, just forget about it
+				sharedRefCount = nullptr;
+				md5 = nullptr;
+				md5Length = 0;
+				paths = nullptr;
+				numPaths = 0;
+				approximatePerimeter = 0.0f;
+				return;
+			}
+
+			g_memory_free(sharedRefCount);
+			sharedRefCount = nullptr;
+		}
+
+		// Frame temporaries get released all at once by FrameArena::reset
+		bool isFrameTemporary = paths && FrameArena::owns(paths);
+		for (int pathi = 0; pathi < numPaths && !isFrameTemporary; pathi++)
 		{
 			if (paths[pathi].curves)
 			{
+				MemoryTracker::recordFree(MemoryTag::SvgCurves, sizeof(Curve) * paths[pathi].maxCapacity);
 				g_memory_free(paths[pathi].curves);
 			}
 			paths[pathi].numCurves = 0;
 			paths[pathi].maxCapacity = 0;
 		}
 
-		if (paths)
+		if (paths && !isFrameTemporary)
 		{
 			g_memory_free(paths);
 		}
@@ -1656,13 +2090,26 @@ namespace MathAnim
 		approximatePerimeter = 0.0f;
 	}
 
-	void SvgObject::serialize(nlohmann::json& memory) const
+	void SvgObject::serialize(nlohmann::json& memory, bool writePath) const
 	{
 		SERIALIZE_VEC(memory, this, fillColor);
 		SERIALIZE_ENUM(memory, this, fillType, _fillTypeNames);
-		// TODO: This is not type-checked. Add 'path' as a property to SVGs or 
-		// a filepath or something to make this type-safe
-		SERIALIZE_VALUE_INLINE(memory, path, getPathAsString());
+		if (writePath)
+		{
+			// TODO: This is not type-checked. Add 'path' as a property to SVGs or 
+			// a filepath or something to make this type-safe
+			SERIALIZE_VALUE_INLINE(memory, path, getPathAsString());
+		}
+	}
+
+	void SvgObject::serializeCurves(nlohmann::json& j) const
+	{
+		RawMemory memory;
+		memory.init(sizeof(Curve) * 8);
+		serializeGeometry(memory);
+
+		j["curves"] = nlohmann::json::binary_t(std::vector<uint8>(memory.data, memory.data + memory.offset));
+		memory.free();
 	}
 
 	SvgObject* SvgObject::deserialize(const nlohmann::json& j, uint32 version)
@@ -1676,13 +2123,35 @@ namespace MathAnim
 
 			DESERIALIZE_ENUM(res, fillType, _fillTypeNames, FillType, j);
 			DESERIALIZE_VEC4(res, fillColor, j, "#e303fc"_hex);
+			if (j.contains("curves") && j["curves"].is_binary())
+			{
+				// Binary scene files store the curves directly
+				const nlohmann::json::binary_t& curves = j["curves"].get_binary();
+				RawMemory memory = { (uint8*)curves.data(), curves.size(), 0 };
+				if (!deserializeGeometry(memory, res))
+				{
+					g_logger_error("Error deserializing SVG. Bad curve data.");
+					*res = Svg::createDefault();
+				}
+
+				return res;
+			}
+
 			const std::string& pathStr = DESERIALIZE_VALUE_INLINE(j, path, "");
 
 			if (pathStr.size() > 0)
 			{
-				if (!SvgParser::parseSvgPath((const char*)pathStr.c_str(), pathStr.length(), res))
+				uint64 diskCacheKey = SvgDiskCache::hashSvgPath(pathStr.c_str(), pathStr.length());
+				if (!SvgDiskCache::loadSvg(diskCacheKey, res))
 				{
-					g_logger_error("Error deserializing SVG. Bad path data: '{}'", pathStr);
+					if (SvgParser::parseSvgPath((const char*)pathStr.c_str(), pathStr.length(), res))
+					{
+						SvgDiskCache::storeSvg(diskCacheKey, *res);
+					}
+					else
+					{
+						g_logger_error("Error deserializing SVG. Bad path data: '{}'", pathStr);
+					}
 				}
 			}
 			else
@@ -1701,6 +2170,101 @@ namespace MathAnim
 		return nullptr;
 	}
 
+	void SvgObject::serializeGeometry(RawMemory& memory) const
+	{
+		// Geometry looks like
+		// bbox                 -> Vec2[2]
+		// approximatePerimeter -> float
+		// md5Length            -> uint32
+		// md5                  -> uint8[md5Length]
+		// numPaths             -> uint32
+		// paths                -> Path[numPaths]
+		//
+		// Each path looks like
+		// isHole               -> uint8
+		// numCurves            -> uint32
+		// curves               -> Curve[numCurves]
+		memory.write<Vec2>(&bbox.min);
+		memory.write<Vec2>(&bbox.max);
+		memory.write<float>(&approximatePerimeter);
+		uint32 md5LengthU32 = (uint32)md5Length;
+		memory.write<uint32>(&md5LengthU32);
+		if (md5LengthU32 > 0)
+		{
+			memory.writeDangerous(md5, md5LengthU32);
+		}
+
+		uint32 numPathsU32 = (uint32)numPaths;
+		memory.write<uint32>(&numPathsU32);
+		for (int pathi = 0; pathi < numPaths; pathi++)
+		{
+			const Path& path = paths[pathi];
+			uint8 isHole = path.isHole ? 1 : 0;
+			uint32 numCurves = (uint32)path.numCurves;
+			memory.write<uint8>(&isHole);
+			memory.write<uint32>(&numCurves);
+			memory.writeDangerous((const uint8*)path.curves, sizeof(Curve) * numCurves);
+		}
+	}
+
+	bool SvgObject::deserializeGeometry(RawMemory& memory, SvgObject* output)
+	{
+		static_assert(std::is_trivially_copyable<Curve>(), "Curves must be trivially copyable to be serialized as raw memory.");
+
+		SvgObject res = Svg::createDefault();
+		uint32 md5Length = 0;
+		uint32 numPaths = 0;
+		bool success = memory.read<Vec2>(&res.bbox.min);
+		success = success && memory.read<Vec2>(&res.bbox.max);
+		success = success && memory.read<float>(&res.approximatePerimeter);
+		success = success && memory.read<uint32>(&md5Length);
+		if (success && md5Length > 0)
+		{
+			res.md5 = (uint8*)g_memory_allocate(sizeof(uint8) * (md5Length + 1));
+			success = memory.readDangerous(res.md5, md5Length);
+			res.md5[md5Length] = '\0';
+			res.md5Length = md5Length;
+		}
+		success = success && memory.read<uint32>(&numPaths);
+
+		if (success && numPaths > 0)
+		{
+			res.paths = (Path*)g_memory_realloc(res.paths, sizeof(Path) * numPaths);
+			for (uint32 pathi = 0; pathi < numPaths; pathi++)
+			{
+				Path& path = res.paths[pathi];
+				uint8 isHole = 0;
+				uint32 numCurves = 0;
+				success = success && memory.read<uint8>(&isHole);
+				success = success && memory.read<uint32>(&numCurves);
+
+				// Always allocate at least one curve so the path can be grown with realloc later
+				path.isHole = isHole != 0;
+				path.maxCapacity = glm::max((int)numCurves, 1);
+				path.curves = (Curve*)g_memory_allocate(sizeof(Curve) * path.maxCapacity);
+				MemoryTracker::recordAllocation(MemoryTag::SvgCurves, sizeof(Curve) * path.maxCapacity);
+				path.numCurves = 0;
+				res.numPaths++;
+
+				if (success)
+				{
+					success = memory.readDangerous((uint8*)path.curves, sizeof(Curve) * numCurves);
+					path.numCurves = success ? (int)numCurves : 0;
+				}
+			}
+		}
+
+		if (!success)
+		{
+			g_logger_error("Corrupted SVG geometry data.");
+			res.free();
+			return false;
+		}
+
+		*output = res;
+		return true;
+	}
+
 	SvgObject* SvgObject::legacy_deserialize(RawMemory& memory, uint32 version)
 	{
 		if (version == 1)
@@ -1909,6 +2473,76 @@ namespace MathAnim
 		uniqueObjectNames = nullptr;
 	}
 
+	void SvgGroup::serializeGeometry(RawMemory& memory) const
+	{
+		// Geometry looks like
+		// bbox                 -> Vec2[2]
+		// numObjects           -> uint32
+		// objects              -> GroupObject[numObjects]
+		//
+		// Each group object looks like
+		// offset               -> Vec2
+		// fillColor            -> Vec4
+		// fillType             -> uint8
+		// geometry             -> SvgObject geometry
+		memory.write<Vec2>(&bbox.min);
+		memory.write<Vec2>(&bbox.max);
+		uint32 numObjectsU32 = (uint32)numObjects;
+		memory.write<uint32>(&numObjectsU32);
+		for (int i = 0; i < numObjects; i++)
+		{
+			uint8 fillTypeU8 = (uint8)objects[i].fillType;
+			memory.write<Vec2>(&objectOffsets[i]);
+			memory.write<Vec4>(&objects[i].fillColor);
+			memory.write<uint8>(&fillTypeU8);
+			objects[i].serializeGeometry(memory);
+		}
+	}
+
+	bool SvgGroup::deserializeGeometry(RawMemory& memory, SvgGroup* output)
+	{
+		SvgGroup res = Svg::createDefaultGroup();
+		uint32 numObjectsU32 = 0;
+		bool success = memory.read<Vec2>(&res.bbox.min);
+		success = success && memory.read<Vec2>(&res.bbox.max);
+		success = success && memory.read<uint32>(&numObjectsU32);
+
+		if (success && numObjectsU32 > 0)
+		{
+			res.objects = (SvgObject*)g_memory_realloc(res.objects, sizeof(SvgObject) * numObjectsU32);
+			g_logger_assert(res.objects != nullptr, "Ran out of RAM.");
+			res.objectOffsets = (Vec2*)g_memory_realloc(res.objectOffsets, sizeof(Vec2) * numObjectsU32);
+			g_logger_assert(res.objectOffsets != nullptr, "Ran out of RAM.");
+
+			for (uint32 i = 0; i < numObjectsU32 && success; i++)
+			{
+				Vec4 fillColor;
+				uint8 fillTypeU8 = 0;
+				success = memory.read<Vec2>(&res.objectOffsets[i]);
+				success = success && memory.read<Vec4>(&fillColor);
+				success = success && memory.read<uint8>(&fillTypeU8);
+				success = success && fillTypeU8 < (uint8)FillType::Length;
+				success = success && SvgObject::deserializeGeometry(memory, &res.objects[i]);
+				if (success)
+				{
+					res.objects[i].fillColor = fillColor;
+					res.objects[i].fillType = (FillType)fillTypeU8;
+					res.numObjects++;
+				}
+			}
+		}
+
+		if (!success)
+		{
+			g_logger_error("Corrupted SVG group geometry data.");
+			res.free();
+			return false;
+		}
+
+		*output = res;
+		return true;
+	}
+
 	// ------------------- Svg Object Internal functions -------------------
 	static void rasterizeAsyncCallback(void* renderAsyncData, size_t dataSize)
 	{
@@ -1948,6 +2582,11 @@ namespace MathAnim
 			true
 		);
 
+		if (data->diskCacheKey != 0)
+		{
+			SvgDiskCache::storeTile(data->diskCacheKey, surfaceWidth, surfaceHeight, pixels);
+		}
+
 		plutovg_surface_destroy(data->surface);
 		plutovg_destroy(data->pluto);
 
@@ -2080,24 +2719,38 @@ namespace MathAnim
 		MP_PROFILE_EVENT("Svg_RenderOutline2D");
 		constexpr float defaultStrokeWidth = 0.02f;
 
-		// Start the fade in after 80% of the svg object is drawn
-		float lengthToDraw = t * (float)obj->approximatePerimeter;
+		const ArcLengthLut& arcLengthLut = obj->getArcLengthLut();
+		float lengthToDraw = t * arcLengthLut.getTotalLength();
 		Vec2 svgSize = obj->bbox.max - obj->bbox.min;
 
 		Vec2 inXRange = Vec2{ obj->bbox.min.x, obj->bbox.max.x };
 		Vec2 inYRange = Vec2{ obj->bbox.min.y, obj->bbox.max.y };
 		Vec2 outXRange = Vec2{ -svgSize.x / 2.0f, svgSize.x / 2.0f };
 		Vec2 outYRange = Vec2{ svgSize.y / 2.0f, -svgSize.y / 2.0f };
+		auto mapPoint = [&](const Vec2& point)
+		{
+			return Vec2{
+				CMath::mapRange(inXRange, outXRange, point.x),
+				CMath::mapRange(inYRange, outYRange, point.y)
+			};
+		};
 
 		if (lengthToDraw > 0 && obj->numPaths > 0)
 		{
 			MP_PROFILE_EVENT("Svg_RenderOutline2D_GeneratePath2D");
-			float lengthDrawn = 0.0f;
+
+			// Everything up to endCurve gets drawn, endCurve itself only up to endCurveT
+			float endCurveT = 1.0f;
+			int endCurve = arcLengthLut.find(lengthToDraw, &endCurveT);
+			bool isPartial = t < 1.0f;
+			int curveOffset = 0;
 
 			for (int pathi = 0; pathi < obj->numPaths; pathi++)
 			{
-				Path2DContext* context = nullptr;
-				if (obj->paths[pathi].numCurves > 0)
+				const Path& path = obj->paths[pathi];
+				bool pathEndsHere = isPartial && endCurve < curveOffset + path.numCurves;
+
+				if (path.numCurves > 0)
 				{
 					Renderer::pushColor(parent->strokeColor);
 					if (glm::epsilonEqual(parent->strokeWidth, 0.0f, 0.01f))
@@ -2109,182 +2762,44 @@ namespace MathAnim
 						Renderer::pushStrokeWidth(parent->strokeWidth);
 					}
 
-					{
-						Vec2 p0 = obj->paths[pathi].curves[0].p0;
-
-						p0.x = CMath::mapRange(inXRange, outXRange, p0.x);
-						p0.y = CMath::mapRange(inYRange, outYRange, p0.y);
-
-						context = Renderer::beginPath(Vec2{ p0.x, p0.y }, parent->globalTransform);
-					}
+					Path2DContext* context = Renderer::beginPath(mapPoint(path.curves[0].p0), parent->globalTransform);
 					g_logger_assert(context != nullptr, "We have bigger problems.");
 
-					for (int curvei = 0; curvei < obj->paths[pathi].numCurves; curvei++)
+					for (int curvei = 0; curvei < path.numCurves; curvei++)
 					{
-						float lengthLeft = lengthToDraw - lengthDrawn;
-						if (lengthLeft < 0.0f)
+						int globalCurvei = curveOffset + curvei;
+						if (isPartial && globalCurvei > endCurve)
 						{
 							break;
 						}
 
-						const Curve& curve = obj->paths[pathi].curves[curvei];
-						Vec2 p0 = curve.p0;
+						Curve curve = isPartial && globalCurvei == endCurve
+							? path.curves[curvei].split(0.0f, endCurveT)
+							: path.curves[curvei];
 
 						switch (curve.type)
 						{
 						case CurveType::Bezier3:
-						{
-							Vec2 p1 = curve.as.bezier3.p1;
-							Vec2 p2 = curve.as.bezier3.p2;
-							Vec2 p3 = curve.as.bezier3.p3;
-
-							float chordLength = CMath::length(p3 - p0);
-							float controlNetLength = CMath::length(p1 - p0) + CMath::length(p2 - p1) + CMath::length(p3 - p2);
-							float approxLength = (chordLength + controlNetLength) / 2.0f;
-							lengthDrawn += approxLength;
-
-							if (lengthLeft < approxLength)
-							{
-								// Interpolate the curve
-								float percentOfCurveToDraw = lengthLeft / approxLength;
-
-								// Taken from https://stackoverflow.com/questions/878862/drawing-part-of-a-b%C3%A9zier-curve-by-reusing-a-basic-b%C3%A9zier-curve-function
-								float t0 = 0.0f;
-								float t1 = percentOfCurveToDraw;
-								float u0 = 1.0f;
-								float u1 = (1.0f - t1);
-
-								Vec2 q0 = ((u0 * u0 * u0) * p0) +
-									((t0 * u0 * u0 + u0 * t0 * u0 + u0 * u0 * t0) * p1) +
-									((t0 * t0 * u0 + u0 * t0 * t0 + t0 * u0 * t0) * p2) +
-									((t0 * t0 * t0) * p3);
-								Vec2 q1 = ((u0 * u0 * u1) * p0) +
-									((t0 * u0 * u1 + u0 * t0 * u1 + u0 * u0 * t1) * p1) +
-									((t0 * t0 * u1 + u0 * t0 * t1 + t0 * u0 * t1) * p2) +
-									((t0 * t0 * t1) * p3);
-								Vec2 q2 = ((u0 * u1 * u1) * p0) +
-									((t0 * u1 * u1 + u0 * t1 * u1 + u0 * u1 * t1) * p1) +
-									((t0 * t1 * u1 + u0 * t1 * t1 + t0 * u1 * t1) * p2) +
-									((t0 * t1 * t1) * p3);
-								Vec2 q3 = ((u1 * u1 * u1) * p0) +
-									((t1 * u1 * u1 + u1 * t1 * u1 + u1 * u1 * t1) * p1) +
-									((t1 * t1 * u1 + u1 * t1 * t1 + t1 * u1 * t1) * p2) +
-									((t1 * t1 * t1) * p3);
-
-								p1 = q1;
-								p2 = q2;
-								p3 = q3;
-							}
-
-							p1.x = CMath::mapRange(inXRange, outXRange, p1.x);
-							p1.y = CMath::mapRange(inYRange, outYRange, p1.y);
-
-							p2.x = CMath::mapRange(inXRange, outXRange, p2.x);
-							p2.y = CMath::mapRange(inYRange, outYRange, p2.y);
-
-							p3.x = CMath::mapRange(inXRange, outXRange, p3.x);
-							p3.y = CMath::mapRange(inYRange, outYRange, p3.y);
-
 							Renderer::cubicTo(
 								context,
-								p1,
-								p2,
-								p3
+								mapPoint(curve.as.bezier3.p1),
+								mapPoint(curve.as.bezier3.p2),
+								mapPoint(curve.as.bezier3.p3)
 							);
-						}
-						break;
+							break;
 						case CurveType::Bezier2:
-						{
-							Vec2 p1 = curve.as.bezier2.p1;
-							Vec2 p2 = curve.as.bezier2.p1;
-							Vec2 p3 = curve.as.bezier2.p2;
-
-							// Degree elevated quadratic bezier curve
-							Vec2 pr0 = p0;
-							Vec2 pr1 = (1.0f / 3.0f) * p0 + (2.0f / 3.0f) * p1;
-							Vec2 pr2 = (2.0f / 3.0f) * p1 + (1.0f / 3.0f) * p2;
-							Vec2 pr3 = p3;
-
-							float chordLength = CMath::length(pr3 - pr0);
-							float controlNetLength = CMath::length(pr1 - pr0) + CMath::length(pr2 - pr1) + CMath::length(pr3 - pr2);
-							float approxLength = (chordLength + controlNetLength) / 2.0f;
-							lengthDrawn += approxLength;
-
-							if (lengthLeft < approxLength)
-							{
-								// Interpolate the curve
-								float percentOfCurveToDraw = lengthLeft / approxLength;
-
-								p1 = (pr1 - pr0) * percentOfCurveToDraw + pr0;
-								p2 = (pr2 - pr1) * percentOfCurveToDraw + pr1;
-								p3 = (pr3 - pr2) * percentOfCurveToDraw + pr2;
-
-								// Taken from https://stackoverflow.com/questions/878862/drawing-part-of-a-bézier-curve-by-reusing-a-basic-bézier-curve-function
-								float t0 = 0.0f;
-								float t1 = percentOfCurveToDraw;
-								float u0 = 1.0f;
-								float u1 = (1.0f - t1);
-
-								Vec2 q0 = ((u0 * u0 * u0) * p0) +
-									((t0 * u0 * u0 + u0 * t0 * u0 + u0 * u0 * t0) * p1) +
-									((t0 * t0 * u0 + u0 * t0 * t0 + t0 * u0 * t0) * p2) +
-									((t0 * t0 * t0) * p3);
-								Vec2 q1 = ((u0 * u0 * u1) * p0) +
-									((t0 * u0 * u1 + u0 * t0 * u1 + u0 * u0 * t1) * p1) +
-									((t0 * t0 * u1 + u0 * t0 * t1 + t0 * u0 * t1) * p2) +
-									((t0 * t0 * t1) * p3);
-								Vec2 q2 = ((u0 * u1 * u1) * p0) +
-									((t0 * u1 * u1 + u0 * t1 * u1 + u0 * u1 * t1) * p1) +
-									((t0 * t1 * u1 + u0 * t1 * t1 + t0 * u1 * t1) * p2) +
-									((t0 * t1 * t1) * p3);
-								Vec2 q3 = ((u1 * u1 * u1) * p0) +
-									((t1 * u1 * u1 + u1 * t1 * u1 + u1 * u1 * t1) * p1) +
-									((t1 * t1 * u1 + u1 * t1 * t1 + t1 * u1 * t1) * p2) +
-									((t1 * t1 * t1) * p3);
-
-								pr1 = q1;
-								pr2 = q2;
-								pr3 = q3;
-							}
-
-							pr1.x = CMath::mapRange(inXRange, outXRange, pr1.x);
-							pr1.y = CMath::mapRange(inYRange, outYRange, pr1.y);
-
-							pr2.x = CMath::mapRange(inXRange, outXRange, pr2.x);
-							pr2.y = CMath::mapRange(inYRange, outYRange, pr2.y);
-
-							pr3.x = CMath::mapRange(inXRange, outXRange, pr3.x);
-							pr3.y = CMath::mapRange(inYRange, outYRange, pr3.y);
-
-							Renderer::cubicTo(
+							Renderer::quadTo(
 								context,
-								pr1,
-								pr2,
-								pr3
+								mapPoint(curve.as.bezier2.p1),
+								mapPoint(curve.as.bezier2.p2)
 							);
-						}
-						break;
+							break;
 						case CurveType::Line:
-						{
-							Vec2 p1 = curve.as.line.p1;
-							float curveLength = CMath::length(p1 - p0);
-							lengthDrawn += curveLength;
-
-							if (lengthLeft < curveLength)
-							{
-								float percentOfCurveToDraw = lengthLeft / curveLength;
-								p1 = ((p1 - p0) * percentOfCurveToDraw) + p0;
-							}
-
-							p1.x = CMath::mapRange(inXRange, outXRange, p1.x);
-							p1.y = CMath::mapRange(inYRange, outYRange, p1.y);
-
 							Renderer::lineTo(
 								context,
-								p1
+								mapPoint(curve.as.line.p1)
 							);
-						}
-						break;
+							break;
 						case CurveType::None:
 							break;
 						}
@@ -2292,31 +2807,22 @@ namespace MathAnim
 
 					Renderer::popStrokeWidth();
 					Renderer::popColor();
-				}
 
-				if (lengthDrawn >= lengthToDraw && t < 1.0f)
-				{
 					MP_PROFILE_EVENT("Svg_RenderOutline2D_EndPath");
-					if (!Renderer::endPath(context, false, parent->id))
+					if (!Renderer::endPath(context, !pathEndsHere, parent->id))
 					{
 #ifdef _DEBUG
 						g_logger_warning("Failed to end path for object: {}<{}>", parent->id, parent->name);
 #endif
 					}
 					Renderer::free(context);
-					break;
 				}
-				else
+
+				if (pathEndsHere)
 				{
-					MP_PROFILE_EVENT("Svg_RenderOutline2D_EndPath");
-					if (!Renderer::endPath(context, true, parent->id))
-					{
-#ifdef _DEBUG
-						g_logger_warning("Failed to end path for object: {}<{}>", parent->id, parent->name);
-#endif
-					}
-					Renderer::free(context);
+					break;
 				}
+				curveOffset += path.numCurves;
 			}
 		}
 	}
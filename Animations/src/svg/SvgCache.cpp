@@ -1,5 +1,6 @@
 #include "svg/SvgCache.h"
 #include "svg/Svg.h"
+#include "svg/SvgDiskCache.h"
 #include "animation/AnimationManager.h"
 #include "animation/Animation.h"
 #include "renderer/Texture.h"
@@ -7,6 +8,7 @@
 #include "renderer/GLApi.h"
 #include "math/CMath.h"
 #include "core/Profiling.h"
+#include "core/MemoryTracker.h"
 #include "editor/panels/ExportPanel.h"
 
 namespace MathAnim
@@ -28,17 +30,17 @@ namespace MathAnim
 	bool SvgCache::exists(AnimationManagerData* am, AnimObjId obj)
 	{
 		const AnimObject* animObj = AnimationManager::getObject(am, obj);
-		if (!animObj->svgObject || !animObj->svgObject->md5) return false;
+		if (!isCacheable(animObj->svgObject)) return false;
 
-		return existsInternal(hash(animObj->svgObject->md5, animObj->svgObject->md5Length, animObj->svgScale, animObj->percentReplacementTransformed));
+		return existsInternal(getKey(animObj, animObj->svgObject));
 	}
 
 	SvgCacheEntry SvgCache::get(AnimationManagerData* am, AnimObjId obj)
 	{
 		const AnimObject* animObj = AnimationManager::getObject(am, obj);
-		if (animObj->svgObject && animObj->svgObject->md5)
+		if (isCacheable(animObj->svgObject))
 		{
-			auto entry = getInternal(hash(animObj->svgObject->md5, animObj->svgObject->md5Length, animObj->svgScale, animObj->percentReplacementTransformed));
+			auto entry = getInternal(getKey(animObj, animObj->svgObject));
 			if (entry.has_value())
 			{
 				return SvgCacheEntry{
@@ -63,9 +65,18 @@ namespace MathAnim
 	{
 		MP_PROFILE_EVENT("SvgCache_GetOrCreateIfNotExists");
 		const AnimObject* animObj = AnimationManager::getObject(am, obj);
-		if (animObj->svgObject && animObj->svgObject->md5)
+		if (isCacheable(svg))
 		{
-			auto entry = getInternal(hash(animObj->svgObject->md5, animObj->svgObject->md5Length, animObj->svgScale, animObj->percentReplacementTransformed));
+			// Every letter of every text object comes through here each frame, so the
+			// key only gets computed once
+			uint64 key = getKey(animObj, svg);
+			auto entry = getInternal(key);
+			if (!entry.has_value())
+			{
+				putInternal(key, animObj, svg);
+				entry = getInternal(key);
+			}
+
 			if (entry.has_value())
 			{
 				return SvgCacheEntry{
@@ -76,14 +87,20 @@ namespace MathAnim
 			}
 		}
 
-		put(animObj, svg);
 		return get(am, obj);
 	}
 
 	void SvgCache::put(const AnimObject* parent, SvgObject* svg)
+	{
+		if (isCacheable(svg))
+		{
+			putInternal(getKey(parent, svg), parent, svg);
+		}
+	}
+
+	void SvgCache::putInternal(uint64 hashValue, const AnimObject* parent, SvgObject* svg)
 	{
 		MP_PROFILE_EVENT("SvgCache_Put");
-		uint64 hashValue = hash(svg->md5, svg->md5Length, parent->svgScale, parent->percentReplacementTransformed);
 
 		// Only add the SVG if it hasn't already been added
 		if (!existsInternal(hashValue))
@@ -208,14 +225,42 @@ namespace MathAnim
 
 			// Then begin the rasterization after we've updated the LRU cache
 
+			// Partially replaced SVGs change every frame, so only fully drawn
+			// SVGs are worth persisting to the disk cache
+			uint64 diskCacheKey = 0;
+			if (parent->percentReplacementTransformed == 0.0f && svg->md5Length > 0)
+			{
+				diskCacheKey = SvgDiskCache::hashTile(svg->md5, svg->md5Length, parent->svgScale);
+			}
+
+			const Texture& textureToRenderTo = framebuffer.getColorAttachment(colorAttachmentToRenderTo);
+			const uint8* cachedPixels = diskCacheKey != 0
+				? SvgDiskCache::loadTile(diskCacheKey, (int)svgTotalWidth, (int)svgTotalHeight)
+				: nullptr;
+			if (cachedPixels)
+			{
+				// This tile was rasterized in a previous session, skip pluto entirely
+				int tileWidth = (int)svgTotalWidth;
+				int tileHeight = (int)svgTotalHeight;
+				textureToRenderTo.uploadSubImage(
+					(int)svgTextureOffset.x,
+					(int)(textureToRenderTo.height - svgTextureOffset.y - tileHeight),
+					tileWidth,
+					tileHeight,
+					(uint8*)cachedPixels,
+					tileWidth * tileHeight * sizeof(uint8) * 4,
+					true
+				);
+			}
 			// If we're exporting video, frame drops don't matter and we want every frame
 			// exported to the encoder to be perfect
-			if (ExportPanel::isExportingVideo())
+			else if (ExportPanel::isExportingVideo())
 			{
 				svg->render(
 					parent->svgScale,
-					framebuffer.getColorAttachment(colorAttachmentToRenderTo),
-					svgTextureOffset
+					textureToRenderTo,
+					svgTextureOffset,
+					diskCacheKey
 				);
 			}
 			else
@@ -224,8 +269,9 @@ namespace MathAnim
 				// so we can dump it on a background thread and wait for the result
 				svg->renderAsync(
 					parent->svgScale,
-					framebuffer.getColorAttachment(colorAttachmentToRenderTo),
-					svgTextureOffset
+					textureToRenderTo,
+					svgTextureOffset,
+					diskCacheKey
 				);
 			}
 		}
@@ -361,6 +407,8 @@ namespace MathAnim
 			height = 4096;
 		}
 
+		MemoryTracker::ScopedTag memoryTag(MemoryTag::SvgCacheAtlas);
+
 		// Default the svg framebuffer cache to 1024x1024 and resize if necessary
 		Texture cacheTexture = TextureBuilder()
 			.setFormat(ByteFormat::RGBA8_UI)
@@ -381,6 +429,25 @@ namespace MathAnim
 		cachedSvgs = {};
 	}
 
+	bool SvgCache::isCacheable(const SvgObject* svg)
+	{
+		return svg && (svg->glyphId != 0 || svg->md5);
+	}
+
+	uint64 SvgCache::getKey(const AnimObject* parent, const SvgObject* svg)
+	{
+		// Unedited font glyphs all share one entry per glyph and scale no matter which text
+		// object they belong to. Their geometry is shared, so the id is enough to identify
+		// the pixels and there's no need to hash the path data.
+		if (svg->glyphId != 0 && parent->percentReplacementTransformed == 0.0f)
+		{
+			int roundedSvgScale = (int)(parent->svgScale * 1000.0f);
+			return CMath::combineHash<int>(roundedSvgScale, svg->glyphId);
+		}
+
+		return hash(svg->md5, svg->md5Length, parent->svgScale, parent->percentReplacementTransformed);
+	}
+
 	uint64 SvgCache::hash(const uint8* svgMd5, size_t svgMd5Length, float svgScale, float replacementTransform)
 	{
 		uint64 hash = 0;
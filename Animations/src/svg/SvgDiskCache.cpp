@@ -0,0 +1,692 @@
+#include "svg/SvgDiskCache.h"
+#include "svg/Svg.h"
+#include "renderer/Fonts.h"
+#include "platform/Platform.h"
+#include "math/CMath.h"
+#include "core/Application.h"
+#include "core/Profiling.h"
+#include "multithreading/GlobalThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace MathAnim
+{
+	// Each cache file is an append-only log that looks like
+	// magicNumber        -> uint32
+	// version            -> uint32
+	// records            -> (DiskCacheRecordHeader, uint8[header.size])[]
+	//
+	// If a key shows up more than once the last record wins.
+	struct DiskCacheRecordHeader
+	{
+		uint64 key;
+		uint64 size;
+		// Seconds since the epoch, as of the last time this record was written
+		uint64 lastUsed;
+	};
+
+	struct DiskCacheEntry
+	{
+		const uint8* data;
+		size_t size;
+		uint64 lastUsed;
+	};
+
+	// One memory-mapped cache file plus the entries added this session
+	struct DiskCacheStore
+	{
+		std::filesystem::path filepath;
+		MemMappedFile* mappedFile;
+		std::unordered_map<uint64, DiskCacheEntry> mappedEntries;
+		// Already appended to the file, but the mapping only gets refreshed
+		// after a compaction so these stay in memory until then
+		std::unordered_map<uint64, RawMemory> appendedEntries;
+		std::unordered_map<uint64, RawMemory> pendingEntries;
+		// Size of every live entry, on disk or not
+		size_t totalSize;
+		size_t maxSize;
+		// Bytes of valid records in the file
+		size_t fileSize;
+		// Set when the file can't be appended to as is, like when it ends in a
+		// partially written record
+		bool needsRewrite;
+
+		// While compacting the mapping and appended entries are read by the
+		// compaction job, so they can't be modified until it's swapped in
+		bool compacting;
+		bool compactionSucceeded;
+		std::vector<DiskCacheEntry> compactionEntries;
+		std::vector<uint64> compactionKeys;
+		JobCounter compactionCounter;
+	};
+
+	namespace SvgDiskCache
+	{
+		// Bump this whenever the layout of Curve, GlyphOutline or any of
+		// the records below changes. Old caches will be discarded.
+		static constexpr uint32 diskCacheVersion = 2;
+		static constexpr uint32 diskCacheMagicNumber = 0x5C6CAC4E;
+		static constexpr uint64 svgHashSeed = 0x9E3779B97F4A7C15ULL;
+		static constexpr uint64 glyphHashSeed = 0xC2B2AE3D27D4EB4FULL;
+		static constexpr uint64 tileHashSeed = 0x165667B19E3779F9ULL;
+		static constexpr size_t fileHeaderSize = sizeof(uint32) * 2;
+		// Compactions evict down to this fraction of maxSize so the next few
+		// flushes don't immediately trigger another one
+		static constexpr float compactionTargetRatio = 0.75f;
+
+		static bool initialized = false;
+		static uint64 sessionTime = 0;
+		static DiskCacheStore geometryStore;
+		static DiskCacheStore tileStore;
+
+		// ------------- Internal Functions -------------
+		static void openStore(DiskCacheStore& store, const std::filesystem::path& filepath, size_t maxSize);
+		static void mapStore(DiskCacheStore& store);
+		static void unmapStore(DiskCacheStore& store);
+		static void closeStore(DiskCacheStore& store);
+		static void appendPendingEntries(DiskCacheStore& store);
+		static void beginCompaction(DiskCacheStore& store);
+		static void writeCompactedStore(DiskCacheStore& store, const std::filesystem::path& tmpFilepath, size_t targetSize);
+		static void finishCompaction(DiskCacheStore& store);
+		static bool findEntry(DiskCacheStore& store, uint64 key, DiskCacheEntry* output);
+		static void addEntry(DiskCacheStore& store, uint64 key, RawMemory& memory);
+
+		void init(const std::filesystem::path& cacheDirectory)
+		{
+			g_logger_assert(!initialized, "SvgDiskCache initialized twice.");
+
+			sessionTime = (uint64)std::chrono::duration_cast<std::chrono::seconds>(
+				std::chrono::system_clock::now().time_since_epoch()
+			).count();
+
+			Platform::createDirIfNotExists(cacheDirectory.string().c_str());
+			openStore(geometryStore, cacheDirectory / "svgGeometry.bin", MB(256));
+			openStore(tileStore, cacheDirectory / "svgTiles.bin", MB(512));
+			initialized = true;
+
+			g_logger_info("Loaded SVG disk cache with '{}' geometry entries and '{}' tiles.", geometryStore.mappedEntries.size(), tileStore.mappedEntries.size());
+		}
+
+		uint64 hashSvgPath(const char* pathText, size_t pathTextLength)
+		{
+			return CMath::hashBytes(pathText, pathTextLength, svgHashSeed);
+		}
+
+		uint64 hashFont(const std::string& fontFilepath)
+		{
+			uint64 hash = CMath::hashBytes(fontFilepath.c_str(), fontFilepath.length(), glyphHashSeed);
+
+			std::error_code error;
+			auto lastWriteTime = std::filesystem::last_write_time(fontFilepath, error);
+			if (!error)
+			{
+				int64 timeCount = (int64)lastWriteTime.time_since_epoch().count();
+				hash = CMath::hashBytes(&timeCount, sizeof(int64), hash);
+			}
+
+			return hash;
+		}
+
+		uint64 hashGlyph(uint64 fontHash, uint32 codepoint)
+		{
+			return CMath::hashBytes(&codepoint, sizeof(uint32), fontHash);
+		}
+
+		uint64 hashTile(const uint8* svgMd5, size_t svgMd5Length, float svgScale)
+		{
+			uint64 hash = CMath::hashBytes(svgMd5, svgMd5Length, tileHashSeed);
+			// Only hash floating point numbers to 3 decimal places, same as SvgCache
+			int32 roundedSvgScale = (int32)(svgScale * 1000.0f);
+			return CMath::hashBytes(&roundedSvgScale, sizeof(int32), hash);
+		}
+
+		bool loadSvg(uint64 svgHash, SvgObject* output)
+		{
+			MP_PROFILE_EVENT("SvgDiskCache_LoadSvg");
+
+			DiskCacheEntry entry;
+			if (!findEntry(geometryStore, svgHash, &entry))
+			{
+				return false;
+			}
+
+			RawMemory memory = { (uint8*)entry.data, entry.size, 0 };
+			return SvgObject::deserializeGeometry(memory, output);
+		}
+
+		void storeSvg(uint64 svgHash, const SvgObject& svg)
+		{
+			if (!initialized)
+			{
+				return;
+			}
+
+			RawMemory memory;
+			memory.init(sizeof(uint32) * 4 + sizeof(Curve) * 8);
+			svg.serializeGeometry(memory);
+			addEntry(geometryStore, svgHash, memory);
+		}
+
+		bool loadGlyph(uint64 glyphHash, GlyphOutline* output)
+		{
+			MP_PROFILE_EVENT("SvgDiskCache_LoadGlyph");
+
+			DiskCacheEntry entry;
+			if (!findEntry(geometryStore, glyphHash, &entry))
+			{
+				return false;
+			}
+
+			// glyphMetrics     -> float[6]
+			// svg              -> SvgObject geometry
+			RawMemory memory = { (uint8*)entry.data, entry.size, 0 };
+			GlyphOutline res = {};
+			bool success = memory.read<float>(&res.advanceX);
+			success = success && memory.read<float>(&res.bearingX);
+			success = success && memory.read<float>(&res.bearingY);
+			success = success && memory.read<float>(&res.descentY);
+			success = success && memory.read<float>(&res.glyphWidth);
+			success = success && memory.read<float>(&res.glyphHeight);
+			if (!success)
+			{
+				return false;
+			}
+
+			res.svg = (SvgObject*)g_memory_allocate(sizeof(SvgObject));
+			if (!SvgObject::deserializeGeometry(memory, res.svg))
+			{
+				g_memory_free(res.svg);
+				return false;
+			}
+
+			*output = res;
+			return true;
+		}
+
+		void storeGlyph(uint64 glyphHash, const GlyphOutline& glyph)
+		{
+			if (!initialized || !glyph.svg)
+			{
+				return;
+			}
+
+			RawMemory memory;
+			memory.init(sizeof(float) * 6 + sizeof(Curve) * 8);
+			memory.write<float>(&glyph.advanceX);
+			memory.write<float>(&glyph.bearingX);
+			memory.write<float>(&glyph.bearingY);
+			memory.write<float>(&glyph.descentY);
+			memory.write<float>(&glyph.glyphWidth);
+			memory.write<float>(&glyph.glyphHeight);
+			glyph.svg->serializeGeometry(memory);
+			addEntry(geometryStore, glyphHash, memory);
+		}
+
+		const uint8* loadTile(uint64 tileHash, int width, int height)
+		{
+			MP_PROFILE_EVENT("SvgDiskCache_LoadTile");
+
+			// Each tile looks like
+			// width            -> uint32
+			// height           -> uint32
+			// pixels           -> uint8[width * height * 4]
+			DiskCacheEntry entry;
+			if (!findEntry(tileStore, tileHash, &entry))
+			{
+				return nullptr;
+			}
+
+			RawMemory memory = { (uint8*)entry.data, entry.size, 0 };
+			uint32 tileWidth, tileHeight;
+			if (!memory.read<uint32>(&tileWidth) || !memory.read<uint32>(&tileHeight))
+			{
+				return nullptr;
+			}
+
+			if (tileWidth != (uint32)width || tileHeight != (uint32)height)
+			{
+				return nullptr;
+			}
+
+			size_t pixelsSize = sizeof(uint8) * 4 * tileWidth * tileHeight;
+			if (memory.offset + pixelsSize > memory.size)
+			{
+				g_logger_error("Corrupted SVG tile cache entry '{:#018x}'.", tileHash);
+				return nullptr;
+			}
+
+			return memory.data + memory.offset;
+		}
+
+		void storeTile(uint64 tileHash, int width, int height, const uint8* pixels)
+		{
+			if (!initialized || width <= 0 || height <= 0)
+			{
+				return;
+			}
+
+			size_t pixelsSize = sizeof(uint8) * 4 * width * height;
+			uint32 tileWidth = (uint32)width;
+			uint32 tileHeight = (uint32)height;
+			RawMemory memory;
+			memory.init(sizeof(uint32) * 2 + pixelsSize);
+			memory.write<uint32>(&tileWidth);
+			memory.write<uint32>(&tileHeight);
+			memory.writeDangerous(pixels, pixelsSize);
+			addEntry(tileStore, tileHash, memory);
+		}
+
+		void flush()
+		{
+			if (!initialized)
+			{
+				return;
+			}
+
+			MP_PROFILE_EVENT("SvgDiskCache_Flush");
+			for (DiskCacheStore* store : { &geometryStore, &tileStore })
+			{
+				// The file gets swapped out from under the appends once the
+				// compaction finishes, so hold them until then
+				if (store->compacting)
+				{
+					continue;
+				}
+
+				if (store->needsRewrite || store->totalSize > store->maxSize)
+				{
+					beginCompaction(*store);
+				}
+				else
+				{
+					appendPendingEntries(*store);
+				}
+			}
+		}
+
+		void free()
+		{
+			if (!initialized)
+			{
+				return;
+			}
+
+			for (DiskCacheStore* store : { &geometryStore, &tileStore })
+			{
+				if (store->compacting)
+				{
+					Application::threadPool()->wait(store->compactionCounter);
+					finishCompaction(*store);
+				}
+				appendPendingEntries(*store);
+			}
+
+			closeStore(geometryStore);
+			closeStore(tileStore);
+			initialized = false;
+		}
+
+		// ------------- Internal Functions -------------
+		static void openStore(DiskCacheStore& store, const std::filesystem::path& filepath, size_t maxSize)
+		{
+			store.filepath = filepath;
+			store.mappedFile = nullptr;
+			store.mappedEntries = {};
+			store.appendedEntries = {};
+			store.pendingEntries = {};
+			store.totalSize = 0;
+			store.maxSize = maxSize;
+			store.fileSize = 0;
+			store.needsRewrite = false;
+			store.compacting = false;
+			store.compactionSucceeded = false;
+			store.compactionEntries = {};
+			store.compactionKeys = {};
+
+			mapStore(store);
+		}
+
+		static void mapStore(DiskCacheStore& store)
+		{
+			store.fileSize = 0;
+			store.needsRewrite = false;
+
+			MemMappedFile* file = Platform::memMapFile(store.filepath.string().c_str());
+			if (!file)
+			{
+				return;
+			}
+
+			RawMemory memory = { (uint8*)file->data, file->dataSize, 0 };
+			uint32 magicNumber = 0;
+			uint32 version = 0;
+			memory.read<uint32>(&magicNumber);
+			memory.read<uint32>(&version);
+
+			if (magicNumber != diskCacheMagicNumber || version != diskCacheVersion)
+			{
+				// Leaving fileSize at 0 makes the next append overwrite it
+				g_logger_info("Discarding stale SVG disk cache '{}' with version '{}'.", store.filepath.string(), version);
+				Platform::freeMemMappedFile(file);
+				return;
+			}
+
+			while (memory.offset < memory.size)
+			{
+				DiskCacheRecordHeader record;
+				if (!memory.read<DiskCacheRecordHeader>(&record) || record.size > memory.size - memory.offset)
+				{
+					// Most likely the app died halfway through an append. Everything
+					// before this record is still good.
+					g_logger_warning("SVG disk cache '{}' ends in a partially written record. It will be rewritten.", store.filepath.string());
+					store.needsRewrite = true;
+					break;
+				}
+
+				auto iter = store.mappedEntries.find(record.key);
+				if (iter != store.mappedEntries.end())
+				{
+					store.totalSize -= iter->second.size;
+				}
+
+				store.mappedEntries[record.key] = DiskCacheEntry{
+					file->data + memory.offset,
+					(size_t)record.size,
+					record.lastUsed
+				};
+				store.totalSize += record.size;
+				memory.offset += record.size;
+				store.fileSize = memory.offset;
+			}
+
+			if (store.fileSize == 0)
+			{
+				store.fileSize = fileHeaderSize;
+			}
+			store.mappedFile = file;
+		}
+
+		static void unmapStore(DiskCacheStore& store)
+		{
+			for (const auto& [key, entry] : store.mappedEntries)
+			{
+				store.totalSize -= entry.size;
+			}
+			store.mappedEntries.clear();
+
+			for (auto& [key, memory] : store.appendedEntries)
+			{
+				store.totalSize -= memory.offset;
+				memory.free();
+			}
+			store.appendedEntries.clear();
+
+			if (store.mappedFile)
+			{
+				Platform::freeMemMappedFile(store.mappedFile);
+				store.mappedFile = nullptr;
+			}
+
+			store.fileSize = 0;
+		}
+
+		static void closeStore(DiskCacheStore& store)
+		{
+			unmapStore(store);
+
+			for (auto& [key, memory] : store.pendingEntries)
+			{
+				memory.free();
+			}
+			store.pendingEntries.clear();
+
+			store.totalSize = 0;
+		}
+
+		static void appendPendingEntries(DiskCacheStore& store)
+		{
+			if (store.pendingEntries.size() == 0 || store.needsRewrite)
+			{
+				return;
+			}
+
+			// Only the new records get written, the rest of the file is never touched
+			// outside of a compaction
+			bool isNewFile = store.fileSize == 0;
+			FILE* fp = fopen(store.filepath.string().c_str(), isNewFile ? "wb" : "ab");
+			if (!fp)
+			{
+				g_logger_error("Failed to open '{}' to write SVG disk cache.", store.filepath.string());
+				return;
+			}
+
+			bool success = true;
+			size_t bytesWritten = 0;
+			if (isNewFile)
+			{
+				success = success && fwrite(&diskCacheMagicNumber, sizeof(uint32), 1, fp) == 1;
+				success = success && fwrite(&diskCacheVersion, sizeof(uint32), 1, fp) == 1;
+				bytesWritten += fileHeaderSize;
+			}
+
+			for (const auto& [key, memory] : store.pendingEntries)
+			{
+				DiskCacheRecordHeader record = { key, (uint64)memory.offset, sessionTime };
+				success = success && fwrite(&record, sizeof(DiskCacheRecordHeader), 1, fp) == 1;
+				success = success && (memory.offset == 0 || fwrite(memory.data, memory.offset, 1, fp) == 1);
+				bytesWritten += sizeof(DiskCacheRecordHeader) + memory.offset;
+			}
+			success = fclose(fp) == 0 && success;
+
+			if (!success)
+			{
+				// Don't know how much of the tail made it to disk, rewrite the whole thing
+				// on the next flush instead of appending after a torn record
+				g_logger_error("Failed to append to SVG disk cache '{}'.", store.filepath.string());
+				store.needsRewrite = true;
+				return;
+			}
+
+			store.fileSize += bytesWritten;
+			for (auto& [key, memory] : store.pendingEntries)
+			{
+				store.appendedEntries[key] = memory;
+			}
+			store.pendingEntries.clear();
+		}
+
+		static void beginCompaction(DiskCacheStore& store)
+		{
+			g_logger_assert(!store.compacting, "Tried to compact SVG disk cache '{}' twice.", store.filepath.string());
+
+			// Snapshot everything already on disk. Pending entries get appended to
+			// the compacted file afterwards.
+			store.compactionEntries.clear();
+			store.compactionKeys.clear();
+			for (const auto& [key, entry] : store.mappedEntries)
+			{
+				store.compactionKeys.push_back(key);
+				store.compactionEntries.push_back(entry);
+			}
+			for (const auto& [key, memory] : store.appendedEntries)
+			{
+				store.compactionKeys.push_back(key);
+				store.compactionEntries.push_back(DiskCacheEntry{ memory.data, memory.offset, sessionTime });
+			}
+
+			size_t pendingSize = 0;
+			for (const auto& [key, memory] : store.pendingEntries)
+			{
+				pendingSize += memory.offset;
+			}
+			size_t targetSize = (size_t)((float)store.maxSize * compactionTargetRatio);
+			targetSize = targetSize > pendingSize ? targetSize - pendingSize : 0;
+
+			std::filesystem::path tmpFilepath = store.filepath;
+			tmpFilepath += ".tmp";
+
+			store.compacting = true;
+			store.compactionSucceeded = false;
+			DiskCacheStore* storePtr = &store;
+			Application::threadPool()->queueJob(
+				[storePtr, tmpFilepath, targetSize]()
+				{
+					writeCompactedStore(*storePtr, tmpFilepath, targetSize);
+				},
+				"Compact SVG Disk Cache",
+				Priority::Low,
+				&store.compactionCounter
+			);
+			Application::threadPool()->continueWith(
+				store.compactionCounter,
+				[storePtr]()
+				{
+					finishCompaction(*storePtr);
+				},
+				"Swap In Compacted SVG Disk Cache",
+				Priority::Low,
+				true
+			);
+		}
+
+		// Runs on a worker. Only touches the compaction snapshot, which the main
+		// thread leaves alone until finishCompaction.
+		static void writeCompactedStore(DiskCacheStore& store, const std::filesystem::path& tmpFilepath, size_t targetSize)
+		{
+			MP_PROFILE_EVENT("SvgDiskCache_Compact");
+
+			// Most recently used first, everything past the target size is evicted
+			std::vector<size_t> order(store.compactionEntries.size());
+			for (size_t i = 0; i < order.size(); i++)
+			{
+				order[i] = i;
+			}
+			std::sort(order.begin(), order.end(), [&store](size_t a, size_t b)
+				{
+					return store.compactionEntries[a].lastUsed > store.compactionEntries[b].lastUsed;
+				});
+
+			// Write everything to a temporary file first, then swap it in
+			// so a crash mid-write never leaves a half-written cache behind
+			FILE* fp = fopen(tmpFilepath.string().c_str(), "wb");
+			if (!fp)
+			{
+				g_logger_error("Failed to open '{}' to write SVG disk cache.", tmpFilepath.string());
+				return;
+			}
+
+			bool success = fwrite(&diskCacheMagicNumber, sizeof(uint32), 1, fp) == 1;
+			success = success && fwrite(&diskCacheVersion, sizeof(uint32), 1, fp) == 1;
+
+			size_t keptSize = 0;
+			for (size_t i : order)
+			{
+				const DiskCacheEntry& entry = store.compactionEntries[i];
+				if (keptSize + entry.size > targetSize)
+				{
+					break;
+				}
+
+				DiskCacheRecordHeader record = { store.compactionKeys[i], (uint64)entry.size, entry.lastUsed };
+				success = success && fwrite(&record, sizeof(DiskCacheRecordHeader), 1, fp) == 1;
+				success = success && (entry.size == 0 || fwrite(entry.data, entry.size, 1, fp) == 1);
+				keptSize += entry.size;
+			}
+			success = fclose(fp) == 0 && success;
+
+			if (!success)
+			{
+				g_logger_error("Failed to write compacted SVG disk cache '{}'.", tmpFilepath.string());
+				return;
+			}
+
+			store.compactionSucceeded = true;
+		}
+
+		static void finishCompaction(DiskCacheStore& store)
+		{
+			if (!store.compacting || !store.compactionCounter.isDone())
+			{
+				// free() already waited on this compaction and swapped it in, and
+				// a new one may have started since
+				return;
+			}
+
+			store.compacting = false;
+			store.compactionEntries.clear();
+			store.compactionKeys.clear();
+
+			std::filesystem::path tmpFilepath = store.filepath;
+			tmpFilepath += ".tmp";
+			std::error_code error;
+			if (!store.compactionSucceeded)
+			{
+				std::filesystem::remove(tmpFilepath, error);
+				return;
+			}
+
+			// Release the old mapping before replacing the file, Windows won't
+			// let us rename over a file that's still mapped
+			size_t oldNumEntries = store.mappedEntries.size() + store.appendedEntries.size();
+			unmapStore(store);
+
+			std::filesystem::rename(tmpFilepath, store.filepath, error);
+			if (error)
+			{
+				g_logger_error("Failed to replace SVG disk cache '{}'. Error: '{}'", store.filepath.string(), error.message());
+			}
+
+			mapStore(store);
+			g_logger_info("Compacted SVG disk cache '{}' from '{}' to '{}' entries.", store.filepath.string(), oldNumEntries, store.mappedEntries.size());
+		}
+
+		static bool findEntry(DiskCacheStore& store, uint64 key, DiskCacheEntry* output)
+		{
+			if (!initialized)
+			{
+				return false;
+			}
+
+			auto pendingIter = store.pendingEntries.find(key);
+			if (pendingIter != store.pendingEntries.end())
+			{
+				*output = DiskCacheEntry{ pendingIter->second.data, pendingIter->second.offset, sessionTime };
+				return true;
+			}
+
+			auto appendedIter = store.appendedEntries.find(key);
+			if (appendedIter != store.appendedEntries.end())
+			{
+				*output = DiskCacheEntry{ appendedIter->second.data, appendedIter->second.offset, sessionTime };
+				return true;
+			}
+
+			auto mappedIter = store.mappedEntries.find(key);
+			if (mappedIter != store.mappedEntries.end())
+			{
+				// Written back to disk by the next compaction, which is what
+				// decides which entries get evicted
+				mappedIter->second.lastUsed = sessionTime;
+				*output = mappedIter->second;
+				return true;
+			}
+
+			return false;
+		}
+
+		static void addEntry(DiskCacheStore& store, uint64 key, RawMemory& memory)
+		{
+			if (store.mappedEntries.find(key) != store.mappedEntries.end() ||
+				store.appendedEntries.find(key) != store.appendedEntries.end() ||
+				store.pendingEntries.find(key) != store.pendingEntries.end())
+			{
+				memory.free();
+				return;
+			}
+
+			store.totalSize += memory.offset;
+			store.pendingEntries[key] = memory;
+		}
+	}
+}
@@ -279,7 +279,8 @@ namespace MathAnim
 	{
 		// Internal variables
 		static constexpr size_t errorBufferSize = 1024;
-		static char errorBuffer[errorBufferSize];
+		// Files get parsed on the thread pool too, every thread reports its own errors
+		static thread_local char errorBuffer[errorBufferSize];
 
 		// ----------- Internal Functions -----------
 		static bool parseSvgStylesheet(XMLElement* element, Stylesheet* output);
@@ -46,6 +46,36 @@ namespace MathAnim
 	}
 
 	RawMemory TableOfContents::getEntry(const char* entryName, size_t entryNameLength)
+	{
+		RawMemory res = {};
+
+		size_t dataOffset, dataSize;
+		if (findEntry(entryName, entryNameLength, &dataOffset, &dataSize))
+		{
+			res.init(dataSize);
+			data.setCursor(dataOffset);
+			data.readDangerous(res.data, dataSize);
+		}
+
+		return res;
+	}
+
+	RawMemory TableOfContents::getEntryView(const char* entryName, size_t entryNameLength)
+	{
+		RawMemory res = {};
+
+		size_t dataOffset, dataSize;
+		if (findEntry(entryName, entryNameLength, &dataOffset, &dataSize))
+		{
+			res.data = data.data + dataOffset;
+			res.size = dataSize;
+			res.offset = 0;
+		}
+
+		return res;
+	}
+
+	bool TableOfContents::findEntry(const char* entryName, size_t entryNameLength, size_t* outDataOffset, size_t* outDataSize)
 	{
 		// Each TOC entry looks like
 		// entryNameLength    -> uint32
@@ -57,8 +87,6 @@ namespace MathAnim
 			entryNameLength = std::strlen(entryName);
 		}
 
-		RawMemory res = {};
-
 		tocEntries.setCursor(0);
 		for (uint32 entryIndex = 0; entryIndex < numEntries; entryIndex++)
 		{
@@ -67,7 +95,7 @@ namespace MathAnim
 			if (entryNameLength >= UINT32_MAX) 
 			{
 				g_logger_error("Corrupted TableOfContents. Invalid entry name. Has length > UINT32_MAX. Entry name: '{}'", entryName);
-				return res;
+				return false;
 			}
 
 			if (currentEntryNameLength != entryNameLength)
@@ -90,27 +118,36 @@ namespace MathAnim
 					if (dataOffset + dataSize > data.size) 
 					{
 						g_logger_error("Corrupted TableOfContents. Data Entry '{}' exceeds available size of data with [offset, size]: [{}, {}]", entryName, dataOffset, dataSize);
-						return res;
+						return false;
 					}
 
-					res.init(dataSize);
-					data.setCursor(dataOffset);
-					data.readDangerous(res.data, dataSize);
-					return res;
+					*outDataOffset = dataOffset;
+					*outDataSize = dataSize;
+					return true;
+				}
+				else
+				{
+					tocEntries.setCursor(tocEntries.offset + (currentEntryNameLength + 1));
+					tocEntries.setCursor(tocEntries.offset + (sizeof(size_t) * 2));
 				}
 			}
 		}
 
 		g_logger_warning("No entry found in TableOfContents with name '{}'.", entryName);
-		return res;
+		return false;
 	}
 
-	void TableOfContents::serialize(const char* filepath)
+	bool TableOfContents::serialize(const char* filepath)
 	{
 		tocEntries.shrinkToFit();
 		data.shrinkToFit();
 
 		FILE* fp = fopen(filepath, "wb");
+		if (!fp)
+		{
+			g_logger_error("Failed to open '{}' to write TableOfContents. Error: '{}'", filepath, strerror(errno));
+			return false;
+		}
 
 		// Write metadata
 		// tocSize     -> size_t
@@ -129,13 +166,25 @@ namespace MathAnim
 			numEntries, 
 			magicNumber
 		);
-		fwrite(tocMetadata.memory, tocMetadata.size, 1, fp);
+		bool success = fwrite(tocMetadata.memory, tocMetadata.size, 1, fp) == 1;
 		g_memory_free(tocMetadata.memory);
 
-		// Write TOC offsets and actual data
-		fwrite(tocEntries.data, tocEntries.size, 1, fp);
-		fwrite(data.data, data.size, 1, fp);
-		fclose(fp);
+		// Write TOC offsets and actual data. Empty blobs write nothing so fwrite reports 0 items for them.
+		success = success && (tocEntries.size == 0 || fwrite(tocEntries.data, tocEntries.size, 1, fp) == 1);
+		success = success && (data.size == 0 || fwrite(data.data, data.size, 1, fp) == 1);
+		if (!success)
+		{
+			g_logger_error("Failed to write TableOfContents to '{}'. Error: '{}'", filepath, strerror(errno));
+		}
+
+		// fclose flushes whatever is still buffered, so a full disk can show up here too
+		if (fclose(fp) != 0)
+		{
+			g_logger_error("Failed to close '{}' after writing TableOfContents. Error: '{}'", filepath, strerror(errno));
+			success = false;
+		}
+
+		return success;
 	}
 
 	TableOfContents TableOfContents::deserialize(RawMemory& memory)
@@ -176,4 +225,43 @@ namespace MathAnim
 
 		return res;
 	}
-}
\ No newline at end of file
+
+	TableOfContents TableOfContents::deserializeView(const uint8* memory, size_t memorySize)
+	{
+		// Read metadata
+		// tocSize     -> size_t
+		// dataSize    -> size_t
+		// numEntries  -> uint32
+		// magicNumber -> uint32
+		TableOfContents res = {};
+
+		RawMemory metadata = { (uint8*)memory, memorySize, 0 };
+		size_t tocSize = 0;
+		size_t dataSize = 0;
+		uint32 magicNumber = 0;
+		metadata.read<size_t>(&tocSize);
+		metadata.read<size_t>(&dataSize);
+		metadata.read<uint32>(&res.numEntries);
+		metadata.read<uint32>(&magicNumber);
+
+		if (magicNumber != 0xC001CAFE)
+		{
+			g_logger_error("Corrupted project file. Expected magic number '0xC001CAFE' but got '{:#010x}'.", magicNumber);
+
+			res.numEntries = 0;
+			return res;
+		}
+
+		if (metadata.offset + tocSize + dataSize > memorySize)
+		{
+			g_logger_error("Corrupted project file. TableOfContents is '{}' bytes but the file is only '{}' bytes.", metadata.offset + tocSize + dataSize, memorySize);
+
+			res.numEntries = 0;
+			return res;
+		}
+
+		res.tocEntries = { (uint8*)memory + metadata.offset, tocSize, 0 };
+		res.data = { (uint8*)memory + metadata.offset + tocSize, dataSize, 0 };
+		return res;
+	}
+}
@@ -1,6 +1,7 @@
 #include "video/Encoder.h"
 #include "multithreading/GlobalThreadPool.h"
 #include "core/Application.h"
+#include "core/MemoryTracker.h"
 #include "platform/Platform.h"
 
 extern "C"
@@ -42,7 +43,10 @@ static void sendFrame(
 
 // receives the whole ivf to fout in it's own thread so we don't have to try to track alt refs
 static void* ivfEncodeThread(void* p);
-static EbSvtIOFormat* allocateIoFormat(const size_t width, const size_t height);
+// same as what ivfEncodeThread writes for a single packet, except into memory for chunked encoding
+static void appendIvfPacket(std::vector<uint8>& ivfData, size_t* lastFrameHeaderOffset, const EbBufferHeaderType* packet, uint64 pts);
+static EbComponentType* createSvtHandle(size_t width, size_t height, size_t fps, const MathAnim::VideoEncoderSettings& settings, size_t keyFrameInterval);
+static EbSvtIOFormat* allocateIoFormat(const size_t width, const size_t height, bool tenBit);
 static void freeIoFormat(EbSvtIOFormat* const pic);
 
 namespace MathAnim
@@ -50,6 +54,19 @@ namespace MathAnim
 	// ------------------------ Internal Functions ------------------------
 	static void waitForVideoEncodingToFinish(void* data, size_t dataSize);
 
+	VideoEncoderSettings VideoEncoder::defaultSettings()
+	{
+		VideoEncoderSettings res;
+		res.preset = 12;
+		res.crf = 28;
+		res.threadsPerEncoder = 2;
+		res.tenBit = false;
+		res.chunked = false;
+		res.numParallelChunks = glm::max((int)std::thread::hardware_concurrency() / res.threadsPerEncoder, 1);
+		res.chunkLengthSeconds = 2;
+		return res;
+	}
+
 	// Adapted from https://stackoverflow.com/questions/46444474/c-ffmpeg-create-mp4-file
 	VideoEncoder* VideoEncoder::startEncodingFile(
 		const char* outputFilename,
@@ -57,6 +74,7 @@ namespace MathAnim
 		int outputHeight,
 		int outputFramerate,
 		size_t totalNumFramesInVideo,
+		const VideoEncoderSettings& settings,
 		VideoEncoderFlags flags)
 	{
 		VideoEncoder* output = (VideoEncoder*)g_memory_allocate(sizeof(VideoEncoder));
@@ -69,6 +87,11 @@ namespace MathAnim
 		output->logProgress = ((uint8)flags & (uint8)VideoEncoderFlags::LogProgress);
 		output->isEncoding = true;
 		output->numPushedFrames = 0;
+		output->numEncodedFrames = 0;
+		output->settings = settings;
+		output->nextChunkToEncode = 0;
+		output->numReadyFrames = 0;
+		output->noMoreFrames = false;
 
 		size_t outputFilenameLength = std::strlen(outputFilename);
 		output->filename = (uint8*)g_memory_allocate(sizeof(uint8) * (outputFilenameLength + 1));
@@ -90,45 +113,21 @@ namespace MathAnim
 		const size_t video_fps = output->framerate;
 		FILE* const output_file = output->outputFile;
 
-		// setup our base handle
+		// setup our base handle, chunked encoding creates one per chunk instead
 		EbComponentType* svt_handle = NULL;
+		if (!settings.chunked)
 		{
-			EbSvtAv1EncConfiguration* enc_params = (EbSvtAv1EncConfiguration*)calloc(1, sizeof(*enc_params));
-			// initlize the handle and get the default configuration
-			if (EB_ErrorNone != svt_av1_enc_init_handle(&svt_handle, NULL, enc_params))
-			{
-				g_logger_error("Uh oh.");
-				return nullptr;
-			}
-			// set individual parameters before sending them to the encoder
-			svt_av1_enc_parse_parameter(enc_params, "width", std::to_string(video_width).c_str());
-			svt_av1_enc_parse_parameter(enc_params, "height", std::to_string(video_height).c_str());
-			svt_av1_enc_parse_parameter(enc_params, "input-depth", "8");
-			svt_av1_enc_parse_parameter(enc_params, "color-format", "420");
-			svt_av1_enc_parse_parameter(enc_params, "fps-num", std::to_string(video_fps).c_str());
-			svt_av1_enc_parse_parameter(enc_params, "fps-denom", "1");
-			svt_av1_enc_parse_parameter(enc_params, "irefresh-type", "kf");
-			svt_av1_enc_parse_parameter(enc_params, "preset", "12");
-			svt_av1_enc_parse_parameter(enc_params, "rc", "crf");
-			svt_av1_enc_parse_parameter(enc_params, "crf", "28");
-			svt_av1_enc_parse_parameter(enc_params, "lp", "2");
-
-			// send the parameters to the encoder, and then initialize the encoder
-			if (EB_ErrorNone != svt_av1_enc_set_parameter(svt_handle, enc_params) ||
-				EB_ErrorNone != svt_av1_enc_init(svt_handle))
+			svt_handle = createSvtHandle(video_width, video_height, video_fps, settings, 0);
+			if (!svt_handle)
 			{
-				g_logger_error("Uh oh");
 				return nullptr;
 			}
-
-
-			// we no longer need enc_params past this point
-			free(enc_params);
 		}
 
 		// Create a memmapped file for video frame cache
-		size_t yChannelSize = outputWidth * outputHeight;
-		size_t uChannelSize = outputWidth / 2 * outputHeight / 2;
+		size_t bytesPerSample = settings.tenBit ? sizeof(uint16) : sizeof(uint8);
+		size_t yChannelSize = outputWidth * outputHeight * bytesPerSample;
+		size_t uChannelSize = outputWidth / 2 * outputHeight / 2 * bytesPerSample;
 		size_t vChannelSize = uChannelSize;
 		size_t frameSize = yChannelSize + uChannelSize + vChannelSize;
 		size_t cacheSize = frameSize * totalNumFramesInVideo;
@@ -140,6 +139,7 @@ namespace MathAnim
 			g_logger_error("Failed to create memmapped file for video frame cache. Aborting export.");
 			return nullptr;
 		}
+		MemoryTracker::recordAllocation(MemoryTag::EncoderFrameCache, output->videoFrameCache->dataSize);
 
 		AV1Context* p = (AV1Context*)g_memory_allocate(sizeof(AV1Context));
 		p->svtHandle = svt_handle;
@@ -151,9 +151,38 @@ namespace MathAnim
 		p->videoEncoder = output;
 		output->av1Context = p;
 
-		// start the thread to receive frames from the encoder
-		output->ivfFileWriteThread = std::thread(ivfEncodeThread, p);
-		output->thread = std::thread(&VideoEncoder::encodeThreadLoop, output);
+		output->encodeStartTime = std::chrono::steady_clock::now();
+		if (settings.chunked)
+		{
+			// Every chunk starts with a key frame and is a whole number of mini-GOPs long, so
+			// the chunks line up with the GOPs a single encoder would have made
+			constexpr size_t miniGopLength = 32;
+			size_t chunkLength = (size_t)glm::max(settings.chunkLengthSeconds, 1) * video_fps;
+			chunkLength = ((chunkLength + miniGopLength - 1) / miniGopLength) * miniGopLength;
+
+			for (size_t firstFrame = 0; firstFrame < video_frames; firstFrame += chunkLength)
+			{
+				EncodedVideoChunk chunk = {};
+				chunk.firstFrame = firstFrame;
+				chunk.numFrames = glm::min(chunkLength, video_frames - firstFrame);
+				chunk.isDone = false;
+				output->chunks.emplace_back(chunk);
+			}
+
+			size_t numChunkThreads = glm::min((size_t)glm::max(settings.numParallelChunks, 1), glm::max(output->chunks.size(), (size_t)1));
+			g_logger_info("Encoding {} chunks of {} frames with {} encoders in parallel.", output->chunks.size(), chunkLength, numChunkThreads);
+			for (size_t i = 0; i < numChunkThreads; i++)
+			{
+				output->chunkThreads.emplace_back(std::thread(&VideoEncoder::encodeChunksThreadLoop, output));
+			}
+			output->ivfFileWriteThread = std::thread(&VideoEncoder::writeChunksThreadLoop, output);
+		}
+		else
+		{
+			// start the thread to receive frames from the encoder
+			output->ivfFileWriteThread = std::thread(ivfEncodeThread, p);
+			output->thread = std::thread(&VideoEncoder::encodeThreadLoop, output);
+		}
 
 		return output;
 	}
@@ -199,13 +228,26 @@ namespace MathAnim
 		}
 	}
 
+	void VideoEncoder::addEncodedFrames(size_t numFrames)
+	{
+		numEncodedFrames.fetch_add(numFrames);
+	}
+
+	float VideoEncoder::getFramesPerSecond() const
+	{
+		float secondsElapsed = std::chrono::duration<float>(std::chrono::steady_clock::now() - encodeStartTime).count();
+		return secondsElapsed > 0.0f
+			? (float)numEncodedFrames.load() / secondsElapsed
+			: 0.0f;
+	}
+
 	void VideoEncoder::destroy()
 	{
 		if (this->finalizeThread.joinable())
 		{
 			this->finalizeThread.join();
 		}
-		else if (this->thread.joinable())
+		else if (this->thread.joinable() || this->ivfFileWriteThread.joinable())
 		{
 			VideoEncoder::finalizeEncodingFile(this);
 			this->finalizeThread.join();
@@ -222,6 +264,10 @@ namespace MathAnim
 			g_memory_free(av1Context);
 		}
 
+		if (videoFrameCache)
+		{
+			MemoryTracker::recordFree(MemoryTag::EncoderFrameCache, videoFrameCache->dataSize);
+		}
 		Platform::freeMemMappedFile(videoFrameCache);
 
 		av1Context = nullptr;
@@ -240,8 +286,9 @@ namespace MathAnim
 
 	void VideoEncoder::pushYuvFrame(uint8* pixels, size_t pixelsSize)
 	{
-		size_t yChannelSize = width * height * sizeof(uint8);
-		size_t uChannelSize = width / 2 * height / 2 * sizeof(uint8);
+		size_t bytesPerSample = settings.tenBit ? sizeof(uint16) : sizeof(uint8);
+		size_t yChannelSize = width * height * bytesPerSample;
+		size_t uChannelSize = width / 2 * height / 2 * bytesPerSample;
 		size_t vChannelSize = uChannelSize;
 		size_t framePixelsSize = yChannelSize + uChannelSize + vChannelSize;
 		g_logger_assert(pixelsSize == framePixelsSize, "Invalid pixel buffer for video encoding. Width and height do not match pixelsLength.");
@@ -257,6 +304,17 @@ namespace MathAnim
 		g_memory_copyMem(frame.pixels, pixels, pixelsSize);
 		frame.pixelsSize = pixelsSize;
 
+		if (settings.chunked)
+		{
+			// The chunk encoders read straight from the frame cache
+			{
+				std::lock_guard<std::mutex> lock(chunkMtx);
+				numReadyFrames++;
+			}
+			chunkCv.notify_all();
+			return;
+		}
+
 		// Push frame onto queue
 		{
 			std::lock_guard<std::mutex> lock(encodeMtx);
@@ -281,6 +339,38 @@ namespace MathAnim
 
 	void VideoEncoder::threadSafeFinalize()
 	{
+		if (settings.chunked)
+		{
+			// Chunks waiting on frames that will never come get cut short
+			{
+				std::lock_guard<std::mutex> lock(chunkMtx);
+				noMoreFrames = true;
+			}
+			chunkCv.notify_all();
+
+			for (std::thread& chunkThread : chunkThreads)
+			{
+				if (chunkThread.joinable())
+				{
+					chunkThread.join();
+				}
+			}
+
+			if (ivfFileWriteThread.joinable())
+			{
+				ivfFileWriteThread.join();
+			}
+
+			if (outputFile)
+			{
+				fclose(outputFile);
+				g_logger_info("Encoding done");
+			}
+
+			isEncoding = false;
+			return;
+		}
+
 		// Stop the encoding loop
 		{
 			// Wait for queued frames to finish encoding
@@ -333,7 +423,7 @@ namespace MathAnim
 
 	void VideoEncoder::encodeThreadLoop()
 	{
-		EbSvtIOFormat* pic = allocateIoFormat(width, height);
+		EbSvtIOFormat* pic = allocateIoFormat(width, height, settings.tenBit);
 		size_t frameIndex = 0;
 
 		while (isEncoding.load())
@@ -358,9 +448,10 @@ namespace MathAnim
 			}
 
 			// send the individual frames to the encoder
-			size_t yChannelSize = width * height * sizeof(uint8);
-			size_t uChannelSize = width / 2 * height / 2 * sizeof(uint8);
-			size_t vChannelSize = width / 2 * height / 2 * sizeof(uint8);
+			size_t bytesPerSample = settings.tenBit ? sizeof(uint16) : sizeof(uint8);
+			size_t yChannelSize = width * height * bytesPerSample;
+			size_t uChannelSize = width / 2 * height / 2 * bytesPerSample;
+			size_t vChannelSize = uChannelSize;
 			sendFrame(
 				pic,
 				av1Context,
@@ -392,6 +483,153 @@ namespace MathAnim
 		freeIoFormat(pic);
 		g_logger_info("Video Encoding loop finished.");
 	}
+
+	void VideoEncoder::encodeChunksThreadLoop()
+	{
+		EbSvtIOFormat* pic = allocateIoFormat(width, height, settings.tenBit);
+		size_t bytesPerSample = settings.tenBit ? sizeof(uint16) : sizeof(uint8);
+		size_t yChannelSize = width * height * bytesPerSample;
+		size_t uChannelSize = width / 2 * height / 2 * bytesPerSample;
+		size_t vChannelSize = uChannelSize;
+		size_t framePixelsSize = yChannelSize + uChannelSize + vChannelSize;
+
+		while (true)
+		{
+			size_t chunkIndex = nextChunkToEncode.fetch_add(1);
+			if (chunkIndex >= chunks.size())
+			{
+				break;
+			}
+
+			EncodedVideoChunk& chunk = chunks[chunkIndex];
+			AV1Context chunkContext = {};
+			chunkContext.videoEncoder = this;
+			chunkContext.width = width;
+			chunkContext.height = height;
+			chunkContext.frameCount = chunk.numFrames;
+			chunkContext.fps = framerate;
+			chunkContext.fileOutput = nullptr;
+
+			size_t lastFrameHeaderOffset = SIZE_MAX;
+			auto receivePackets = [&](bool waitForEos)
+			{
+				while (true)
+				{
+					EbBufferHeaderType* packet = NULL;
+					EbErrorType err = svt_av1_enc_get_packet(chunkContext.svtHandle, &packet, waitForEos ? 1 : 0);
+					if (err == EB_NoErrorEmptyQueue)
+					{
+						return;
+					}
+					else if (err != EB_ErrorNone)
+					{
+						g_logger_error("Failed to receive a packet for video chunk {}.", chunkIndex);
+						return;
+					}
+
+					const uint32 flags = packet->flags;
+					if (!(flags & EB_BUFFERFLAG_IS_ALT_REF))
+					{
+						addEncodedFrames(1);
+					}
+					// Packets are numbered from the start of the chunk
+					appendIvfPacket(chunk.ivfData, &lastFrameHeaderOffset, packet, chunk.firstFrame + packet->pts);
+					svt_av1_enc_release_out_buffer(&packet);
+
+					if (flags & EB_BUFFERFLAG_EOS)
+					{
+						return;
+					}
+				}
+			};
+
+			size_t numSentFrames = 0;
+			for (size_t frameIndex = chunk.firstFrame; frameIndex < chunk.firstFrame + chunk.numFrames; frameIndex++)
+			{
+				// Encoding starts as soon as the chunk's first frame is rendered instead of
+				// waiting for the whole chunk
+				{
+					std::unique_lock<std::mutex> lock(chunkMtx);
+					chunkCv.wait(lock, [&]() { return numReadyFrames > frameIndex || noMoreFrames; });
+				}
+
+				if (numReadyFrames <= frameIndex)
+				{
+					// The export stopped before this frame was rendered
+					break;
+				}
+
+				if (!chunkContext.svtHandle)
+				{
+					chunkContext.svtHandle = createSvtHandle(width, height, framerate, settings, chunk.numFrames);
+					if (!chunkContext.svtHandle)
+					{
+						g_logger_error("Failed to create an encoder for video chunk {}, it will be missing from the video.", chunkIndex);
+						break;
+					}
+				}
+
+				const uint8* pixels = videoFrameCache->data + frameIndex * framePixelsSize;
+				sendFrame(
+					pic,
+					&chunkContext,
+					numSentFrames,
+					pixels,
+					yChannelSize,
+					pixels + yChannelSize,
+					uChannelSize,
+					pixels + yChannelSize + uChannelSize,
+					vChannelSize
+				);
+				numSentFrames++;
+				receivePackets(false);
+			}
+
+			if (chunkContext.svtHandle)
+			{
+				EbBufferHeaderType eofFlags = { 0 };
+				eofFlags.flags = EB_BUFFERFLAG_EOS;
+				svt_av1_enc_send_picture(chunkContext.svtHandle, &eofFlags);
+				receivePackets(true);
+
+				svt_av1_enc_deinit(chunkContext.svtHandle);
+				svt_av1_enc_deinit_handle(chunkContext.svtHandle);
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(chunkMtx);
+				chunk.numFrames = numSentFrames;
+				chunk.isDone = true;
+			}
+			chunkCv.notify_all();
+		}
+
+		freeIoFormat(pic);
+	}
+
+	void VideoEncoder::writeChunksThreadLoop()
+	{
+		writeIvfHeader(av1Context);
+
+		size_t numWrittenFrames = 0;
+		for (EncodedVideoChunk& chunk : chunks)
+		{
+			// Chunks finish out of order, but have to be written in order
+			{
+				std::unique_lock<std::mutex> lock(chunkMtx);
+				chunkCv.wait(lock, [&]() { return chunk.isDone; });
+			}
+
+			fwrite(chunk.ivfData.data(), 1, chunk.ivfData.size(), outputFile);
+			fflush(outputFile);
+			chunk.ivfData = std::vector<uint8>();
+
+			numWrittenFrames += chunk.numFrames;
+			setPercentComplete((float)numWrittenFrames / (float)glm::max(av1Context->frameCount, (size_t)1));
+		}
+
+		setPercentComplete(1.0f);
+	}
 }
 
 // ----------- Internal Encoding Functions ------------
@@ -503,6 +741,7 @@ static void* ivfEncodeThread(void* p)
 			ivf_header_position = ftell(fout);
 			frame_size = receive_buffer->n_filled_len;
 			writeIvfFrameHeader(ctx, frame_size, receive_buffer->pts);
+			ctx->videoEncoder->addEncodedFrames(1);
 		}
 		else
 		{
@@ -534,8 +773,80 @@ static void* ivfEncodeThread(void* p)
 	return NULL;
 }
 
-static EbSvtIOFormat* allocateIoFormat(const size_t width, const size_t height)
+static void appendIvfPacket(std::vector<uint8>& ivfData, size_t* lastFrameHeaderOffset, const EbBufferHeaderType* packet, uint64 pts)
+{
+	const bool altRef = packet->flags & EB_BUFFERFLAG_IS_ALT_REF;
+	if (!altRef || *lastFrameHeaderOffset == SIZE_MAX)
+	{
+		// Visible frame, give it its own ivf frame header
+		*lastFrameHeaderOffset = ivfData.size();
+		unsigned char header[12];
+		memPutLe32(header + 0, (uint32)packet->n_filled_len);
+		memPutLe32(header + 4, pts & 0xFFFFFFFF);
+		memPutLe32(header + 8, pts >> 32);
+		ivfData.insert(ivfData.end(), header, header + sizeof(header));
+	}
+	else
+	{
+		// Hidden frames get counted in the size of the frame before them, like ivfEncodeThread does
+		uint8* frameSizeField = ivfData.data() + *lastFrameHeaderOffset;
+		uint32 frameSize = (uint32)frameSizeField[0] |
+			((uint32)frameSizeField[1] << 8) |
+			((uint32)frameSizeField[2] << 16) |
+			((uint32)frameSizeField[3] << 24);
+		memPutLe32(frameSizeField, frameSize + packet->n_filled_len);
+	}
+
+	ivfData.insert(ivfData.end(), packet->p_buffer, packet->p_buffer + packet->n_filled_len);
+}
+
+static EbComponentType* createSvtHandle(size_t width, size_t height, size_t fps, const MathAnim::VideoEncoderSettings& settings, size_t keyFrameInterval)
+{
+	EbComponentType* svt_handle = NULL;
+	EbSvtAv1EncConfiguration* enc_params = (EbSvtAv1EncConfiguration*)calloc(1, sizeof(*enc_params));
+	// initlize the handle and get the default configuration
+	if (EB_ErrorNone != svt_av1_enc_init_handle(&svt_handle, NULL, enc_params))
+	{
+		g_logger_error("Failed to create an SVT-AV1 encoder handle.");
+		free(enc_params);
+		return NULL;
+	}
+	// set individual parameters before sending them to the encoder
+	svt_av1_enc_parse_parameter(enc_params, "width", std::to_string(width).c_str());
+	svt_av1_enc_parse_parameter(enc_params, "height", std::to_string(height).c_str());
+	svt_av1_enc_parse_parameter(enc_params, "input-depth", settings.tenBit ? "10" : "8");
+	svt_av1_enc_parse_parameter(enc_params, "color-format", "420");
+	svt_av1_enc_parse_parameter(enc_params, "fps-num", std::to_string(fps).c_str());
+	svt_av1_enc_parse_parameter(enc_params, "fps-denom", "1");
+	svt_av1_enc_parse_parameter(enc_params, "irefresh-type", "kf");
+	svt_av1_enc_parse_parameter(enc_params, "preset", std::to_string(settings.preset).c_str());
+	svt_av1_enc_parse_parameter(enc_params, "rc", "crf");
+	svt_av1_enc_parse_parameter(enc_params, "crf", std::to_string(settings.crf).c_str());
+	svt_av1_enc_parse_parameter(enc_params, "lp", std::to_string(settings.threadsPerEncoder).c_str());
+	if (keyFrameInterval > 0)
+	{
+		svt_av1_enc_parse_parameter(enc_params, "keyint", std::to_string(keyFrameInterval).c_str());
+	}
+
+	// send the parameters to the encoder, and then initialize the encoder
+	if (EB_ErrorNone != svt_av1_enc_set_parameter(svt_handle, enc_params) ||
+		EB_ErrorNone != svt_av1_enc_init(svt_handle))
+	{
+		g_logger_error("Failed to initialize the SVT-AV1 encoder.");
+		svt_av1_enc_deinit_handle(svt_handle);
+		free(enc_params);
+		return NULL;
+	}
+
+	// we no longer need enc_params past this point
+	free(enc_params);
+	return svt_handle;
+}
+
+static EbSvtIOFormat* allocateIoFormat(const size_t width, const size_t height, bool tenBit)
 {
+	// Strides are in samples, 10 bit samples take 2 bytes each
+	const size_t bytesPerSample = tenBit ? sizeof(uint16) : sizeof(uint8);
 	EbSvtIOFormat* pic = (EbSvtIOFormat*)g_memory_allocate(sizeof(EbSvtIOFormat));
 	g_logger_assert(pic != nullptr, "Ran out of RAM.");
 
@@ -546,13 +857,13 @@ static EbSvtIOFormat* allocateIoFormat(const size_t width, const size_t height)
 	pic->width = (uint32)width;
 	pic->height = (uint32)height;
 	pic->color_fmt = EB_YUV420;
-	pic->bit_depth = EB_EIGHT_BIT;
-	pic->luma = (uint8*)g_memory_allocate(height * pic->y_stride * sizeof(uint8));
-	g_memory_zeroMem(pic->luma, height * pic->y_stride * sizeof(uint8));
-	pic->cb = (uint8*)g_memory_allocate(height * pic->cb_stride * sizeof(uint8));
-	g_memory_zeroMem(pic->cb, height * pic->cb_stride * sizeof(uint8));
-	pic->cr = (uint8*)g_memory_allocate(height * pic->cr_stride * sizeof(uint8));
-	g_memory_zeroMem(pic->cr, height * pic->cr_stride * sizeof(uint8));
+	pic->bit_depth = tenBit ? EB_TEN_BIT : EB_EIGHT_BIT;
+	pic->luma = (uint8*)g_memory_allocate(height * pic->y_stride * bytesPerSample);
+	g_memory_zeroMem(pic->luma, height * pic->y_stride * bytesPerSample);
+	pic->cb = (uint8*)g_memory_allocate(height * pic->cb_stride * bytesPerSample);
+	g_memory_zeroMem(pic->cb, height * pic->cb_stride * bytesPerSample);
+	pic->cr = (uint8*)g_memory_allocate(height * pic->cr_stride * bytesPerSample);
+	g_memory_zeroMem(pic->cr, height * pic->cr_stride * bytesPerSample);
 	return pic;
 }
 
@@ -0,0 +1,171 @@
+#ifdef _MATH_ANIM_TESTS
+#include "JobSystemTests.h"
+#include "core/Testing.h"
+#include "multithreading/GlobalThreadPool.h"
+
+namespace MathAnim
+{
+	namespace JobSystemTests
+	{
+		// -------------------- Constants --------------------
+		constexpr uint32 NUM_TEST_THREADS = 4;
+
+		// -------------------- Tests --------------------
+		DEFINE_TEST(waitShouldBlockUntilAllJobsFinish)
+		{
+			GlobalThreadPool pool(NUM_TEST_THREADS);
+
+			std::atomic<uint32> numJobsRun = 0;
+			JobCounter counter;
+			for (int i = 0; i < 1000; i++)
+			{
+				pool.queueJob([&numJobsRun]() { numJobsRun++; }, "TestJob", Priority::None, &counter);
+			}
+			pool.wait(counter);
+
+			ASSERT_TRUE(counter.isDone());
+			ASSERT_EQUAL(numJobsRun.load(), 1000u);
+
+			pool.free();
+			END_TEST;
+		}
+
+		DEFINE_TEST(parallelForShouldVisitEveryIndexOnce)
+		{
+			GlobalThreadPool pool(NUM_TEST_THREADS);
+
+			constexpr size_t count = 10'007;
+			std::vector<uint32> visits(count, 0);
+			pool.parallelFor(count, 64, [&visits](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					visits[i]++;
+				}
+			});
+
+			for (size_t i = 0; i < count; i++)
+			{
+				ASSERT_EQUAL(visits[i], 1u);
+			}
+
+			pool.free();
+			END_TEST;
+		}
+
+		DEFINE_TEST(nestedWaitInsideJobShouldNotDeadlock)
+		{
+			GlobalThreadPool pool(NUM_TEST_THREADS);
+
+			std::atomic<uint32> numInnerJobsRun = 0;
+			JobCounter outerCounter;
+			for (uint32 i = 0; i < NUM_TEST_THREADS * 2; i++)
+			{
+				pool.queueJob([&pool, &numInnerJobsRun]()
+				{
+					pool.parallelFor(100, 1, [&numInnerJobsRun](size_t, size_t) { numInnerJobsRun++; });
+				}, "OuterJob", Priority::None, &outerCounter);
+			}
+			pool.wait(outerCounter);
+
+			ASSERT_EQUAL(numInnerJobsRun.load(), NUM_TEST_THREADS * 2 * 100);
+
+			pool.free();
+			END_TEST;
+		}
+
+		DEFINE_TEST(continuationShouldRunAfterCounterFinishes)
+		{
+			GlobalThreadPool pool(NUM_TEST_THREADS);
+
+			std::atomic<uint32> numJobsRun = 0;
+			std::atomic<uint32> jobsRunWhenContinuationStarted = 0;
+			JobCounter counter;
+			for (int i = 0; i < 100; i++)
+			{
+				pool.queueJob([&numJobsRun]() { numJobsRun++; }, "TestJob", Priority::Low, &counter);
+			}
+
+			pool.continueWith(counter, [&]()
+			{
+				jobsRunWhenContinuationStarted = numJobsRun.load();
+			});
+
+			pool.wait(counter);
+			// free() runs every queued job, including the continuation
+			pool.free();
+
+			ASSERT_EQUAL(jobsRunWhenContinuationStarted.load(), 100u);
+			END_TEST;
+		}
+
+		DEFINE_TEST(mainThreadContinuationShouldRunInProcessFinishedTasks)
+		{
+			GlobalThreadPool pool(NUM_TEST_THREADS);
+
+			bool continuationRan = false;
+			JobCounter counter;
+			pool.queueJob([]() {}, "TestJob", Priority::None, &counter);
+			pool.continueWith(counter, [&continuationRan]() { continuationRan = true; }, "MainThreadContinuation", Priority::None, true);
+			pool.wait(counter);
+
+			ASSERT_FALSE(continuationRan);
+			pool.processFinishedTasks();
+			ASSERT_TRUE(continuationRan);
+
+			pool.free();
+			END_TEST;
+		}
+
+		DEFINE_TEST(waitShouldOnlyRunJobsFromTheAwaitedCounter)
+		{
+			GlobalThreadPool pool(1);
+
+			// Keep the only worker busy so the waiting thread has to run the awaited job itself
+			std::atomic<bool> blockerStarted = false;
+			std::atomic<bool> releaseBlocker = false;
+			pool.queueJob([&blockerStarted, &releaseBlocker]()
+			{
+				blockerStarted = true;
+				while (!releaseBlocker)
+				{
+					std::this_thread::yield();
+				}
+			}, "BlockerJob");
+			while (!blockerStarted)
+			{
+				std::this_thread::yield();
+			}
+
+			std::thread::id unrelatedJobThread;
+			std::thread::id awaitedJobThread;
+			pool.queueJob([&unrelatedJobThread]() { unrelatedJobThread = std::this_thread::get_id(); }, "UnrelatedJob");
+			JobCounter counter;
+			pool.queueJob([&awaitedJobThread]() { awaitedJobThread = std::this_thread::get_id(); }, "AwaitedJob", Priority::None, &counter);
+			pool.wait(counter);
+
+			ASSERT_TRUE(awaitedJobThread == std::this_thread::get_id());
+			ASSERT_TRUE(unrelatedJobThread == std::thread::id());
+
+			releaseBlocker = true;
+			pool.free();
+			ASSERT_TRUE(unrelatedJobThread != std::thread::id());
+			ASSERT_TRUE(unrelatedJobThread != std::this_thread::get_id());
+			END_TEST;
+		}
+
+		void setupTestSuite()
+		{
+			TestSuite& testSuite = Tests::addTestSuite("JobSystem");
+
+			ADD_TEST(testSuite, waitShouldBlockUntilAllJobsFinish);
+			ADD_TEST(testSuite, parallelForShouldVisitEveryIndexOnce);
+			ADD_TEST(testSuite, nestedWaitInsideJobShouldNotDeadlock);
+			ADD_TEST(testSuite, continuationShouldRunAfterCounterFinishes);
+			ADD_TEST(testSuite, mainThreadContinuationShouldRunInProcessFinishedTasks);
+			ADD_TEST(testSuite, waitShouldOnlyRunJobsFromTheAwaitedCounter);
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,66 @@
+#ifdef _MATH_ANIM_TESTS
+#include "LaTexTests.h"
+#include "core/Testing.h"
+#include "latex/LaTexLayer.h"
+
+namespace MathAnim
+{
+	namespace LaTexTests
+	{
+		// -------------------- Constants --------------------
+		constexpr size_t NUM_BATCH_PAGES = 12;
+
+		// -------------------- Private functions --------------------
+		// Expands %p the way dvisvgm does. Without a width it pads to the number of digits
+		// in the last page number, with one like %3p it pads to that many digits.
+		static std::string expandDvisvgmPattern(const std::string& pattern, size_t pageNumber, size_t numPages)
+		{
+			size_t percent = pattern.find('%');
+			size_t specifier = pattern.find('p', percent);
+			if (percent == std::string::npos || specifier == std::string::npos)
+			{
+				return pattern;
+			}
+
+			std::string widthStr = pattern.substr(percent + 1, specifier - percent - 1);
+			size_t width = widthStr.empty()
+				? std::to_string(numPages).length()
+				: (size_t)std::stoi(widthStr);
+
+			std::string number = std::to_string(pageNumber);
+			if (number.length() < width)
+			{
+				number.insert(0, width - number.length(), '0');
+			}
+
+			return pattern.substr(0, percent) + number + pattern.substr(specifier + 1);
+		}
+
+		// -------------------- Tests --------------------
+		DEFINE_TEST(batchPageFilenamesShouldMatchDvisvgmOutputPastNinePages)
+		{
+			std::string basename = "batch_7";
+			std::string pattern = LaTexLayer::getBatchPageOutputPattern(basename);
+
+			std::unordered_set<std::string> filenames;
+			for (size_t page = 1; page <= NUM_BATCH_PAGES; page++)
+			{
+				std::string filename = LaTexLayer::getBatchPageFilename(basename, page);
+				ASSERT_EQUAL(filename, expandDvisvgmPattern(pattern, page, NUM_BATCH_PAGES));
+				filenames.insert(filename);
+			}
+
+			ASSERT_EQUAL(filenames.size(), NUM_BATCH_PAGES);
+			END_TEST;
+		}
+
+		void setupTestSuite()
+		{
+			TestSuite& testSuite = Tests::addTestSuite("LaTex");
+
+			ADD_TEST(testSuite, batchPageFilenamesShouldMatchDvisvgmOutputPastNinePages);
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,367 @@
+#ifdef _MATH_ANIM_TESTS
+#include "SvgTests.h"
+#include "core/Testing.h"
+#include "svg/Svg.h"
+#include "core/FrameArena.h"
+
+#include <atomic>
+#include <thread>
+
+namespace MathAnim
+{
+	namespace SvgTests
+	{
+		// -------------------- Constants --------------------
+		constexpr int NUM_SHARING_THREADS = 4;
+		constexpr int NUM_COPIES_PER_THREAD = 1'000;
+		constexpr int NUM_GENERATOR_OBJECTS = 2'000;
+		constexpr int NUM_GENERATOR_POINTS = 100;
+
+		// -------------------- Private functions --------------------
+		static SvgObject* createGlyph(float size)
+		{
+			SvgObject* glyph = (SvgObject*)g_memory_allocate(sizeof(SvgObject));
+			*glyph = Svg::createDefault();
+
+			// Roughly the shape of an 'o', an outer contour with a hole
+			Svg::beginPath(glyph, Vec2{ 0.0f, 0.0f });
+			Svg::bezier3To(glyph, Vec2{ size, 0.0f }, Vec2{ size, size }, Vec2{ 0.0f, size });
+			Svg::bezier3To(glyph, Vec2{ -size, size }, Vec2{ -size, 0.0f }, Vec2{ 0.0f, 0.0f });
+			Svg::closePath(glyph);
+			Svg::beginPath(glyph, Vec2{ 0.0f, size * 0.25f });
+			Svg::lineTo(glyph, Vec2{ size * 0.25f, size * 0.5f });
+			Svg::lineTo(glyph, Vec2{ 0.0f, size * 0.75f });
+			Svg::lineTo(glyph, Vec2{ -size * 0.25f, size * 0.5f });
+			Svg::closePath(glyph, true, true);
+
+			return glyph;
+		}
+
+		// Single contour made of lines, so it never has the same number of paths or curves as createGlyph
+		static SvgObject* createBoxGlyph(float size)
+		{
+			SvgObject* glyph = (SvgObject*)g_memory_allocate(sizeof(SvgObject));
+			*glyph = Svg::createDefault();
+
+			Svg::beginPath(glyph, Vec2{ 0.0f, 0.0f });
+			Svg::lineTo(glyph, Vec2{ size, 0.0f });
+			Svg::lineTo(glyph, Vec2{ size, size });
+			Svg::lineTo(glyph, Vec2{ 0.0f, size });
+			Svg::lineTo(glyph, Vec2{ -size, size });
+			Svg::lineTo(glyph, Vec2{ -size, 0.0f });
+			Svg::closePath(glyph);
+
+			return glyph;
+		}
+
+		static void freeSvg(SvgObject* svg)
+		{
+			svg->free();
+			g_memory_free(svg);
+		}
+
+		// -------------------- Tests --------------------
+		DEFINE_TEST(copyFromSharedSvgShouldReferenceSameGeometry)
+		{
+			SvgObject* glyph = createGlyph(1.0f);
+			glyph->makeShared();
+
+			SvgObject copyA = Svg::createDefault();
+			SvgObject copyB = Svg::createDefault();
+			Svg::copy(&copyA, glyph);
+			Svg::copy(&copyB, &copyA);
+
+			ASSERT_TRUE(copyA.paths == glyph->paths);
+			ASSERT_TRUE(copyB.paths == glyph->paths);
+			ASSERT_EQUAL(glyph->sharedRefCount->load(), 3u);
+
+			copyA.free();
+			copyB.free();
+			ASSERT_EQUAL(glyph->sharedRefCount->load(), 1u);
+
+			freeSvg(glyph);
+			END_TEST;
+		}
+
+		DEFINE_TEST(sharedSvgCopiesShouldBeReleasableFromWorkers)
+		{
+			SvgObject* glyph = createGlyph(1.0f);
+			glyph->makeShared();
+
+			std::vector<std::thread> workers;
+			for (int i = 0; i < NUM_SHARING_THREADS; i++)
+			{
+				workers.emplace_back([glyph]()
+				{
+					for (int copyi = 0; copyi < NUM_COPIES_PER_THREAD; copyi++)
+					{
+						SvgObject copy = Svg::createDefault();
+						Svg::copy(&copy, glyph);
+						if (copyi % 2 == 0)
+						{
+							// Some copies race each other to take their own geometry
+							Svg::lineTo(&copy, Vec2{ 5.0f, 5.0f });
+						}
+						copy.free();
+					}
+				});
+			}
+			for (std::thread& worker : workers)
+			{
+				worker.join();
+			}
+
+			ASSERT_EQUAL(glyph->sharedRefCount->load(), 1u);
+
+			freeSvg(glyph);
+			END_TEST;
+		}
+
+		DEFINE_TEST(mutatingSharedSvgShouldCopyOnWrite)
+		{
+			SvgObject* glyph = createGlyph(1.0f);
+			glyph->makeShared();
+			int numGlyphCurves = glyph->paths[glyph->numPaths - 1].numCurves;
+
+			SvgObject copy = Svg::createDefault();
+			Svg::copy(&copy, glyph);
+			Svg::lineTo(&copy, Vec2{ 5.0f, 5.0f });
+
+			ASSERT_FALSE(copy.isShared());
+			ASSERT_TRUE(copy.paths != glyph->paths);
+			ASSERT_EQUAL(copy.paths[copy.numPaths - 1].numCurves, numGlyphCurves + 1);
+			ASSERT_EQUAL(glyph->paths[glyph->numPaths - 1].numCurves, numGlyphCurves);
+			ASSERT_EQUAL(glyph->sharedRefCount->load(), 1u);
+
+			copy.free();
+			freeSvg(glyph);
+			END_TEST;
+		}
+
+		DEFINE_TEST(sharedGeometryShouldOutliveOriginalOwner)
+		{
+			SvgObject* glyph = createGlyph(1.0f);
+			glyph->makeShared();
+			int numPaths = glyph->numPaths;
+
+			SvgObject copy = Svg::createDefault();
+			Svg::copy(&copy, glyph);
+			freeSvg(glyph);
+
+			ASSERT_TRUE(copy.isShared());
+			ASSERT_EQUAL(copy.sharedRefCount->load(), 1u);
+			ASSERT_EQUAL(copy.numPaths, numPaths);
+
+			// Sole owner now, so this shouldn't need to copy anything
+			Path* paths = copy.paths;
+			copy.makeUnique();
+			ASSERT_FALSE(copy.isShared());
+			ASSERT_TRUE(copy.paths == paths);
+
+			copy.free();
+			END_TEST;
+		}
+
+		DEFINE_TEST(glyphIdShouldOnlySurviveUneditedCopies)
+		{
+			SvgObject* glyph = createGlyph(1.0f);
+			glyph->makeShared();
+			glyph->glyphId = 42;
+
+			SvgObject copy = Svg::createDefault();
+			Svg::copy(&copy, glyph);
+			ASSERT_EQUAL(copy.glyphId, (uint64)42);
+
+			// Edited geometry isn't the font glyph anymore, so it can't use the glyph's cache entry
+			Svg::lineTo(&copy, Vec2{ 5.0f, 5.0f });
+			ASSERT_EQUAL(copy.glyphId, (uint64)0);
+			ASSERT_EQUAL(glyph->glyphId, (uint64)42);
+
+			copy.free();
+			freeSvg(glyph);
+			END_TEST;
+		}
+
+		DEFINE_TEST(copiedSvgGroupShouldOwnItsGeometry)
+		{
+			SvgObject* glyph = createGlyph(1.0f);
+			SvgObject* box = createBoxGlyph(1.0f);
+			SvgGroup group = Svg::createDefaultGroup();
+			Svg::beginSvgGroup(&group);
+			Svg::pushSvgToGroup(&group, *glyph, "glyph", Vec2{ 0.0f, 0.0f });
+			Svg::pushSvgToGroup(&group, *box, "box", Vec2{ 2.0f, 0.0f });
+			Svg::pushSvgToGroup(&group, *glyph, "glyph", Vec2{ 4.0f, 0.0f });
+			Svg::endSvgGroup(&group);
+
+			SvgGroup copy = Svg::createDefaultGroup();
+			Svg::copy(&copy, &group);
+
+			ASSERT_EQUAL(copy.numObjects, group.numObjects);
+			ASSERT_EQUAL(copy.numUniqueObjects, 2);
+			for (int i = 0; i < group.numObjects; i++)
+			{
+				ASSERT_TRUE(copy.objects[i].paths != group.objects[i].paths);
+				ASSERT_EQUAL(copy.objects[i].numPaths, group.objects[i].numPaths);
+				ASSERT_TRUE(copy.objectOffsets[i] == group.objectOffsets[i]);
+			}
+			ASSERT_TRUE(copy.uniqueObjectNames[1] != group.uniqueObjectNames[1]);
+			ASSERT_EQUAL(std::strcmp(copy.uniqueObjectNames[1], "box"), 0);
+
+			// Freeing the original can't take the copy's geometry with it
+			group.free();
+			ASSERT_TRUE(copy.objects[1].paths[0].numCurves > 0);
+
+			copy.free();
+			freeSvg(glyph);
+			freeSvg(box);
+			END_TEST;
+		}
+
+		DEFINE_TEST(interpolateShouldOnlyUseFrameArenaForTemporaries)
+		{
+			SvgObject* src = createGlyph(1.0f);
+			SvgObject* dst = createBoxGlyph(2.0f);
+			FrameArena::reset();
+
+			SvgObject* res = Svg::interpolate(src, dst, 0.5f);
+			ASSERT_TRUE(FrameArena::getBytesUsed() > 0);
+			ASSERT_FALSE(FrameArena::owns(res));
+			ASSERT_FALSE(FrameArena::owns(res->paths));
+
+			// The result has to survive the end of the frame
+			FrameArena::reset();
+			ASSERT_EQUAL(FrameArena::getBytesUsed(), (size_t)0);
+			ASSERT_TRUE(res->numPaths > 0);
+			for (int pathi = 0; pathi < res->numPaths; pathi++)
+			{
+				ASSERT_FALSE(FrameArena::owns(res->paths[pathi].curves));
+				ASSERT_TRUE(res->paths[pathi].numCurves > 0);
+			}
+
+			freeSvg(res);
+			freeSvg(src);
+			freeSvg(dst);
+			END_TEST;
+		}
+
+		DEFINE_TEST(generatorOnWorkerShouldNotTouchFrameArena)
+		{
+			// Make this thread the arena's owner before the worker starts
+			FrameArena::allocate(1);
+
+			// Builds SVGs with the same calls the Svg.beginPath/Svg.polyline script globals
+			// make, while the main thread keeps adding and merging arena blocks
+			std::atomic<bool> workerDone = false;
+			std::vector<SvgObject*> generated;
+			std::thread worker([&generated, &workerDone]()
+			{
+				std::vector<Vec2> points;
+				for (int i = 0; i < NUM_GENERATOR_POINTS; i++)
+				{
+					points.push_back(Vec2{ (float)i, (float)(i % 7) });
+				}
+
+				for (int i = 0; i < NUM_GENERATOR_OBJECTS; i++)
+				{
+					SvgObject* obj = (SvgObject*)g_memory_allocate(sizeof(SvgObject));
+					*obj = Svg::createDefault();
+					Svg::beginPath(obj, Vec2{ 0.0f, 0.0f });
+					Svg::polylineTo(obj, points.data(), (int)points.size());
+					Svg::closePath(obj);
+					generated.push_back(obj);
+				}
+
+				workerDone = true;
+			});
+
+			while (!workerDone)
+			{
+				for (int i = 0; i < 64; i++)
+				{
+					FrameArena::allocate(KB(64));
+				}
+				FrameArena::reset();
+			}
+			worker.join();
+
+			ASSERT_EQUAL(generated.size(), (size_t)NUM_GENERATOR_OBJECTS);
+			for (SvgObject* obj : generated)
+			{
+				ASSERT_FALSE(FrameArena::owns(obj->paths));
+				ASSERT_EQUAL(obj->paths[0].numCurves, NUM_GENERATOR_POINTS);
+				freeSvg(obj);
+			}
+
+			FrameArena::reset();
+			END_TEST;
+		}
+
+		DEFINE_TEST(arcLengthLutShouldMapLengthToConstantSpeed)
+		{
+			// Control points bunched up at the start, so t and distance don't line up at all
+			Curve curve{};
+			curve.type = CurveType::Bezier3;
+			curve.p0 = Vec2{ 0.0f, 0.0f };
+			curve.as.bezier3.p1 = Vec2{ 0.1f, 0.0f };
+			curve.as.bezier3.p2 = Vec2{ 0.2f, 0.0f };
+			curve.as.bezier3.p3 = Vec2{ 10.0f, 0.0f };
+
+			ArcLengthLut lut = ArcLengthLut::create();
+			lut.addCurve(curve);
+			ASSERT_TRUE(glm::abs(lut.getTotalLength() - 10.0f) < 0.001f);
+
+			float t;
+			ASSERT_EQUAL(lut.find(5.0f, &t), 0);
+			ASSERT_TRUE(glm::abs(curve.evaluate(t).x - 5.0f) < 0.1f);
+
+			Curve line{};
+			line.type = CurveType::Line;
+			line.p0 = curve.as.bezier3.p3;
+			line.as.line.p1 = Vec2{ 20.0f, 0.0f };
+			lut.addCurve(line);
+
+			ASSERT_EQUAL(lut.find(17.5f, &t), 1);
+			ASSERT_TRUE(glm::abs(t - 0.75f) < 0.001f);
+			ASSERT_EQUAL(lut.find(100.0f, &t), 1);
+			ASSERT_TRUE(t == 1.0f);
+
+			lut.free();
+			END_TEST;
+		}
+
+		DEFINE_TEST(editingSvgShouldInvalidateArcLengthLut)
+		{
+			SvgObject* glyph = createGlyph(1.0f);
+			glyph->finalize();
+
+			float length = glyph->getArcLengthLut().getTotalLength();
+			ASSERT_FALSE(glyph->arcLengthLut.isEmpty());
+
+			Svg::beginPath(glyph, Vec2{ 5.0f, 5.0f });
+			Svg::lineTo(glyph, Vec2{ 6.0f, 5.0f });
+			ASSERT_TRUE(glyph->arcLengthLut.isEmpty());
+			ASSERT_TRUE(glm::abs(glyph->getArcLengthLut().getTotalLength() - (length + 1.0f)) < 0.001f);
+
+			freeSvg(glyph);
+			END_TEST;
+		}
+
+		void setupTestSuite()
+		{
+			TestSuite& testSuite = Tests::addTestSuite("Svg");
+
+			ADD_TEST(testSuite, copyFromSharedSvgShouldReferenceSameGeometry);
+			ADD_TEST(testSuite, sharedSvgCopiesShouldBeReleasableFromWorkers);
+			ADD_TEST(testSuite, mutatingSharedSvgShouldCopyOnWrite);
+			ADD_TEST(testSuite, sharedGeometryShouldOutliveOriginalOwner);
+			ADD_TEST(testSuite, glyphIdShouldOnlySurviveUneditedCopies);
+			ADD_TEST(testSuite, copiedSvgGroupShouldOwnItsGeometry);
+			ADD_TEST(testSuite, interpolateShouldOnlyUseFrameArenaForTemporaries);
+			ADD_TEST(testSuite, generatorOnWorkerShouldNotTouchFrameArena);
+			ADD_TEST(testSuite, arcLengthLutShouldMapLengthToConstantSpeed);
+			ADD_TEST(testSuite, editingSvgShouldInvalidateArcLengthLut);
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,15 @@
+#ifdef _MATH_ANIM_TESTS
+#ifndef MATH_ANIM_SVG_TESTS_H
+#define MATH_ANIM_SVG_TESTS_H
+#include "core/Testing.h"
+
+namespace MathAnim
+{
+	namespace SvgTests
+	{
+		void setupTestSuite();
+	}
+}
+
+#endif 
+#endif // _MATH_ANIM_TESTS
@@ -0,0 +1,143 @@
+#ifdef _MATH_ANIM_TESTS
+#include "SyntaxHighlighterTests.h"
+#include "core/Testing.h"
+#include "parsers/SyntaxHighlighter.h"
+#include "parsers/SyntaxTheme.h"
+#include "platform/Platform.h"
+
+#include <algorithm>
+
+namespace MathAnim
+{
+	namespace SyntaxHighlighterTests
+	{
+		// -------------------- Constants --------------------
+		constexpr const char* CPP_GRAMMAR = "assets/grammars/cpp.tmLanguage.json";
+
+		// -------------------- Private functions --------------------
+		static std::string generateCppFile(int numLines)
+		{
+			std::string res = "#include <stdio.h>\n\n";
+			int numFunctions = 0;
+			while (std::count(res.begin(), res.end(), '\n') < numLines)
+			{
+				std::string id = std::to_string(numFunctions++);
+				res += "/* Adds up the numbers for case " + id + " */\n";
+				res += "static int sum" + id + "(int count, float scale)\n";
+				res += "{\n";
+				res += "\t// Keep a running total\n";
+				res += "\tint total = 0;\n";
+				res += "\tfor (int i = 0; i < count; i++)\n";
+				res += "\t{\n";
+				res += "\t\ttotal += (int)(i * scale) + 0x" + id + ";\n";
+				res += "\t}\n";
+				res += "\tprintf(\"sum" + id + ": %d\\n\", total);\n";
+				res += "\treturn total;\n";
+				res += "}\n\n";
+			}
+
+			return res;
+		}
+
+		static SyntaxTheme createTestTheme()
+		{
+			SyntaxTheme theme = {};
+			theme.defaultForeground = Vec4{ 1.0f, 1.0f, 1.0f, 1.0f };
+			theme.defaultRule.settings.push_back({ ThemeSettingType::ForegroundColor, theme.defaultForeground });
+			return theme;
+		}
+
+		static bool matchesEqual(const GrammarMatch& a, const GrammarMatch& b)
+		{
+			if (a.start != b.start || a.end != b.end || a.scope.friendlyName != b.scope.friendlyName || a.subMatches.size() != b.subMatches.size())
+			{
+				return false;
+			}
+
+			for (size_t i = 0; i < a.subMatches.size(); i++)
+			{
+				if (!matchesEqual(a.subMatches[i], b.subMatches[i]))
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		static bool highlightsEqual(const CodeHighlights& a, const CodeHighlights& b)
+		{
+			if (a.matches.size() != b.matches.size() || a.matchGroupEnds != b.matchGroupEnds || a.segments.size() != b.segments.size())
+			{
+				return false;
+			}
+
+			for (size_t i = 0; i < a.matches.size(); i++)
+			{
+				if (!matchesEqual(a.matches[i], b.matches[i]))
+				{
+					return false;
+				}
+			}
+
+			for (size_t i = 0; i < a.segments.size(); i++)
+			{
+				if (a.segments[i].startPos != b.segments[i].startPos || a.segments[i].endPos != b.segments[i].endPos)
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		// -------------------- Tests --------------------
+		DEFINE_TEST(reparseShouldMatchFullParseAfterEdits)
+		{
+			if (!Platform::fileExists(CPP_GRAMMAR))
+			{
+				printf("      SyntaxHighlighter: Skipping, '%s' not found\n", CPP_GRAMMAR);
+				END_TEST;
+			}
+
+			SyntaxHighlighter highlighter(CPP_GRAMMAR);
+			SyntaxTheme theme = createTestTheme();
+
+			std::string code = generateCppFile(200);
+			CodeHighlights highlights = highlighter.parse(code, theme);
+			ASSERT_TRUE(highlights.matches.size() > 0);
+
+			size_t middle = code.find("static int sum7(");
+			std::vector<std::string> edits;
+			// Insert a line
+			edits.push_back(code.substr(0, middle) + "int extraLine = 5;\n" + code.substr(middle));
+			// Delete a character
+			edits.push_back(code.substr(0, middle) + code.substr(middle + 1));
+			// Open a block comment that swallows the rest of the file, then close it again
+			edits.push_back(code.substr(0, middle) + "/* " + code.substr(middle));
+			edits.push_back(code);
+			// Append to the end
+			edits.push_back(code + "int lastLine = 1;");
+
+			for (const std::string& edit : edits)
+			{
+				CodeHighlights incremental = highlighter.reparse(highlights, edit, theme);
+				CodeHighlights full = highlighter.parse(edit, theme);
+				ASSERT_TRUE(highlightsEqual(incremental, full));
+				highlights = incremental;
+			}
+
+			highlighter.free();
+			END_TEST;
+		}
+
+		void setupTestSuite()
+		{
+			TestSuite& testSuite = Tests::addTestSuite("SyntaxHighlighter");
+
+			ADD_TEST(testSuite, reparseShouldMatchFullParseAfterEdits);
+		}
+	}
+}
+
+#endif
@@ -2,6 +2,10 @@
 #include "core/Testing.h"
 #include "LRUCacheTests.h"
 #include "AnimationManagerTests.h"
+#include "JobSystemTests.h"
+#include "SvgTests.h"
+#include "SyntaxHighlighterTests.h"
+#include "LaTexTests.h"
 
 int main()
 {
@@ -12,6 +16,10 @@ int main()
 
 	LRUCacheTests::setupTestSuite();
 	AnimationManagerTests::setupTestSuite();
+	JobSystemTests::setupTestSuite();
+	SvgTests::setupTestSuite();
+	SyntaxHighlighterTests::setupTestSuite();
+	LaTexTests::setupTestSuite();
 
 	Tests::runTests();
 	Tests::free();
@@ -13,21 +13,61 @@ void main()
 
 #type fragment
 #version 330 core
-layout(location = 4) out vec4 JumpMaskOne;
-layout(location = 5) out vec4 JumpMaskTwo;
+layout(location = 0) out vec4 JumpMaskOne;
+layout(location = 1) out vec4 JumpMaskTwo;
 
 in vec2 fTexCoords;
 
+#define MAX_ACTIVE_OBJECT_IDS 128
+
 uniform usampler2D uObjectIdTexture;
-uniform uvec2 uActiveObjectId;
+// Sorted by (HIGH, LOW) so we can binary search it
+uniform uvec2 uActiveObjectIds[MAX_ACTIVE_OBJECT_IDS];
+uniform int uNumActiveObjectIds;
+// Number of object id texels that map to one jump mask texel along each axis
+uniform int uDownsampleFactor;
+
+bool lessThanId(uvec2 a, uvec2 b)
+{
+    return a.g < b.g || (a.g == b.g && a.r < b.r);
+}
+
+bool isActiveObject(uvec2 objId)
+{
+    int low = 0;
+    int high = uNumActiveObjectIds - 1;
+    while (low <= high) {
+        int mid = (low + high) / 2;
+        uvec2 midId = uActiveObjectIds[mid];
+        if (midId == objId) {
+            return true;
+        } else if (lessThanId(midId, objId)) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+
+    return false;
+}
 
 void main()
 {
-    uvec2 sample = texture(uObjectIdTexture, fTexCoords).rg;
-    if (sample == uActiveObjectId) {
-        JumpMaskOne = vec4(fTexCoords, -1.0f, -1.0f);
-        JumpMaskTwo = vec4(fTexCoords, -1.0f, -1.0f);
-    } else {
-        discard;
+    // Check every full resolution texel covered by this jump mask texel
+    // so thin objects don't disappear when the mask is downsampled
+    ivec2 objIdTextureSize = textureSize(uObjectIdTexture, 0);
+    ivec2 basePixel = ivec2(gl_FragCoord.xy) * uDownsampleFactor;
+    for (int y = 0; y < uDownsampleFactor; y++) {
+        for (int x = 0; x < uDownsampleFactor; x++) {
+            ivec2 pixel = min(basePixel + ivec2(x, y), objIdTextureSize - ivec2(1, 1));
+            uvec2 sample = texelFetch(uObjectIdTexture, pixel, 0).rg;
+            if (isActiveObject(sample)) {
+                JumpMaskOne = vec4(fTexCoords, -1.0f, -1.0f);
+                JumpMaskTwo = vec4(fTexCoords, -1.0f, -1.0f);
+                return;
+            }
+        }
     }
+
+    discard;
 }
\ No newline at end of file
@@ -24,8 +24,6 @@ uniform float uOutlineWidth;
 uniform vec4 uOutlineColor;
 uniform vec2 uFramebufferSize;
 
-uniform uvec2 uActiveObjectId;
-
 #define UINT32_MAX uint(0xFFFFFFFF)
 
 void main()
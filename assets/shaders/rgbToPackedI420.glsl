@@ -0,0 +1,74 @@
+#type vertex
+#version 330 core
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec2 aTexCoords;
+
+void main()
+{
+	gl_Position = vec4(aPos.x, aPos.y, 0.0, 1.0);
+}
+
+#type fragment
+#version 330 core
+layout(location = 0) out uint PackedColor;
+
+uniform sampler2D uTexture;
+// Size of the video frame, not of the packed texture we're rendering into
+uniform uvec2 uFrameSize;
+// 1 for 8 bit samples, 4 for 10 bit samples
+uniform float uSampleScale;
+
+void main()
+{
+    // The packed texture is one long row of samples that wraps every frameSize.x texels,
+    // laid out as YYYY...UU...VV... so it reads back as a planar I420 frame
+    ivec2 frameSize = ivec2(uFrameSize);
+    int index = int(gl_FragCoord.y) * frameSize.x + int(gl_FragCoord.x);
+    int yPlaneSize = frameSize.x * frameSize.y;
+    ivec2 uvPlaneDimensions = frameSize / 2;
+    int uvPlaneSize = uvPlaneDimensions.x * uvPlaneDimensions.y;
+
+    float value = 0.0f;
+    if (index < yPlaneSize)
+    {
+        vec2 texCoords = (vec2(index % frameSize.x, index / frameSize.x) + 0.5f) / vec2(frameSize);
+        vec4 color = texture(uTexture, texCoords);
+        // Taken from https://en.wikipedia.org/wiki/YCbCr#RGB_conversion
+        // Y'CbCr from R'dG'dB'd
+        value = (65.481f * color.r / 255.0f)
+            + (128.553f * color.g / 255.0f)
+            + (24.966f * color.b / 255.0f)
+            + (16.0f / 255.0f);
+    }
+    else if (index < yPlaneSize + uvPlaneSize * 2)
+    {
+        int uvIndex = index - yPlaneSize;
+        bool isVPlane = uvIndex >= uvPlaneSize;
+        if (isVPlane)
+        {
+            uvIndex -= uvPlaneSize;
+        }
+
+        // Sampling between the 4 texels each chroma sample covers averages them
+        vec2 texCoords = (vec2(uvIndex % uvPlaneDimensions.x, uvIndex / uvPlaneDimensions.x) + 0.5f) / vec2(uvPlaneDimensions);
+        vec4 color = texture(uTexture, texCoords);
+        if (isVPlane)
+        {
+            value = (112.0f * color.r / 255.0f)
+                - (93.786f * color.g / 255.0f)
+                - (18.214f * color.b / 255.0f)
+                + (128.0f / 255.0f);
+        }
+        else
+        {
+            value = (-37.797f * color.r / 255.0f)
+                - (74.203f * color.g / 255.0f)
+                + (112.0f * color.b / 255.0f)
+                + (128.0f / 255.0f);
+        }
+    }
+
+    // Converting a negative float to uint is undefined, and out of range colors can
+    // push the chroma equations slightly below 0
+    PackedColor = uint(clamp(value, 0.0f, 1.0f) * 255.0f * uSampleScale + 0.5f);
+}
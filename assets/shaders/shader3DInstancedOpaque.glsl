@@ -0,0 +1,43 @@
+#type vertex
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aTubeOffset;
+
+// Per instance
+layout (location = 2) in mat4 iTransform;
+layout (location = 6) in vec4 iColor;
+layout (location = 7) in float iTubeRadius;
+layout (location = 8) in uvec2 iObjId;
+
+out vec4 fColor;
+flat out uvec2 fObjId;
+
+uniform mat4 uProjection;
+uniform mat4 uView;
+
+void main()
+{
+    fColor = iColor;
+    fObjId = iObjId;
+    vec3 localPos = aPos + aTubeOffset * iTubeRadius;
+    gl_Position = uProjection * uView * iTransform * vec4(localPos, 1.0);
+}
+
+#type fragment
+#version 330 core
+layout (location = 0) out vec4 FragColor;
+layout (location = 3) out uvec2 ObjId;
+
+in vec4 fColor;
+flat in uvec2 fObjId;
+
+void main()
+{
+    if (fColor.a < 0.5) 
+    {
+        discard;
+    }
+
+    FragColor = fColor;
+    ObjId = fObjId;
+}
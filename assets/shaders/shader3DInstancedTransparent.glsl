@@ -0,0 +1,51 @@
+#type vertex
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aTubeOffset;
+
+// Per instance
+layout (location = 2) in mat4 iTransform;
+layout (location = 6) in vec4 iColor;
+layout (location = 7) in float iTubeRadius;
+layout (location = 8) in uvec2 iObjId;
+
+out vec4 fColor;
+flat out uvec2 fObjId;
+
+uniform mat4 uProjection;
+uniform mat4 uView;
+
+void main()
+{
+    fColor = iColor;
+    fObjId = iObjId;
+    vec3 localPos = aPos + aTubeOffset * iTubeRadius;
+    gl_Position = uProjection * uView * iTransform * vec4(localPos, 1.0);
+}
+
+#type fragment
+#version 330 core
+
+layout (location = 1) out vec4 accumulation;
+layout (location = 2) out float revealage;
+layout (location = 3) out uvec2 ObjId;
+
+in vec4 fColor;
+flat in uvec2 fObjId;
+
+#define UINT32_MAX uint(0xFFFFFFFF)
+
+void main()
+{
+   // Same weighted blended OIT output as shader3DTransparent.glsl
+   vec4 premultipliedReflect = fColor;
+   float w = clamp(pow(min(1.0, premultipliedReflect.a * 10.0) + 0.01, 3.0) * 1e8 * pow(1.0 - gl_FragCoord.z * 0.9, 3.0), 1e-2, 3e3);
+   accumulation = premultipliedReflect * w;
+   revealage = premultipliedReflect.a;
+
+   if (premultipliedReflect.a > 0.5) {
+      ObjId = fObjId;
+   } else {
+      ObjId = uvec2(UINT32_MAX, UINT32_MAX);
+   }
+}